@@ -69,6 +69,12 @@ kissat_set_id(kissat*, int);
 // Interface inner functions
 char
 kissat_set_phase(kissat*, unsigned, int);
+// Best phase of an external variable (1 or -1), 0 if it is eliminated or unknown
+int
+kissat_get_best_phase(kissat*, unsigned);
+// Height of the trail saved in the best phases, reset at each rephasing
+unsigned
+kissat_get_best_assigned(kissat*);
 char
 kissat_check_searches(kissat*);
 
@@ -216,7 +216,7 @@ char kissat_set_phase (kissat *solver, unsigned external_var, int phase) {
     return false;
   }
   import *import_lit = &PEEK_STACK (solver->import, external_var);
-  if (import_lit->eliminated) {
+  if (!import_lit->imported || import_lit->eliminated) {
     LOGP (" The kissat solver %d eliminated the variable %u",
           solver->id_painless, external_var);
     return false;
@@ -229,6 +229,19 @@ char kissat_set_phase (kissat *solver, unsigned external_var, int phase) {
   return true;
 }
 
+int kissat_get_best_phase (kissat *solver, unsigned external_var) {
+  if (external_var >= SIZE_STACK (solver->import))
+    return 0;
+  import *import_lit = &PEEK_STACK (solver->import, external_var);
+  if (!import_lit->imported || import_lit->eliminated)
+    return 0;
+  return solver->phases.best[IDX (import_lit->lit)];
+}
+
+unsigned kissat_get_best_assigned (kissat *solver) {
+  return solver->best_assigned;
+}
+
 char kissat_check_searches (kissat *solver) {
   return kissat_get_searches (&solver->statistics) > 0;
 }
\ No newline at end of file
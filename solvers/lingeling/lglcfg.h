@@ -1,8 +1,8 @@
 /*************************************************************/
 /* Automatically generated by './mkconfig.sh': do note edit! */
 /*************************************************************/
-#define LGL_OS "Linux HP-12-8-2 6.8.0-57-generic x86_64"
-#define LGL_COMPILED "Thu May  8 06:23:01 CEST 2025"
-#define LGL_RELEASED "Thu May  8 06:23:01 CEST 2025"
+#define LGL_OS "Linux vm 6.18.44-fc-v139 x86_64"
+#define LGL_COMPILED "Sun Oct 18 14:29:34 UTC 2026"
+#define LGL_RELEASED "Sun Oct 18 14:29:34 UTC 2026"
 #define LGL_VERSION "1.0.0"
-#define LGL_ID "ce750adb0b91f80d66f9df19f70fd10178d47d85"
+#define LGL_ID "65ff5ac63962e18aa321e7f1f1a24c8a907e9bfc"
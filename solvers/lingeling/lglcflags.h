@@ -1,2 +1,2 @@
-#define LGL_CC "gcc (Ubuntu 13.3.0-6ubuntu2~24.04) 13.3.0"
+#define LGL_CC "gcc (Debian 12.2.0-14+deb12u1) 12.2.0"
 #define LGL_CFLAGS "-W -Wall -O3 -I../yalsat -DNLGLOG -DNDEBUG -DNCHKSOL -DNLGLDRUPLIG -DNLGLFILES -DNLGLDEMA"
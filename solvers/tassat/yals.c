@@ -112,6 +112,19 @@ Copyright (C) 2023  Md Solimul Chowdhury, Cayden Codel, and Marijn Heule, Carneg
     (S).end = (S).start + NS; \
   } while (0)
 
+#define RESERVE(S, N)         \
+  do                          \
+  {                           \
+    size_t OS = SIZE(S);      \
+    size_t OC = COUNT(S);     \
+    size_t NS = OC + (N);     \
+    if (NS <= OS)             \
+      break;                  \
+    RSZ((S).start, OS, NS);   \
+    (S).top = (S).start + OC; \
+    (S).end = (S).start + NS; \
+  } while (0)
+
 #define RESET(S, N)            \
   do                           \
   {                            \
@@ -252,9 +265,14 @@ typedef unsigned Word;
 #endif
 /*------------------------------------------------------------------------*/
 
+/* Occurrences are '(cidx << lenshift) | len' with the length capped to
+ * 'lenmask'.  The shift is LENSHIFT unless the number of clauses does not
+ * fit, then it is decreased down to MINLENSHIFT (lengths are only used to
+ * weight the clauses, larger ones share the weight of the capped length).
+ */
 #define LENSHIFT 5
+#define MINLENSHIFT 2
 #define MAXLEN ((1 << LENSHIFT) - 1)
-#define LENMASK MAXLEN
 
 /*------------------------------------------------------------------------*/
 
@@ -759,8 +777,6 @@ struct Yals
   Exp exp;
   LIWET liwet;
   int inner_restart;
-  STACK(int)
-  clause_size;
   int wid, nthreads;
   int consecutive_non_improvement, last_flip_unsat_count;
   int force_restart, fres_count;
@@ -768,6 +784,13 @@ struct Yals
 
   int preprocessing_done;
   int primary_worker;
+  int lenshift, lenmask;
+  Yals *primary;
+  STACK(int)
+  units;
+  STACK(int)
+  fixes;
+  int nfixed;
   int *(*get_cdb_top)();
   int *(*get_cdb_end)();
   int *(*get_cdb_start)();
@@ -1125,6 +1148,13 @@ static int tass_best(Yals *yals, int lit)
   return res;
 }
 
+static int tass_is_fixed(Yals *yals, int lit)
+{
+  int idx = ABS(lit);
+  return GETBIT(yals->set, yals->nvarwords, idx) ||
+         !GETBIT(yals->clear, yals->nvarwords, idx);
+}
+
 static unsigned tass_weighted_break(Yals *yals, int lit)
 {
   int idx = ABS(lit);
@@ -1216,7 +1246,6 @@ static unsigned tass_incsatcnt(Yals *yals, int cidx, int lit, int len)
     assert(yals->satcnt4[cidx]);
   }
   yals->liwet.sat_count_in_clause[cidx] = res + 1;
-  // printf ("\n===> inc %d %d",res, PEEK(yals->clause_size, cidx));
 #ifndef NYALSTATS
   assert(res + 1 <= yals->maxlen);
   yals->stats.inc[res]++;
@@ -1542,8 +1571,8 @@ static unsigned tass_compute_weighted_break(Yals *yals, int lit)
   occs = tass_occs(yals, -lit);
   for (p = occs; (occ = *p) >= 0; p++)
   {
-    len = occ & LENMASK;
-    cidx = occ >> LENSHIFT;
+    len = occ & yals->lenmask;
+    cidx = occ >> yals->lenshift;
     cnt = tass_satcnt(yals, cidx);
     if (cnt != 1)
       continue;
@@ -1644,7 +1673,7 @@ static int tass_pick_literal(Yals *yals, int cidx)
 {
   const int pick_break_zero = yals->opts.breakzero.val;
   const int *p, *lits;
-  int lit, zero;
+  int lit, zero, skip;
   unsigned w;
   double s;
 
@@ -1653,9 +1682,17 @@ static int tass_pick_literal(Yals *yals, int cidx)
 
   lits = tass_lits(yals, cidx);
 
+  // Never flip a variable fixed by 'tass_fix' unless all of them are
+  skip = 0;
+  if (yals->nfixed)
+    for (p = lits; !skip && (lit = *p); p++)
+      skip = !tass_is_fixed(yals, lit);
+
   zero = 0;
   for (p = lits; (lit = *p); p++)
   {
+    if (skip && tass_is_fixed(yals, lit))
+      continue;
     w = tass_determine_weighted_break(yals, lit);
     LOG("literal %d weighted break %u", lit, w);
     if (pick_break_zero && !w)
@@ -1692,7 +1729,7 @@ static int tass_pick_literal(Yals *yals, int cidx)
     {
       w = wbs[i];
       s = tass_compute_score_from_weighted_break(yals, w);
-      LOG("literal %d weighted break %u score %g", lits[i], w, s);
+      LOG("literal %d weighted break %u score %g", PEEK(yals->cands, i), w, s);
       PUSH(yals->scores, s);
     }
     lit = tass_pick_by_score(yals);
@@ -1700,7 +1737,7 @@ static int tass_pick_literal(Yals *yals, int cidx)
 #ifndef NDEBUG
     for (i = 0; i < n; i++)
     {
-      int tmp = lits[i];
+      int tmp = PEEK(yals->cands, i);
       if (tmp != lit)
         continue;
       s = yals->scores.start[i];
@@ -2051,8 +2088,8 @@ static void tass_make_clauses_after_flipping_lit(Yals *yals, int lit)
   occs = tass_occs(yals, lit);
   for (p = occs; (occ = *p) >= 0; p++)
   {
-    len = occ & LENMASK;
-    cidx = occ >> LENSHIFT;
+    len = occ & yals->lenmask;
+    cidx = occ >> yals->lenshift;
     if (tass_incsatcnt(yals, cidx, lit, len))
     {
       if (yals->liwet.sat_count_in_clause[cidx] == 2) // 1 to 2
@@ -2094,8 +2131,8 @@ static void tass_break_clauses_after_flipping_lit(Yals *yals, int lit)
   occs = tass_occs(yals, -lit);
   for (p = occs; (occ = *p) >= 0; p++)
   {
-    len = occ & LENMASK;
-    cidx = occ >> LENSHIFT;
+    len = occ & yals->lenmask;
+    cidx = occ >> yals->lenshift;
     if (tass_decsatcnt(yals, cidx, -lit, len))
     {
       if (yals->liwet.sat_count_in_clause[cidx] == 1) // 2 to 1
@@ -2702,7 +2739,7 @@ static void tass_update_sat_and_unsat(Yals *yals)
 
   tass_reset_liwet(yals);
 
-  for (len = 1; len <= MAXLEN; len++)
+  for (len = 1; len <= yals->lenmask; len++)
     yals->weights[len] = tass_len_to_weight(yals, len);
   if (yals->crit)
     memset(yals->weightedbreak, 0, 2 * yals->nvars * sizeof(int));
@@ -2731,7 +2768,7 @@ static void tass_update_sat_and_unsat(Yals *yals)
       yals->crit[cidx] = crit;
 
     len = p - lits;
-    cappedlen = MIN(len, MAXLEN);
+    cappedlen = MIN(len, yals->lenmask);
     LOGCIDX(cidx,
             "sat count %u length %d weight %u for",
             satcnt, len, yals->weights[cappedlen]);
@@ -2815,6 +2852,25 @@ static void tass_init_weight_to_score_table(Yals *yals)
 
 /*------------------------------------------------------------------------*/
 
+static void tass_set_lenshift(Yals *yals, int nclauses)
+{
+  if ((long long)COUNT(yals->cdb) + 2LL * yals->nvars > INT_MAX)
+    tass_abort(yals, "maximum number of literals %d exceeded", INT_MAX);
+
+  yals->lenshift = LENSHIFT;
+  while (yals->lenshift > MINLENSHIFT && (INT_MAX >> yals->lenshift) < nclauses)
+    yals->lenshift--;
+  if ((INT_MAX >> yals->lenshift) < nclauses)
+    tass_abort(yals,
+               "maximum number of clauses %d exceeded",
+               (INT_MAX >> yals->lenshift));
+  yals->lenmask = (1 << yals->lenshift) - 1;
+  if (yals->lenshift < LENSHIFT)
+    tass_msg(yals, 1,
+             "packing occurrences with %d length bits (lengths capped to %d)",
+             yals->lenshift, yals->lenmask);
+}
+
 static void tass_connect(Yals *yals)
 {
   int idx, n, lit, nvars = yals->nvars, *count, cidx, sign;
@@ -2874,10 +2930,7 @@ static void tass_connect(Yals *yals)
   NEWN(yals->stats.dec, yals->stats.nincdec);
 #endif
 
-  if ((INT_MAX >> LENSHIFT) < nclauses)
-    tass_abort(yals,
-               "maximum number of clauses %d exceeded",
-               (INT_MAX >> LENSHIFT));
+  tass_set_lenshift(yals, nclauses);
 
   yals->nclauses = nclauses;
   yals->nbin = nbin;
@@ -3020,7 +3073,7 @@ static void tass_connect(Yals *yals)
   {
     p = tass_lits(yals, cidx);
     len = 0;
-    while (len < MAXLEN && p[len])
+    while (len < yals->lenmask && p[len])
       len++;
     while ((lit = *p++))
     {
@@ -3028,7 +3081,7 @@ static void tass_connect(Yals *yals)
       occs = *occsptr;
       assert_valid_occs(occs);
       assert(!yals->occs[occs]);
-      yals->occs[occs] = (cidx << LENSHIFT) | len;
+      yals->occs[occs] = (cidx << yals->lenshift) | len;
       *occsptr = occs + 1;
     }
   }
@@ -3387,6 +3440,8 @@ void tass_del(Yals *yals)
   RELEASE(yals->scores);
   RELEASE(yals->cands);
   RELEASE(yals->trail);
+  RELEASE(yals->units);
+  RELEASE(yals->fixes);
   RELEASE(yals->phases);
   RELEASE(yals->exp.table.two);
   RELEASE(yals->exp.table.cb);
@@ -3451,6 +3506,24 @@ void tass_setphase(Yals *yals, int lit)
   PUSH(yals->phases, lit);
 }
 
+void tass_fix(Yals *yals, int lit)
+{
+  int idx = ABS(lit);
+  if (!lit)
+    tass_abort(yals, "zero literal argument to 'tass_fix'");
+  if (!yals->set || idx >= yals->nvars)
+    return;
+  if (tass_is_fixed(yals, lit))
+    return;
+  LOG("fixing %d", lit);
+  if (lit > 0)
+    SETBIT(yals->set, yals->nvarwords, idx);
+  else
+    CLRBIT(yals->clear, yals->nvarwords, idx);
+  yals->nfixed++;
+  PUSH(yals->fixes, lit);
+}
+
 void tass_setflipslimit(Yals *yals, long long flips)
 {
   yals->limits.flips = flips;
@@ -3549,13 +3622,8 @@ void tass_add(Yals *yals, int lit)
   else
   {
     const int *p;
-    int size = 0;
     for (p = yals->clause.start; p < yals->clause.top; p++)
-    {
       POKE(yals->mark, ABS(*p), 0);
-      size++;
-    }
-    PUSH(yals->clause_size, size);
 
     if (yals->trivial)
       yals->trivial = 0;
@@ -3565,6 +3633,44 @@ void tass_add(Yals *yals, int lit)
   }
 }
 
+/*Added for Painless*/
+void tass_add_clauses(Yals *yals, const int *lits, int nclauses, int maxvar)
+{
+  const int *p, *end;
+  int i;
+  if (!EMPTY(yals->clause))
+    tass_abort(yals, "added clause incomplete in 'tass_add_clauses'");
+  if (yals->preprocessing_done || yals->primary)
+    tass_abort(yals, "can not add clauses after 'tass_prepare'");
+  for (end = lits, i = 0; i < nclauses; end++)
+    if (!*end)
+      i++;
+  // Sized once, instead of doubling the stacks while adding
+  RESERVE(yals->cdb, end - lits);
+  if (maxvar >= COUNT(yals->mark))
+  {
+    RESERVE(yals->mark, maxvar + 1 - COUNT(yals->mark));
+    while (maxvar >= COUNT(yals->mark))
+      PUSH(yals->mark, 0);
+  }
+  for (p = lits; p < end; p++)
+    tass_add(yals, *p);
+}
+
+void tass_share(Yals *yals, Yals *primary)
+{
+  if (!primary->preprocessing_done && !primary->mt)
+    tass_abort(yals, "shared instance not prepared in 'tass_share'");
+  if (yals->preprocessing_done || !EMPTY(yals->cdb) || !EMPTY(yals->clause))
+    tass_abort(yals, "clauses already added before 'tass_share'");
+  yals->primary = primary;
+  yals->primary_worker = 0;
+  yals->mt = primary->mt;
+  yals->nvars = primary->nvars;
+  tass_msg(yals, 1, "sharing %d connected clauses", primary->nclauses);
+}
+/*-------------------*/
+
 /*------------------------------------------------------------------------*/
 
 #define ISDEFSTRAT(NAME, ENABLED)                      \
@@ -3840,6 +3946,8 @@ void tass_restart_inner(Yals *yals)
 
 /*------------------------------------------------------------------------*/
 
+static void tass_flip_fixes(Yals *yals);
+
 int tass_done(Yals *yals)
 {
   assert(!yals->mt);
@@ -3876,6 +3984,12 @@ int tass_done(Yals *yals)
       return -1;
     }
   }
+  if (!EMPTY(yals->fixes))
+  {
+    tass_flip_fixes(yals);
+    if (tass_nunsat(yals) <= yals->opts.target.val)
+      return 1;
+  }
   if (yals->opts.hitlim.val >= 0 &&
       yals->stats.hits >= yals->opts.hitlim.val)
   {
@@ -3962,7 +4076,7 @@ void tass_liwet_transfer_weights_for_clause(Yals *yals, int sink)
     occs = tass_occs(yals, lit);
     for (p = occs; (occ = *p) >= 0; p++)
     {
-      nidx = occ >> LENSHIFT;
+      nidx = occ >> yals->lenshift;
       if (tass_satcnt(yals, nidx) > 0)
       {
         if (yals->liwet.clause_weights[nidx] >= best_w)
@@ -4042,10 +4156,8 @@ void tass_liwet_transfer_weights(Yals *yals)
   yals->liwet.guaranteed_uwrvs = 0;
 }
 
-void tass_flip(Yals *yals)
+static void tass_flip_lit(Yals *yals, int lit)
 {
-  int cidx = tass_pick_clause(yals);
-  int lit = tass_pick_literal(yals, cidx);
   yals->stats.flips++;
   yals->stats.unsum += tass_nunsat(yals);
   tass_flip_value_of_lit(yals, lit);
@@ -4055,6 +4167,26 @@ void tass_flip(Yals *yals)
   yals->last_flip_unsat_count = tass_nunsat(yals);
 }
 
+void tass_flip(Yals *yals)
+{
+  int cidx = tass_pick_clause(yals);
+  int lit = tass_pick_literal(yals, cidx);
+  tass_flip_lit(yals, lit);
+}
+
+// Force the values of the variables fixed since the last call
+static void tass_flip_fixes(Yals *yals)
+{
+  const int *p;
+  for (p = yals->fixes.start; p < yals->fixes.top; p++)
+    if (!tass_val(yals, *p))
+      tass_flip_lit(yals, *p);
+  tass_msg(yals, 2,
+           "forced %d new fixed variables (%d in total)",
+           (int)COUNT(yals->fixes), yals->nfixed);
+  CLEAR(yals->fixes);
+}
+
 /*static void save_stats_lm (Yals * yals)
 {
   if (!yals->liwet.uwrvs_size)
@@ -4261,8 +4393,14 @@ DONE:
 }
 
 // Extensions
-int tass_init(Yals *yals, char doPreprocess)
+static void tass_connect_palsat(Yals *yals);
+
+int tass_prepare(Yals *yals, char doPreprocess)
 {
+  const int *p;
+  if (yals->preprocessing_done)
+    return 0;
+
   yals->primary_worker = 1;
   if (!EMPTY(yals->clause))
     tass_abort(yals, "added clause incomplete in 'tass_sat'");
@@ -4284,9 +4422,31 @@ int tass_init(Yals *yals, char doPreprocess)
     }
   }
 
+  // The units of the (preprocessed) formula, needed by 'tass_share'
+  RESERVE(yals->units, COUNT(yals->trail));
+  for (p = yals->trail.start; p < yals->trail.top; p++)
+    PUSH(yals->units, *p);
+
   if (yals->opts.setfpu.val)
     tass_set_fpu(yals);
   tass_connect(yals);
+  yals->preprocessing_done = 1;
+
+  return 0;
+}
+
+int tass_init(Yals *yals, char doPreprocess)
+{
+  int res;
+  if (yals->primary)
+  {
+    if (yals->mt)
+      return 20;
+    set_shared_structures(yals);
+    tass_connect_palsat(yals);
+  }
+  else if ((res = tass_prepare(yals, doPreprocess)))
+    return res;
 
   tass_liwet_init_build(yals);
 
@@ -4820,6 +4980,9 @@ void determine_uwvar(Yals *yals, int var)
 {
   int true_lit = tass_val(yals, var) ? var : -var;
   int false_lit = -true_lit;
+  // A fixed variable never becomes a candidate of the weight transfer
+  if (yals->nfixed && tass_is_fixed(yals, true_lit))
+    return;
   /**
       FLIP: true_lit ---> false_lit
       1) unsat_weights [get_pos (false_lit)]
@@ -5011,7 +5174,7 @@ void compute_neighborhood_for_clause_init(Yals *yals, int cidx)
     // printf ("%d ",lit);
     for (p = occs; (occ = *p) >= 0; p++)
     {
-      neighbor = occ >> LENSHIFT;
+      neighbor = occ >> yals->lenshift;
       // if (!tass_satcnt (yals, neighbor)) continue;
       if (cidx != neighbor && yals->liwet.helper_hash_clauses[neighbor]++ == 0)
       {
@@ -5125,7 +5288,7 @@ void tass_check_lits_weights_sanity_var(Yals *yals, int v)
   // const int * occs = tass_occs (yals, tl), *p;
   // for (p=occs; (occ = *p) >= 0; p++)
   // {
-  //   int cidx = occ >> LENSHIFT;
+  //   int cidx = occ >> yals->lenshift;
   //   if (tass_satcnt (yals, cidx) == 1)
   //     s1w += yals->liwet.clause_weights [cidx];
   // }
@@ -5136,7 +5299,7 @@ void tass_check_lits_weights_sanity_var(Yals *yals, int v)
 
   // for (p=occs; (occ = *p) >= 0; p++)
   // {
-  //   int cidx = occ >> LENSHIFT;
+  //   int cidx = occ >> yals->lenshift;
   //   if (!tass_satcnt (yals, cidx))
   //     uw += yals->liwet.clause_weights [cidx];
   // }
@@ -5157,7 +5320,7 @@ void tass_liwet_update_lit_weights_at_restart_var(Yals *yals, int v)
   const int *occs = tass_occs(yals, tl), *p;
   for (p = occs; (occ = *p) >= 0; p++)
   {
-    int cidx = occ >> LENSHIFT;
+    int cidx = occ >> yals->lenshift;
     if (tass_satcnt(yals, cidx) == 1)
       s1w += yals->liwet.clause_weights[cidx];
     if (tass_satcnt(yals, cidx) == 0)
@@ -5174,7 +5337,7 @@ void tass_liwet_update_lit_weights_at_restart_var(Yals *yals, int v)
 
   for (p = occs; (occ = *p) >= 0; p++)
   {
-    int cidx = occ >> LENSHIFT;
+    int cidx = occ >> yals->lenshift;
     if (!tass_satcnt(yals, cidx))
       uw += yals->liwet.clause_weights[cidx];
     if (tass_satcnt(yals, cidx) == 1)
@@ -5257,7 +5420,7 @@ int tass_var_in_unsat(Yals *yals, int v)
   int occ;
   for (o = pos_oocs; (occ = *o) >= 0; o++)
   {
-    int pcidx = occ >> LENSHIFT;
+    int pcidx = occ >> yals->lenshift;
     if (!tass_satcnt(yals, pcidx))
       return 1;
   }
@@ -5265,7 +5428,7 @@ int tass_var_in_unsat(Yals *yals, int v)
   int *neg_occs = tass_occs(yals, -v);
   for (o = neg_occs; (occ = *o) >= 0; o++)
   {
-    int ncidx = occ >> LENSHIFT;
+    int ncidx = occ >> yals->lenshift;
     if (!tass_satcnt(yals, ncidx))
       return 1;
   }
@@ -5426,6 +5589,22 @@ void tass_fnpointers(Yals *yals,
 
 void set_shared_structures(Yals *yals)
 {
+  if (yals->primary)
+  {
+    const Yals *primary = yals->primary;
+    const int *p;
+    yals->cdb = primary->cdb;
+    yals->occs = primary->occs;
+    yals->noccs = primary->noccs;
+    yals->refs = primary->refs;
+    yals->lits = primary->lits;
+    yals->nvars = primary->nvars;
+    CLEAR(yals->trail);
+    RESERVE(yals->trail, COUNT(primary->units));
+    for (p = primary->units.start; p < primary->units.top; p++)
+      PUSH(yals->trail, *p);
+    return;
+  }
   yals->cdb.top = yals->get_cdb_top();
   yals->cdb.start = yals->get_cdb_start();
   yals->cdb.end = yals->get_cdb_end();
@@ -5504,10 +5683,7 @@ static void tass_connect_palsat(Yals *yals)
   NEWN(yals->stats.dec, yals->stats.nincdec);
 #endif
 
-  if ((INT_MAX >> LENSHIFT) < nclauses)
-    tass_abort(yals,
-               "maximum number of clauses %d exceeded",
-               (INT_MAX >> LENSHIFT));
+  tass_set_lenshift(yals, nclauses);
 
   yals->nclauses = nclauses;
   yals->nbin = nbin;
@@ -59,6 +59,24 @@ tass_showopts(Yals*);
 
 // Painless Extension
 
+/* Add 'nclauses' zero terminated clauses over variables up to 'maxvar' */
+void
+tass_add_clauses(Yals*, const int* lits, int nclauses, int maxvar);
+
+/* Preprocess and connect the clauses, returns 20 if they are unsatisfiable */
+int
+tass_prepare(Yals*, char);
+
+/* Search on the clauses of a prepared instance without copying them, it
+ * must be deleted after this one and no clause can be added to this one */
+void
+tass_share(Yals*, Yals* primary);
+
+/* Fix a literal for the rest of the search, must be called between two
+ * flips, the value is forced at the next 'tass_done' */
+void
+tass_fix(Yals*, int lit);
+
 int
 tass_init(Yals*, char);
 
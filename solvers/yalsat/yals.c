@@ -85,6 +85,17 @@ do { \
   (S).end = (S).start + NS; \
 } while (0)
 
+#define RESERVE(S,N) \
+do { \
+  size_t OS = SIZE (S); \
+  size_t OC = COUNT (S); \
+  size_t NS = OC + (N); \
+  if (NS <= OS) break; \
+  RSZ ((S).start, OS, NS); \
+  (S).top = (S).start + OC; \
+  (S).end = (S).start + NS; \
+} while (0)
+
 #define RESET(S,N) \
 do { \
   assert ((N) <= SIZE (S) ); \
@@ -189,9 +200,14 @@ do { \
 #endif
 /*------------------------------------------------------------------------*/
 
+/* Occurrences are '(cidx << lenshift) | len' with the length capped to
+ * 'lenmask'.  The shift is LENSHIFT unless the number of clauses does not
+ * fit, then it is decreased down to MINLENSHIFT (lengths are only used to
+ * weight the clauses, larger ones share the weight of the capped length).
+ */
 #define LENSHIFT	6
+#define MINLENSHIFT	2
 #define MAXLEN		((1<<LENSHIFT)-1)
-#define LENMASK		MAXLEN
 
 /*------------------------------------------------------------------------*/
 
@@ -414,6 +430,9 @@ struct Yals {
   int * pos, * lits; Lnk ** lnk;
   int * crit; unsigned * weightedbreak;
   int nclauses, nbin, ntrn, minlen, maxlen; double avglen;
+  int lenshift, lenmask;
+  int connected; Yals * primary; STACK(int) units;
+  STACK(int) fixes; int nfixed;
   STACK(unsigned) breaks; STACK(double) scores; STACK(int) cands;
   STACK(Word*) cache; int cachesizetarget; STACK(Word) sigs;
   STACK(int) minlits;
@@ -718,6 +737,12 @@ static int yals_best (Yals * yals, int lit) {
   return res;
 }
 
+static int yals_fixed (Yals * yals, int lit) {
+  int idx = ABS (lit);
+  return GETBIT (yals->set, yals->nvarwords, idx) ||
+         !GETBIT (yals->clear, yals->nvarwords, idx);
+}
+
 static unsigned yals_weighted_break (Yals * yals, int lit) {
   int idx = ABS (lit);
   assert (yals->crit);
@@ -1044,8 +1069,8 @@ static unsigned yals_compute_weighted_break (Yals * yals, int lit) {
   wb = b = 0;
   occs = yals_occs (yals, -lit);
   for (p = occs ; (occ = *p) >= 0; p++) {
-    len = occ & LENMASK;
-    cidx = occ >> LENSHIFT;
+    len = occ & yals->lenmask;
+    cidx = occ >> yals->lenshift;
     cnt = yals_satcnt (yals, cidx);
     if (cnt != 1) continue;
     w = yals->weights [len];		  // TODO remove mem for uniform
@@ -1135,16 +1160,23 @@ static int yals_pick_literal (Yals * yals, int cidx) {
   const int * p, * lits;
   unsigned w, best_w;
   double s;
-  int lit;
+  int lit, skip;
 
   assert (EMPTY (yals->breaks));
   assert (EMPTY (yals->cands));
 
   lits = yals_lits (yals, cidx);
 
+  /* Never flip a variable fixed by 'yals_fix' unless all of them are.  */
+  skip = 0;
+  if (yals->nfixed)
+    for (p = lits; !skip && (lit = *p); p++)
+      skip = !yals_fixed (yals, lit);
+
   best_w = UINT_MAX;
 
   for (p = lits; (lit = *p); p++) {
+    if (skip && yals_fixed (yals, lit)) continue;
     w = yals_determine_weighted_break (yals, lit);
     LOG ("literal %d weighted break %u", lit, w);
     if (!eager) {
@@ -1171,7 +1203,9 @@ static int yals_pick_literal (Yals * yals, int cidx) {
 
     yals->stats.walks++;
     const unsigned size = p - lits;
-    const unsigned pos = yals_rand_mod (yals, size);
+    unsigned pos;
+    do pos = yals_rand_mod (yals, size);
+    while (skip && yals_fixed (yals, lits[pos]));
     lit = lits[pos];
     LOG ("picked random walk literal %d at position %u", lit, pos);
   
@@ -1194,14 +1228,15 @@ static int yals_pick_literal (Yals * yals, int cidx) {
     for (i = 0; i < n; i++) {
       w = wbs[i];
       s = yals_compute_score_from_weighted_break (yals, w);
-      LOG ("literal %d weighted break %u score %g", lits[i], w, s);
+      LOG ("literal %d weighted break %u score %g",
+           PEEK (yals->cands, i), w, s);
       PUSH (yals->scores, s);
     }
     lit = yals_pick_by_score (yals);
 
 #ifndef NDEBUG
     for (i = 0; i < n; i++) {
-      int tmp = lits[i];
+      int tmp = PEEK (yals->cands, i);
       if (tmp != lit) continue;
       s = yals->scores.start[i];
       w = wbs[i];
@@ -1473,8 +1508,8 @@ static void yals_make_clauses_after_flipping_lit (Yals * yals, int lit) {
   assert (yals_val (yals, lit));
   occs = yals_occs (yals, lit);
   for (p = occs; (occ = *p) >= 0; p++) {
-    len = occ & LENMASK;
-    cidx = occ >> LENSHIFT;
+    len = occ & yals->lenmask;
+    cidx = occ >> yals->lenshift;
     if (yals_incsatcnt (yals, cidx, lit, len)) continue;
     yals_dequeue (yals, cidx);
     LOGCIDX (cidx, "made");
@@ -1503,8 +1538,8 @@ static void yals_break_clauses_after_flipping_lit (Yals * yals, int lit) {
 #endif
   occs = yals_occs (yals, -lit);
   for (p = occs; (occ = *p) >= 0; p++) {
-    len = occ & LENMASK;
-    cidx = occ >> LENSHIFT;
+    len = occ & yals->lenmask;
+    cidx = occ >> yals->lenshift;
     if (yals_decsatcnt (yals, cidx, -lit, len)) continue;
     yals_enqueue (yals, cidx);
     LOGCIDX (cidx, "broken");
@@ -1531,9 +1566,7 @@ static void yals_update_minimum (Yals * yals) {
   yals_check_global_invariant (yals);
 }
 
-static void yals_flip (Yals * yals) {
-  int cidx = yals_pick_clause (yals);
-  int lit = yals_pick_literal (yals, cidx);
+static void yals_flip_lit (Yals * yals, int lit) {
   yals->stats.flips++;
   yals->stats.unsum += yals_nunsat (yals);
   yals_flip_value_of_lit (yals, lit);
@@ -1542,6 +1575,24 @@ static void yals_flip (Yals * yals) {
   yals_update_minimum (yals);
 }
 
+static void yals_flip (Yals * yals) {
+  int cidx = yals_pick_clause (yals);
+  int lit = yals_pick_literal (yals, cidx);
+  yals_flip_lit (yals, lit);
+}
+
+/* Force the values of the variables fixed since the last call.  */
+
+static void yals_flip_fixes (Yals * yals) {
+  const int * p;
+  for (p = yals->fixes.start; p < yals->fixes.top; p++)
+    if (!yals_val (yals, *p)) yals_flip_lit (yals, *p);
+  yals_msg (yals, 2,
+    "forced %d new fixed variables (%d in total)",
+    (int) COUNT (yals->fixes), yals->nfixed);
+  CLEAR (yals->fixes);
+}
+
 /*------------------------------------------------------------------------*/
 
 static void yals_preprocess (Yals * yals) {
@@ -1949,7 +2000,7 @@ static void yals_update_sat_and_unsat (Yals * yals) {
   unsigned satcnt;
   yals_log_assignment (yals);
   yals_reset_unsat (yals);
-  for (len = 1; len <= MAXLEN; len++)
+  for (len = 1; len <= yals->lenmask; len++)
     yals->weights[len] = yals_len_to_weight (yals, len);
   if (yals->crit)
     memset (yals->weightedbreak, 0, 2*yals->nvars*sizeof(int));
@@ -1964,7 +2015,7 @@ static void yals_update_sat_and_unsat (Yals * yals) {
     }
     if (yals->crit) yals->crit[cidx] = crit;
     len = p - lits;
-    cappedlen = MIN (len, MAXLEN);
+    cappedlen = MIN (len, yals->lenmask);
     LOGCIDX (cidx,
        "sat count %u length %d weight %u for",
        satcnt, len, yals->weights[cappedlen]);
@@ -2034,10 +2085,14 @@ static void yals_init_weight_to_score_table (Yals * yals) {
 
 /*------------------------------------------------------------------------*/
 
-static void yals_connect (Yals * yals) {
+/* Connect the clauses: literal offsets, occurrence lists and references.
+ * These are never modified afterwards and may thus be shared read-only by
+ * other instances (see 'yals_share').
+ */
+static void yals_connect_clauses (Yals * yals) {
   int idx, n, lit, nvars = yals->nvars, * count, cidx, sign;
-  long long sumoccs, sumlen; int minoccs, maxoccs, minlen, maxlen;
-  int * occsptr, occs, len, lits, maxidx, nused, uniform;
+  long long sumoccs, sumlen, occs; int minoccs, maxoccs, minlen, maxlen;
+  int * occsptr, occ, len, lits, maxidx, nused;
   int nclauses, nbin, ntrn, nquad, nlarge;
   const int * p,  * q;
 
@@ -2045,6 +2100,10 @@ static void yals_connect (Yals * yals) {
   RELEASE (yals->mark);
   RELEASE (yals->clause);
 
+  if (COUNT (yals->cdb) > INT_MAX)
+    yals_abort (yals,
+      "maximum number of literals %d exceeded", INT_MAX);
+
   maxlen = 0;
   sumlen = 0;
   minlen = INT_MAX;
@@ -2078,16 +2137,20 @@ static void yals_connect (Yals * yals) {
 
   yals->maxlen = maxlen;
   yals->minlen = minlen;
-#ifndef NYALSTATS
-  yals->stats.nincdec = MAX (maxlen + 1, 3);
-  NEWN (yals->stats.inc, yals->stats.nincdec);
-  NEWN (yals->stats.dec, yals->stats.nincdec);
-#endif
 
-  if ((INT_MAX >> LENSHIFT) < nclauses)
+  yals->lenshift = LENSHIFT;
+  while (yals->lenshift > MINLENSHIFT &&
+         (INT_MAX >> yals->lenshift) < nclauses)
+    yals->lenshift--;
+  if ((INT_MAX >> yals->lenshift) < nclauses)
     yals_abort (yals,
       "maximum number of clauses %d exceeded",
-      (INT_MAX >> LENSHIFT));
+      (INT_MAX >> yals->lenshift));
+  yals->lenmask = (1 << yals->lenshift) - 1;
+  if (yals->lenshift < LENSHIFT)
+    yals_msg (yals, 1,
+      "packing occurrences with %d length bits (lengths capped to %d)",
+      yals->lenshift, yals->lenmask);
 
   yals->nclauses = nclauses;
   yals->nbin = nbin;
@@ -2103,8 +2166,6 @@ static void yals_connect (Yals * yals) {
   }
   assert (lits == COUNT (yals->cdb));
 
-  NEWN (yals->weights, MAXLEN + 1);
-
   NEWN (count, 2*nvars);
   count += nvars;
 
@@ -2128,6 +2189,10 @@ static void yals_connect (Yals * yals) {
     if (sum) nused++;
   }
 
+  if (occs > INT_MAX)
+    yals_abort (yals,
+      "maximum number of occurrences %d exceeded", INT_MAX);
+
   assert (nused <= nvars);
   if (nused == nvars)
     yals_msg (yals, 1, "all variables occur");
@@ -2137,55 +2202,30 @@ static void yals_connect (Yals * yals) {
       nused, nvars, nvars - nused, yals_pct (nvars-nused, nvars));
 
   yals->noccs = occs;
-  LOG ("size of occurrences stack %d", occs);
+  LOG ("size of occurrences stack %d", yals->noccs);
   NEWN (yals->occs, yals->noccs);
 
   NEWN (yals->refs, 2*nvars);
 
-  occs = 0;
+  occ = 0;
   for (lit = 1; lit < nvars; lit++) {
     n = count[lit];
     LOG ("literal %d occurs %d times", lit, n);
-    *yals_refs (yals, lit) = occs;
-    occs += n, yals->occs[occs++] = -1;
+    *yals_refs (yals, lit) = occ;
+    occ += n, yals->occs[occ++] = -1;
     n = count[-lit];
     LOG ("literal %d occurs %d times", -lit, n);
-    *yals_refs (yals, -lit) = occs;
-    occs += n, yals->occs[occs++] = -1;
+    *yals_refs (yals, -lit) = occ;
+    occ += n, yals->occs[occ++] = -1;
   }
-  assert (occs == yals->noccs);
+  assert (occ == yals->noccs);
 
   yals->avglen = yals_avg (sumlen, yals->nclauses);
 
-  if (minlen == maxlen) {
-    yals_msg (yals, 1,
-      "all %d clauses are of uniform length %d",
-      yals->nclauses, maxlen);
-  } else if (maxlen >= 0) {
-    yals_msg (yals, 1,
-      "average clause length %.2f (min %d, max %d)",
-      yals->avglen, minlen, maxlen);
-    yals_msg (yals, 2,
-      "%d binary %.0f%%, %d ternary %.0f%% ",
-      nbin, yals_pct (nbin, yals->nclauses),
-      ntrn, yals_pct (ntrn, yals->nclauses));
-    yals_msg (yals, 2,
-      "%d quaterny %.0f%%, %d large clauses %.0f%%",
-      nquad, yals_pct (nquad, yals->nclauses),
-      nlarge, yals_pct (nlarge, yals->nclauses));
-  }
-
-  if (minlen == maxlen) uniform = !yals->opts.toggleuniform.val;
-  else uniform = yals->opts.toggleuniform.val;
-
-  if (uniform) {
-    yals_msg (yals, 1,
-      "using uniform strategy for clauses of length %d", maxlen);
-    yals->uniform = maxlen;
-  } else {
-    yals_msg (yals, 1, "using standard non-uniform strategy");
-    yals->uniform = 0;
-  }
+  yals_msg (yals, 2,
+    "%d quaterny %.0f%%, %d large clauses %.0f%%",
+    nquad, yals_pct (nquad, yals->nclauses),
+    nlarge, yals_pct (nlarge, yals->nclauses));
 
   yals_msg (yals, 1,
     "clause variable ratio %.3f = %d / %d",
@@ -2204,14 +2244,14 @@ static void yals_connect (Yals * yals) {
   for (cidx = 0; cidx < yals->nclauses; cidx++) {
     p = yals_lits (yals, cidx);
     len = 0;
-    while (len < MAXLEN && p[len]) len++;
+    while (len < yals->lenmask && p[len]) len++;
     while ((lit = *p++)) {
       occsptr = yals_refs (yals, lit);
-      occs = *occsptr;
-      assert_valid_occs (occs);
-      assert (!yals->occs[occs]);
-      yals->occs[occs] = (cidx << LENSHIFT) | len;
-      *occsptr = occs + 1;
+      occ = *occsptr;
+      assert_valid_occs (occ);
+      assert (!yals->occs[occ]);
+      yals->occs[occ] = (cidx << yals->lenshift) | len;
+      *occsptr = occ + 1;
     }
   }
 
@@ -2219,12 +2259,12 @@ static void yals_connect (Yals * yals) {
     for (sign = 1; sign >= -1; sign -= 2) {
       lit = sign * idx;
       occsptr = yals_refs (yals, lit);
-      occs = *occsptr;
-      assert_valid_occs (occs);
-      assert (yals->occs[occs] == -1);
+      occ = *occsptr;
+      assert_valid_occs (occ);
+      assert (yals->occs[occ] == -1);
       n = count[lit];
-      assert (occs >= n);
-      *occsptr = occs - n;
+      assert (occ >= n);
+      *occsptr = occ - n;
     }
   }
 
@@ -2235,6 +2275,58 @@ static void yals_connect (Yals * yals) {
     "average literal occurrence %.2f (min %d, max %d)",
     yals_avg (sumoccs, yals->nvars)/2.0, minoccs, maxoccs);
 
+  /* The units of the (preprocessed) formula, needed by 'yals_share'.  */
+  RESERVE (yals->units, COUNT (yals->trail));
+  for (p = yals->trail.start; p < yals->trail.top; p++)
+    PUSH (yals->units, *p);
+
+  yals->connected = 1;
+}
+
+/* Connect the search state of this instance to the connected clauses.  */
+
+static void yals_connect (Yals * yals) {
+  int idx, lit, nvars = yals->nvars, cidx, uniform;
+  int nclauses = yals->nclauses, minlen, maxlen;
+
+  if (!yals->connected) yals_connect_clauses (yals);
+
+  minlen = yals->minlen;
+  maxlen = yals->maxlen;
+#ifndef NYALSTATS
+  yals->stats.nincdec = MAX (maxlen + 1, 3);
+  NEWN (yals->stats.inc, yals->stats.nincdec);
+  NEWN (yals->stats.dec, yals->stats.nincdec);
+#endif
+
+  NEWN (yals->weights, MAXLEN + 1);
+
+  if (minlen == maxlen) {
+    yals_msg (yals, 1,
+      "all %d clauses are of uniform length %d",
+      yals->nclauses, maxlen);
+  } else if (maxlen >= 0) {
+    yals_msg (yals, 1,
+      "average clause length %.2f (min %d, max %d)",
+      yals->avglen, minlen, maxlen);
+    yals_msg (yals, 2,
+      "%d binary %.0f%%, %d ternary %.0f%% ",
+      yals->nbin, yals_pct (yals->nbin, yals->nclauses),
+      yals->ntrn, yals_pct (yals->ntrn, yals->nclauses));
+  }
+
+  if (minlen == maxlen) uniform = !yals->opts.toggleuniform.val;
+  else uniform = yals->opts.toggleuniform.val;
+
+  if (uniform) {
+    yals_msg (yals, 1,
+      "using uniform strategy for clauses of length %d", maxlen);
+    yals->uniform = maxlen;
+  } else {
+    yals_msg (yals, 1, "using standard non-uniform strategy");
+    yals->uniform = 0;
+  }
+
   if (yals->uniform) yals->pick = yals->opts.unipick.val;
   else yals->pick = yals->opts.pick.val;
 
@@ -2524,7 +2616,7 @@ static void yals_reset_cache (Yals * yals) {
 void yals_del (Yals * yals) {
   yals_reset_cache (yals);
   yals_reset_unsat (yals);
-  RELEASE (yals->cdb);
+  if (!yals->primary) RELEASE (yals->cdb);
   RELEASE (yals->clause);
   RELEASE (yals->mark);
   RELEASE (yals->mins);
@@ -2533,13 +2625,15 @@ void yals_del (Yals * yals) {
   RELEASE (yals->scores);
   RELEASE (yals->cands);
   RELEASE (yals->trail);
+  RELEASE (yals->units);
+  RELEASE (yals->fixes);
   RELEASE (yals->phases);
   RELEASE (yals->exp.table.two);
   RELEASE (yals->exp.table.cb);
   RELEASE (yals->minlits);
   if (yals->unsat.usequeue) DELN (yals->lnk, yals->nclauses);
   else DELN (yals->pos, yals->nclauses);
-  DELN (yals->lits, yals->nclauses);
+  if (!yals->primary) DELN (yals->lits, yals->nclauses);
   if (yals->crit) DELN (yals->crit, yals->nclauses);
   if (yals->weightedbreak) DELN (yals->weightedbreak, 2*yals->nvars);
   if (yals->satcntbytes == 1) DELN (yals->satcnt1, yals->nclauses);
@@ -2551,8 +2645,10 @@ void yals_del (Yals * yals) {
   DELN (yals->tmp, yals->nvarwords);
   DELN (yals->clear, yals->nvarwords);
   DELN (yals->set, yals->nvarwords);
-  DELN (yals->occs, yals->noccs);
-  if (yals->refs) DELN (yals->refs, 2*yals->nvars);
+  if (!yals->primary) {
+    DELN (yals->occs, yals->noccs);
+    if (yals->refs) DELN (yals->refs, 2*yals->nvars);
+  }
   if (yals->flips) DELN (yals->flips, yals->nvars);
 #ifndef NYALSTATS
   DELN (yals->stats.inc, yals->stats.nincdec);
@@ -2580,6 +2676,24 @@ void yals_setphase (Yals * yals, int lit) {
   PUSH (yals->phases, lit);
 }
 
+/*Added for Painless*/
+void yals_clearphases (Yals * yals) {
+  CLEAR (yals->phases);
+}
+
+void yals_fix (Yals * yals, int lit) {
+  int idx = ABS (lit);
+  if (!lit) yals_abort (yals, "zero literal argument to 'yals_fix'");
+  if (!yals->set || idx >= yals->nvars) return;
+  if (yals_fixed (yals, lit)) return;
+  LOG ("fixing %d", lit);
+  if (lit > 0) SETBIT (yals->set, yals->nvarwords, idx);
+  else CLRBIT (yals->clear, yals->nvarwords, idx);
+  yals->nfixed++;
+  PUSH (yals->fixes, lit);
+}
+/*-------------------*/
+
 void yals_setflipslimit (Yals * yals, long long flips) {
   yals->limits.flips = flips;
   yals_msg (yals, 1, "new flips limit %lld", (long long) flips);
@@ -2668,6 +2782,82 @@ void yals_add (Yals * yals, int lit) {
   }
 }
 
+/*Added for Painless*/
+void yals_add_clauses (Yals * yals, const int * lits, int nclauses, int maxvar) {
+  const int * p, * end;
+  int i;
+  if (!EMPTY (yals->clause))
+    yals_abort (yals, "added clause incomplete in 'yals_add_clauses'");
+  if (yals->connected)
+    yals_abort (yals, "can not add clauses after 'yals_prepare'");
+  for (end = lits, i = 0; i < nclauses; end++)
+    if (!*end) i++;
+  /* Sized once, instead of doubling the stacks while adding.  */
+  RESERVE (yals->cdb, end - lits);
+  if (maxvar >= COUNT (yals->mark)) {
+    RESERVE (yals->mark, maxvar + 1 - COUNT (yals->mark));
+    while (maxvar >= COUNT (yals->mark)) PUSH (yals->mark, 0);
+  }
+  for (p = lits; p < end; p++) yals_add (yals, *p);
+}
+
+int yals_prepare (Yals * yals) {
+  if (yals->primary) return yals->mt ? 20 : 0;
+  if (yals->connected) return 0;
+
+  if (!EMPTY (yals->clause))
+    yals_abort (yals, "added clause incomplete in 'yals_sat'");
+
+  if (yals->mt) {
+    yals_msg (yals, 1, "original formula contains empty clause");
+    return 20;
+  }
+
+  if (yals->opts.prep.val && !EMPTY (yals->trail)) {
+    yals_preprocess (yals);
+    if (yals->mt) {
+      yals_msg (yals, 1,
+	"formula after unit propagation contains empty clause");
+      return 20;
+    }
+  }
+
+  yals_connect_clauses (yals);
+  return 0;
+}
+
+void yals_share (Yals * yals, Yals * primary) {
+  const int * p;
+  if (!primary->connected && !primary->mt)
+    yals_abort (yals, "shared instance not prepared in 'yals_share'");
+  if (yals->connected || !EMPTY (yals->cdb) || !EMPTY (yals->clause))
+    yals_abort (yals, "clauses already added before 'yals_share'");
+  RELEASE (yals->mark);
+  RELEASE (yals->clause);
+  yals->primary = primary;
+  yals->mt = primary->mt;
+  yals->nvars = primary->nvars;
+  yals->cdb = primary->cdb;
+  yals->lits = primary->lits;
+  yals->occs = primary->occs;
+  yals->noccs = primary->noccs;
+  yals->refs = primary->refs;
+  yals->nclauses = primary->nclauses;
+  yals->nbin = primary->nbin;
+  yals->ntrn = primary->ntrn;
+  yals->minlen = primary->minlen;
+  yals->maxlen = primary->maxlen;
+  yals->avglen = primary->avglen;
+  yals->lenshift = primary->lenshift;
+  yals->lenmask = primary->lenmask;
+  RESERVE (yals->trail, COUNT (primary->units));
+  for (p = primary->units.start; p < primary->units.top; p++)
+    PUSH (yals->trail, *p);
+  yals->connected = primary->connected;
+  yals_msg (yals, 1, "sharing %d connected clauses", yals->nclauses);
+}
+/*-------------------*/
+
 /*------------------------------------------------------------------------*/
 
 #define ISDEFSTRAT(NAME,ENABLED) \
@@ -2904,6 +3094,10 @@ static int yals_done (Yals * yals) {
       return -1;
     }
   }
+  if (!EMPTY (yals->fixes)) {
+    yals_flip_fixes (yals);
+    if (yals_nunsat (yals) <= yals->opts.target.val) return 1;
+  }
   if (yals->opts.hitlim.val >= 0 &&
       yals->stats.hits  >= yals->opts.hitlim.val) {
     yals_msg (yals, 1,
@@ -3021,22 +3215,7 @@ DONE:
 int yals_sat (Yals * yals) {
   int res, limited = 0, lkhd;
 
-  if (!EMPTY (yals->clause))
-    yals_abort (yals, "added clause incomplete in 'yals_sat'");
-
-  if (yals->mt) {
-    yals_msg (yals, 1, "original formula contains empty clause");
-    return 20;
-  }
-
-  if (yals->opts.prep.val && !EMPTY (yals->trail)) {
-    yals_preprocess (yals);
-    if (yals->mt) {
-      yals_msg (yals, 1,
-	"formula after unit propagation contains empty clause");
-      return 20;
-    }
-  }
+  if ((res = yals_prepare (yals))) return res;
 
   yals->stats.time.entered = yals_time (yals);
 
@@ -53,6 +53,14 @@ yals_showopts(Yals*);
 /*Added for Painless*/
 int
 yals_getnvars(Yals*);
+/* Drop the phases set since the last outer restart */
+void
+yals_clearphases(Yals*);
+/* Fix a literal for the rest of the search, must be called between two
+ * flips (from the termination callback), the value is forced at the next
+ * termination check */
+void
+yals_fix(Yals*, int lit);
 /*------------------*/
 
 /*------------------------------------------------------------------------*/
@@ -60,6 +68,19 @@ yals_getnvars(Yals*);
 void
 yals_add(Yals*, int lit);
 
+/*Added for Painless*/
+/* Add 'nclauses' zero terminated clauses over variables up to 'maxvar' */
+void
+yals_add_clauses(Yals*, const int* lits, int nclauses, int maxvar);
+/* Preprocess and connect the clauses, returns 20 if they are unsatisfiable */
+int
+yals_prepare(Yals*);
+/* Search on the clauses of a prepared instance without copying them, it
+ * must be deleted after this one and no clause can be added to this one */
+void
+yals_share(Yals*, Yals* primary);
+/*------------------*/
+
 int
 yals_sat(Yals*);
 
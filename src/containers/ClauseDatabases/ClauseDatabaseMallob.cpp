@@ -305,6 +305,7 @@ ClauseDatabaseMallob::shrinkDatabase()
 void
 ClauseDatabaseMallob::clearDatabase()
 {
+	std::unique_lock<std::shared_mutex> lock(m_shrinkMutex);
 	for (auto& bucket : m_clauses) {
 		bucket->clear();
 	}
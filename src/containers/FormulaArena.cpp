@@ -0,0 +1,98 @@
+#include "containers/FormulaArena.hpp"
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+FormulaArena::FormulaArena(size_t size, unsigned int clsCount, unsigned int varCount)
+	: m_size(size)
+	, m_clsCount(clsCount)
+	, m_varCount(varCount)
+{
+	size_t pageSize = sysconf(_SC_PAGESIZE);
+	m_mappedBytes = ((std::max<size_t>(size, 1) * sizeof(lit_t) + pageSize - 1) / pageSize) * pageSize;
+
+	void* mapping = mmap(nullptr, m_mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED) {
+		LOGERROR("FormulaArena: cannot map %zu bytes", m_mappedBytes);
+		throw std::bad_alloc();
+	}
+	m_literals = static_cast<lit_t*>(mapping);
+}
+
+FormulaArena::~FormulaArena()
+{
+	munmap(m_literals, m_mappedBytes);
+}
+
+void
+FormulaArena::seal()
+{
+	if (mprotect(m_literals, m_mappedBytes, PROT_READ) != 0)
+		LOGWARN("FormulaArena: mprotect failed, the arena stays writable");
+
+	LOG1("FormulaArena: %u clauses, %zu literals, %u variables in %zu KB",
+		 m_clsCount,
+		 getLiteralsCount(),
+		 m_varCount,
+		 m_mappedBytes / 1024);
+}
+
+std::shared_ptr<const FormulaArena>
+FormulaArena::create(std::vector<lit_t>&& literals, unsigned int clsCount, unsigned int varCount)
+{
+	std::shared_ptr<FormulaArena> arena(new FormulaArena(literals.size(), clsCount, varCount));
+
+	std::memcpy(arena->m_literals, literals.data(), literals.size() * sizeof(lit_t));
+	std::vector<lit_t>().swap(literals);
+
+	arena->seal();
+	return arena;
+}
+
+std::shared_ptr<const FormulaArena>
+FormulaArena::create(const lit_t* literals, size_t size, unsigned int clsCount, unsigned int varCount)
+{
+	std::shared_ptr<FormulaArena> arena(new FormulaArena(size, clsCount, varCount));
+
+	std::memcpy(arena->m_literals, literals, size * sizeof(lit_t));
+
+	arena->seal();
+	return arena;
+}
+
+std::shared_ptr<const FormulaArena>
+FormulaArena::create(const std::vector<simpleClause>& clauses, unsigned int varCount)
+{
+	size_t size = clauses.size();
+	for (const auto& clause : clauses)
+		size += clause.size();
+
+	std::shared_ptr<FormulaArena> arena(new FormulaArena(size, clauses.size(), varCount));
+
+	lit_t* cursor = arena->m_literals;
+	for (const auto& clause : clauses) {
+		cursor = std::copy(clause.begin(), clause.end(), cursor);
+		*cursor++ = 0;
+	}
+
+	arena->seal();
+	return arena;
+}
+
+void
+FormulaArena::toClauses(std::vector<simpleClause>& clauses) const
+{
+	clauses.reserve(clauses.size() + m_clsCount);
+
+	const lit_t* begin = m_literals;
+	const lit_t* end = m_literals + m_size;
+	while (begin < end) {
+		const lit_t* zero = std::find(begin, end, 0);
+		clauses.emplace_back(begin, zero);
+		begin = zero + 1;
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "containers/SimpleTypes.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @class FormulaArena
+ * @brief Immutable flat storage of a formula, shared by all the solvers of a process.
+ *
+ * The clauses are stored contiguously, each one terminated by a 0, in a page-aligned anonymous mapping that is made
+ * read-only once filled. The solvers load it through SolverInterface::addInitialFormula or addInitialClauses(const
+ * lit_t*, ...) without any intermediate per-clause container, so that the formula exists once in the process whatever
+ * the number of solvers.
+ *
+ * @ingroup pl_containers
+ */
+class FormulaArena
+{
+  public:
+	/**
+	 * @brief Create an arena from zero terminated clauses.
+	 * @param literals The clauses with 0 as a separator, released once copied.
+	 * @param clsCount The number of clauses in literals.
+	 * @param varCount The number of variables.
+	 * @throw std::bad_alloc If the mapping fails.
+	 */
+	static std::shared_ptr<const FormulaArena> create(std::vector<lit_t>&& literals,
+													  unsigned int clsCount,
+													  unsigned int varCount);
+
+	/**
+	 * @brief Create an arena from a buffer of zero terminated clauses, such as a mapped file.
+	 * @param literals The clauses with 0 as a separator.
+	 * @param size The number of literals in the buffer, terminating zeros included.
+	 * @param clsCount The number of clauses in literals.
+	 * @param varCount The number of variables.
+	 * @throw std::bad_alloc If the mapping fails.
+	 */
+	static std::shared_ptr<const FormulaArena> create(const lit_t* literals,
+													  size_t size,
+													  unsigned int clsCount,
+													  unsigned int varCount);
+
+	/**
+	 * @brief Create an arena from a vector of clauses.
+	 * @param clauses The clauses, left untouched.
+	 * @param varCount The number of variables.
+	 * @throw std::bad_alloc If the mapping fails.
+	 */
+	static std::shared_ptr<const FormulaArena> create(const std::vector<simpleClause>& clauses, unsigned int varCount);
+
+	~FormulaArena();
+
+	FormulaArena(const FormulaArena&) = delete;
+	FormulaArena& operator=(const FormulaArena&) = delete;
+
+	/// Zero terminated clauses, never null even for an empty formula.
+	const lit_t* data() const { return m_literals; }
+
+	unsigned int getClausesCount() const { return m_clsCount; }
+
+	unsigned int getVariablesCount() const { return m_varCount; }
+
+	/// Number of literals, terminating zeros excluded.
+	size_t getLiteralsCount() const { return m_size - m_clsCount; }
+
+	/// Size in bytes of the mapping.
+	size_t getMappedBytes() const { return m_mappedBytes; }
+
+	/**
+	 * @brief Copy the clauses into a vector, for the components that still need one.
+	 * @param clauses Vector to which the clauses are appended.
+	 */
+	void toClauses(std::vector<simpleClause>& clauses) const;
+
+  private:
+	/// Map a writable region for size literals (size >= 1)
+	FormulaArena(size_t size, unsigned int clsCount, unsigned int varCount);
+
+	/// Make the mapping read-only, called once filled
+	void seal();
+
+	lit_t* m_literals;
+
+	/// Number of literals, terminating zeros included
+	size_t m_size;
+
+	size_t m_mappedBytes;
+
+	unsigned int m_clsCount;
+
+	unsigned int m_varCount;
+};
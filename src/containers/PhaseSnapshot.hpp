@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Lock-free double-buffered snapshot of a full assignment, written by a single thread and read by any.
+ *
+ * The writer fills the buffer that is not the last published one, then publishes it. Each buffer is guarded by a
+ * sequence counter, odd while it is written: a reader copying a buffer that the writer started to overwrite (two
+ * publications during the copy) detects it and gives up until the next read. Neither side ever waits for the other.
+ *
+ * The phases are bit-packed, variable v is bit v of the buffer. A publication carries a quality defined by the user of
+ * the snapshot (number of unsatisfied clauses, trail height, ...).
+ * @ingroup pl_containers
+ */
+class PhaseSnapshot
+{
+  public:
+	/// @param varCount Number of variables of the assignments
+	explicit PhaseSnapshot(unsigned int varCount)
+		: m_varCount(varCount)
+		, m_wordCount(varCount / 64 + 1)
+	{
+		for (Buffer& buffer : m_buffers)
+			buffer.words = std::make_unique<std::atomic<uint64_t>[]>(m_wordCount);
+	}
+
+	unsigned int getVariablesCount() const { return m_varCount; }
+
+	/// Number of publications, 0 if nothing was published yet
+	uint64_t getVersion() const { return m_version.load(std::memory_order_acquire); }
+
+	/**
+	 * @brief Publish a new assignment, must always be called by the same thread.
+	 * @param phaseOf Callable returning the phase (true for positive) of a variable in [1, varCount].
+	 * @param quality Quality of the assignment, read with it.
+	 */
+	template<typename PhaseOf>
+	void publish(PhaseOf&& phaseOf, unsigned int quality)
+	{
+		const uint64_t version = m_version.load(std::memory_order_relaxed) + 1;
+		Buffer& buffer = m_buffers[version & 1];
+
+		const uint64_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+		buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		uint64_t word = 0;
+		for (unsigned int var = 1; var <= m_varCount; var++) {
+			if (phaseOf(var))
+				word |= 1ULL << (var % 64);
+			if (var % 64 == 63 || var == m_varCount) {
+				buffer.words[var / 64].store(word, std::memory_order_relaxed);
+				word = 0;
+			}
+		}
+		buffer.quality.store(quality, std::memory_order_relaxed);
+		buffer.version.store(version, std::memory_order_relaxed);
+
+		buffer.sequence.store(sequence + 2, std::memory_order_release);
+		m_version.store(version, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Copy the last publication if it is newer than version.
+	 * @param phases Set to the phases, phases[var] for var in [1, varCount].
+	 * @param quality Set to the quality of the publication.
+	 * @param version Version already read by the caller, updated on success.
+	 * @return false if there is no newer publication or if it was overwritten during the copy.
+	 */
+	bool read(std::vector<char>& phases, unsigned int& quality, uint64_t& version) const
+	{
+		const uint64_t latest = getVersion();
+		if (latest == 0 || latest == version)
+			return false;
+
+		const Buffer& buffer = m_buffers[latest & 1];
+		const uint64_t sequence = buffer.sequence.load(std::memory_order_acquire);
+		if (sequence & 1)
+			return false;
+
+		phases.resize(m_varCount + 1);
+		for (unsigned int w = 0; w < m_wordCount; w++) {
+			const uint64_t word = buffer.words[w].load(std::memory_order_relaxed);
+			const unsigned int first = std::max(1U, w * 64);
+			const unsigned int last = std::min(m_varCount, w * 64 + 63);
+			for (unsigned int var = first; var <= last; var++)
+				phases[var] = (word >> (var % 64)) & 1;
+		}
+		const unsigned int readQuality = buffer.quality.load(std::memory_order_relaxed);
+		const uint64_t readVersion = buffer.version.load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (buffer.sequence.load(std::memory_order_relaxed) != sequence)
+			return false;
+
+		quality = readQuality;
+		version = readVersion;
+		return true;
+	}
+
+  private:
+	struct Buffer
+	{
+		/// Odd while the buffer is written
+		std::atomic<uint64_t> sequence{ 0 };
+		std::atomic<uint64_t> version{ 0 };
+		std::atomic<unsigned int> quality{ 0 };
+		std::unique_ptr<std::atomic<uint64_t>[]> words;
+	};
+
+	unsigned int m_varCount;
+	unsigned int m_wordCount;
+
+	Buffer m_buffers[2];
+
+	std::atomic<uint64_t> m_version{ 0 };
+};
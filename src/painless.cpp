@@ -89,7 +89,9 @@ main(int argc, char** argv)
 	if (dist) {
 		// MPI Initialization
 		int provided;
-		TESTRUNMPI(MPI_Init_thread(NULL, NULL, MPI_THREAD_SERIALIZED, &provided));
+		// The termination listener calls MPI concurrently with the sharers
+		int required = (__globalParameters__.endPollPeriod > 0) ? MPI_THREAD_MULTIPLE : MPI_THREAD_SERIALIZED;
+		TESTRUNMPI(MPI_Init_thread(NULL, NULL, required, &provided));
 		TESTRUNMPI(MPI_Comm_set_errhandler(MPI_COMM_WORLD, MPI_ERRORS_RETURN));
 
 		LOGDEBUG1("Thread strategy provided is %d", provided);
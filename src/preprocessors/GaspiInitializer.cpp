@@ -11,59 +11,140 @@ using namespace saga;
 void
 GeneticAlgorithm::initialize_population(std::mt19937 rng)
 {
-
-	// Create a uniform distribution for integers in [0, 1]
-	std::uniform_int_distribution<int> dist(0, 1);
-
 	for (std::size_t i = 0; i < population_size_; i++) {
 		// Create a new solution with random values in its vector
-		Solution sol(variable_count_, clause_count_);
-		assert(sol.getSolution().size() == variable_count_);
-		for (std::size_t j = 0; j < variable_count_; ++j) {
+		Solution sol(solution_size_, clause_count_);
+		sol.setRandomSolution(rng);
+		for (std::size_t j = 1; j <= variable_count_; ++j) {
 			if (isVariableFixed(j))
-				sol[j] = getFixedValue(j) > 0;
-			else
-				sol[j] = dist(rng); // generate a random bit using the distribution and the generator
+				sol.set(j, getFixedValue(j) > 0);
 		}
 		population_.push_back(sol); // Add the solution to the population
 	}
 }
 
+// Contiguous copy of the clauses and occurrence lists of the variables, in a compressed row layout
+void
+GeneticAlgorithm::build_occurrences()
+{
+	clause_start_.assign(1, 0);
+	clause_start_.reserve(clauses_.size() + 1);
+	literals_.clear();
+	occ_start_.assign(variable_count_ + 2, 0);
+	for (const auto& clause : clauses_) {
+		for (int lit : clause)
+			occ_start_[std::abs(lit) + 1]++;
+		literals_.insert(literals_.end(), clause.begin(), clause.end());
+		clause_start_.push_back(literals_.size());
+	}
+	for (std::size_t v = 1; v < occ_start_.size(); ++v)
+		occ_start_[v] += occ_start_[v - 1];
+
+	occurrences_.resize(literals_.size());
+	std::vector<unsigned> cursor(occ_start_.begin(), occ_start_.end() - 1);
+	for (unsigned c = 0; c < clauses_.size(); ++c)
+		for (int lit : clauses_[c])
+			occurrences_[cursor[std::abs(lit)]++] = c;
+}
+
 int
-GeneticAlgorithm::fitness_unsat(Solution& solution)
+GeneticAlgorithm::fitness_unsat_full(const Solution& solution)
 {
-	if (memo.contains(solution.getSolution())) {
-		// std::cout << "memo hit" << std::endl;
-		int fit = memo.get(solution.getSolution()).get_value_or(clause_count_);
-		return fit;
-	} else {
-		assert(clauses_.size() > 0);
+	assert(clauses_.size() > 0);
+
+	int fitness = 0;
+	const int* lits = literals_.data();
+	for (size_t c = 0; c + 1 < clause_start_.size(); ++c) {
+		bool satisfied = false;
+		for (size_t i = clause_start_[c]; i < clause_start_[c + 1] && !satisfied; ++i)
+			satisfied = solution[std::abs(lits[i])] == SIGN(lits[i]);
+		fitness += !satisfied;
+	}
+	return fitness;
+}
 
-		size_t fitness = 0;
-		// std::vector<unsigned> unsat_vars;
+int
+GeneticAlgorithm::fitness_unsat_delta(Solution& solution)
+{
+	// Per thread marks: flipped variables and clauses already visited at the current epoch
+	static thread_local std::vector<char> flipped;
+	static thread_local std::vector<unsigned> visited;
+	static thread_local unsigned epoch = 0;
+
+	if (flipped.size() < solution_size_)
+		flipped.resize(solution_size_, 0);
+	if (visited.size() < clauses_.size())
+		visited.resize(clauses_.size(), 0);
+	if (++epoch == 0) {
+		std::fill(visited.begin(), visited.end(), 0);
+		epoch = 1;
+	}
+
+	// A variable flipped an even number of times keeps its value
+	std::vector<unsigned>& delta = solution.getDelta();
+	for (unsigned var : delta)
+		flipped[var] ^= 1;
+
+	size_t kept = 0, touched = 0;
+	for (unsigned var : delta) {
+		if (flipped[var] == 1) {
+			flipped[var] = 2;
+			delta[kept++] = var;
+			touched += occ_start_[var + 1] - occ_start_[var];
+		}
+	}
+	delta.resize(kept);
+
+	int fitness = solution.getFitness();
 
-		for (const auto& clause : clauses_) {
-			bool satisfied = false;
-			for (int lit : clause) {
-				if (!satisfied && solution[std::abs(lit)] == SIGN(lit)) {
-					satisfied = true;
+	// Each touched clause is evaluated twice, a full evaluation reads every literal once
+	if (touched * 6 > literals_.size()) {
+		fitness = -1;
+	} else {
+		for (unsigned var : delta) {
+			for (unsigned o = occ_start_[var]; o < occ_start_[var + 1]; ++o) {
+				unsigned c = occurrences_[o];
+				if (visited[c] == epoch)
+					continue;
+				visited[c] = epoch;
+
+				bool satisfiedBefore = false, satisfiedNow = false;
+				for (size_t i = clause_start_[c]; i < clause_start_[c + 1]; ++i) {
+					unsigned v = std::abs(literals_[i]);
+					bool now = solution[v] == SIGN(literals_[i]);
+					satisfiedNow |= now;
+					satisfiedBefore |= now != (flipped[v] != 0);
 				}
-			}
-			if (!satisfied) {
-				fitness++;
-				// add all unsat variables to the solution
+				fitness += (int)satisfiedBefore - (int)satisfiedNow;
 			}
 		}
-
-		memo.insert(solution.getSolution(), fitness);
-		return fitness;
 	}
+
+	for (unsigned var : delta)
+		flipped[var] = 0;
+	return fitness;
+}
+
+// The fitness of a solution derived from an evaluated one is updated through the occurrence lists of the flipped
+// variables, other solutions are evaluated from scratch
+int
+GeneticAlgorithm::fitness_unsat(Solution& solution)
+{
+	int fitness = -1;
+	if (solution.hasDelta())
+		fitness = solution.getDelta().empty() ? solution.getFitness() : fitness_unsat_delta(solution);
+	if (fitness < 0)
+		fitness = fitness_unsat_full(solution);
+
+	solution.setEvaluated(fitness);
+	return fitness;
 }
 
 // Evaluate the fitness of each solution in the population
 void
 GeneticAlgorithm::evaluate_fitness()
 {
+#pragma omp parallel for schedule(dynamic)
 	for (std::size_t i = 0; i < population_size_; ++i) {
 		assert(population_[i].size() == variable_count_ + 1);
 		assert(i < population_.getPopulation().size());
@@ -82,9 +163,9 @@ GeneticAlgorithm::evaluate_fitness()
 void
 GeneticAlgorithm::evaluate_fitness(std::vector<Solution>& offspring)
 {
-	for (auto& sol : offspring) {
-		sol.setFitness(fitness_unsat(sol));
-	}
+#pragma omp parallel for schedule(dynamic)
+	for (std::size_t i = 0; i < offspring.size(); ++i)
+		fitness_unsat(offspring[i]);
 }
 
 // Select parents using tournament selection
@@ -106,9 +187,9 @@ GeneticAlgorithm::select_parents_tournament(std::mt19937 rng)
 
 		// Compare their fitness and select the fitter one as a parent
 		if (candidate1.getFitness() < candidate2.getFitness()) {
-			parents.push_back(std::move(candidate1));
+			parents.push_back(candidate1);
 		} else {
-			parents.push_back(std::move(candidate2));
+			parents.push_back(candidate2);
 		}
 	}
 
@@ -124,7 +205,7 @@ GeneticAlgorithm::select_parents_random(std::mt19937 rng)
 	std::uniform_int_distribution<int> dist(0, population_size_ - 1);
 	for (int i = 0; i < (population_size_ / 2); ++i) {
 		int index = dist(rng);
-		parents.push_back(std::move(population_[index]));
+		parents.push_back(population_[index]);
 	}
 	return parents;
 }
@@ -138,7 +219,7 @@ GeneticAlgorithm::mutate_degree_vars(Solution& solution, std::mt19937 rng)
 	for (auto& var : centrality_vars) {
 
 		if (dist(rng) < mutation_rate_ && !isVariableFixed(var)) {
-			solution[var] = 1 - solution[var];
+			solution.flip(var);
 		}
 	}
 }
@@ -160,24 +241,34 @@ GeneticAlgorithm::create_offspring(const std::vector<Solution>& parents, std::mt
 
 	for (std::size_t i = 0; i < parents.size() - 1; i += 2) {
 		// Select two parents from the vector using their index
-		Solution parent1 = parents[i];
-		Solution parent2 = parents[i + 1];
+		const Solution& parent1 = parents[i];
+		const Solution& parent2 = parents[i + 1];
 		// Solution parent1 = parents[dist3(rng)];
 		// Solution parent2 = parents[dist3(rng)];
 
-		Solution child1(parent1);
-		Solution child2(parent2);
-
 		// Perform crossover with a given probability
-		if (dist(rng) < crossover_rate_) {
-			// Select a random point to split the solution vector
-			int point = dist2(rng);
-			// std::cout << "point: " << point << std::endl;
-
+		bool crossover = dist(rng) < crossover_rate_;
+		// Select a random point to split the solution vector
+		int point = crossover ? dist2(rng) : 0;
+
+		// child1 takes [1, point] from parent2 and the rest from parent1. Each child is copied from the parent giving
+		// it the larger part, so that the delta to evaluate incrementally is the smaller part
+		bool swapped = point > (int)solution_size_ / 2;
+		Solution child1(swapped ? parent2 : parent1);
+		Solution child2(swapped ? parent1 : parent2);
+
+		if (swapped) {
+			for (int j = point + 1; j < solution_size_; ++j) {
+				if (!isVariableFixed(j)) {
+					child1.set(j, parent1[j]);
+					child2.set(j, parent2[j]);
+				}
+			}
+		} else {
 			for (int j = 1; j <= point; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 		}
@@ -186,8 +277,8 @@ GeneticAlgorithm::create_offspring(const std::vector<Solution>& parents, std::mt
 			// int unsat_var = var.first;
 			// assert(!isVariableFixed(var));
 			if (dist(rng) < mutation_rate_ && !isVariableFixed(var)) {
-				child1[var] = 1 - child1[var];
-				child2[var] = 1 - child1[var];
+				child1.flip(var);
+				child2.flip(var);
 			}
 		}
 
@@ -236,8 +327,8 @@ GeneticAlgorithm::create_offspring(std::mt19937 rng)
 
 			for (int j = 0; j <= point; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 		}
@@ -246,8 +337,8 @@ GeneticAlgorithm::create_offspring(std::mt19937 rng)
 			// int unsat_var = var.first;
 			// assert(!isVariableFixed(var));
 			if (dist(rng) < mutation_rate_ && !isVariableFixed(var)) {
-				child1[var] = 1 - child1[var];
-				child2[var] = 1 - child1[var];
+				child1.flip(var);
+				child2.flip(var);
 			}
 		}
 
@@ -289,14 +380,14 @@ GeneticAlgorithm::create_offspring_two_points(std::mt19937 rng)
 			}
 			for (int j = 0; j <= point1; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 			for (int j = point2; j < solution_size_; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 		}
@@ -305,8 +396,8 @@ GeneticAlgorithm::create_offspring_two_points(std::mt19937 rng)
 			// int unsat_var = var.first;
 			// assert(!isVariableFixed(var));
 			if (dist(rng) < mutation_rate_ && !isVariableFixed(var)) {
-				child1[var] = 1 - child1[var];
-				child2[var] = 1 - child1[var];
+				child1.flip(var);
+				child2.flip(var);
 			}
 		}
 
@@ -352,14 +443,14 @@ GeneticAlgorithm::create_offspring_two_points(const std::vector<Solution>& paren
 			}
 			for (int j = 0; j <= point1; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 			for (int j = point2; j < solution_size_; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 		}
@@ -368,8 +459,8 @@ GeneticAlgorithm::create_offspring_two_points(const std::vector<Solution>& paren
 			// int unsat_var = var.first;
 			// assert(!isVariableFixed(var));
 			if (dist(rng) < mutation_rate_ && !isVariableFixed(var)) {
-				child1[var] = 1 - child1[var];
-				child2[var] = 1 - child1[var];
+				child1.flip(var);
+				child2.flip(var);
 			}
 		}
 
@@ -426,14 +517,14 @@ GeneticAlgorithm::create_offspring_three_points(const std::vector<Solution>& par
 
 			for (int j = 0; j <= point1; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 			for (int j = point2; j <= point3; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 		}
@@ -442,8 +533,8 @@ GeneticAlgorithm::create_offspring_three_points(const std::vector<Solution>& par
 			// int unsat_var = var.first;
 			// assert(!isVariableFixed(var));
 			if (dist(rng) < mutation_rate_ && !isVariableFixed(var)) {
-				child1[var] = 1 - child1[var];
-				child2[var] = 1 - child1[var];
+				child1.flip(var);
+				child2.flip(var);
 			}
 		}
 
@@ -495,14 +586,14 @@ GeneticAlgorithm::create_offspring_three_points(std::mt19937 rng)
 
 			for (int j = 0; j <= point1; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 			for (int j = point2; j <= point3; ++j) {
 				if (!isVariableFixed(j)) {
-					child1[j] = parent2[j];
-					child2[j] = parent1[j];
+					child1.set(j, parent2[j]);
+					child2.set(j, parent1[j]);
 				}
 			}
 		}
@@ -511,8 +602,8 @@ GeneticAlgorithm::create_offspring_three_points(std::mt19937 rng)
 			// int unsat_var = var.first;
 			// assert(!isVariableFixed(var));
 			if (dist(rng) < mutation_rate_ && !isVariableFixed(var)) {
-				child1[var] = 1 - child1[var];
-				child2[var] = 1 - child1[var];
+				child1.flip(var);
+				child2.flip(var);
 			}
 		}
 
@@ -797,38 +888,29 @@ GeneticAlgorithm::fitness_with_diversity(Solution& solution, double alpha, doubl
 void
 GeneticAlgorithm::evaluate_fitness_with_diversity(double alpha, double beta)
 {
+	// Each thread only writes the fitness of its own solutions, the distances read the assignments
+#pragma omp parallel for schedule(dynamic)
 	for (size_t i = 0; i < population_.size(); ++i) {
-		assert(i < population_.size());
-		// std::cout << "  population[" << i << "] size = " << population_[i].size() << std::endl;
-		assert(population_[i].size() == variable_count_);
+		assert(population_[i].size() == solution_size_);
 		double combined_fitness = fitness_with_diversity(population_[i], alpha, beta);
 
 		// Set the fitness value
 		population_[i].setCombinedFitness(combined_fitness);
 	}
 
-	try {
-
-		std::vector<Solution> pop = population_.getPopulation();
-		std::sort(pop.begin(), pop.end(), [](const Solution& a, const Solution& b) {
-			return a.getCombinedFitness() > b.getCombinedFitness();
-		});
-		population_.setPopulation(pop);
-
-	} catch (const std::exception& e) {
-		std::cerr << "Exception during sort: " << e.what() << std::endl;
-	}
+	population_.sort_combined();
 }
 
 // Evaluate fitness with diversity for a set of offspring
 void
 GeneticAlgorithm::evaluate_fitness_with_diversity(std::vector<Solution>& offspring, double alpha, double beta)
 {
-	// Evaluate each offspring individually
-	for (auto& sol : offspring) {
-		double combined_fitness = fitness_with_diversity(sol, alpha, beta);
+	// Evaluate each offspring individually, the population is only read
+#pragma omp parallel for schedule(dynamic)
+	for (size_t i = 0; i < offspring.size(); ++i) {
+		double combined_fitness = fitness_with_diversity(offspring[i], alpha, beta);
 
 		// Set the fitness value
-		sol.setCombinedFitness(combined_fitness);
+		offspring[i].setCombinedFitness(combined_fitness);
 	}
 }
@@ -3,8 +3,8 @@
 
 #include "containers/SimpleTypes.hpp"
 #include <algorithm>
-#include <boost/compute/detail/lru_cache.hpp>
 #include <chrono>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <math.h>
@@ -184,39 +184,29 @@ namespace saga {
 // 	int fitness;
 // };
 
+/**
+ * @brief Candidate assignment of the genetic algorithm.
+ *
+ * The assignment is bit-packed, one bit per variable (index 0 is unused). The variables flipped since the last
+ * evaluation are recorded so that the fitness of an offspring can be updated from the one of its parent, see
+ * GeneticAlgorithm::fitness_unsat.
+ */
 class Solution
 {
   public:
-	Solution(const Solution& other)
-		: solution(other.solution)
-		, fitness(other.fitness)
-		, combined_fitness(other.combined_fitness)
-		, mutation_rate(other.mutation_rate)
-		, crossover_rate(other.crossover_rate) //, unsatisfying_variables(other.unsatisfying_variables)
-	{
-	}
-
-	// Solution(const Solution &other) = default;
-	// Solution(Solution &&other) noexcept = default;
+	Solution(const Solution& other) = default;
+	Solution& operator=(const Solution& other) = default;
 
-	Solution(std::vector<unsigned> solution_, int fitness_, float pm, float pc)
-		: solution(solution_)
-		, fitness(fitness_)
-		, mutation_rate(pm)
-		, crossover_rate(pc)
-		, combined_fitness(0.0) //, unsatisfying_variables()
-	{
-	}
 	Solution(size_t solution_size, int nclauses)
-		: solution(solution_size)
+		: bits((solution_size + 63) / 64, 0)
+		, nbits(solution_size)
 		, fitness(nclauses)
 		, combined_fitness(0.0)
 	{
-		solution.reserve(solution_size);
 	}
 
 	Solution()
-		: solution()
+		: nbits(0)
 		, fitness(UINT_MAX)
 		, combined_fitness(0.0)
 	{
@@ -224,48 +214,52 @@ class Solution
 
 	~Solution() {}
 
-	// Operators overloading
-	Solution& operator=(const Solution& other)
-	{
-		if (this != &other) {
-			solution = other.solution;
-			fitness = other.fitness;
-			mutation_rate = other.mutation_rate;
-			crossover_rate = other.crossover_rate;
-			combined_fitness = other.combined_fitness;
-		}
-
-		return *this;
-	}
-
 	bool operator==(const Solution& s) const
 	{
-		return solution == s.solution && fitness == s.fitness && mutation_rate == s.mutation_rate &&
-			   crossover_rate == s.crossover_rate &&
-			   std::abs(combined_fitness - s.combined_fitness) <
-				   1e-4; // && unsatisfying_variables == s.unsatisfying_variables;
+		return bits == s.bits && fitness == s.fitness && mutation_rate == s.mutation_rate &&
+			   crossover_rate == s.crossover_rate && std::abs(combined_fitness - s.combined_fitness) < 1e-4;
 	}
 
 	bool operator!=(const Solution& s) const { return !(*this == s); }
 
-	const unsigned& operator[](std::size_t i) const { return solution[i]; }
-	unsigned& operator[](std::size_t i) { return solution[i]; }
+	bool operator[](std::size_t i) const { return (bits[i >> 6] >> (i & 63)) & 1; }
+
+	/// Flip a variable, recording it in the delta if the solution was evaluated
+	void flip(std::size_t i)
+	{
+		bits[i >> 6] ^= 1ULL << (i & 63);
+		if (!evaluated || deltaOverflow)
+			return;
+		if (delta.size() >= nbits / 4) {
+			// Too many flips for an incremental evaluation to pay off
+			deltaOverflow = true;
+			std::vector<unsigned>().swap(delta);
+			return;
+		}
+		delta.push_back(i);
+	}
+
+	void set(std::size_t i, bool value)
+	{
+		if ((*this)[i] != value)
+			flip(i);
+	}
 
 	std::string toString() const
 	{
 		std::ostringstream oss;
 		for (int i = 0; i < size(); ++i)
-			oss << (solution[i] ? "" : "-") << i << " ";
+			oss << ((*this)[i] ? "" : "-") << i << " ";
 		oss << std::endl;
 		return oss.str();
 	}
 
 	void setRandomSolution(std::mt19937& rng)
 	{
-		std::uniform_int_distribution<int> dist(0, 1);
-		for (std::size_t i = 0; i < solution.size(); ++i) {
-			solution[i] = dist(rng);
-		}
+		for (auto& word : bits)
+			word = ((uint64_t)rng() << 32) | rng();
+		clearUnusedBits();
+		evaluated = false;
 	}
 
 	// Getters and setters
@@ -283,65 +277,72 @@ class Solution
 	double getCombinedFitness() const { return combined_fitness; }
 	void setCombinedFitness(double combined_fitness_) { combined_fitness = combined_fitness_; }
 
-	std::size_t size() const { return solution.size(); }
-	void resize(std::size_t size_) { solution.resize(size_); }
-	std::vector<unsigned> getSolution() const { return solution; }
-	void setSolution(std::vector<unsigned> solution_) { solution = solution_; }
+	std::size_t size() const { return nbits; }
+	const std::vector<uint64_t>& getWords() const { return bits; }
+
+	/// True if getFitness() is the number of clauses falsified by the assignment before the delta
+	bool isEvaluated() const { return evaluated; }
+
+	/// True if the delta holds every flip since the last evaluation
+	bool hasDelta() const { return evaluated && !deltaOverflow; }
+
+	/// Variables flipped since the last evaluation, a variable flipped twice appears twice
+	std::vector<unsigned>& getDelta() { return delta; }
+
+	/// Set the fitness of the current assignment and start a new delta
+	void setEvaluated(int fitness_)
+	{
+		fitness = fitness_;
+		evaluated = true;
+		deltaOverflow = false;
+		delta.clear();
+	}
 
 	double hamming_distance(const Solution& other) const
 	{
-		if (solution.size() != other.size()) {
+		if (size() != other.size()) {
 			throw std::invalid_argument("The two solutions must have the same size");
 		}
 		double distance = 0;
-		for (std::size_t i = 1; i < solution.size(); ++i) {
-			distance += solution[i] != other[i];
+		for (std::size_t i = 1; i < size(); ++i) {
+			distance += (*this)[i] != other[i];
 		}
-		return distance / solution.size();
+		return distance / size();
 	}
 
-	// optimized hamming distance
+	// optimized hamming distance, one popcount per 64 variables
 	double opt_hamming_distance(const Solution& other) const
 	{
-		if (solution.size() != other.size()) {
+		if (size() != other.size()) {
 			throw std::invalid_argument("The two solutions must have the same size");
 		}
 
-		double distance = 0;
+		size_t distance = 0;
+		for (size_t i = 0; i < bits.size(); ++i)
+			distance += __builtin_popcountll(bits[i] ^ other.bits[i]);
 
-		for (size_t i = 0; i < solution.size(); ++i) {
-			unsigned xor_result = solution[i] ^ other[i];
-
-// Count the number of set bits
-// Use compiler-specific intrinsics if available
-#if defined(__GNUC__) || defined(__clang__)
-			// printf("Using __builtin_popcount\n");
-			distance += __builtin_popcount(xor_result);
-#elif defined(_MSC_VER)
-			printf("Using __popcnt\n");
-			distance += __popcnt(xor_result);
-#else
-			// Generic implementation
-			printf("Using generic implementation\n");
-			while (xor_result) {
-				distance += xor_result & 1;
-				xor_result >>= 1;
-			}
-#endif
-		}
-
-		return distance / solution.size();
+		return (double)distance / size();
 	}
 
   private:
-	std::vector<unsigned> solution;
-	// std::vector<unsigned> unsatisfying_variables; // Vector that maps unsatisfying variables to the number of clauses
-	// they do not satisfy
+	void clearUnusedBits()
+	{
+		if (nbits & 63)
+			bits.back() &= (1ULL << (nbits & 63)) - 1;
+	}
+
+	std::vector<uint64_t> bits;
+	size_t nbits;
+
+	std::vector<unsigned> delta;
+	bool evaluated = false;
+	bool deltaOverflow = false;
+
 	int fitness;			 // Number of clauses that are not satisfied by the solution
 	double combined_fitness; // Combined fitness of the solution
 
-	float mutation_rate;
-	float crossover_rate;
+	float mutation_rate = 0;
+	float crossover_rate = 0;
 };
 
 // class Population
@@ -523,10 +524,11 @@ class GeneticAlgorithm
 		// , formula_(formula)
 		, clause_count_(clause_count)
 		, variable_count_(variable_count)
-		, fixed_variables_(variable_count, 0)
+		, fixed_variables_(variable_count + 1, 0)
 		, clauses_(clauses)
 	{
 		population_ = Population(population_size_);
+		build_occurrences();
 	}
 
 	~GeneticAlgorithm() {}
@@ -542,6 +544,10 @@ class GeneticAlgorithm
 			crossover_rate_ = other.crossover_rate_;
 			population_ = other.population_;
 			fixed_variables_ = other.fixed_variables_;
+			clause_start_ = other.clause_start_;
+			literals_ = other.literals_;
+			occ_start_ = other.occ_start_;
+			occurrences_ = other.occurrences_;
 			// formula_ = other.formula_;
 			// memo = other.memo;
 		}
@@ -629,11 +635,11 @@ class GeneticAlgorithm
 	}
 	Solution& getWorstSolution();
 
-	void fixVariable(unsigned int var, char val) { fixed_variables_[var - 1] = val; }
+	void fixVariable(unsigned int var, char val) { fixed_variables_[var] = val; }
 
 	bool isVariableFixed(unsigned int var) { return fixed_variables_[var] != 0; }
 
-	char getFixedValue(unsigned int var) { return fixed_variables_[var - 1]; }
+	char getFixedValue(unsigned int var) { return fixed_variables_[var]; }
 
 	Solution& getBestSolutionByFitness();
 	Solution& getBestSolutionByCombinedFitness();
@@ -642,9 +648,6 @@ class GeneticAlgorithm
 	Solution& getWorstSolutionByCombinedFitness();
 
   private:
-	boost::compute::detail::lru_cache<std::vector<unsigned>, int> memo{
-		500
-	}; // cache memory to store the results of previous calls to fitness_unsat
 	size_t population_size_;
 	size_t solution_size_;
 	int max_iterations_;
@@ -657,6 +660,14 @@ class GeneticAlgorithm
 
 	std::vector<char> fixed_variables_;
 	const std::vector<simpleClause>& clauses_;
+
+	/// Literals of clause c are literals_[clause_start_[c], clause_start_[c+1]), contiguous for the evaluations
+	std::vector<size_t> clause_start_;
+	std::vector<int> literals_;
+
+	/// Clauses of variable v are occurrences_[occ_start_[v], occ_start_[v+1])
+	std::vector<unsigned> occ_start_;
+	std::vector<unsigned> occurrences_;
 	std::vector<unsigned> centrality_vars;
 
 	size_t seed;
@@ -665,7 +676,14 @@ class GeneticAlgorithm
 	void evaluate_fitness(std::vector<Solution>& offspring);
 	void evaluate_fitness();
 	int fitness(Solution& solution);
+
+	// Flatten the clauses and build the occurrence lists
+	void build_occurrences();
 	int fitness_unsat(Solution& solution);
+	// Number of clauses falsified by the solution, computed from scratch
+	int fitness_unsat_full(const Solution& solution);
+	// Fitness updated from the delta of the solution, -1 if it touches too many clauses to pay off
+	int fitness_unsat_delta(Solution& solution);
 
 	Solution select_parent(std::mt19937 rng);
 	std::vector<Solution> create_offspring_two_points(std::mt19937 rng);
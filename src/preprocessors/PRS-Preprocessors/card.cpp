@@ -10,10 +10,10 @@ preprocess::search_almost_one()
 	occur = new std::vector<int>[nlit];
 	for (int i = 1; i <= clauses; i++) {
 		clause_delete[i] = 0;
-		if (clause[i].size() != 2)
+		if (formula[i].size() != 2)
 			continue;
-		int x = tolit(clause[i][0]);
-		int y = tolit(clause[i][1]);
+		int x = tolit(formula[i][0]);
+		int y = tolit(formula[i][1]);
 		ll id1 = mapv(x, y);
 		ll id2 = mapv(y, x);
 		C->insert(id1, i);
@@ -25,7 +25,7 @@ preprocess::search_almost_one()
 		seen[tolit(i)] = seen[tolit(-i)] = 0;
 	int t = 0;
 	std::vector<int> ino, nei;
-	for (int i = 0; i < vars * 2; i++) {
+	for (int i = 0; i < vars * 2 && !interrupted; i++) {
 		if (seen[i] || !occur[i].size())
 			continue;
 		seen[i] = 1;
@@ -110,6 +110,8 @@ preprocess::scc_almost_one()
 	int flag = 1;
 	do {
 		flag = 0;
+		if (interrupted)
+			return 0;
 		for (int i = 1; i <= vars; i++) {
 			if (!occurp[i].size() || !occurn[i].size())
 				continue;
@@ -257,16 +259,16 @@ preprocess::card_elimination()
 		if (clause_delete[i])
 			continue;
 		int b = 1;
-		for (int j = 0; j < clause[i].size(); j++)
-			if (clause[i][j] < 0)
+		for (int j = 0; j < formula[i].size(); j++)
+			if (formula[i][j] < 0)
 				b--;
 		// convert >= to <=
 		mat.emplace_back();
-		row_size.push_back(clause[i].size());
+		row_size.push_back(formula[i].size());
 		int id = mat.size() - 1;
 		mat[id].resize(vars + 1, 0);
-		for (int j = 0; j < clause[i].size(); j++) {
-			mat[id][abs(clause[i][j])] += -pnsign(clause[i][j]);
+		for (int j = 0; j < formula[i].size(); j++) {
+			mat[id][abs(formula[i][j])] += -pnsign(formula[i][j]);
 		}
 		mat[id][0] = -b;
 	}
@@ -294,6 +296,8 @@ preprocess::card_elimination()
 	std::vector<int> elim;
 	elim.resize(vars + 1, 0);
 	for (int turn = 1; turn <= vars; turn++) {
+		if (interrupted)
+			return 1;
 		int v = 0;
 		for (int i = 1; i <= vars; i++) {
 			if (elim[i])
@@ -373,4 +377,19 @@ preprocess::preprocess_card()
 		mat[i].clear();
 	mat.clear();
 	return res;
-}
\ No newline at end of file
+}
+int
+preprocess::analysis_card()
+{
+	int res = 0;
+	auto init = std::chrono::high_resolution_clock::now();
+
+	if (vars <= this->maxVarCard && clauses <= this->maxClauseCard && !preprocess_card())
+		res = 20;
+
+	auto card = std::chrono::high_resolution_clock::now();
+	LOG1("[PRS %d] Card Elimination took %.3lfs",
+		 this->getSolverId(),
+		 std::chrono::duration_cast<std::chrono::milliseconds>(card - init).count() / 1000.0);
+	return res;
+}
@@ -1,4 +1,5 @@
 #include "preprocess.hpp"
+#include <algorithm>
 #include <cassert>
 
 int
@@ -10,7 +11,7 @@ preprocess::find_fa(int x)
 int
 preprocess::rematch_eql(int x)
 {
-	if (clause[x].size() != 2 || clause[x - 1].size() != 2)
+	if (formula[x].size() != 2 || formula[x - 1].size() != 2)
 		return 0;
 	// if (abs(clause[x][0]) > abs(clause[x][1])) std::swap(clause[x][0], clause[x][1]);
 	// if (abs(clause[x - 1][0]) > abs(clause[x - 1][1])) std::swap(clause[x - 1][0], clause[x - 1][1]);
@@ -18,8 +19,8 @@ preprocess::rematch_eql(int x)
 	// if (clause[x][1] != -clause[x - 1][1]) return 0;
 	// assert(find(abs(clause[x][1])) == abs(clause[x][1]));
 	// f[find(abs(clause[x][1]))] = find(abs(clause[x][0]));
-	int a = clause[x][0], b = clause[x][1];
-	int c = clause[x - 1][0], d = clause[x - 1][1];
+	int a = formula[x][0], b = formula[x][1];
+	int c = formula[x - 1][0], d = formula[x - 1][1];
 	if (abs(a) > abs(b))
 		std::swap(a, b);
 	if (abs(c) > abs(d))
@@ -37,42 +38,42 @@ int
 preprocess::rematch_and(int x)
 {
 	++flag;
-	int l = clause[x].size();
+	int l = formula[x].size();
 	if (l != 3)
 		return 0;
 	for (int i = 0; i < l; i++) {
-		seen[abs(clause[x][i])] = flag;
-		psign[abs(clause[x][i])] = pnsign(clause[x][i]);
-		psum[abs(clause[x][i])] = 0;
+		seen[abs(formula[x][i])] = flag;
+		psign[abs(formula[x][i])] = pnsign(formula[x][i]);
+		psum[abs(formula[x][i])] = 0;
 	}
 	for (int i = x - l + 1; i < x; i++) {
-		int l1 = clause[i].size();
+		int l1 = formula[i].size();
 		if (l1 != 2)
 			return 0;
 		for (int j = 0; j < l1; j++) {
-			if (seen[abs(clause[i][j])] != flag)
+			if (seen[abs(formula[i][j])] != flag)
 				return 0;
-			if (psign[abs(clause[i][j])] != -pnsign(clause[i][j]))
+			if (psign[abs(formula[i][j])] != -pnsign(formula[i][j]))
 				return 0;
-			++psum[abs(clause[i][j])];
+			++psum[abs(formula[i][j])];
 		}
 	}
 	int t = 0, r = 0;
 	for (int i = 0; i < l; i++)
-		if (psum[abs(clause[x][i])] != 1)
+		if (psum[abs(formula[x][i])] != 1)
 			++t, r = i;
 	if (t != 1)
 		return 0;
-	if (psum[abs(clause[x][r])] != l - 1 || clause[x][r] < 0)
+	if (psum[abs(formula[x][r])] != l - 1 || formula[x][r] < 0)
 		return 0;
 
 	gate.emplace_back();
 	int id = gate.size() - 1;
 	gate[id].type = 0;
-	gate[id].out = abs(clause[x][r]);
+	gate[id].out = abs(formula[x][r]);
 	for (int i = 0; i < l; i++)
 		if (i != r)
-			gate[id].push_in(-clause[x][i]);
+			gate[id].push_in(-formula[x][i]);
 	return 1;
 }
 
@@ -80,36 +81,36 @@ int
 preprocess::rematch_xor(int x)
 {
 	for (int i = x - 3; i <= x; i++)
-		if (clause[i].size() != 3)
+		if (formula[i].size() != 3)
 			return 0;
 	++flag;
 	int xor_sign = true;
 	for (int i = 0; i < 3; i++) {
-		seen[abs(clause[x][i])] = flag;
-		psign[abs(clause[x][i])] = pnsign(clause[x][i]);
-		psum[abs(clause[x][i])] = 0;
-		if (clause[x][i] < 0)
+		seen[abs(formula[x][i])] = flag;
+		psign[abs(formula[x][i])] = pnsign(formula[x][i]);
+		psum[abs(formula[x][i])] = 0;
+		if (formula[x][i] < 0)
 			xor_sign = !xor_sign;
 	}
 	for (int i = x - 3; i < x; i++) {
 		int xor_sign_one = true;
 		for (int j = 0; j < 3; j++) {
-			if (seen[abs(clause[i][j])] != flag)
+			if (seen[abs(formula[i][j])] != flag)
 				return 0;
-			if (psign[abs(clause[i][j])] == pnsign(clause[i][j]))
-				++psum[abs(clause[i][j])];
-			if (clause[i][j] < 0)
+			if (psign[abs(formula[i][j])] == pnsign(formula[i][j]))
+				++psum[abs(formula[i][j])];
+			if (formula[i][j] < 0)
 				xor_sign_one = !xor_sign_one;
 		}
 		if (xor_sign != xor_sign_one)
 			return false;
 	}
-	if (psum[abs(clause[x][0])] != 1 || psum[abs(clause[x][1])] != 1 || psum[abs(clause[x][2])] != 1)
+	if (psum[abs(formula[x][0])] != 1 || psum[abs(formula[x][1])] != 1 || psum[abs(formula[x][2])] != 1)
 		return 0;
 	gate.emplace_back();
 	int id = gate.size() - 1;
 	gate[id].type = 1;
-	int a = abs(clause[x][0]), b = abs(clause[x][1]), c = abs(clause[x][2]);
+	int a = abs(formula[x][0]), b = abs(formula[x][1]), c = abs(formula[x][2]);
 	if (b > a)
 		std::swap(a, b);
 	if (c > a)
@@ -144,10 +145,10 @@ preprocess::cnf2aig()
 			if (i - last > 4)
 				return false;
 			last = i;
-		} else if (clause[i].size() == 1) {
+		} else if (formula[i].size() == 1) {
 			if (i - last > 1)
 				return false;
-			val.push_back(clause[i][0]), last = i;
+			val.push_back(formula[i][0]), last = i;
 		}
 		if (i - last >= 4)
 			return false;
@@ -218,7 +219,7 @@ preprocess::epcec_preprocess()
 {
 	used = new int[maxvar + 1];
 	model = new int[maxvar + 1];
-	topo_counter = new int[maxvar + 1];
+	topo_counter = new int[gate.size()];
 	for (int i = 1; i <= maxvar; i++)
 		used[i] = 0;
 
@@ -230,17 +231,9 @@ preprocess::epcec_preprocess()
 		if (!fixed[epcec_in[i]])
 			epcec_rin.push_back(epcec_in[i]);
 	}
-}
 
-bool
-preprocess::_simulate(Bitset** result, int bit_size)
-{
-	int* fanouts = new int[maxvar + 1];
-	for (int i = 1; i <= maxvar; i++) {
-		used[i] = 0;
-		fanouts[i] = inv_C[i].size();
-	}
-	for (int i = 1; i <= gate.size(); i++)
+	// The gates evaluated do not depend on the input values, the breadth-first order is computed once for all rounds
+	for (int i = 0; i < gate.size(); i++)
 		topo_counter[i] = 0;
 	std::queue<int> q;
 	for (int i = 0; i < epcec_in.size(); i++) {
@@ -248,6 +241,7 @@ preprocess::_simulate(Bitset** result, int bit_size)
 		used[epcec_in[i]] = 2;
 	}
 	int o = abs(epcec_out);
+	epcec_gates.clear();
 	while (!q.empty()) {
 		int u = q.front();
 		q.pop();
@@ -260,164 +254,137 @@ preprocess::_simulate(Bitset** result, int bit_size)
 				continue;
 			int v = abs(gate[c].out);
 			q.push(v), used[v] = 1;
-			result[v] = new Bitset;
-			result[v]->allocate(bit_size);
-			int l1 = gate[c][0], l2 = gate[c][1];
-			int v1 = abs(l1), v2 = abs(l2);
-			if (gate[c].type == 0)
-				result[v]->ands(*result[v1], *result[v2], gate[c].out, l1, l2);
-			else if (gate[c].type == 1)
-				result[v]->xors(*result[v1], *result[v2], gate[c].out, l1, l2);
-			fanouts[v1]--;
-			fanouts[v2]--;
+			epcec_gates.push_back({ gate[c].out, gate[c][0], gate[c][1], gate[c].type == 1 });
 		}
 	}
+}
 
-	bool res = true;
-	Bitset& bit = *result[o];
-	if (epcec_out < 0)
-		bit.flip();
-	for (int i = 0; i < bit.m_size; i++)
-		if (bit.array[i] != 0)
-			res = false;
-	if (!res) {
-		for (int i = 0; i < bit.m_size * 64; i++) {
-			if (bit[i] == 0)
-				continue;
-			for (int j = 1; j <= vars; j++) {
-				model[j] = -1;
-				if (result[j] != nullptr)
-					model[j] = (*result[j])[i];
-			}
-			break;
+bool
+preprocess::_simulate(CircuitSimulator& sim)
+{
+	sim.simulate(circuitThreads);
+
+	// The output is not reachable from the inputs, nothing can be concluded
+	ull* out = sim.signature(abs(epcec_out));
+	if (out == nullptr)
+		return true;
+
+	const ull mask = (epcec_out < 0) ? ~0ULL : 0;
+	for (size_t w = 0; w < sim.getWords(); w++) {
+		ull word = out[w] ^ mask;
+		if (word == 0)
+			continue;
+		// First input pattern satisfying the output
+		int pos = __builtin_ctzll(word);
+		for (int j = 1; j <= vars; j++) {
+			ull* bits = sim.signature(j);
+			model[j] = (bits == nullptr) ? -1 : (bits[w] >> pos) & 1;
 		}
+		return false;
 	}
-	for (int i = 1; i <= maxvar; i++)
-		if (result[i] != nullptr) {
-			result[i]->free();
-			delete result[i];
-			result[i] = nullptr;
+	return true;
+}
+
+bool
+preprocess::check_simulation(CircuitSimulator& sim)
+{
+	const size_t words = sim.getWords();
+	std::vector<Bitset*> result(maxvar + 1, nullptr);
+
+	for (int v : epcec_in) {
+		result[v] = new Bitset;
+		result[v]->allocate(words * 64);
+		std::copy_n(sim.signature(v), words, result[v]->array);
+	}
+
+	// The gates are in a topological order, as in the original breadth-first simulation
+	bool same = true;
+	for (const SimGate& g : epcec_gates) {
+		int v = abs(g.out);
+		result[v] = new Bitset;
+		result[v]->allocate(words * 64);
+		if (g.isXor)
+			result[v]->xors(*result[abs(g.in0)], *result[abs(g.in1)], g.out, g.in0, g.in1);
+		else
+			result[v]->ands(*result[abs(g.in0)], *result[abs(g.in1)], g.out, g.in0, g.in1);
+
+		if (same && !std::equal(result[v]->array, result[v]->array + words, sim.signature(v))) {
+			LOGWARN("[PRS %d] [Circuit] signature of %d differs from the reference simulation", this->getSolverId(), v);
+			same = false;
 		}
-	delete fanouts;
-	return res;
+	}
+
+	for (Bitset* bits : result) {
+		if (bits) {
+			bits->free();
+			delete bits;
+		}
+	}
+	return same;
 }
 
 bool
 preprocess::do_epcec()
 {
-	Bitset** result = new Bitset*[maxvar + 1];
-	for (int i = 1; i <= vars; i++)
-		result[i] = nullptr;
 	int nri = epcec_rin.size(), ni = epcec_in.size();
 	const int maxR = 20;
 	int bit_size = 1 << std::min(maxR, nri);
-	if (nri > maxR) {
-		int extra_len = nri - maxR;
-		ull extra_values = 0;
+	int extra_len = std::max(0, nri - maxR);
+	// With few inputs the patterns repeat inside a single word
+	const int words = std::max(1, bit_size / 64);
 
-		while (extra_values < (1LL << (extra_len))) {
-			if (extra_values % (1 << 7) == 0)
-				LOG2("[PRS %d] [Circuit] epcec round [%llu / %lld]",
-					 this->getSolverId(),
-					 extra_values,
-					 (1LL << (extra_len)));
-			for (int i = 0; i < ni; i++) {
-				int v = epcec_in[i];
-				result[v] = new Bitset;
-				result[v]->allocate(bit_size);
-				if (fixed[v]) {
-					if (fixed[v] == 1)
-						result[v]->set();
-					else
-						result[v]->reset();
-				}
-			}
-			for (int i = 0; i < extra_len; i++) {
-				int input_var = epcec_rin[i];
-				ull val = extra_values & (1LL << (extra_len - i - 1));
-				if (val != 0)
-					val = ~(val = 0);
-				for (int j = 0; j < result[input_var]->m_size; j++) {
-					result[input_var]->array[j] = val;
-				}
-			}
-			int sz = 1 << maxR;
-			int unit = sz;
-			for (int i = extra_len; i < nri; i++) {
-				int input_var = epcec_rin[i];
-				unit >>= 1;
-				if (unit >= 64) {
-					const ull all_zero = 0;
-					const ull all_one = ~all_zero;
-					for (int j = 0; j < sz / 64; j++) {
-						int value = (j * 64 / unit) % 2;
-						assert(j < result[input_var]->m_size);
-						if (value)
-							result[input_var]->array[j] = all_one;
-						else
-							result[input_var]->array[j] = all_zero;
-					}
-				} else {
-					for (int j = 0; j < 64; j++) {
-						int value = (j >> (nri - i - 1)) & 1;
-						if (value)
-							result[input_var]->reset(j);
-						else
-							result[input_var]->set(j);
-					}
+	CircuitSimulator sim;
+	sim.build(epcec_in, epcec_gates, maxvar, words);
+	LOG2("[PRS %d] [Circuit] %zu gates on %zu levels, %d bits per signature, %d threads",
+		 this->getSolverId(),
+		 epcec_gates.size(),
+		 sim.getLevels(),
+		 bit_size,
+		 circuitThreads);
 
-					for (int j = 1; j < sz / 64; j++) {
-						result[input_var]->array[j] = result[input_var]->array[0];
-					}
-				}
-			}
-			int res = _simulate(result, bit_size);
-			extra_values++;
-			if (!res)
-				return 0;
-		}
-	} else {
+	const ull all_zero = 0;
+	const ull all_one = ~all_zero;
+
+	for (ull extra_values = 0; extra_values < (1ULL << extra_len) && !interrupted; extra_values++) {
+		if (extra_len && extra_values % (1 << 7) == 0)
+			LOG2("[PRS %d] [Circuit] epcec round [%llu / %lld]",
+				 this->getSolverId(),
+				 extra_values,
+				 (1LL << (extra_len)));
 		for (int i = 0; i < ni; i++) {
 			int v = epcec_in[i];
-			result[v] = new Bitset;
-			result[v]->allocate(bit_size);
-			if (fixed[v]) {
-				if (fixed[v] == 1)
-					result[v]->set();
-				else
-					result[v]->reset();
-			}
+			if (fixed[v])
+				std::fill_n(sim.signature(v), words, (fixed[v] == 1) ? all_one : all_zero);
+		}
+		// The first extra_len inputs are constant during a round
+		for (int i = 0; i < extra_len; i++) {
+			ull val = extra_values & (1LL << (extra_len - i - 1));
+			std::fill_n(sim.signature(epcec_rin[i]), words, val ? all_one : all_zero);
 		}
-		int sz = 1 << nri;
-		int unit = sz;
-		for (int i = 0; i < epcec_rin.size(); i++) {
-			int input_var = epcec_rin[i];
+		// The others enumerate all their values in the bits of the signatures
+		int unit = bit_size;
+		for (int i = extra_len; i < nri; i++) {
+			ull* bits = sim.signature(epcec_rin[i]);
 			unit >>= 1;
 			if (unit >= 64) {
-				const ull all_zero = 0;
-				const ull all_one = ~all_zero;
-				for (int j = 0; j < sz / 64; j++) {
-					int value = (j * 64 / unit) % 2;
-					if (value)
-						result[input_var]->array[j] = all_one;
-					else
-						result[input_var]->array[j] = all_zero;
-				}
+				for (int j = 0; j < words; j++)
+					bits[j] = ((j * 64 / unit) % 2) ? all_one : all_zero;
 			} else {
-				for (int j = 0; j < 64; j++) {
-					int value = (j >> (nri - i - 1)) & 1;
-					if (value)
-						result[input_var]->reset(j);
-					else
-						result[input_var]->set(j);
-				}
-
-				for (int j = 1; j < sz / 64; j++) {
-					result[input_var]->array[j] = result[input_var]->array[0];
-				}
+				bits[0] = 0;
+				for (int j = 0; j < 64; j++)
+					if (!((j >> (nri - i - 1)) & 1))
+						bits[0] |= 1ULL << j;
+				std::fill_n(bits + 1, words - 1, bits[0]);
 			}
 		}
-		return _simulate(result, bit_size);
+		bool unsatisfied = _simulate(sim);
+		if (__globalParameters__.prsCircuitCheck && !check_simulation(sim)) {
+			LOGWARN("[PRS %d] [Circuit] the simulation differs from the reference one, no conclusion is drawn",
+					this->getSolverId());
+			return true;
+		}
+		if (!unsatisfied)
+			return false;
 	}
 	return true;
 }
@@ -450,8 +417,25 @@ preprocess::preprocess_circuit()
 	delete[] topo_counter;
 	delete[] used;
 	gate.clear();
+	epcec_gates.clear();
 	return res == 0 ? 10 : 0;
 failed:
 	gate.clear();
 	return 0;
-}
\ No newline at end of file
+}
+
+int
+preprocess::analysis_circuit()
+{
+	int res = 0;
+	auto init = std::chrono::high_resolution_clock::now();
+
+	if (vars <= this->maxVarCircuit && clauses <= this->maxClauseCircuit)
+		res = preprocess_circuit();
+
+	auto circuit = std::chrono::high_resolution_clock::now();
+	LOG1("[PRS %d] Circuit Check took %.3lfs",
+		 this->getSolverId(),
+		 std::chrono::duration_cast<std::chrono::milliseconds>(circuit - init).count() / 1000.0);
+	return res;
+}
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <m4ri/m4ri.h>
 #include <set>
+#include <thread>
 
 bool
 cmpvar(int x, int y)
@@ -14,11 +15,11 @@ cmpvar(int x, int y)
 int
 preprocess::cal_dup_val(int i)
 {
-	for (int j = 0; j < clause[i].size(); j++)
-		a[j] = clause[i][j];
-	std::sort(a, a + clause[i].size(), cmpvar);
+	for (int j = 0; j < formula[i].size(); j++)
+		a[j] = formula[i][j];
+	std::sort(a, a + formula[i].size(), cmpvar);
 	int v = 0;
-	for (int j = 0; j < clause[i].size(); j++)
+	for (int j = 0; j < formula[i].size(); j++)
 		if (a[j] < 0)
 			v |= (1 << j);
 	return v;
@@ -36,25 +37,25 @@ preprocess::search_xors()
 	}
 	for (int i = 1; i <= clauses; i++) {
 		abstract[i] = clause_delete[i] = nxtc[i] = 0;
-		int l = clause[i].size();
+		int l = formula[i].size();
 		for (int j = 0; j < l; j++) {
-			if (clause[i][j] > 0)
-				occurp[clause[i][j]].push_back(i);
+			if (formula[i][j] > 0)
+				occurp[formula[i][j]].push_back(i);
 			else
-				occurn[-clause[i][j]].push_back(i);
-			abstract[i] |= 1 << (abs(clause[i][j]) & 31);
+				occurn[-formula[i][j]].push_back(i);
+			abstract[i] |= 1 << (abs(formula[i][j]) & 31);
 		}
 	}
-	for (int i = 1; i <= clauses; i++) {
+	for (int i = 1; i <= clauses && !interrupted; i++) {
 		if (nxtc[i])
 			continue;
 		nxtc[i] = 1;
-		int l = clause[i].size();
+		int l = formula[i].size();
 		if (l <= 2 || l > this->maxClauseSizeXor)
 			continue;
 		int required_num = 1 << (l - 2), skip = 0, mino = clauses + 1, mino_id = 0;
 		for (int j = 0; j < l; j++) {
-			int idx = abs(clause[i][j]);
+			int idx = abs(formula[i][j]);
 			if (occurp[idx].size() < required_num || occurn[idx].size() < required_num) {
 				skip = 1;
 				break;
@@ -70,12 +71,12 @@ preprocess::search_xors()
 		xorsp.push_back(i);
 		for (int j = 0; j < occurp[mino_id].size(); j++) {
 			int o = occurp[mino_id][j];
-			if (!nxtc[o] && clause[o].size() == l && abstract[o] == abstract[i])
+			if (!nxtc[o] && formula[o].size() == l && abstract[o] == abstract[i])
 				xorsp.push_back(o);
 		}
 		for (int j = 0; j < occurn[mino_id].size(); j++) {
 			int o = occurn[mino_id][j];
-			if (!nxtc[o] && clause[o].size() == l && abstract[o] == abstract[i])
+			if (!nxtc[o] && formula[o].size() == l && abstract[o] == abstract[i])
 				xorsp.push_back(o);
 		}
 		if (xorsp.size() < 2 * required_num)
@@ -83,17 +84,17 @@ preprocess::search_xors()
 
 		int rhs[2] = { 0, 0 };
 		for (int j = 0; j < l; j++)
-			seen[abs(clause[i][j])] = i;
+			seen[abs(formula[i][j])] = i;
 		dup_table.clear();
 		dup_table.resize(1 << this->maxClauseSizeXor, false);
 
 		for (int j = 0; j < xorsp.size(); j++) {
 			int o = xorsp[j], dup_v;
 			bool xor_sign = true;
-			for (int k = 0; k < clause[o].size(); k++) {
-				if (seen[abs(clause[o][k])] != i)
+			for (int k = 0; k < formula[o].size(); k++) {
+				if (seen[abs(formula[o][k])] != i)
 					goto Next;
-				if (clause[o][k] < 0)
+				if (formula[o][k] < 0)
 					xor_sign = !xor_sign;
 			}
 			dup_v = cal_dup_val(o);
@@ -151,22 +152,22 @@ preprocess::ecc_var()
 	for (int i = 0; i < xors.size(); i++) {
 		int x = xors[i].c;
 		xids.clear();
-		for (int j = 0; j < clause[x].size(); j++)
-			if (scc_id[abs(clause[x][j])] != -1)
-				xids.insert(scc_id[abs(clause[x][j])]);
+		for (int j = 0; j < formula[x].size(); j++)
+			if (scc_id[abs(formula[x][j])] != -1)
+				xids.insert(scc_id[abs(formula[x][j])]);
 
 		if (xids.size() == 0) {
 			scc.emplace_back();
-			for (int j = 0; j < clause[x].size(); j++) {
-				scc_id[abs(clause[x][j])] = scc.size() - 1;
-				scc[scc.size() - 1].push_back(abs(clause[x][j]));
+			for (int j = 0; j < formula[x].size(); j++) {
+				scc_id[abs(formula[x][j])] = scc.size() - 1;
+				scc[scc.size() - 1].push_back(abs(formula[x][j]));
 			}
 		} else if (xids.size() == 1) {
 			int id = *xids.begin();
-			for (int j = 0; j < clause[x].size(); j++) {
-				if (scc_id[abs(clause[x][j])] == -1) {
-					scc_id[abs(clause[x][j])] = id;
-					scc[id].push_back(abs(clause[x][j]));
+			for (int j = 0; j < formula[x].size(); j++) {
+				if (scc_id[abs(formula[x][j])] == -1) {
+					scc_id[abs(formula[x][j])] = id;
+					scc[id].push_back(abs(formula[x][j]));
 				}
 			}
 		} else {
@@ -186,10 +187,10 @@ preprocess::ecc_var()
 					v.clear();
 				}
 			}
-			for (int j = 0; j < clause[x].size(); j++) {
-				if (scc_id[abs(clause[x][j])] == -1) {
-					scc_id[abs(clause[x][j])] = id_max;
-					scc[id_max].push_back(abs(clause[x][j]));
+			for (int j = 0; j < formula[x].size(); j++) {
+				if (scc_id[abs(formula[x][j])] == -1) {
+					scc_id[abs(formula[x][j])] = id_max;
+					scc[id_max].push_back(abs(formula[x][j]));
 				}
 			}
 		}
@@ -203,7 +204,7 @@ preprocess::ecc_xor()
 	for (int i = 0; i < scc.size(); i++)
 		seen[i] = -1;
 	for (int i = 0; i < xors.size(); i++) {
-		int id = scc_id[abs(clause[xors[i].c][0])];
+		int id = scc_id[abs(formula[xors[i].c][0])];
 		if (seen[id] == -1)
 			xor_scc.emplace_back(), seen[id] = xor_scc.size() - 1;
 		int id2 = seen[id];
@@ -212,71 +213,184 @@ preprocess::ecc_xor()
 	return xor_scc.size();
 }
 
+/// Components with at most this number of columns are packed together in one matrix
+static const int GAUSS_SMALL_COLS = 64;
+
+/// Number of columns a batch of small components is filled up to
+static const int GAUSS_BATCH_COLS = 512;
+
+void
+preprocess::gauss_echelonize(const std::vector<int>& comps,
+							 std::vector<int>& v2mzd,
+							 std::vector<std::vector<int>>& derived,
+							 std::atomic<bool>& unsat)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// The components are laid out as the blocks of a block-diagonal matrix, each block has its own rhs column. The
+	// reduced echelon form of such a matrix is the union of the reduced echelon forms of its blocks.
+	int rows = 0, cols = 0;
+	std::vector<int> colBlock, mzd2v, rhsCol;
+	for (int k = 0; k < comps.size(); k++) {
+		std::vector<int>& vars_k = scc[scc_id[abs(formula[xors[xor_scc[comps[k]][0]].c][0])]];
+		rows += xor_scc[comps[k]].size();
+		for (int j = 0; j < vars_k.size(); j++) {
+			v2mzd[vars_k[j]] = cols++;
+			colBlock.push_back(k);
+			mzd2v.push_back(vars_k[j]);
+		}
+		rhsCol.push_back(cols++);
+		colBlock.push_back(k);
+		mzd2v.push_back(0);
+	}
+
+	mzd_t* mat = mzd_init(rows, cols);
+	for (int k = 0, row = 0; k < comps.size(); k++) {
+		const std::vector<int>& xs = xor_scc[comps[k]];
+		for (int r = 0; r < xs.size(); r++, row++) {
+			int c = xors[xs[r]].c;
+			for (int j = 0; j < formula[c].size(); j++)
+				mzd_write_bit(mat, row, v2mzd[abs(formula[c][j])], 1);
+			if (xors[xs[r]].rhs)
+				mzd_write_bit(mat, row, rhsCol[k], 1);
+		}
+	}
+	mzd_echelonize(mat, true);
+
+	// The pivots of the reduced echelon form are in increasing columns
+	for (int row = 0, pivot = 0; row < rows; row++, pivot++) {
+		while (pivot < cols && !mzd_read_bit(mat, row, pivot))
+			pivot++;
+		if (pivot == cols)
+			break;
+		int col = pivot;
+
+		std::vector<int>& out = derived[comps[colBlock[col]]];
+		std::vector<int> ones;
+		for (; mzd2v[col]; col++)
+			if (mzd_read_bit(mat, row, col)) {
+				if (ones.size() == 2)
+					goto NextRow;
+				ones.push_back(mzd2v[col]);
+			}
+
+		// col is now the rhs column of the block
+		if (ones.size() == 1) {
+			out.push_back(ones[0] * (mzd_read_bit(mat, row, col) ? 1 : -1));
+			out.push_back(0);
+		} else if (ones.size() == 2) {
+			int p = ones[0], q = mzd_read_bit(mat, row, col) ? ones[1] : -ones[1];
+			out.insert(out.end(), { p, q, 0, -p, -q, 0 });
+		} else {
+			// 0 = 1, the empty clause
+			out.push_back(0);
+			unsat = true;
+		}
+	NextRow:;
+	}
+	mzd_free(mat);
+
+	auto end = std::chrono::high_resolution_clock::now();
+	double time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1e6;
+	if (comps.size() == 1)
+		LOG2("[PRS %d]  [GE] component %d: %d x %d (time: %.3f)", this->getSolverId(), comps[0], rows, cols, time);
+	else
+		LOG2("[PRS %d]  [GE] batch of %zu components: %d x %d (time: %.3f)",
+			 this->getSolverId(),
+			 comps.size(),
+			 rows,
+			 cols,
+			 time);
+}
+
 int
 preprocess::gauss_elimination()
 {
 	gauss_eli_unit = gauss_eli_binary = 0;
-	std::vector<int> v2mzd(vars + 1, -1);
-	std::vector<int> mzd2v;
+
+	// Components worth eliminating, their variables are sorted before the threads read them
+	std::vector<int> comps;
 	for (int i = 0; i < xor_scc.size(); i++) {
 		if (xor_scc[i].size() == 1)
 			continue;
-		int id = scc_id[abs(clause[xors[xor_scc[i][0]].c][0])];
+		int id = scc_id[abs(formula[xors[xor_scc[i][0]].c][0])];
 		assert(scc[id].size() > 3);
 		if (scc[id].size() > 1e7 / xor_scc[i].size())
 			continue;
-		mzd2v.clear();
-		std::sort(scc[id].begin(), scc[id].begin() + scc[id].size(), cmpvar);
-		for (int j = 0; j < scc[id].size(); j++) {
-			assert(scc[id][j] > 0);
-			assert(scc[id][j] <= vars);
-			v2mzd[scc[id][j]] = j;
-			mzd2v.push_back(scc[id][j]);
-		}
-		int cols = scc[id].size() + 1;
-		mzd_t* mat = mzd_init(xor_scc[i].size(), cols);
-		for (int row = 0; row < xor_scc[i].size(); row++) {
-			int k = xors[xor_scc[i][row]].c;
-			for (int j = 0; j < clause[k].size(); j++)
-				mzd_write_bit(mat, row, v2mzd[abs(clause[k][j])], 1);
-			if (xors[xor_scc[i][row]].rhs)
-				mzd_write_bit(mat, row, cols - 1, 1);
+		std::sort(scc[id].begin(), scc[id].end(), cmpvar);
+		comps.push_back(i);
+	}
+	if (comps.empty())
+		return true;
+
+	auto colsOf = [this](int i) { return (int)scc[scc_id[abs(formula[xors[xor_scc[i][0]].c][0])]].size() + 1; };
+
+	// Largest components first for load balance, small ones are batched to amortize the matrix setup of m4ri
+	std::vector<int> order(comps);
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+		return 1ll * colsOf(a) * xor_scc[a].size() > 1ll * colsOf(b) * xor_scc[b].size();
+	});
+	std::vector<std::vector<int>> tasks;
+	int batchCols = GAUSS_BATCH_COLS;
+	for (int i : order) {
+		if (colsOf(i) > GAUSS_SMALL_COLS) {
+			tasks.push_back({ i });
+			continue;
 		}
-		mzd_echelonize(mat, true);
-		for (int row = 0, rhs; row < xor_scc[i].size(); row++) {
-			std::vector<int> ones;
-			for (int col = 0; col < cols - 1; col++)
-				if (mzd_read_bit(mat, row, col)) {
-					if (ones.size() == 2)
-						goto NextRow;
-					ones.push_back(mzd2v[col]);
-				}
+		if (batchCols + colsOf(i) > GAUSS_BATCH_COLS)
+			tasks.emplace_back(), batchCols = 0;
+		tasks.back().push_back(i);
+		batchCols += colsOf(i);
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::vector<std::vector<int>> derived(xor_scc.size());
+	std::atomic<size_t> nextTask(0);
+	std::atomic<bool> unsat(false);
+	auto worker = [&]() {
+		std::vector<int> v2mzd(vars + 1, -1);
+		for (size_t t = nextTask++; t < tasks.size() && !unsat && !interrupted; t = nextTask++)
+			gauss_echelonize(tasks[t], v2mzd, derived, unsat);
+	};
+
+	unsigned int threads = std::min<size_t>(std::max(1u, gaussThreads), tasks.size());
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < threads; i++)
+		pool.emplace_back(worker);
+	worker();
+	for (auto& thread : pool)
+		thread.join();
+
+	auto end = std::chrono::high_resolution_clock::now();
+	LOG2("[PRS %d]  [GE] %zu components in %zu tasks on %u threads (time: %.2f)",
+		 this->getSolverId(),
+		 comps.size(),
+		 tasks.size(),
+		 threads,
+		 std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0);
+
+	if (unsat)
+		return false;
+	if (interrupted)
+		return true;
 
-			rhs = mzd_read_bit(mat, row, cols - 1);
-			if (ones.size() == 1) {
+	// Clauses are added in the order of the components, as a sequential elimination would
+	for (int i : comps) {
+		for (int j = 0; j < derived[i].size(); j++) {
+			// Appended to the own clauses, the formula of a snapshot is shared
+			clause.emplace_back();
+			++clauses;
+			for (; derived[i][j]; j++)
+				clause.back().push_back(derived[i][j]);
+			if (clause.back().size() == 1)
 				++gauss_eli_unit;
-				clause.emplace_back();
-				++clauses;
-				clause[clauses].push_back(ones[0] * (rhs ? 1 : -1));
-			} else if (ones.size() == 2) {
+			else
 				++gauss_eli_binary;
-				// assert(clauses == clause.size() - 1);
-				int p = ones[0], q = rhs ? ones[1] : -ones[1];
-				clause.emplace_back();
-				++clauses;
-				clause[clauses].push_back(p);
-				clause[clauses].push_back(q);
-				clause.emplace_back();
-				++clauses;
-				clause[clauses].push_back(-p);
-				clause[clauses].push_back(-q);
-			} else if (rhs) {
-				return false;
-			}
-		NextRow:;
 		}
-		mzd_free(mat); /* moved because of heap-use-after-use */
 	}
+	// Each binary xor gives two clauses
+	gauss_eli_binary /= 2;
 	return true;
 }
 
@@ -309,4 +423,21 @@ preprocess::preprocess_gauss()
 	clause_delete.resize(clauses + 1, 0);
 	nxtc.resize(clauses + 1, 0);
 	return true;
-}
\ No newline at end of file
+}
+
+int
+preprocess::analysis_gauss()
+{
+	int res = 0;
+	auto init = std::chrono::high_resolution_clock::now();
+
+	if (vars <= this->maxVarGauss && clauses <= this->maxClauseGauss && !preprocess_gauss())
+		res = 20;
+
+	auto gauss = std::chrono::high_resolution_clock::now();
+	LOG1("[PRS %d] Gauss Elimination (xor-limit=%d) took %.3lfs",
+		 this->getSolverId(),
+		 this->maxClauseSizeXor,
+		 std::chrono::duration_cast<std::chrono::milliseconds>(gauss - init).count() / 1000.0);
+	return res;
+}
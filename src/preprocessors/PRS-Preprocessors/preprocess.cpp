@@ -2,11 +2,21 @@
 #include "./utils-prs/parse.hpp"
 #include "utils/Logger.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 preprocess::preprocess(int id_)
 	: PreprocessorInterface(PreprocessorAlgorithm::MIX, id_)
 	, vars(0)
 	, clauses(0)
+	, formula(clause)
+	, nxors(0)
+	, model(nullptr)
 	, maxlen(0)
+	, interrupted(false)
 {
 	/* Painless */
 	this->maxVarCircuit = __globalParameters__.prsCircuitVar;
@@ -18,17 +28,62 @@ preprocess::preprocess(int id_)
 	this->maxClauseGauss = 	 __globalParameters__.prsGaussCls;
 	this->maxClauseBinary =  __globalParameters__.prsBinCls;
 	this->maxClauseCard =    __globalParameters__.prsCardCls;
+	this->circuitThreads = (__globalParameters__.prsCircuitThreads > 0) ? __globalParameters__.prsCircuitThreads
+																		: __globalParameters__.cpus;
+	this->gaussThreads = (__globalParameters__.prsGaussThreads > 0) ? __globalParameters__.prsGaussThreads
+																	: __globalParameters__.cpus;
 
 	initializeTypeId<preprocess>();
 
-	// this->preprocessors.push_back(std::bind(&preprocess::preprocess_circuit_wrapper, this));
-	// this->preprocessors.push_back(std::bind(&preprocess::preprocess_gauss_wrapper, this));
+	// The circuit check matches the gates on the clauses as parsed, it must run before the propagation
+	std::vector<prs_analysis> beforePropagation;
+	if (__globalParameters__.prsCircuit)
+		beforePropagation.push_back(
+			{ "Circuit Check", &preprocess::analysis_circuit, __globalParameters__.prsCircuitTimeout });
+
+	// Gauss and card work on the propagated formula, they run side by side by default
+	std::vector<prs_analysis> afterPropagation;
+	if (__globalParameters__.prsGauss)
+		afterPropagation.push_back(
+			{ "Gauss Elimination", &preprocess::analysis_gauss, __globalParameters__.prsGaussTimeout });
+	afterPropagation.push_back(
+		{ "Card Elimination", &preprocess::analysis_card, __globalParameters__.prsCardTimeout });
+
+	if (!beforePropagation.empty())
+		this->preprocessors.push_back([this, beforePropagation]() { return preprocess_concurrent(beforePropagation); });
 	this->preprocessors.push_back(std::bind(&preprocess::preprocess_propagation_wrapper, this));
-	this->preprocessors.push_back(std::bind(&preprocess::preprocess_card_wrapper, this));
+	this->preprocessors.push_back([this, afterPropagation]() { return preprocess_concurrent(afterPropagation); });
 	this->preprocessors.push_back(std::bind(&preprocess::preprocess_resolution_wrapper, this));
 	this->preprocessors.push_back(std::bind(&preprocess::preprocess_binary_wrapper, this));
 }
 
+preprocess::preprocess(const preprocess& parent, std::shared_ptr<std::vector<std::vector<int>>> formula_)
+	: PreprocessorInterface(PreprocessorAlgorithm::MIX, parent.m_solverId)
+	, vars(parent.vars)
+	, clauses(parent.clauses)
+	, formula(*formula_)
+	, nxors(0)
+	, model(nullptr)
+	, maxlen(0)
+	, interrupted(false)
+	, sharedFormula(std::move(formula_))
+{
+	this->orivars = this->vars;
+	this->oriclauses = this->clauses;
+
+	this->maxVarCircuit = parent.maxVarCircuit;
+	this->maxVarGauss = parent.maxVarGauss;
+	this->maxVarCard = parent.maxVarCard;
+
+	this->maxClauseCircuit = parent.maxClauseCircuit;
+	this->maxClauseSizeXor = parent.maxClauseSizeXor;
+	this->maxClauseGauss = parent.maxClauseGauss;
+	this->maxClauseBinary = parent.maxClauseBinary;
+	this->maxClauseCard = parent.maxClauseCard;
+	this->circuitThreads = parent.circuitThreads;
+	this->gaussThreads = parent.gaussThreads;
+}
+
 void
 preprocess::preprocess_init()
 {
@@ -48,7 +103,7 @@ preprocess::preprocess_init()
 	occurp = new std::vector<int>[vars + 1];
 	occurn = new std::vector<int>[vars + 1];
 	for (int i = 1; i <= clauses; i++) {
-		int l = clause[i].size();
+		int l = formula[i].size();
 		if (l > maxlen)
 			maxlen = l;
 	}
@@ -57,6 +112,7 @@ preprocess::preprocess_init()
 
 	mapval = new int[vars + 10];
 	mapto = new int[vars + 10];
+	mapfrom = nullptr;
 	for (int i = 1; i <= vars; i++)
 		mapto[i] = i, mapval[i] = 0;
 }
@@ -91,6 +147,68 @@ preprocess::releaseMemory()
 	delete[] occurn;
 }
 
+bool
+preprocess::saveReconstruction(std::vector<int>& data)
+{
+	data.push_back(orivars);
+	data.push_back(vars);
+	data.insert(data.end(), mapto + 1, mapto + orivars + 1);
+	data.insert(data.end(), mapval + 1, mapval + orivars + 1);
+
+	// The resolution pass fills these only if it eliminated variables
+	const int savedResolutions = resolution.empty() ? 0 : resolutions;
+	data.push_back(savedResolutions);
+	data.insert(data.end(), resolution.begin() + (savedResolutions > 0), resolution.end());
+
+	const int savedClauses = res_clause.empty() ? 0 : res_clauses;
+	data.push_back(savedClauses);
+	for (int i = 1; i <= savedClauses; i++) {
+		data.push_back(res_clause[i].size());
+		data.insert(data.end(), res_clause[i].begin(), res_clause[i].end());
+	}
+	return true;
+}
+
+bool
+preprocess::loadReconstruction(const int* data, size_t size)
+{
+	const int* end = data + size;
+	if (size < 2 || data[0] < 0 || data[1] < 0 || size < 3 + 2 * (size_t)data[0])
+		return false;
+
+	orivars = *data++;
+	vars = *data++;
+	clauses = 0;
+
+	mapto = new int[orivars + 10];
+	mapval = new int[orivars + 10];
+	mapto[0] = mapval[0] = 0;
+	std::copy(data, data + orivars, mapto + 1);
+	data += orivars;
+	std::copy(data, data + orivars, mapval + 1);
+	data += orivars;
+
+	resolutions = *data++;
+	if (resolutions < 0 || end - data <= resolutions)
+		return false;
+	resolution.assign(1, 0);
+	resolution.insert(resolution.end(), data, data + resolutions);
+	data += resolutions;
+
+	res_clauses = *data++;
+	if (res_clauses < 0)
+		return false;
+	res_clause.assign(1, {});
+	for (int i = 1; i <= res_clauses; i++) {
+		if (data == end || *data < 0 || end - data - 1 < *data)
+			return false;
+		int length = *data++;
+		res_clause.emplace_back(data, data + length);
+		data += length;
+	}
+	return data == end;
+}
+
 void
 preprocess::update_var_clause_label()
 {
@@ -246,6 +364,148 @@ preprocess::loadFormula(const char* filename)
 		 this->oriclauses);
 }
 
+void
+preprocess::release_snapshot()
+{
+	releaseMemory();
+	delete[] mapto;
+	delete[] mapval;
+	delete[] model;
+	clause.clear();
+	sharedFormula.reset();
+}
+
+bool
+preprocess::check_model(const int* model)
+{
+	for (int i = 1; i <= clauses; i++) {
+		bool satisfied = false;
+		for (int j = 0; j < clause[i].size() && !satisfied; j++)
+			satisfied = model[abs(clause[i][j])] == clause[i][j];
+		if (!satisfied)
+			return false;
+	}
+	return true;
+}
+
+int
+preprocess::preprocess_concurrent(const std::vector<prs_analysis>& analyses)
+{
+	struct job
+	{
+		std::unique_ptr<preprocess> snapshot;
+		bool done = false;
+		bool timedOut = false;
+		int res = 0;
+	};
+
+	std::vector<job> jobs(analyses.size());
+	std::vector<std::thread> threads(analyses.size());
+	std::mutex mutex;
+	std::condition_variable cond;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// The snapshots read the same copy of the formula, taken back once the analyses are over
+	auto shared = std::make_shared<std::vector<std::vector<int>>>(std::move(clause));
+	clause.clear();
+	for (int i = 0; i < analyses.size(); i++) {
+		jobs[i].snapshot = std::make_unique<preprocess>(*this, shared);
+		threads[i] = std::thread([&jobs, &mutex, &cond, i, run = analyses[i].run]() {
+			preprocess& snapshot = *jobs[i].snapshot;
+			snapshot.preprocess_init();
+			int res = (snapshot.*run)();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				jobs[i].res = res;
+				jobs[i].done = true;
+			}
+			cond.notify_all();
+		});
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (int i = 0; i < analyses.size(); i++) {
+			auto deadline = start + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+										std::chrono::duration<double>(analyses[i].timeout));
+			// Sliced wait, the whole preprocessing may be interrupted
+			auto now = std::chrono::high_resolution_clock::now();
+			while (!jobs[i].done && !this->interrupted && now < deadline) {
+				cond.wait_until(lock, std::min(deadline, now + std::chrono::milliseconds(100)));
+				now = std::chrono::high_resolution_clock::now();
+			}
+			if (!jobs[i].done) {
+				jobs[i].timedOut = true;
+				jobs[i].snapshot->interrupted = true;
+				if (this->interrupted)
+					LOG1("[PRS %d] %s interrupted", this->getSolverId(), analyses[i].name);
+				else
+					LOG1("[PRS %d] %s exceeded its budget of %.2fs, interrupted",
+						 this->getSolverId(),
+						 analyses[i].name,
+						 analyses[i].timeout);
+			}
+		}
+	}
+
+	// The analyses poll their interrupted flag, an XOR component being echelonized by m4ri is finished first
+	for (auto& thread : threads)
+		thread.join();
+	clause = std::move(*shared);
+
+	auto end = std::chrono::high_resolution_clock::now();
+	LOG1("[PRS %d] %zu concurrent analyses took %.3lfs",
+		 this->getSolverId(),
+		 analyses.size(),
+		 std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0);
+
+	// Deterministic merge, in the order of the analyses
+	int res = 0;
+	for (int i = 0; i < analyses.size() && !res; i++) {
+		preprocess& snapshot = *jobs[i].snapshot;
+		if (jobs[i].timedOut)
+			continue;
+
+		if (jobs[i].res == 20) {
+			LOG0("[PRS %d] Solved by %s", this->getSolverId(), analyses[i].name);
+			res = 20;
+		} else if (jobs[i].res == 10) {
+			if (!check_model(snapshot.model)) {
+				LOGWARN("[PRS %d] %s returned a wrong model, ignored", this->getSolverId(), analyses[i].name);
+				continue;
+			}
+			LOG0("[PRS %d] Solved by %s", this->getSolverId(), analyses[i].name);
+			model = new int[vars + 1];
+			std::copy(snapshot.model, snapshot.model + vars + 1, model);
+			res = 10;
+		} else if (snapshot.clauses > snapshot.oriclauses) {
+			clause.resize(clauses + 1);
+			for (auto& derived : snapshot.clause)
+				clause.push_back(std::move(derived));
+			LOG1("[PRS %d] %s derived %d clauses",
+				 this->getSolverId(),
+				 analyses[i].name,
+				 snapshot.clauses - snapshot.oriclauses);
+			clauses += snapshot.clauses - snapshot.oriclauses;
+			clause_delete.resize(clauses + 1, 0);
+			nxtc.resize(clauses + 1, 0);
+		}
+	}
+
+	for (auto& job : jobs)
+		job.snapshot->release_snapshot();
+
+	if (res == 20) {
+		delete[] mapto;
+		delete[] mapval;
+		clause.clear();
+		res_clause.clear();
+		resolution.clear();
+	}
+	return res;
+}
+
 SatResult
 preprocess::solve(const std::vector<int> &cube)
 {
@@ -256,6 +516,10 @@ preprocess::solve(const std::vector<int> &cube)
 	// std::random_shuffle(this->preprocessors.begin(), this->preprocessors.end());
 
 	for (auto fct : this->preprocessors) {
+		if (this->interrupted) {
+			LOG1("[PRS %d] interrupted", this->getSolverId());
+			return SatResult::UNKNOWN;
+		}
 		res = fct();
 		if (0 != res) {
 			return static_cast<SatResult>(res);
@@ -2,6 +2,7 @@
 
 #include "./utils-prs/bitset.hpp"
 #include "./utils-prs/hashmap.hpp"
+#include "./utils-prs/simulator.hpp"
 #include "preprocessors/PreprocessorInterface.hpp"
 #include "utils/ErrorCodes.hpp"
 #include "utils/Parameters.hpp"
@@ -10,6 +11,7 @@
 #include <cassert>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <queue>
 #include <unordered_set>
 #include <vector>
@@ -88,6 +90,20 @@ struct type_gate
 	}
 };
 
+struct preprocess;
+
+/**
+ * @brief Read-only analysis of the PRS framework, run on a snapshot of the formula.
+ * @ingroup preproc_solving
+ */
+struct prs_analysis
+{
+	const char* name;
+	int (preprocess::*run)();
+	/// Time budget in seconds
+	double timeout;
+};
+
 /**
  * @brief The different simplification techniques implemented in PRS framework
  * @ingroup preproc_solving
@@ -96,10 +112,20 @@ struct preprocess : public PreprocessorInterface
 {
   public:
 	preprocess(int id_);
+
+	/**
+	 * @brief Snapshot of parent for a concurrent analysis: it reads formula, shared with the other snapshots, and keeps
+	 * the clauses it derives in its own clause vector. The working arrays are allocated by preprocess_init.
+	 */
+	preprocess(const preprocess& parent, std::shared_ptr<std::vector<std::vector<int>>> formula_);
+
 	int vars;
 	int clauses;
 	std::vector<std::vector<int>> clause, res_clause;
 
+	/// Clauses read by the analyses: clause itself, or the formula shared by the snapshots
+	const std::vector<std::vector<int>>& formula;
+
 	~preprocess();
 
 	int flag, epcec_out, maxvar, nxors, rins;
@@ -145,6 +171,13 @@ struct preprocess : public PreprocessorInterface
 	int ecc_var();
 	int ecc_xor();
 	int gauss_elimination();
+	void gauss_echelonize(const std::vector<int>& comps,
+						  std::vector<int>& v2mzd,
+						  std::vector<std::vector<int>>& derived,
+						  std::atomic<bool>& unsat);
+
+	/// Threads echelonizing the independent XOR components
+	unsigned int gaussThreads;
 
 	int rematch_eql(int x);
 	int rematch_and(int x);
@@ -154,7 +187,13 @@ struct preprocess : public PreprocessorInterface
 	int preprocess_circuit();
 	void epcec_preprocess();
 	bool do_epcec();
-	bool _simulate(Bitset** result, int bit_size);
+	bool _simulate(CircuitSimulator& sim);
+	/// Evaluate the gates again with the reference Bitset operations, false if a signature of sim differs
+	bool check_simulation(CircuitSimulator& sim);
+
+	/// Gates evaluated by the circuit simulation, in breadth-first order from the inputs
+	std::vector<SimGate> epcec_gates;
+	unsigned int circuitThreads;
 
 	/* Painless */
 	unsigned int getVariablesCount() { return this->vars; }
@@ -193,47 +232,33 @@ struct preprocess : public PreprocessorInterface
 
 	std::vector<std::function<int()>> preprocessors;
 
-	int preprocess_circuit_wrapper()
-	{
-		int res = 0;
-		auto init = std::chrono::high_resolution_clock::now();
+	/* Concurrent analyses */
 
-		if (vars <= this->maxVarCircuit && clauses <= this->maxClauseCircuit) {
-			res = preprocess_circuit();
-			if (res == 10) {
-				LOG0("[PRS %d] Solved by Circuit Check", this->getSolverId());
-			} else {
-				res = 0;
-			}
-		}
-		auto circuit = std::chrono::high_resolution_clock::now();
-		LOG1("[PRS %d] Circuit Check took %.3lfs",
-			 this->getSolverId(),
-			 std::chrono::duration_cast<std::chrono::milliseconds>(circuit - init).count() / 1000.0);
-		return res;
-	}
+	/// Cooperative stop, polled by the passes. Set on a snapshot whose analysis exceeds its time budget
+	std::atomic<bool> interrupted;
 
-	int preprocess_gauss_wrapper()
-	{
-		int res = 0;
-		auto init = std::chrono::high_resolution_clock::now();
+	/// Owner of the formula of a snapshot, null otherwise
+	std::shared_ptr<std::vector<std::vector<int>>> sharedFormula;
 
-		if (vars <= this->maxVarGauss && clauses <= this->maxClauseGauss) {
-			res = preprocess_gauss();
-			if (!res) {
-				LOG0("[PRS %d] Solved by Gauss Elimination", this->getSolverId());
-				res = 20;
-			} else {
-				res = 0;
-			}
-		}
-		auto gauss = std::chrono::high_resolution_clock::now();
-		LOG1("[PRS %d] Gauss Elimination (xor-limit=%d) took %.3lfs",
-			 this->getSolverId(),
-			 this->maxClauseSizeXor,
-			 std::chrono::duration_cast<std::chrono::milliseconds>(gauss - init).count() / 1000.0);
-		return res;
-	}
+	void release_snapshot();
+
+	/// Analyses run on a snapshot, each within its effort limits. They return 10 (SAT), 20 (UNSAT) or 0.
+	int analysis_circuit();
+	int analysis_gauss();
+	int analysis_card();
+
+	/**
+	 * @brief Run read-only analyses concurrently, on snapshots sharing one copy of the formula, each within its time
+	 * budget.
+	 * @details The results are merged in the order of the analyses: the first SAT or UNSAT answer is kept, otherwise
+	 * the clauses derived by the analyses are appended to the formula. An analysis exceeding its budget is asked to
+	 * stop through the interrupted flag of its snapshot and joined, its result is ignored.
+	 * @return 10 (SAT), 20 (UNSAT) or 0.
+	 */
+	int preprocess_concurrent(const std::vector<prs_analysis>& analyses);
+
+	/// True if the model (model[v] = v or -v) satisfies the current formula
+	bool check_model(const int* model);
 
 	int preprocess_propagation_wrapper()
 	{
@@ -256,32 +281,6 @@ struct preprocess : public PreprocessorInterface
 		return res;
 	}
 
-	int preprocess_card_wrapper()
-	{
-		int res = 0;
-		auto init = std::chrono::high_resolution_clock::now();
-
-		if (vars <= this->maxVarCard && clauses <= this->maxClauseCard) {
-			res = preprocess_card();
-			if (!res) {
-				LOG0("[PRS %d] Solved by Card Elimination", this->getSolverId());
-				delete[] mapto;
-				delete[] mapval;
-				clause.clear();
-				res_clause.clear();
-				resolution.clear();
-				res = 20;
-			} else {
-				res = 0;
-			}
-		}
-		auto card = std::chrono::high_resolution_clock::now();
-		LOG1("[PRS %d] Card Elimination took %.3lfs",
-			 this->getSolverId(),
-			 std::chrono::duration_cast<std::chrono::milliseconds>(card - init).count() / 1000.0);
-		return res;
-	}
-
 	int preprocess_resolution_wrapper()
 	{
 		auto init = std::chrono::high_resolution_clock::now();
@@ -327,22 +326,20 @@ struct preprocess : public PreprocessorInterface
   public:
 	/* Preprocess Interface */
 
-	void setSolverInterrupt()
-	{
-		LOGERROR("NOT IMPLEMENTED, YET!");
-		exit(PERR_NOT_SUPPORTED);
-	}
+	/// The running pass ends, or the running analyses are interrupted, and solve() returns UNKNOWN
+	void setSolverInterrupt() { this->interrupted = true; }
 
-	void unsetSolverInterrupt()
-	{
-		LOGERROR("NOT IMPLEMENTED, YET!");
-		exit(PERR_NOT_SUPPORTED);
-	}
+	void unsetSolverInterrupt() { this->interrupted = false; }
 
 	SatResult solve(const std::vector<int>& cube = {}) override;
 
 	void releaseMemory() override;
 
+	/// Save orivars, vars, mapto, mapval, the eliminated variables and their clauses
+	bool saveReconstruction(std::vector<int>& data) override;
+
+	bool loadReconstruction(const int* data, size_t size) override;
+
 	std::vector<int> getModel() override;
 
 	void loadFormula(const char* filename) override;
@@ -1,5 +1,6 @@
 #include "bitset.hpp"
 #include <cassert>
+#include <cstdlib>
 
 std::random_device rd;
 std::mt19937_64 eng(1000007);
@@ -23,7 +24,8 @@ Bitset::allocate(int sz) noexcept
 	n = sz;
 	assert(n % bits == 0);
 	m_size = n / bits;
-	array = (ull*)aligned_alloc(64, sizeof(ull) * m_size);
+	// aligned_alloc requires a size multiple of the alignment
+	array = (ull*)aligned_alloc(64, (sizeof(ull) * m_size + 63) / 64 * 64);
 }
 
 void
@@ -44,7 +46,7 @@ Bitset::hash() noexcept
 void
 Bitset::free() noexcept
 {
-	delete[] array;
+	std::free(array);
 }
 
 void
@@ -1,4 +1,6 @@
 #include "parse.hpp"
+#include "utils/ErrorCodes.hpp"
+#include "utils/InputStream.hpp"
 #include <cstring>
 #include <fstream>
 using namespace std;
@@ -45,14 +47,21 @@ read_int(char* p, int* i)
 void
 readfile(const char* file, int* vars, int* clauses, std::vector<std::vector<int>>& clause)
 {
-	std::string infile(file);
-	std::ifstream fin(infile);
-	fin.seekg(0, fin.end);
-	size_t file_len = fin.tellg();
-	fin.seekg(0, fin.beg);
-	char* data = new char[file_len + 1];
-	fin.read(data, file_len);
-	fin.close();
+	// The input may be compressed, its size is unknown
+	std::unique_ptr<Parsers::InputStream> fin = Parsers::InputStream::open(file);
+	if (!fin)
+		exit(PERR_PARSING);
+	std::vector<char> buffer;
+	size_t file_len = 0;
+	do {
+		buffer.resize(file_len + (1 << 20) + 1);
+		file_len += fin->read(buffer.data() + file_len, 1 << 20);
+	} while (file_len == buffer.size() - 1);
+	if (fin->hasFailed())
+		exit(PERR_PARSING);
+	fin.reset();
+	buffer.resize(file_len + 1);
+	char* data = buffer.data();
 	data[file_len] = '\0';
 	char* p = data;
 	clause.emplace_back();
@@ -83,7 +92,6 @@ readfile(const char* file, int* vars, int* clauses, std::vector<std::vector<int>
 		// printf("c parse warning: clauses: %d, real clauses: %d\n", clauses, num_clauses - 1);
 		*clauses = num_clauses - 1;
 	}
-	delete[] data;
 }
 
 // void preprocess::write_cnf() {
@@ -0,0 +1,136 @@
+#include "simulator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SIMD_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define SIMD_CLONES
+#endif
+
+/// Words of a gate evaluated by a thread at once
+static const size_t BLOCK_WORDS = 2048;
+
+/// Under this number of words to evaluate, the simulation is not worth threads
+static const size_t PARALLEL_MIN_WORDS = 1 << 16;
+
+SIMD_CLONES static void
+andWords(ull* __restrict out, const ull* __restrict u, const ull* __restrict v, size_t n, ull mu, ull mv, ull mo)
+{
+	for (size_t i = 0; i < n; i++)
+		out[i] = ((u[i] ^ mu) & (v[i] ^ mv)) ^ mo;
+}
+
+SIMD_CLONES static void
+xorWords(ull* __restrict out, const ull* __restrict u, const ull* __restrict v, size_t n, ull m)
+{
+	for (size_t i = 0; i < n; i++)
+		out[i] = u[i] ^ v[i] ^ m;
+}
+
+CircuitSimulator::~CircuitSimulator()
+{
+	std::free(arena);
+}
+
+void
+CircuitSimulator::build(const std::vector<int>& inputs, const std::vector<SimGate>& topoGates, int maxvar, size_t words)
+{
+	this->words = words;
+	slot.assign(maxvar + 1, -1);
+
+	long slots = 0;
+	std::vector<int> level(maxvar + 1, 0);
+	for (int v : inputs)
+		slot[v] = slots++;
+
+	int maxLevel = 0;
+	for (const SimGate& gate : topoGates) {
+		int out = abs(gate.out);
+		slot[out] = slots++;
+		level[out] = 1 + std::max(level[abs(gate.in0)], level[abs(gate.in1)]);
+		maxLevel = std::max(maxLevel, level[out]);
+	}
+
+	// Counting sort of the gates by level, keeping their order inside a level
+	levelStart.assign(maxLevel + 2, 0);
+	for (const SimGate& gate : topoGates)
+		levelStart[level[abs(gate.out)] + 1]++;
+	for (int l = 1; l <= maxLevel + 1; l++)
+		levelStart[l] += levelStart[l - 1];
+	levelStart.erase(levelStart.begin());
+
+	gates.resize(topoGates.size());
+	std::vector<size_t> cursor(levelStart.begin(), levelStart.end() - 1);
+	for (const SimGate& gate : topoGates)
+		gates[cursor[level[abs(gate.out)] - 1]++] = gate;
+
+	std::free(arena);
+	// aligned_alloc requires a size multiple of the alignment
+	size_t bytes = std::max<size_t>(1, slots * words) * sizeof(ull);
+	arena = static_cast<ull*>(std::aligned_alloc(64, (bytes + 63) & ~size_t(63)));
+	if (!arena)
+		throw std::bad_alloc();
+}
+
+void
+CircuitSimulator::evaluate(const SimGate& gate, size_t begin, size_t end)
+{
+	ull* out = signature(abs(gate.out)) + begin;
+	const ull* u = signature(abs(gate.in0)) + begin;
+	const ull* v = signature(abs(gate.in1)) + begin;
+	ull mu = (gate.in0 < 0) ? ~0ULL : 0;
+	ull mv = (gate.in1 < 0) ? ~0ULL : 0;
+	ull mo = (gate.out < 0) ? ~0ULL : 0;
+
+	if (gate.isXor)
+		xorWords(out, u, v, end - begin, mu ^ mv ^ mo);
+	else
+		andWords(out, u, v, end - begin, mu, mv, mo);
+}
+
+void
+CircuitSimulator::simulate(unsigned threads)
+{
+	if (threads <= 1 || gates.size() * words < PARALLEL_MIN_WORDS) {
+		for (const SimGate& gate : gates)
+			evaluate(gate, 0, words);
+		return;
+	}
+
+	const size_t blocksPerGate = (words + BLOCK_WORDS - 1) / BLOCK_WORDS;
+	const size_t levels = getLevels();
+
+	size_t level = 0;
+	std::atomic<size_t> nextTask(0);
+
+	// The completion step of the barrier moves all the threads to the next level
+	std::barrier sync(threads, [&]() noexcept {
+		level++;
+		nextTask.store(0, std::memory_order_relaxed);
+	});
+
+	auto worker = [&]() {
+		while (level < levels) {
+			size_t first = levelStart[level];
+			size_t tasks = (levelStart[level + 1] - first) * blocksPerGate;
+			for (size_t task = nextTask++; task < tasks; task = nextTask++) {
+				size_t begin = (task % blocksPerGate) * BLOCK_WORDS;
+				evaluate(gates[first + task / blocksPerGate], begin, std::min(words, begin + BLOCK_WORDS));
+			}
+			sync.arrive_and_wait();
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned i = 1; i < threads; i++)
+		pool.emplace_back(worker);
+	worker();
+	for (auto& thread : pool)
+		thread.join();
+}
@@ -0,0 +1,73 @@
+#ifndef SIMULATOR_H_
+#define SIMULATOR_H_
+
+#include <cstddef>
+#include <vector>
+
+typedef unsigned long long ull;
+
+/**
+ * @brief Gate of the simulated circuit, out = in0 AND in1 or out = in0 XOR in1.
+ * @details Inputs are signed literals, a negative output complements the result (as in the Bitset ands/xors).
+ */
+struct SimGate
+{
+	int out, in0, in1;
+	bool isXor;
+};
+
+/**
+ * @brief Bit-parallel simulation of an AND/XOR circuit.
+ *
+ * All the signatures (one bit per simulated input pattern) are stored in one contiguous 64-byte aligned arena. The
+ * gates are grouped by topological level, the gates of a level being independent they are evaluated by several
+ * threads, each one taking blocks of words. The word loops are compiled for AVX-512, AVX2 and a generic x86-64 target
+ * and the best version is selected at load time.
+ * @ingroup preproc_solving
+ */
+class CircuitSimulator
+{
+  public:
+	CircuitSimulator() = default;
+	~CircuitSimulator();
+
+	CircuitSimulator(const CircuitSimulator&) = delete;
+	CircuitSimulator& operator=(const CircuitSimulator&) = delete;
+
+	/**
+	 * @brief Allocate the arena and compute the levels.
+	 * @param inputs The input variables, their signature is to be filled by the caller before simulate().
+	 * @param gates The gates in a topological order, each gate only reads inputs or outputs of previous gates.
+	 * @param maxvar The greatest variable of the circuit.
+	 * @param words Number of 64-bit words per signature.
+	 */
+	void build(const std::vector<int>& inputs, const std::vector<SimGate>& gates, int maxvar, size_t words);
+
+	/// Signature of a variable, nullptr if it is neither an input nor the output of a gate.
+	ull* signature(int var) { return (slot[var] < 0) ? nullptr : arena + slot[var] * words; }
+
+	/// Evaluate all the gates, level by level.
+	void simulate(unsigned threads);
+
+	size_t getWords() const { return words; }
+
+	size_t getLevels() const { return levelStart.size() - 1; }
+
+  private:
+	/// Evaluate words [begin, end) of a gate
+	void evaluate(const SimGate& gate, size_t begin, size_t end);
+
+	ull* arena = nullptr;
+	size_t words = 0;
+
+	/// Slot of each variable in the arena, -1 if not simulated
+	std::vector<long> slot;
+
+	/// Gates sorted by level
+	std::vector<SimGate> gates;
+
+	/// Gates of level l are gates[levelStart[l], levelStart[l+1])
+	std::vector<size_t> levelStart;
+};
+
+#endif
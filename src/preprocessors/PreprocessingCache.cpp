@@ -0,0 +1,310 @@
+#include "preprocessors/PreprocessingCache.hpp"
+#include "utils/Logger.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/System.hpp"
+#include "utils/hashfunc.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Generated by the Makefile, rewritten each time a preprocessor source changes
+#include "PreprocessorsHash.hpp"
+
+/// Incremented at each change of the entry layout or of a reconstruction state
+static const uint32_t CACHE_FORMAT_VERSION = 1;
+
+static const char CACHE_MAGIC[8] = { 'P', 'L', 'S', 'P', 'R', 'E', 'P', '\0' };
+
+static const size_t HASH_CHUNK_SIZE = 1 << 20;
+
+/// Fowler-Noll-Vo hash of a buffer, continued from hash
+static uint64_t
+hashBytes(uint64_t hash, const unsigned char* bytes, size_t size)
+{
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= fnv<uint64_t>::prime;
+	}
+	return hash;
+}
+
+/// Values of the parameters changing the result of the preprocessing, and the hash of the preprocessor sources
+static std::string
+preprocessingConfig()
+{
+	std::ostringstream config;
+	config << PAINLESS_PREPROCESSORS_HASH << ';' << CACHE_FORMAT_VERSION << ';';
+
+#define PARAM(name, type, parsed_name, default_value, description)                                                     \
+	if (std::strncmp(parsed_name, "prs", 3) == 0 || std::strncmp(parsed_name, "bve", 3) == 0)                          \
+		config << parsed_name << '=' << __globalParameters__.name << ';';
+#define CATEGORY(description)
+#define SUBCATEGORY(description)
+	PARAMETERS
+#undef PARAM
+#undef CATEGORY
+#undef SUBCATEGORY
+
+	return config.str();
+}
+
+PreprocessingCache::PreprocessingCache(const std::string& directory, const std::string& filename)
+	: m_directory(directory)
+{
+	static_assert(sizeof(Header) % sizeof(uint64_t) == 0, "The data following the header must stay aligned");
+
+	double start = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	std::error_code error;
+	std::filesystem::create_directories(m_directory, error);
+	if (error) {
+		LOGWARN("Cannot create the preprocessing cache directory %s: %s", m_directory.c_str(), error.message().c_str());
+		return;
+	}
+
+	FILE* file = std::fopen(filename.c_str(), "rb");
+	if (!file) {
+		LOGWARN("Cannot read %s, the preprocessing cache is disabled", filename.c_str());
+		return;
+	}
+
+	std::vector<unsigned char> buffer(HASH_CHUNK_SIZE);
+	uint64_t hash = fnv<uint64_t>::init;
+	size_t read;
+	while ((read = std::fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+		hash = hashBytes(hash, buffer.data(), read);
+		m_formulaSize += read;
+	}
+	std::fclose(file);
+	m_formulaHash = hash;
+
+	std::string config = preprocessingConfig();
+	m_configHash = hashBytes(fnv<uint64_t>::init, reinterpret_cast<const unsigned char*>(config.data()), config.size());
+
+	char name[64];
+	std::snprintf(name, sizeof(name), "%016lx-%016lx.prep", (unsigned long)m_formulaHash, (unsigned long)m_configHash);
+	m_path = (std::filesystem::path(m_directory) / name).string();
+
+	m_hashTime = SystemResourceMonitor::getRelativeTimeSeconds() - start;
+	LOGDEBUG1("[PrepCache] key %s, config '%s'", name, config.c_str());
+}
+
+bool
+PreprocessingCache::load(const std::vector<std::shared_ptr<PreprocessorInterface>>& preprocessors,
+						 SatResult& result,
+						 std::shared_ptr<const FormulaArena>& formula,
+						 unsigned int& varCount,
+						 unsigned int& clausesCount)
+{
+	if (m_path.empty())
+		return false;
+
+	double start = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	int fd = open(m_path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		m_misses++;
+		updateDirectoryStats(false, 0);
+		LOG0("[PrepCache] miss for %s", m_path.c_str());
+		return false;
+	}
+
+	struct stat fileStat;
+	void* mapping = MAP_FAILED;
+	size_t size = 0;
+	if (fstat(fd, &fileStat) == 0 && fileStat.st_size >= (off_t)sizeof(Header)) {
+		size = fileStat.st_size;
+		mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	close(fd);
+
+	bool valid = false;
+	if (mapping != MAP_FAILED) {
+		const char* data = static_cast<const char*>(mapping);
+		Header header;
+		std::memcpy(&header, data, sizeof(Header));
+
+		const uint64_t* stateSizes = reinterpret_cast<const uint64_t*>(data + sizeof(Header));
+		const size_t expectedStates =
+			(header.result == static_cast<int32_t>(SatResult::UNSAT)) ? 0 : preprocessors.size();
+
+		valid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+				header.formatVersion == CACHE_FORMAT_VERSION && header.formulaHash == m_formulaHash &&
+				header.formulaSize == m_formulaSize && header.configHash == m_configHash &&
+				(header.result == static_cast<int32_t>(SatResult::UNKNOWN) ||
+				 header.result == static_cast<int32_t>(SatResult::UNSAT)) &&
+				header.statesCount == expectedStates &&
+				size >= sizeof(Header) + header.statesCount * sizeof(uint64_t);
+
+		// All the sizes are checked against the file size before reading the literals and the states
+		uint64_t intsCount = header.literalsCount;
+		for (size_t i = 0; valid && i < header.statesCount; i++)
+			intsCount += stateSizes[i];
+		valid = valid && size == sizeof(Header) + header.statesCount * sizeof(uint64_t) + intsCount * sizeof(int);
+
+		// The literals are checked in place, the arena is their only copy
+		const int* ints = reinterpret_cast<const int*>(stateSizes + header.statesCount);
+		const int* literals = ints;
+		if (valid) {
+			valid = (uint64_t)std::count(literals, literals + header.literalsCount, 0) == header.clausesCount &&
+					(header.literalsCount == 0 || literals[header.literalsCount - 1] == 0);
+			ints += header.literalsCount;
+		}
+
+		for (size_t i = 0; valid && i < header.statesCount; i++) {
+			valid = preprocessors[i]->loadReconstruction(ints, stateSizes[i]);
+			ints += stateSizes[i];
+		}
+
+		if (valid && header.result == static_cast<int32_t>(SatResult::UNKNOWN))
+			formula = FormulaArena::create(literals, header.literalsCount, header.clausesCount, header.varCount);
+
+		if (valid) {
+			result = static_cast<SatResult>(header.result);
+			varCount = header.varCount;
+			clausesCount = header.clausesCount;
+		}
+		munmap(mapping, size);
+	}
+
+	double loadTime = SystemResourceMonitor::getRelativeTimeSeconds() - start;
+	if (!valid) {
+		LOGWARN("[PrepCache] invalid entry %s, it will be replaced", m_path.c_str());
+		formula.reset();
+		m_misses++;
+		updateDirectoryStats(false, 0);
+		return false;
+	}
+
+	m_hits++;
+	m_loadTime += loadTime;
+	updateDirectoryStats(true, loadTime);
+	LOG0("[PrepCache] hit for %s: %u vars, %u clauses loaded in %.3fs",
+		 m_path.c_str(),
+		 varCount,
+		 clausesCount,
+		 loadTime);
+	return true;
+}
+
+void
+PreprocessingCache::store(const std::vector<std::shared_ptr<PreprocessorInterface>>& preprocessors,
+						  SatResult result,
+						  const std::vector<lit_t>& literals,
+						  unsigned int varCount,
+						  unsigned int clausesCount)
+{
+	if (m_path.empty() || (result != SatResult::UNKNOWN && result != SatResult::UNSAT))
+		return;
+
+	double start = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	// Neither the formula nor the reconstruction states are needed to answer UNSAT again
+	const bool unsat = result == SatResult::UNSAT;
+	std::vector<std::vector<int>> states(unsat ? 0 : preprocessors.size());
+	for (size_t i = 0; i < states.size(); i++) {
+		if (!preprocessors[i]->saveReconstruction(states[i])) {
+			LOGWARN("[PrepCache] preprocessor %zu cannot be cached, nothing is stored", i);
+			return;
+		}
+	}
+
+	Header header;
+	std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.formatVersion = CACHE_FORMAT_VERSION;
+	header.result = static_cast<int32_t>(result);
+	header.formulaHash = m_formulaHash;
+	header.formulaSize = m_formulaSize;
+	header.configHash = m_configHash;
+	header.varCount = unsat ? 0 : varCount;
+	header.clausesCount = unsat ? 0 : clausesCount;
+	header.literalsCount = unsat ? 0 : literals.size();
+	header.statesCount = states.size();
+
+	std::vector<uint64_t> stateSizes;
+	for (const std::vector<int>& state : states)
+		stateSizes.push_back(state.size());
+
+	// Concurrent runs write their own temporary file, the rename is atomic
+	std::string temporary = m_path + ".tmp." + std::to_string(getpid());
+	FILE* file = std::fopen(temporary.c_str(), "wb");
+	if (!file) {
+		LOGWARN("[PrepCache] cannot write %s", temporary.c_str());
+		return;
+	}
+
+	bool written = std::fwrite(&header, sizeof(Header), 1, file) == 1 &&
+				   std::fwrite(stateSizes.data(), sizeof(uint64_t), stateSizes.size(), file) == stateSizes.size() &&
+				   std::fwrite(literals.data(), sizeof(lit_t), header.literalsCount, file) == header.literalsCount;
+	for (const std::vector<int>& state : states)
+		written = written && std::fwrite(state.data(), sizeof(int), state.size(), file) == state.size();
+	written = (std::fclose(file) == 0) && written;
+
+	std::error_code error;
+	if (written)
+		std::filesystem::rename(temporary, m_path, error);
+	if (!written || error) {
+		LOGWARN("[PrepCache] cannot write %s", m_path.c_str());
+		std::filesystem::remove(temporary, error);
+		return;
+	}
+
+	m_stores++;
+	m_storeTime += SystemResourceMonitor::getRelativeTimeSeconds() - start;
+	LOG0("[PrepCache] stored %s in %.3fs", m_path.c_str(), m_storeTime);
+}
+
+void
+PreprocessingCache::updateDirectoryStats(bool hit, double loadTime)
+{
+	std::string path = (std::filesystem::path(m_directory) / "stats").string();
+	int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0)
+		return;
+
+	// The runs sharing the directory update the file one at a time
+	if (flock(fd, LOCK_EX) == 0) {
+		char text[128] = { 0 };
+		if (pread(fd, text, sizeof(text) - 1, 0) > 0)
+			std::sscanf(text, "%lu %lu %lf", &m_totalHits, &m_totalMisses, &m_totalLoadTime);
+
+		if (hit) {
+			m_totalHits++;
+			m_totalLoadTime += loadTime;
+		} else {
+			m_totalMisses++;
+		}
+
+		int length =
+			std::snprintf(text, sizeof(text), "%lu %lu %.6f\n", m_totalHits, m_totalMisses, m_totalLoadTime);
+		if (ftruncate(fd, 0) != 0 || pwrite(fd, text, length, 0) != length)
+			LOGWARN("[PrepCache] cannot update %s", path.c_str());
+		flock(fd, LOCK_UN);
+	}
+	close(fd);
+}
+
+void
+PreprocessingCache::printStats()
+{
+	LOGSTAT("[PrepCache] hits %lu, misses %lu, stores %lu, hash time %.3fs, load time %.3fs, store time %.3fs",
+			m_hits,
+			m_misses,
+			m_stores,
+			m_hashTime,
+			m_loadTime,
+			m_storeTime);
+	LOGSTAT("[PrepCache] all runs: hits %lu, misses %lu, mean load time %.3fs",
+			m_totalHits,
+			m_totalMisses,
+			m_totalHits ? m_totalLoadTime / m_totalHits : 0.0);
+}
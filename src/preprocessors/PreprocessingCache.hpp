@@ -0,0 +1,102 @@
+#pragma once
+
+#include "containers/FormulaArena.hpp"
+#include "preprocessors/PreprocessorInterface.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief On-disk cache of the preprocessing results, so that PRS and BVE run only once on a given formula.
+ *
+ * An entry is keyed by a hash of the formula file, the preprocessing parameters (prs* and bve*) and a hash of the
+ * preprocessor sources, generated by the Makefile. It holds the result of the preprocessing (UNKNOWN or UNSAT), the simplified formula as zero terminated
+ * clauses and the reconstruction state of each preprocessor (see PreprocessorInterface::saveReconstruction()), in
+ * a binary file loaded with mmap. An entry is written to a temporary file then renamed, so that concurrent runs
+ * never read a partial entry.
+ *
+ * The hits, misses and load times are logged, and summed over all the runs in a stats file of the cache directory.
+ * @ingroup preproc_solving
+ */
+class PreprocessingCache
+{
+  public:
+	/**
+	 * @brief Compute the key of the formula for the current parameters.
+	 * @param directory The cache directory, created if needed.
+	 * @param filename The formula file.
+	 */
+	PreprocessingCache(const std::string& directory, const std::string& filename);
+
+	/**
+	 * @brief Look for the entry of the formula and load it.
+	 * @param preprocessors The preprocessors whose reconstruction state is loaded, in the order they ran.
+	 * @param result Set to UNKNOWN or UNSAT.
+	 * @param formula Set to the simplified formula, copied once from the mapped entry (null for UNSAT).
+	 * @param varCount Set to the number of variables of the simplified formula.
+	 * @param clausesCount Set to the number of clauses of the simplified formula.
+	 * @return false on a miss or an invalid entry.
+	 */
+	bool load(const std::vector<std::shared_ptr<PreprocessorInterface>>& preprocessors,
+			  SatResult& result,
+			  std::shared_ptr<const FormulaArena>& formula,
+			  unsigned int& varCount,
+			  unsigned int& clausesCount);
+
+	/**
+	 * @brief Write the entry of the formula.
+	 * @details Only UNKNOWN and UNSAT results are stored, only the result is stored for UNSAT.
+	 */
+	void store(const std::vector<std::shared_ptr<PreprocessorInterface>>& preprocessors,
+			   SatResult result,
+			   const std::vector<lit_t>& literals,
+			   unsigned int varCount,
+			   unsigned int clausesCount);
+
+	/// Print the statistics of this run and of all the runs using the cache directory.
+	void printStats();
+
+  private:
+	/// Header of an entry, followed by the sizes of the reconstruction states, the literals and the states
+	struct Header
+	{
+		char magic[8];
+		uint32_t formatVersion;
+		int32_t result;
+		uint64_t formulaHash;
+		uint64_t formulaSize;
+		uint64_t configHash;
+		uint32_t varCount;
+		uint32_t clausesCount;
+		uint64_t literalsCount;
+		uint64_t statesCount;
+	};
+
+	/// Add a hit or a miss and its load time to the stats file of the directory, under a file lock
+	void updateDirectoryStats(bool hit, double loadTime);
+
+	std::string m_directory;
+
+	/// Path of the entry, empty if the formula file could not be read
+	std::string m_path;
+
+	uint64_t m_formulaHash = 0;
+	uint64_t m_formulaSize = 0;
+	uint64_t m_configHash = 0;
+
+	// Stats
+	//------
+	unsigned long m_hits = 0;
+	unsigned long m_misses = 0;
+	unsigned long m_stores = 0;
+	double m_hashTime = 0;
+	double m_loadTime = 0;
+	double m_storeTime = 0;
+
+	/// Sums over the runs, read back from the stats file
+	unsigned long m_totalHits = 0;
+	unsigned long m_totalMisses = 0;
+	double m_totalLoadTime = 0;
+};
@@ -25,7 +25,8 @@ enum PreprocessorAlgorithm
 	MIX = 0,
 	BVA = 1,
 	BVE = 2,
-	GAUSS = 3
+	GAUSS = 3,
+	SYMMETRY = 4
 	/* To fill */
 };
 
@@ -73,6 +74,21 @@ class PreprocessorInterface : public SolverInterface
 	 */
 	virtual void releaseMemory() = 0;
 
+	/**
+	 * @brief Serialize the state used by restoreModel(), for the preprocessing cache.
+	 * @param data The state is appended to it.
+	 * @return false if the preprocessor does not support the cache.
+	 */
+	virtual bool saveReconstruction(std::vector<int>&) { return false; }
+
+	/**
+	 * @brief Load a state saved by saveReconstruction(), restoreModel() is then the only supported operation.
+	 * @param data The saved state.
+	 * @param size Number of integers of the saved state.
+	 * @return false if the state is not valid.
+	 */
+	virtual bool loadReconstruction(const int*, size_t) { return false; }
+
   private:
 	PreprocessorAlgorithm preProcType; ///< The type of preprocessor algorithm used.
 };
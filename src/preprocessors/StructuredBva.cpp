@@ -2,26 +2,95 @@
 #include "utils/ErrorCodes.hpp"
 #include "utils/NumericConstants.hpp"
 #include "utils/Parameters.hpp"
+#include <algorithm>
+#include <climits>
 #include <random>
+#include <thread>
 #include <unordered_set>
 
-bool
-decreasingOrder(const queuePair& lhs, const queuePair& rhs)
+/// Variables whose adjacency is computed at once by a thread of buildAdjacency()
+static const int ADJACENCY_CHUNK = 1024;
+
+void
+SBVALitQueue::init(SBVAOrder order, unsigned int seed)
 {
-	return lhs.occurencesCount < rhs.occurencesCount;
+	this->order = order;
+	this->buckets.clear();
+	this->bucketOf.clear();
+	this->positionOf.clear();
+	this->front = (order == SBVAOrder::INCREASING) ? UINT32_MAX : 0;
+	this->size = 0;
+	this->rng.seed(seed);
 }
 
-bool
-increasingOrder(const queuePair& lhs, const queuePair& rhs)
+void
+SBVALitQueue::remove(int lit)
 {
-	return lhs.occurencesCount > rhs.occurencesCount;
+	unsigned int idx = LIT_IDX(lit);
+	std::vector<int>& bucket = this->buckets[this->bucketOf[idx]];
+
+	/* Swap with the last literal of the bucket */
+	int last = bucket.back();
+	bucket[this->positionOf[idx]] = last;
+	this->positionOf[LIT_IDX(last)] = this->positionOf[idx];
+	bucket.pop_back();
+
+	this->bucketOf[idx] = -1;
+	this->size--;
 }
 
-bool
-randomOrder(const queuePair& lhs, const queuePair& rhs)
+void
+SBVALitQueue::update(int lit, unsigned int count)
 {
-	std::srand(lhs.lit);
-	return std::rand() % 2 == 0;
+	unsigned int idx = LIT_IDX(lit);
+	if (idx >= this->bucketOf.size()) {
+		this->bucketOf.resize(idx + 2, -1);
+		this->positionOf.resize(idx + 2);
+	}
+
+	if (this->bucketOf[idx] >= 0)
+		this->remove(lit);
+
+	if (!count)
+		return;
+
+	unsigned int bucket = (this->order == SBVAOrder::RANDOM) ? 0 : count;
+	if (bucket >= this->buckets.size())
+		this->buckets.resize(bucket + 1);
+
+	this->bucketOf[idx] = bucket;
+	this->positionOf[idx] = this->buckets[bucket].size();
+	this->buckets[bucket].push_back(lit);
+	this->size++;
+
+	if (this->order == SBVAOrder::DECREASING)
+		this->front = std::max(this->front, bucket);
+	else if (this->order == SBVAOrder::INCREASING)
+		this->front = std::min(this->front, bucket);
+}
+
+int
+SBVALitQueue::pop()
+{
+	assert(this->size > 0);
+	int lit;
+
+	if (this->order == SBVAOrder::RANDOM) {
+		std::vector<int>& bucket = this->buckets[0];
+		lit = bucket[this->rng() % bucket.size()];
+	} else {
+		if (this->order == SBVAOrder::DECREASING) {
+			while (this->buckets[this->front].empty())
+				this->front--;
+		} else {
+			while (this->buckets[this->front].empty())
+				this->front++;
+		}
+		lit = this->buckets[this->front].back();
+	}
+
+	this->remove(lit);
+	return lit;
 }
 
 StructuredBVA::StructuredBVA(int _id, unsigned long maxReplacements, bool shuffleTies)
@@ -37,9 +106,15 @@ StructuredBVA::StructuredBVA(int _id, unsigned long maxReplacements, bool shuffl
 	this->shuffleTies = shuffleTies;
 	this->generateProof = false;
 	this->preserveModelCount = false;
+	this->litOrder = SBVAOrder::DECREASING;
 	this->tieBreakHeuristic = SBVATieBreak::THREEHOPS;
-	this->breakTie = std::bind(&StructuredBVA::threeHopTieBreak, this, std::placeholders::_1, std::placeholders::_2);
+	this->breakTie = std::bind(&StructuredBVA::threeHopTieBreak,
+							   this,
+							   std::placeholders::_1,
+							   std::placeholders::_2,
+							   std::placeholders::_3);
 	this->shuffleTies = false;
+	this->threads = std::max(1, __globalParameters__.sbvaThreads);
 	this->stopPreprocessing = false;
 
 	/* Stats */
@@ -75,83 +150,122 @@ StructuredBVA::unsetSolverInterrupt()
 }
 
 void
-StructuredBVA::updateAdjacencyMatrix(int var)
+StructuredBVA::buildAdjacency()
 {
-	assert(var > 0);
-	if (this->adjacencyMatrix[MATRIX_VAR_TO_IDX(var)].nonZeros() > 0) {
-		// already done (it is cleared when needed, a var is added)
-		return;
-	}
-
-	Eigen::SparseVector<int> vec(this->adjacencyMatrixWidth);
-
-	/* For each clause in occurence list, update the number of times, lit is in the same clause with other literals*/
-	for (unsigned int clauseIdx : this->litToClause[PLIT_IDX(var)]) {
-		if (this->isClauseDeleted[clauseIdx]) {
-			continue;
+	this->adjacency.assign(this->varCount + 1, {});
+	std::atomic<int> nextVar(1);
+
+	/* Each thread computes the rows of chunks of variables, a row only reads the occurence lists of its variable */
+	auto worker = [this, &nextVar]() {
+		std::vector<int> counts(this->varCount + 1, 0);
+		std::vector<int> neighbors;
+
+		for (int first = nextVar.fetch_add(ADJACENCY_CHUNK); first <= (int)this->varCount;
+			 first = nextVar.fetch_add(ADJACENCY_CHUNK)) {
+			int last = std::min(first + ADJACENCY_CHUNK - 1, (int)this->varCount);
+
+			for (int var = first; var <= last; var++) {
+				/* For each clause of var or -var, count the clauses shared with the other variables */
+				for (int lit : { var, -var }) {
+					for (unsigned int clauseIdx : this->litToClause[LIT_IDX(lit)]) {
+						if (this->isClauseDeleted[clauseIdx])
+							continue;
+						for (int other : this->clauses[clauseIdx]) {
+							if (!counts[std::abs(other)]++)
+								neighbors.push_back(std::abs(other));
+						}
+					}
+				}
+
+				std::sort(neighbors.begin(), neighbors.end());
+				std::vector<std::pair<int, int>>& row = this->adjacency[var];
+				row.reserve(neighbors.size());
+				for (int neighbor : neighbors) {
+					row.emplace_back(neighbor, counts[neighbor]);
+					counts[neighbor] = 0;
+				}
+				neighbors.clear();
+			}
 		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < this->threads; i++)
+		pool.emplace_back(worker);
+	worker();
+	for (auto& thread : pool)
+		thread.join();
+}
 
-		for (int lit : this->clauses[clauseIdx]) {
-			vec.coeffRef(MATRIX_LIT_TO_IDX(lit))++;
+void
+StructuredBVA::updateAdjacency(const simpleClause& clause, int delta)
+{
+	for (int lit : clause) {
+		std::vector<std::pair<int, int>>& row = this->adjacency[std::abs(lit)];
+
+		for (int other : clause) {
+			int var = std::abs(other);
+			auto it = std::lower_bound(row.begin(), row.end(), std::make_pair(var, INT_MIN));
+			if (it != row.end() && it->first == var)
+				it->second += delta;
+			else
+				row.emplace(it, var, delta);
 		}
 	}
+}
 
-	/* Same for negative lit*/
-	for (unsigned int clauseIdx : this->litToClause[NLIT_IDX(-var)]) {
-		if (this->isClauseDeleted[clauseIdx]) {
-			continue;
-		}
-		for (int lit : this->clauses[clauseIdx]) {
-			vec.coeffRef(MATRIX_LIT_TO_IDX(lit))++;
-		}
+/// Sum of the products of the counts of the variables in both rows
+static unsigned int
+adjacencyDot(const std::vector<std::pair<int, int>>& row1, const std::vector<std::pair<int, int>>& row2)
+{
+	unsigned int dot = 0;
+	auto it1 = row1.begin(), it2 = row2.begin();
+
+	while (it1 != row1.end() && it2 != row2.end()) {
+		if (it1->first < it2->first)
+			it1++;
+		else if (it2->first < it1->first)
+			it2++;
+		else
+			dot += (it1++)->second * (it2++)->second;
 	}
-
-	this->adjacencyMatrix[MATRIX_VAR_TO_IDX(var)] = std::move(vec);
+	return dot;
 }
 
 unsigned int
-StructuredBVA::getThreeHopHeuristic(int lit1, int lit2)
+StructuredBVA::getThreeHopHeuristic(int lit1, int lit2, SBVAScratch& scratch)
 {
 	unsigned int var1 = std::abs(lit1);
 	unsigned int var2 = std::abs(lit2);
 
 	/* If lit2 has its total_count already computed*/
-	if (this->tempTieHeuristicCache.find(MATRIX_VAR_TO_IDX(var2)) != this->tempTieHeuristicCache.end()) {
-		return this->tempTieHeuristicCache[MATRIX_VAR_TO_IDX(var2)];
+	auto cached = scratch.threeHopCache.find(var2);
+	if (cached != scratch.threeHopCache.end()) {
+		return cached->second;
 	}
-	/* Update_adjacency matrix here since there may be added variables */
-
-	this->updateAdjacencyMatrix(var1); /* update in case needed */
-	this->updateAdjacencyMatrix(var2); /* update in case needed */
 
-	Eigen::SparseVector<int>& vec1 = this->adjacencyMatrix[MATRIX_VAR_TO_IDX(var1)];
-	Eigen::SparseVector<int>& vec2 = this->adjacencyMatrix[MATRIX_VAR_TO_IDX(var2)];
+	const std::vector<std::pair<int, int>>& vec1 = this->adjacency[var1];
+	const std::vector<std::pair<int, int>>& vec2 = this->adjacency[var2];
 
 	unsigned int totalCount = 0;
-	unsigned int var;
-	unsigned int count;
 
 	/* For each neighbor of var2 */
-	for (int* idxPtr = vec2.innerIndexPtr(); idxPtr < vec2.innerIndexPtr() + vec2.nonZeros(); idxPtr++) {
-		// *idxPtr is a matrix index
-		var = MATRIX_IDX_TO_VAR(*idxPtr);
-		count = vec2.coeffRef(*idxPtr);
-
-		this->updateAdjacencyMatrix(var); /* update if needed: source of bug */
-		Eigen::SparseVector<int>* vec3 = &this->adjacencyMatrix[*idxPtr];
+	for (const auto& [var, count] : vec2) {
+		if (!count)
+			continue;
 		/* dot : returns the sum of products of the adjacencies of neighbors var and var2 have in common
 				The sum is then multiplied by the adjency of var2 with var */
 		/* the more var and var1 have the same neighbors, the greater the weight. And the more var2 is connected to var,
 		 * the greater the weight*/
-		totalCount += count * vec3->dot(vec1);
+		totalCount += count * adjacencyDot(this->adjacency[var], vec1);
 	}
 
-	this->tempTieHeuristicCache[MATRIX_VAR_TO_IDX(var2)] = totalCount;
+	scratch.threeHopCache[var2] = totalCount;
 	return totalCount;
 }
 
 int
-StructuredBVA::leastFrequentLiteral(simpleClause& clause, int elit)
+StructuredBVA::leastFrequentLiteral(const simpleClause& clause, int elit)
 {
 	int leastOccuringLit = 0;
 	int occurenceCount = INT32_MAX;
@@ -184,7 +298,6 @@ StructuredBVA::addInitialClauses(const std::vector<simpleClause>& initClauses, u
 	this->clauses.reserve(nbClauses);
 	this->isClauseDeleted.reserve(nbClauses);
 	this->litToClause.resize(2 * nbVariables);
-	this->litCountAdjustement.resize(2 * nbVariables);
 
 	for (unsigned int i = 0; i < nbClauses && !this->stopPreprocessing; i++) {
 		tmpClause = initClauses[i];
@@ -208,19 +321,8 @@ StructuredBVA::addInitialClauses(const std::vector<simpleClause>& initClauses, u
 		return;
 	}
 
-	this->adjacencyMatrixWidth = nbVariables * 4;
-
-	if (this->tieBreakHeuristic == SBVATieBreak::THREEHOPS) {
-		adjacencyMatrix.resize(nbVariables);
-		for (unsigned int i = 1; i < this->varCount; i++) {
-			this->updateAdjacencyMatrix(i);
-		}
-	}
-
-	if (this->stopPreprocessing) {
-		LOGDEBUG1("[SBVA %d] stopped at addInitialClauses after updateMatrices", this->getSolverId());
-		return;
-	}
+	/* The adjacency of the 3HOP heuristic is built by solve() since diversify() may choose another heuristic */
+	this->initLitCounts();
 
 	this->varCount = nbVariables;
 	this->m_initialized = true;
@@ -238,7 +340,6 @@ void StructuredBVA::addInitialClauses(const lit_t *literals, unsigned int nbClau
 	this->clauses.reserve(nbClauses);
 	this->isClauseDeleted.reserve(nbClauses);
 	this->litToClause.resize(2 * nbVariables);
-	this->litCountAdjustement.resize(2 * nbVariables);
 
 	for (unsigned int i = 0; i < nbClauses && !this->stopPreprocessing; i++) {
 		tmpClause.clear();
@@ -267,19 +368,8 @@ void StructuredBVA::addInitialClauses(const lit_t *literals, unsigned int nbClau
 		return;
 	}
 
-	this->adjacencyMatrixWidth = nbVariables * 4;
-
-	if (this->tieBreakHeuristic == SBVATieBreak::THREEHOPS) {
-		adjacencyMatrix.resize(nbVariables);
-		for (unsigned int i = 1; i < this->varCount; i++) {
-			this->updateAdjacencyMatrix(i);
-		}
-	}
-
-	if (this->stopPreprocessing) {
-		LOGDEBUG1("[SBVA %d] stopped at addInitialClauses after updateMatrices", this->getSolverId());
-		return;
-	}
+	/* The adjacency of the 3HOP heuristic is built by solve() since diversify() may choose another heuristic */
+	this->initLitCounts();
 
 	this->varCount = nbVariables;
 	this->m_initialized = true;
@@ -304,15 +394,21 @@ StructuredBVA::loadFormula(const char* filename)
 	this->isClauseDeleted.shrink_to_fit();
 	this->litToClause.shrink_to_fit();
 
-	this->adjacencyMatrixWidth = this->varCount * 4;
-	this->litCountAdjustement.resize(2 * this->varCount);
-
-	adjacencyMatrix.resize(this->varCount);
+	this->initLitCounts();
 	this->originalClauseCount = this->clauses.size();
 
 	this->m_initialized = true;
 }
 
+void
+StructuredBVA::initLitCounts()
+{
+	this->litCount.resize(this->litToClause.size());
+	this->litDeadCount.assign(this->litToClause.size(), 0);
+	for (unsigned int i = 0; i < this->litToClause.size(); i++)
+		this->litCount[i] = this->litToClause[i].size();
+}
+
 std::vector<simpleClause>
 StructuredBVA::getSimplifiedFormula()
 {
@@ -334,20 +430,32 @@ StructuredBVA::setTieBreakHeuristic(SBVATieBreak heuristic)
 	this->tieBreakHeuristic = heuristic;
 	switch (heuristic) {
 		case SBVATieBreak::THREEHOPS:
-			this->breakTie =
-				std::bind(&StructuredBVA::threeHopTieBreak, this, std::placeholders::_1, std::placeholders::_2);
+			this->breakTie = std::bind(&StructuredBVA::threeHopTieBreak,
+									   this,
+									   std::placeholders::_1,
+									   std::placeholders::_2,
+									   std::placeholders::_3);
 			break;
 		case SBVATieBreak::MOSTOCCUR:
-			this->breakTie =
-				std::bind(&StructuredBVA::mostOccurTieBreak, this, std::placeholders::_1, std::placeholders::_2);
+			this->breakTie = std::bind(&StructuredBVA::mostOccurTieBreak,
+									   this,
+									   std::placeholders::_1,
+									   std::placeholders::_2,
+									   std::placeholders::_3);
 			break;
 		case SBVATieBreak::LEASTOCCUR:
-			this->breakTie =
-				std::bind(&StructuredBVA::leastOccurTieBreak, this, std::placeholders::_1, std::placeholders::_2);
+			this->breakTie = std::bind(&StructuredBVA::leastOccurTieBreak,
+									   this,
+									   std::placeholders::_1,
+									   std::placeholders::_2,
+									   std::placeholders::_3);
 			break;
 		case SBVATieBreak::RANDOM:
-			this->breakTie =
-				std::bind(&StructuredBVA::randomTieBreak, this, std::placeholders::_1, std::placeholders::_2);
+			this->breakTie = std::bind(&StructuredBVA::randomTieBreak,
+									   this,
+									   std::placeholders::_1,
+									   std::placeholders::_2,
+									   std::placeholders::_3);
 			break;
 		default:
 			this->tieBreakHeuristic = SBVATieBreak::NONE;
@@ -368,22 +476,23 @@ StructuredBVA::printStatistics()
 void
 StructuredBVA::printParameters()
 {
-	LOG1("[SBVA %d] generateProof: %s, preserveModelCount: %s, maxReplacements: %u, pairCompare: %s, "
-		 "tieBreakHeuristic: %s",
+	LOG1("[SBVA %d] generateProof: %s, preserveModelCount: %s, maxReplacements: %u, litOrder: %s, "
+		 "tieBreakHeuristic: %s, threads: %u",
 		 this->getSolverId(),
 		 this->generateProof ? "true" : "false",
 		 this->preserveModelCount ? "true" : "false",
 		 this->maxReplacements,
-		 (pairCompare.func == decreasingOrder)	 ? "decreasingOrder"
-		 : (pairCompare.func == increasingOrder) ? "increasingOrder"
-		 : (pairCompare.func == randomOrder)	 ? "randomOrder"
-												 : "unknown",
+		 (litOrder == SBVAOrder::DECREASING)   ? "decreasingOrder"
+		 : (litOrder == SBVAOrder::INCREASING) ? "increasingOrder"
+		 : (litOrder == SBVAOrder::RANDOM)	   ? "randomOrder"
+											   : "unknown",
 		 (tieBreakHeuristic == SBVATieBreak::NONE)		   ? "NONE"
 		 : (tieBreakHeuristic == SBVATieBreak::THREEHOPS)  ? "THREEHOPS"
 		 : (tieBreakHeuristic == SBVATieBreak::MOSTOCCUR)  ? "MOSTOCCUR"
 		 : (tieBreakHeuristic == SBVATieBreak::LEASTOCCUR) ? "LEASTOCCUR"
 		 : (tieBreakHeuristic == SBVATieBreak::RANDOM)	   ? "RANDOM"
-														   : "unknown");
+														   : "unknown",
+		 this->threads);
 }
 
 void
@@ -391,7 +500,7 @@ StructuredBVA::diversify(const SeedGenerator& getSeed)
 {
 	// Default
 	this->setTieBreakHeuristic(SBVATieBreak::THREEHOPS);
-	this->pairCompare.func = decreasingOrder;
+	this->litOrder = SBVAOrder::DECREASING;
 
 	unsigned int sbvaCount = this->getSolverTypeCount();
 	if (!sbvaCount)
@@ -401,16 +510,16 @@ StructuredBVA::diversify(const SeedGenerator& getSeed)
 	// if( 1 == tempId)
 	// {
 	//     this->setTieBreakHeuristic(SBVATieBreak::MOSTOCCUR);
-	// this->pairCompare.func = decreasingOrder;
+	// this->litOrder = SBVAOrder::DECREASING;
 	// }
 
 	// 12 configurations
 	switch (tempId % 3) {
 		case 1:
-			this->pairCompare.func = randomOrder;
+			this->litOrder = SBVAOrder::RANDOM;
 			break;
 		case 2:
-			this->pairCompare.func = increasingOrder;
+			this->litOrder = SBVAOrder::INCREASING;
 			break;
 			// default decreasing
 	}
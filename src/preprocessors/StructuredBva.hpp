@@ -1,68 +1,107 @@
 #pragma once
 
-#include <map>
 #include <random>
-
-#include <Eigen/SparseCore>
+#include <tuple>
+#include <unordered_map>
 
 #include "preprocessors/PreprocessorInterface.hpp"
 #include "utils/Parsers.hpp"
 
 //===============litQueue.h====================
 
-/// @brief queuePair struct used for the priorityQueue in solve
-typedef struct
+/// Order in which the literals are tried by solve()
+enum class SBVAOrder
 {
-	int lit;
-	unsigned int occurencesCount;
-} queuePair;
-
-/* Notes from cppreference:
-Note that the Compare parameter is defined such that it returns true if its first argument
-comes before its second argument in a weak ordering. But because the priority queue outputs
-largest elements first, the elements that "come before" are actually output last.
-That is, the front of the queue contains the "last" element according to the weak ordering
-imposed by Compare.
-*/
-bool
-decreasingOrder(const queuePair& lhs, const queuePair& rhs);
-
-bool
-increasingOrder(const queuePair& lhs, const queuePair& rhs);
-
-bool
-randomOrder(const queuePair& lhs, const queuePair& rhs);
-
-/// Functor for the priority queue used in solve()
-struct PairCompare
+	DECREASING = 1,
+	INCREASING = 2,
+	RANDOM = 3,
+};
+
+/**
+ * @brief Indexed bucket queue of literals keyed by their number of occurrences.
+ *
+ * A literal is at most once in the queue, changing its number of occurrences moves it to another bucket in O(1)
+ * instead of pushing a new entry as in a binary heap, thus no stale entry is ever popped. In RANDOM order all the
+ * literals are kept in one bucket and a random one is popped.
+ */
+class SBVALitQueue
 {
-	typedef bool (*compareFunc)(const queuePair&, const queuePair&);
+  public:
+	void init(SBVAOrder order, unsigned int seed);
 
-	PairCompare(compareFunc func)
-		: func(func)
-	{
-	}
+	/// Insert lit or move it to the bucket of count, a literal without occurrences is removed from the queue
+	void update(int lit, unsigned int count);
 
-	PairCompare()
-		: func(decreasingOrder)
-	{
-	}
+	/// Pop the next literal, the queue must not be empty
+	int pop();
 
-	bool operator()(const queuePair& lhs, const queuePair& rhs) const { return func(lhs, rhs); }
+	bool empty() const { return this->size == 0; }
 
-	compareFunc func;
+  private:
+	void remove(int lit);
+
+	SBVAOrder order;
+
+	/// Literals of each bucket
+	std::vector<std::vector<int>> buckets;
+
+	/// Bucket and position in the bucket of each literal (LIT_IDX), bucket -1 if not queued
+	std::vector<int> bucketOf;
+	std::vector<unsigned int> positionOf;
+
+	/// First bucket possibly non empty: the highest in DECREASING order, the lowest in INCREASING order
+	unsigned int front;
+
+	unsigned int size;
+
+	std::mt19937 rng;
 };
 
 //=============================================
 
 // Occurence lists
-#define REAL_LIT_COUNT(LIT)                                                                                            \
-	((unsigned int)this->litToClause[LIT_IDX(LIT)].size() + this->litCountAdjustement[LIT_IDX(LIT)])
+#define REAL_LIT_COUNT(LIT) (this->litCount[LIT_IDX(LIT)])
+
+/// Replacement of a literal found by the matching, not yet applied
+struct SBVAMatch
+{
+	int lit;
+
+	/// The literals factorized with lit, lit included, in the order they were matched
+	std::vector<int> matchedLiterals;
 
-// Adjacency Matrix
-#define MATRIX_VAR_TO_IDX(LIT) (LIT - 1)
-#define MATRIX_LIT_TO_IDX(LIT) (LIT > 0 ? LIT - 1 : -LIT - 1)
-#define MATRIX_IDX_TO_VAR(IDX) (IDX + 1)
+	/// Index in this->clauses of the clauses of lit that are replaced
+	std::vector<int> matchedClauses;
+
+	/// Index in the occurrence list of lit of each matched clause (same order as matchedClauses)
+	std::vector<int> matchedClausesIdx;
+
+	/// Stores the pair (global_clause_idx, in_occurence_list_idx)
+	std::vector<std::pair<int, int>> clausesToRemove;
+};
+
+/// Buffers of a matching thread
+struct SBVAScratch
+{
+	std::vector<int> matchedClausesSwap;
+	std::vector<int> matchedClausesIdxSwap;
+	std::vector<int> diff;
+	std::vector<int> ties;
+
+	/// Matches (lit, clause_global_idx, column in matchedClauses) of the current round
+	std::vector<std::tuple<int, int, int>> matchedEntries;
+
+	/// Number of matches of each literal (LIT_IDX) in the current round, and the literals having matches
+	std::vector<unsigned int> litMatches;
+	std::vector<int> matchedEntriesLits;
+
+	/// litStamp[LIT_IDX(lit)] == stamp iff lit is in the matchedLiterals of the current match
+	std::vector<unsigned int> litStamp;
+	unsigned int stamp = 0;
+
+	/// 3HOP heuristic of the ties, by variable, for the current match
+	std::unordered_map<int, unsigned int> threeHopCache;
+};
 
 /// Tie-Breaking Heuristics
 enum class SBVATieBreak
@@ -88,6 +127,8 @@ struct ProofClause
  * It is based on the original implementation from https://github.com/hgarrereyn/SBVA,
  * reorganized and adapted for this solver framework.
  *
+ * @note No portfolio of this tree instantiates it yet, the sbva-* parameters are only read by this class.
+ *
  * @ingroup preproc_solving
  */
 class StructuredBVA : public PreprocessorInterface
@@ -124,9 +165,9 @@ class StructuredBVA : public PreprocessorInterface
 
 	int getDivisionVariable() { return 0; }
 
-	void addClause(ClauseExchangePtr clause) { return; }
+	void addClause(ClauseExchangePtr) { return; }
 
-	void addClauses(const std::vector<ClauseExchangePtr>& clauses) { return; }
+	void addClauses(const std::vector<ClauseExchangePtr>&) { return; }
 
 	/**
 	 * @brief Diversify the preprocessor's behavior.
@@ -134,27 +175,32 @@ class StructuredBVA : public PreprocessorInterface
 	 */
 	void diversify(const SeedGenerator& getSeed = [](SolverInterface* s) { return s->getSolverId(); });
 
-	void updateAdjacencyMatrix(int var);
+	/// Count, for each variable, the clauses it shares with each other variable (3HOP heuristic)
+	void buildAdjacency();
+
+	/// Add delta to the co-occurrence counts of the variables of clause
+	void updateAdjacency(const simpleClause& clause, int delta);
 
-	unsigned int getThreeHopHeuristic(int lit1, int lit2);
+	unsigned int getThreeHopHeuristic(int lit1, int lit2, SBVAScratch& scratch);
 
 	/* returns the least occuring literal in a clause c\var */
-	int leastFrequentLiteral(simpleClause& clause, int lit);
+	int leastFrequentLiteral(const simpleClause& clause, int lit);
 
 	void setTieBreakHeuristic(SBVATieBreak tieBreak);
 
 	void releaseMemory()
 	{
-		this->tempTieHeuristicCache.clear();
-		this->litCountAdjustement.clear();
-		this->adjacencyMatrix.clear();
+		this->litDeadCount.clear();
+		this->litCount.clear();
+		this->adjacency.clear();
 		this->isClauseDeleted.clear();
 		this->litToClause.clear();
 		this->clauses.clear();
 		this->proof.clear();
 
-		this->litCountAdjustement.shrink_to_fit();
-		this->adjacencyMatrix.shrink_to_fit();
+		this->litDeadCount.shrink_to_fit();
+		this->litCount.shrink_to_fit();
+		this->adjacency.shrink_to_fit();
 		this->isClauseDeleted.shrink_to_fit();
 		this->litToClause.shrink_to_fit();
 		this->clauses.shrink_to_fit();
@@ -168,13 +214,13 @@ class StructuredBVA : public PreprocessorInterface
 	void restoreModel(std::vector<int>& model) override { model.resize(this->varCount - this->replacementsCount); }
 
 	/* TODO factorize using a macro */
-	inline int threeHopTieBreak(const std::vector<int>& ties, const int currentLit)
+	inline int threeHopTieBreak(const std::vector<int>& ties, const int currentLit, SBVAScratch& scratch)
 	{
 		int lmax = 0;
 		/* How much currentLit.lit is connected to ties[i] */
 		unsigned int maxHeuristicVal = 0;
 		for (int tie : ties) {
-			unsigned int temp = this->getThreeHopHeuristic(currentLit, tie);
+			unsigned int temp = this->getThreeHopHeuristic(currentLit, tie, scratch);
 			if (temp > maxHeuristicVal) {
 				maxHeuristicVal = temp;
 				lmax = tie;
@@ -183,7 +229,7 @@ class StructuredBVA : public PreprocessorInterface
 		return lmax;
 	}
 
-	inline int mostOccurTieBreak(const std::vector<int>& ties, const int currentLit)
+	inline int mostOccurTieBreak(const std::vector<int>& ties, const int, SBVAScratch&)
 	{
 		int lmax = 0;
 		/* How much currentLit.lit is connected to ties[i] */
@@ -198,7 +244,7 @@ class StructuredBVA : public PreprocessorInterface
 		return lmax;
 	}
 
-	inline int leastOccurTieBreak(const std::vector<int>& ties, const int currentLit)
+	inline int leastOccurTieBreak(const std::vector<int>& ties, const int, SBVAScratch&)
 	{
 		int lmax = 0;
 		/* How much currentLit.lit is connected to ties[i] */
@@ -213,10 +259,11 @@ class StructuredBVA : public PreprocessorInterface
 		return lmax;
 	}
 
-	inline int randomTieBreak(const std::vector<int>& ties, const int currentLit)
+	inline int randomTieBreak(const std::vector<int>& ties, const int currentLit, SBVAScratch&)
 	{
-		std::srand(currentLit);
-		return ties[std::rand() % ties.size()];
+		/* Local generator: the ties of several literals are broken concurrently */
+		std::minstd_rand rng(currentLit);
+		return ties[rng() % ties.size()];
 	}
 
 	std::vector<int> getModel() override
@@ -228,6 +275,31 @@ class StructuredBVA : public PreprocessorInterface
   private:
 	void printParameters();
 
+	/// Set the occurrence counts once the occurrence lists are loaded
+	void initLitCounts();
+
+	/**
+	 * @brief Search the best replacement of a literal, does not modify the formula.
+	 * @details Several literals are matched at once by the threads of solve(), only the scratch is written.
+	 * @return false if no replacement is worth it.
+	 */
+	bool matchLiteral(int lit, SBVAMatch& match, SBVAScratch& scratch);
+
+	/// Check that no clause read by the matching of match.lit has a variable in touched (== stamp)
+	bool isMatchValid(const SBVAMatch& match, const std::vector<unsigned int>& touched, unsigned int stamp);
+
+	/**
+	 * @brief Introduce a new variable for a match and replace the matched clauses.
+	 * @param touched The variables of the deleted clauses are set to stamp.
+	 */
+	void applyMatch(const SBVAMatch& match,
+					SBVALitQueue& litQueue,
+					std::vector<unsigned int>& touched,
+					unsigned int stamp);
+
+	/// Remove the deleted clauses from an occurrence list
+	void compactOccurrences(unsigned int litIdx);
+
   private:
 	std::atomic<bool> stopPreprocessing;
 
@@ -240,17 +312,14 @@ class StructuredBVA : public PreprocessorInterface
 	/// @brief Occurence list using the literal as an index for a list of clause indexes in this->clauses
 	std::vector<std::vector<unsigned int>> litToClause;
 
-	/// @brief To keep track of the real number of occurences during the algorithm
-	std::vector<int> litCountAdjustement;
+	/// @brief Real number of occurences of each literal during the algorithm
+	std::vector<unsigned int> litCount;
 
-	/// @brief For the eigenVector size
-	unsigned int adjacencyMatrixWidth;
+	/// @brief Deleted clauses still in each occurrence list, they are removed lazily
+	std::vector<unsigned int> litDeadCount;
 
-	/// @brief Adjacency matrix used to compute 3HOP tie breaking heuristic
-	std::vector<Eigen::SparseVector<int>> adjacencyMatrix;
-
-	/// @brief Cache used for not recomputing the heuristic each time
-	std::map<int, int> tempTieHeuristicCache;
+	/// @brief Per variable (var, count) sorted by var: number of clauses sharing both variables, for the 3HOP heuristic
+	std::vector<std::vector<std::pair<int, int>>> adjacency;
 
 	/// @brief Stores the DRAT proof if enabled
 	std::vector<ProofClause> proof;
@@ -263,13 +332,16 @@ class StructuredBVA : public PreprocessorInterface
 
 	bool shuffleTies;
 
-	PairCompare pairCompare;
+	SBVAOrder litOrder;
 
 	SBVATieBreak tieBreakHeuristic;
 
 	unsigned int maxReplacements;
 
-	std::function<int(const std::vector<int>&, const int)> breakTie;
+	/// Number of threads matching literals in solve()
+	unsigned int threads;
+
+	std::function<int(const std::vector<int>&, const int, SBVAScratch&)> breakTie;
 
 	// Stats
 	//------
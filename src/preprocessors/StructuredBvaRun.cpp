@@ -1,16 +1,17 @@
 #include "StructuredBva.hpp"
 #include "painless.hpp"
 
-#include <queue>
-#include <set>
-#include <unordered_set>
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <thread>
 
 // Performs partial clause difference between clause1 and clause2, storing the result in diff.
 // Only the first maxDiff literals are stored in diff.
 // Requires that clause and other are sorted.
 /* clause1 \ clause2 */
 inline void
-orderedClauseSub(simpleClause& clause1, simpleClause& clause2, simpleClause& diff, int maxDiff)
+orderedClauseSub(const simpleClause& clause1, const simpleClause& clause2, simpleClause& diff, int maxDiff)
 {
 	diff.clear();
 
@@ -42,383 +43,498 @@ int static inline reduction(int lits, int clauses)
 	return (lits * clauses) - (lits + clauses);
 }
 
-SatResult
-StructuredBVA::solve(const std::vector<int> &cube)
+bool
+StructuredBVA::matchLiteral(int currentLit, SBVAMatch& match, SBVAScratch& scratch)
 {
-	if (!this->m_initialized) {
-		LOGWARN("SBVA %d wasn't initialized correctly, cannot run, returning", this->getSolverId());
-		return SatResult::UNKNOWN;
+	std::vector<int>& matchedLiterals = match.matchedLiterals;
+	/* Stores the index of the clauses in this->clauses vector */
+	std::vector<int>& matchedClauses = match.matchedClauses;
+	/* Stores the index of the clauses in an occurence list == column in matchedEntries */
+	std::vector<int>& matchedClausesIdx = match.matchedClausesIdx; /* exists only for clause deletion */
+	std::vector<std::pair<int, int>>& clausesToRemove = match.clausesToRemove;
+	std::vector<int>& diff = scratch.diff;
+
+	/* Clear to not cancel the reserve */
+	match.lit = currentLit;
+	matchedLiterals.clear();
+	matchedClauses.clear();
+	matchedClausesIdx.clear();
+	clausesToRemove.clear();
+	scratch.threeHopCache.clear();
+
+	if (++scratch.stamp == 0) {
+		std::fill(scratch.litStamp.begin(), scratch.litStamp.end(), 0);
+		scratch.stamp = 1;
 	}
-	/* A priority queue is instantiated to keep track of all the literals in pairs (num_clauses_occuring, lit) using a
-	 * certain order */
-	/* Functor to sort using the clause number only, thus order in decreasing number of clauses*/
-	std::priority_queue<queuePair, std::vector<queuePair>, PairCompare> litQueue(this->pairCompare);
 
-	/* Init queue with original literals, DIVERSIFICATION potentiel: change the order, do not add all literals ... */
-	for (int i = 1; i <= this->varCount; i++) {
-		litQueue.emplace(queuePair{ i, REAL_LIT_COUNT(i) });
-		litQueue.emplace(queuePair{ -i, REAL_LIT_COUNT(-i) });
+	LOGDEBUG3("Trying literal %d (%u)", currentLit, REAL_LIT_COUNT(currentLit));
+
+	matchedLiterals.push_back(currentLit);
+	scratch.litStamp[LIT_IDX(currentLit)] = scratch.stamp;
+
+	/* Occurence list with the clauses indexes in this->clauses */
+	const std::vector<unsigned int>& occurenceList = this->litToClause[LIT_IDX(currentLit)];
+	unsigned int size = occurenceList.size();
 
-		LOGDEBUG3("Emplaced: (%d,%u), (%d,%u)", i, REAL_LIT_COUNT(i), -i, REAL_LIT_COUNT(-i));
+	/* Matched clauses are init to all occurences of chosen literal */
+	for (unsigned int i = 0; i < size; i++) {
+		if (!this->isClauseDeleted[occurenceList[i]]) {
+			matchedClauses.push_back(occurenceList[i]);
+			matchedClausesIdx.push_back(i);
+			clausesToRemove.emplace_back(occurenceList[i],
+										 i); /* TO OPTIMIZE: need to check at match if to remove or not!! */
+		}
 	}
 
-	// std::vector<int> matchedLiterals;
-	std::unordered_set<int> matchedLiterals;
-	/* Stores the index of the clauses in this->clauses vector */
-	std::vector<int> matchedClauses;
-	std::vector<int> matchedClausesSwap;
-	/* Stores the index of the clauses in an occurence list == column in matchedEntries */
-	std::vector<int> matchedClausesIdx; /* exists only for clause deletion */
-	std::vector<int> matchedClausesIdxSwap;
+	/* Search for potential matches with currentLit */
+	while (1) {
+		scratch.matchedEntries.clear();
+		scratch.matchedEntriesLits.clear();
 
-	/* Stores the pair (global_clause_idx, in_occurence_list_idx) */
-	std::vector<std::pair<int, int>> clausesToRemove;
-	/* Init the diff vector used with this->clauseSub*/
-	std::vector<int> diff;
+		size = matchedClauses.size();
 
-	/* Keep track of the matrix of swaps to be performed, to be changed to a map of pairs, with lit as key ? */
-	std::vector<std::tuple<int, int, int>> matchedEntries;
+		// foreach C in matchedClauses check if there is a literal lmin in C having a clause D s.t D \ l2 == C \ l1
+		// (lmin must be incommon)
+		for (unsigned int i = 0; i < size; i++) {
+			int clauseGlobalIdx = matchedClauses[i];
 
-	/* Keep a list of the literals that are matched to sort and count them later */
-	std::vector<int> matchedEntriesLits;
+			int lmin = this->leastFrequentLiteral(this->clauses[clauseGlobalIdx], currentLit);
+			if (lmin == 0)
+				continue; /* unit clause, Unit clauses cannot be matched, store them individually ? */
 
-	/* Used for litQueue updates*/
-	std::unordered_set<int> litsToUpdate;
+			for (int otherGlobalIdx : this->litToClause[LIT_IDX(lmin)]) {
+				/* if deleted or trivially unmatchable */
+				if (this->isClauseDeleted[otherGlobalIdx] ||
+					this->clauses[clauseGlobalIdx].size() != this->clauses[otherGlobalIdx].size())
+					continue;
 
-	/* TODO Add a better reserve than the 10000, using the max_clause_size, nbVar, nbClauses ... */
+				/* If the difference C \ D is more than 1 literal, l1 and l2 cannot be factorized */
+				orderedClauseSub(this->clauses[clauseGlobalIdx], this->clauses[otherGlobalIdx], diff, 2);
 
-	this->replacementsCount = 0;
+				/* To be factorized (matched): C \ {l1} \ D == D \ {l2} \ C
+				 * C \ D must equal l1 and D \ C must equal l2
+				 * (all the other literals are shared)
+				 */
+				if (diff.size() == 1 && diff[0] == currentLit) {
+					orderedClauseSub(this->clauses[otherGlobalIdx], this->clauses[clauseGlobalIdx], diff, 2);
 
-	queuePair currentLit;
+					/*
+					 * Since we checked if of the same size, the other diff is necessarely of size 1:
+					 * C \ D = l1 => each l in C \ l1 is in D => they have C.size() - 1 literals in common
+					 * C.size() == D.size() thus D has only one different literal l2
+					 */
 
-	while (litQueue.size() > 0) {
-		/* Check if to stop */
-		if (this->stopPreprocessing || globalEnding ||
-			(this->maxReplacements > 0 && this->replacementsCount >= this->maxReplacements)) {
-			LOG0("SBVA %d is ending: stopPreprocessing %d, globalEnding %d, maxReplacement %u, replacementCount %u",
-				this->getSolverId(),
-				this->stopPreprocessing.load(),
-				globalEnding.load(),
-				this->maxReplacements,
-				this->replacementsCount);
-			return SatResult::UNKNOWN;
+					int lit = diff[0];
+
+					if (scratch.litStamp[LIT_IDX(lit)] != scratch.stamp) /* different from original implementation */
+					{
+						/* Duplicated clauses must have been deleted at parsing or addition to not have more than
+						 * once the same literal for a given i*/
+						LOGDEBUG3("matchedEntry(%d,%d,%d)", lit, otherGlobalIdx, i);
+						scratch.matchedEntries.emplace_back(lit, otherGlobalIdx, i);
+						if (!scratch.litMatches[LIT_IDX(lit)]++)
+							scratch.matchedEntriesLits.push_back(lit);
+					}
+				} // else diff = 0 (same clause) or diff >= 2 or diff == 1 && diff[0] != currentLit
+			}
+		}
+		/* Now we have a list of literals with matches with currentLit, we need to take the one with the most
+		 * matches */
+
+		int lmax = 0;
+		int lmaxMatches = 0;
+
+		std::vector<int>& ties = scratch.ties;
+		ties.clear();
+
+		LOGDEBUG3("MatchedLiterals: ");
+		// Find the element with the maximum count, in the order the literals were first matched
+		for (int lit : scratch.matchedEntriesLits) {
+			int count = scratch.litMatches[LIT_IDX(lit)];
+			scratch.litMatches[LIT_IDX(lit)] = 0;
+
+			LOGDEBUG3("\t*(%d,%d)", lit, count);
+			if (count > lmaxMatches) {
+				lmaxMatches = count;
+				lmax = lit;
+				ties.clear();
+				ties.push_back(lmax);
+			} else if (count == lmaxMatches) {
+				ties.push_back(lit);
+			}
 		}
 
-		/* Clear to not cancel the reserve */
-		matchedLiterals.clear();
-		matchedClauses.clear();
-		matchedClausesIdx.clear();
-		clausesToRemove.clear();
-		this->tempTieHeuristicCache.clear();
-
-		/* Get the least occuring literal to test */
-		currentLit = litQueue.top();
-		litQueue.pop();
+		if (lmax == 0) {
+			LOGDEBUG3("Breaking since no matches");
+			break; /* stop while(1) currentLit cannot be matched */
+		}
 
-		LOGDEBUG3("Trying literal %d (%u)", currentLit.lit, currentLit.occurencesCount);
+		int prevReduction = reduction(matchedLiterals.size(), matchedClauses.size());
+		int newReduction = reduction(matchedLiterals.size() + 1, lmaxMatches);
 
-		/* if the number of occurences is zero or are out of date, loop*/
-		if (currentLit.occurencesCount == 0 || currentLit.occurencesCount != REAL_LIT_COUNT(currentLit.lit))
-			continue;
+		if (newReduction <= prevReduction) {
+			LOGDEBUG3("Breaking since prevReduction is same or better");
+			break; /* breaks while(1) : Not worth it */
+		}
 
-		matchedLiterals.insert(currentLit.lit);
+		/* DIVERSIFICATION : different tieBreakingHeuristics: take randomly a tie, take the least occuring / the
+		 * most occuring,  */
+		/* If several ties on lmaxMatches, select the most connected lmax to currentLit */
+		if (ties.size() > 1 && this->tieBreakHeuristic != SBVATieBreak::NONE) {
+			int tie = this->breakTie(ties, currentLit, scratch);
+			if (tie)
+				lmax = tie;
+		}
 
-		/* Occurence list with the clauses indexes in this->clauses */
-		std::vector<unsigned int>& occurenceList = this->litToClause[LIT_IDX(currentLit.lit)];
-		unsigned int size = occurenceList.size();
+		LOGDEBUG3("lmax: %d (ties:%lu), lmaxCount: %d, prevReduction: %d, newReduction: %d",
+				  lmax,
+				  ties.size(),
+				  lmaxMatches,
+				  prevReduction,
+				  newReduction);
+
+		/* add best match according to tieBreakHeuristic or the first lmax*/
+		matchedLiterals.push_back(lmax);
+		scratch.litStamp[LIT_IDX(lmax)] = scratch.stamp;
+
+		/* What we want: update the matchedClauses to contain only the matches with lmax*/
+		std::vector<int>& matchedClausesSwap = scratch.matchedClausesSwap;
+		std::vector<int>& matchedClausesIdxSwap = scratch.matchedClausesIdxSwap;
+		matchedClausesSwap.resize(lmaxMatches);
+		matchedClausesIdxSwap.resize(lmaxMatches);
+
+		int insertIdx = 0;
+		for (auto& tuple : scratch.matchedEntries) {
+			int lit = std::get<0>(tuple);
+			if (lit != lmax)
+				continue;
 
-		/* Matched clauses are init to all occurences of chosen literal */
-		for (unsigned int i = 0; i < size; i++) {
-			if (!this->isClauseDeleted[occurenceList[i]]) {
-				matchedClauses.push_back(occurenceList[i]);
-				matchedClausesIdx.push_back(i);
-				clausesToRemove.emplace_back(occurenceList[i],
-											 i); /* TO OPTIMIZE: need to check at match if to remove or not!! */
-			}
-		}
+			int clauseGlobalIdx = std::get<1>(tuple);
+			int columnIdx = std::get<2>(tuple);
 
-		/* Search for potential matches with currentLit.lit */
-		while (1) {
-			matchedEntries.clear();
-			matchedEntriesLits.clear();
+			matchedClausesSwap[insertIdx] = matchedClauses[columnIdx];
+			matchedClausesIdxSwap[insertIdx] = matchedClausesIdx[columnIdx];
+			insertIdx++;
 
-			size = matchedClauses.size();
+			clausesToRemove.emplace_back(
+				clauseGlobalIdx,
+				matchedClausesIdx[columnIdx]); /* To optimize: requires a check later at deletion */
+		}
 
-			// foreach C in matchedClauses check if there is a literal lmin in C having a clause D s.t D \ l2 == C \ l1
-			// (lmin must be incommon)
-			for (unsigned int i = 0; i < size; i++) {
-				int clauseGlobalIdx = matchedClauses[i];
-				int clauseMatrixIdx = matchedClausesIdx[i]; /* not used ! */
+		std::swap(matchedClauses, matchedClausesSwap);
+		std::swap(matchedClausesIdx, matchedClausesIdxSwap);
 
-				int lmin = this->leastFrequentLiteral(this->clauses[clauseGlobalIdx], currentLit.lit);
-				if (lmin == 0)
-					continue; /* unit clause, Unit clauses cannot be matched, store them individually ? */
+		LOGDEBUG3("Matched clauses new size %d", matchedClauses.size());
 
-				for (int otherGlobalIdx : litToClause[LIT_IDX(lmin)]) {
-					/* if deleted or trivially unmatchable */
-					if (this->isClauseDeleted[otherGlobalIdx] ||
-						this->clauses[clauseGlobalIdx].size() != this->clauses[otherGlobalIdx].size())
-						continue;
+	} // end of while(1)
 
-					/* If the difference C \ D is more than 1 literal, l1 and l2 cannot be factorized */
-					orderedClauseSub(this->clauses[clauseGlobalIdx], this->clauses[otherGlobalIdx], diff, 2);
+	unsigned int matchesClauseCount = matchedClauses.size();
+	unsigned int matchesCount = matchedLiterals.size();
 
-					/* To be factorized (matched): C \ {l1} \ D == D \ {l2} \ C
-					 * C \ D must equal l1 and D \ C must equal l2
-					 * (all the other literals are shared)
-					 */
-					if (diff.size() == 1 && diff[0] == currentLit.lit) {
-						orderedClauseSub(this->clauses[otherGlobalIdx], this->clauses[clauseGlobalIdx], diff, 2);
-
-						/*
-						 * Since we checked if of the same size, the other diff is necessarely of size 1:
-						 * C \ D = l1 => each l in C \ l1 is in D => they have C.size() - 1 literals in common
-						 * C.size() == D.size() thus D has only one different literal l2
-						 */
-
-						int lit = diff[0];
-
-						if (matchedLiterals.find(lit) ==
-							matchedLiterals.end()) /* different from original implementation */
-						{
-							/* Duplicated clauses must have been deleted at parsing or addition to not have more than
-							 * once the same literal for a given i*/
-							LOGDEBUG3("matchedEntry(%d,%d,%d)", lit, otherGlobalIdx, i);
-							matchedEntries.emplace_back(
-								lit, otherGlobalIdx, i);	   /* better to have a map and then get keys*/
-							matchedEntriesLits.push_back(lit); /* redundant information */
-						}
-					} // else diff = 0 (same clause) or diff >= 2 or diff == 1 && diff[0] != currentLit.lit
-				}
-			}
-			/* Now we have a list of literals with matches with currentLit.lit, we need to take the one with the most
-			 * matches */
+	/* No match or not worth it */
+	return !(matchesCount == 1 || (matchesCount <= 2 && matchesClauseCount <= 2));
+}
 
-			int lmax = 0;
-			int lmaxMatches = 0;
+bool
+StructuredBVA::isMatchValid(const SBVAMatch& match, const std::vector<unsigned int>& touched, unsigned int stamp)
+{
+	/* The matching read the clauses of match.lit, the occurences of their literals and the clauses of their least
+	 * occuring literals: all of them are unchanged if no variable of the clauses of match.lit was touched */
+	if (touched[std::abs(match.lit)] == stamp)
+		return false;
 
-			std::vector<int> ties;
-			int count = 1;
+	for (unsigned int clauseIdx : this->litToClause[LIT_IDX(match.lit)]) {
+		if (this->isClauseDeleted[clauseIdx])
+			continue;
+		for (int lit : this->clauses[clauseIdx]) {
+			if (touched[std::abs(lit)] == stamp)
+				return false;
+		}
+	}
+	return true;
+}
 
-			/* Better complexity than sorting the vector O(2N) vs O(N + NlogN)*/
-			std::unordered_map<int, int> counts;
+void
+StructuredBVA::compactOccurrences(unsigned int litIdx)
+{
+	std::vector<unsigned int>& occurenceList = this->litToClause[litIdx];
+	occurenceList.erase(std::remove_if(occurenceList.begin(),
+									   occurenceList.end(),
+									   [this](unsigned int clauseIdx) { return this->isClauseDeleted[clauseIdx]; }),
+						occurenceList.end());
+	this->litDeadCount[litIdx] = 0;
+}
 
-			for (int lit : matchedEntriesLits) {
-				counts[lit]++;
-			}
-			LOGDEBUG3("MatchedLiterals: ");
-			// Find the element with the maximum count
-			for (const auto& pair : counts) {
-				LOGDEBUG3("\t*(%d,%d)", pair.first, pair.second);
-				if (pair.second > lmaxMatches) {
-					lmaxMatches = pair.second;
-					lmax = pair.first;
-					ties.clear();
-					ties.push_back(lmax);
-				} else if (pair.second == lmaxMatches) {
-					ties.push_back(pair.first);
-				}
-			}
+void
+StructuredBVA::applyMatch(const SBVAMatch& match,
+						  SBVALitQueue& litQueue,
+						  std::vector<unsigned int>& touched,
+						  unsigned int stamp)
+{
+	const std::vector<int>& matchedLiterals = match.matchedLiterals;
+	const std::vector<int>& matchedClauses = match.matchedClauses;
+	unsigned int matchesClauseCount = matchedClauses.size();
+	unsigned int matchesCount = matchedLiterals.size();
+	bool withAdjacency = !this->adjacency.empty();
+
+	/* Introduce new var and update clauses */
+	int newVar = ++this->varCount;
+
+	assert(newVar > 0);
+
+	LOGDEBUG3("A new variable %d was added", newVar);
+
+	/* Current clauses + (newVar, matche_i) clauses + (newVar, C \ matche_i) + preservingModelCountClause */
+	this->clauses.reserve(this->clauses.size() + matchesCount + matchesClauseCount + this->preserveModelCount);
+	this->litToClause.resize(this->varCount * 2);
+	this->litCount.resize(this->varCount * 2);
+	this->litDeadCount.resize(this->varCount * 2);
+	touched.resize(this->varCount + 1, 0);
+	if (withAdjacency)
+		this->adjacency.resize(this->varCount + 1);
+
+	/* Adding (newVar, match_i) clauses */
+	for (int lit : matchedLiterals) {
+		// Add clause
+		this->clauses.emplace_back(std::vector<int>{ lit, newVar });
+		this->isClauseDeleted.push_back(false);
+		// Update occurence lists
+		int newClauseGlobalIdx = this->clauses.size() - 1;
+		this->litToClause[LIT_IDX(lit)].push_back(newClauseGlobalIdx);
+		this->litToClause[PLIT_IDX(newVar)].push_back(newClauseGlobalIdx);
+		this->litCount[LIT_IDX(lit)]++;
+		this->litCount[PLIT_IDX(newVar)]++;
+
+		if (withAdjacency)
+			this->updateAdjacency(this->clauses.back(), 1);
+
+		if (this->generateProof) {
+			// newVar must be first in proof clause
+			this->proof.emplace_back(ProofClause{ std::vector<int>{ newVar, lit }, true });
+		}
+	}
 
-			if (lmax == 0) {
-				LOGDEBUG3("Breaking since no matches");
-				break; /* stop while(1) currentLit.lit cannot be matched */
-			}
+	/* Adding (-newVar, ... ) clauses */
+	for (unsigned int globalClauseIdx : matchedClauses) {
+		int newNLit = -1 * newVar;
+		this->clauses.emplace_back(std::vector<int>{ newNLit });
+		this->isClauseDeleted.push_back(false);
 
-			int prevReduction = reduction(matchedLiterals.size(), matchedClauses.size());
-			int newReduction = reduction(matchedLiterals.size() + 1, lmaxMatches);
+		int newClauseGlobalIdx = this->clauses.size() - 1;
+		this->litToClause[NLIT_IDX(newNLit)].push_back(newClauseGlobalIdx);
+		this->litCount[NLIT_IDX(newNLit)]++;
 
-			if (newReduction <= prevReduction) {
-				LOGDEBUG3("Breaking since prevReduction is same or better");
-				break; /* breaks while(1) : Not worth it */
+		for (int lit : this->clauses[globalClauseIdx]) {
+			if (lit != match.lit) {
+				this->clauses.back().push_back(lit);
+				this->litToClause[LIT_IDX(lit)].push_back(newClauseGlobalIdx);
+				this->litCount[LIT_IDX(lit)]++;
 			}
+		}
 
-			/* DIVERSIFICATION : different tieBreakingHeuristics: take randomly a tie, take the least occuring / the
-			 * most occuring,  */
-			/* If several ties on lmaxMatches, select the most connected lmax to currentLit.lit */
-			if (ties.size() > 1 && this->tieBreakHeuristic != SBVATieBreak::NONE) {
-				this->breakTie(ties, currentLit.lit);
-			}
+		if (withAdjacency)
+			this->updateAdjacency(this->clauses.back(), 1);
 
-			LOGDEBUG3("lmax: %d (ties:%lu), lmaxCount: %d, prevReduction: %d, newReduction: %d",
-					  lmax,
-					  ties.size(),
-					  lmaxMatches,
-					  prevReduction,
-					  newReduction);
-
-			/* add best match according to tieBreakHeuristic or the first lmax*/
-			matchedLiterals.insert(lmax);
-
-			/* TODO optimize this using a map as matchedEntries, and do not use swap , Eigen can be used no ?*/
-			/* What we want: update the matchedClauses to contain only the matches with lmax*/
-			matchedClausesSwap.resize(lmaxMatches);
-			matchedClausesIdxSwap.resize(lmaxMatches);
-
-			int insertIdx = 0;
-			for (auto& tuple : matchedEntries) {
-				int lit = std::get<0>(tuple);
-				if (lit != lmax)
-					continue;
+		if (this->generateProof) {
+			this->proof.emplace_back(ProofClause{ this->clauses.back(), true });
+		}
+	}
 
-				int clauseGlobalIdx = std::get<1>(tuple);
-				int columnIdx = std::get<2>(tuple);
+	/* From Original Implementation */
+	// Preserving model count:
+	//
+	// The only case where we add a model is if both assignments for the auxiiliary variable satisfy the formula
+	// for the same assignment of the original variables. This only happens if all(matched_lits) *AND*
+	// all(matches_clauses) are satisfied.
+	//
+	// The easiest way to fix this is to add one clause that constrains all(matched_lits) => -f
+	if (this->preserveModelCount) {
+		int newNLit = -1 * newVar;
+		this->clauses.emplace_back(std::vector<int>{ newNLit });
+		this->isClauseDeleted.push_back(false);
+
+		int newClauseGlobalIdx = this->clauses.size() - 1;
+		this->litToClause[NLIT_IDX(newNLit)].push_back(newClauseGlobalIdx);
+		this->litCount[NLIT_IDX(newNLit)]++;
 
-				matchedClausesSwap[insertIdx] = matchedClauses[columnIdx];
-				matchedClausesIdxSwap[insertIdx] = matchedClausesIdx[columnIdx];
-				insertIdx++;
+		for (int lit : matchedLiterals) {
+			this->clauses.back().push_back(-lit);
+			this->litToClause[LIT_IDX(-lit)].push_back(newClauseGlobalIdx);
+			this->litCount[LIT_IDX(-lit)]++;
+		}
 
-				clausesToRemove.emplace_back(
-					clauseGlobalIdx,
-					matchedClausesIdx[columnIdx]); /* To optimize: requires a check later at deletion */
-			}
+		if (withAdjacency)
+			this->updateAdjacency(this->clauses.back(), 1);
 
-			std::swap(matchedClauses, matchedClausesSwap);
-			std::swap(matchedClausesIdx, matchedClausesIdxSwap);
+		if (this->generateProof) {
+			this->proof.emplace_back(ProofClause{ this->clauses.back(), true });
+		}
+		LOGDEBUG3("PreservedModel clauses generated");
+	}
 
-			LOGDEBUG3("Matched clauses new size %d", matchedClauses.size());
+	/* Remove olds clauses: the ones whose clause of match.lit is still matched at the end */
+	std::vector<int> validClausesToDelete(match.matchedClausesIdx);
+	std::sort(validClausesToDelete.begin(), validClausesToDelete.end());
 
-		} // end of while(1)
+	std::vector<int> litsToUpdate;
 
-		unsigned int matchesClauseCount = matchedClauses.size();
-		unsigned int matchesCount = matchedLiterals.size();
+	for (auto& pair : match.clausesToRemove) {
+		int clauseGlobalIdx = pair.first;
+		int clauseMatrixIdx = pair.second;
 
-		/* No match or not worth it: take another literal */
-		if (matchesCount == 1 || (matchesCount <= 2 && matchesClauseCount <= 2))
+		if (!std::binary_search(validClausesToDelete.begin(), validClausesToDelete.end(), clauseMatrixIdx))
 			continue;
 
-		/* Introduce new var and update clauses */
-		int newVar = ++this->varCount;
-
-		assert(newVar > 0);
+		this->isClauseDeleted[clauseGlobalIdx] = true;
+		this->adjacencyDeleted++;
 
-		LOGDEBUG3("A new variable %d was added", newVar);
-
-		/* Current clauses + (newVar, matche_i) clauses + (newVar, C \ matche_i) + preservingModelCountClause */
-		this->clauses.reserve(this->clauses.size() + matchesCount + matchesClauseCount + this->preserveModelCount);
-		this->litToClause.resize(this->varCount * 2);
-		this->litCountAdjustement.resize(this->varCount * 2);
-
-		/* Check if the adjency matrices have to be reconstructed */
-		if (MATRIX_VAR_TO_IDX(newVar) >= this->adjacencyMatrixWidth) {
-			LOGDEBUG1("All the adjacency matrix is to be recomputed");
-			this->adjacencyMatrixWidth = this->varCount * 2;
-			this->adjacencyMatrix.clear();
+		for (int lit : this->clauses[clauseGlobalIdx]) {
+			this->litCount[LIT_IDX(lit)]--;
+			this->litDeadCount[LIT_IDX(lit)]++;
+			touched[std::abs(lit)] = stamp;
+			litsToUpdate.push_back(lit);
 		}
-		this->adjacencyMatrix.resize(this->varCount);
 
-		/* Adding (newVar, match_i) clauses */
-		for (int lit : matchedLiterals) {
-			// Add clause
-			this->clauses.emplace_back(std::vector<int>{ lit, newVar });
-			this->isClauseDeleted.push_back(false);
-			// Update occurence lists
-			int newClauseGlobalIdx = this->clauses.size() - 1;
-			this->litToClause[LIT_IDX(lit)].push_back(newClauseGlobalIdx);
-			this->litToClause[PLIT_IDX(newVar)].push_back(newClauseGlobalIdx);
-
-			if (this->generateProof) {
-				// newVar must be first in proof clause
-				this->proof.emplace_back(ProofClause{ std::vector<int>{ newVar, lit }, true });
-			}
+		if (withAdjacency)
+			this->updateAdjacency(this->clauses[clauseGlobalIdx], -1);
+
+		if (this->generateProof) {
+			proof.emplace_back(ProofClause{ this->clauses[clauseGlobalIdx], false });
 		}
+	}
 
-		/* Adding (-newVar, ... ) clauses */
-		for (unsigned int globalClauseIdx : matchedClauses) {
-			int newNLit = -1 * newVar;
-			this->clauses.emplace_back(std::vector<int>{ newNLit });
-			this->isClauseDeleted.push_back(false);
+	std::sort(litsToUpdate.begin(), litsToUpdate.end());
+	litsToUpdate.erase(std::unique(litsToUpdate.begin(), litsToUpdate.end()), litsToUpdate.end());
 
-			int newClauseGlobalIdx = this->clauses.size() - 1;
-			this->litToClause[NLIT_IDX(newNLit)].push_back(newClauseGlobalIdx);
+	/* Requeue modified literals, compacting the occurence lists holding more deleted clauses than live ones */
+	for (int lit : litsToUpdate) /* match.lit is always in litsToUpdate*/
+	{
+		if (this->litDeadCount[LIT_IDX(lit)] > this->litCount[LIT_IDX(lit)])
+			this->compactOccurrences(LIT_IDX(lit));
+		litQueue.update(lit, REAL_LIT_COUNT(lit)); /* can be rematched since clauses were deleted */
+	}
 
-			for (int lit : this->clauses[globalClauseIdx]) {
-				if (lit != currentLit.lit) {
-					this->clauses.back().push_back(lit);
-					this->litToClause[LIT_IDX(lit)].push_back(newClauseGlobalIdx);
-				}
-			}
+	litQueue.update(newVar, REAL_LIT_COUNT(newVar));
+	litQueue.update(-newVar, REAL_LIT_COUNT(-newVar));
 
-			if (this->generateProof) {
-				this->proof.emplace_back(ProofClause{ this->clauses.back(), true });
-			}
-		}
+	this->replacementsCount++;
+}
 
-		/* From Original Implementation */
-		// Preserving model count:
-		//
-		// The only case where we add a model is if both assignments for the auxiiliary variable satisfy the formula
-		// for the same assignment of the original variables. This only happens if all(matched_lits) *AND*
-		// all(matches_clauses) are satisfied.
-		//
-		// The easiest way to fix this is to add one clause that constrains all(matched_lits) => -f
-		if (this->preserveModelCount) {
-			int newNLit = -1 * newVar;
-			this->clauses.emplace_back(std::vector<int>{ newNLit });
-			this->isClauseDeleted.push_back(false);
-
-			int newClauseGlobalIdx = this->clauses.size() - 1;
-			this->litToClause[NLIT_IDX(newNLit)].push_back(newClauseGlobalIdx);
-
-			for (int lit : matchedLiterals) {
-				this->clauses.back().push_back(-lit);
-				this->litToClause[LIT_IDX(lit)].push_back(newClauseGlobalIdx);
-			}
+SatResult
+StructuredBVA::solve(const std::vector<int>& cube)
+{
+	if (!this->m_initialized) {
+		LOGWARN("SBVA %d wasn't initialized correctly, cannot run, returning", this->getSolverId());
+		return SatResult::UNKNOWN;
+	}
 
-			if (this->generateProof) {
-				this->proof.emplace_back(ProofClause{ this->clauses.back(), true });
-			}
-			LOGDEBUG3("PreservedModel clauses generated");
-		}
+	if (this->tieBreakHeuristic == SBVATieBreak::THREEHOPS)
+		this->buildAdjacency();
 
-		/* Remove olds clauses */
+	/* The queue keeps each literal once with its number of occurences, using a certain order */
+	SBVALitQueue litQueue;
+	litQueue.init(this->litOrder, this->getSolverId());
 
-		litsToUpdate.clear();
+	/* Init queue with original literals, DIVERSIFICATION potentiel: change the order, do not add all literals ... */
+	for (int i = 1; i <= this->varCount; i++) {
+		litQueue.update(i, REAL_LIT_COUNT(i));
+		litQueue.update(-i, REAL_LIT_COUNT(-i));
 
-		/* TODO: a better clause deletion management */
-		std::set<int> validClausesToDelete;
+		LOGDEBUG3("Queued: (%d,%u), (%d,%u)", i, REAL_LIT_COUNT(i), -i, REAL_LIT_COUNT(-i));
+	}
 
-		for (unsigned int i = 0; i < matchesClauseCount; i++) {
-			validClausesToDelete.insert(matchedClausesIdx[i]);
+	/* The literals are popped by batches, matched concurrently on the same formula, and their replacements are applied
+	 * in the popping order. A replacement whose matching read a variable touched by a previous replacement of the
+	 * batch is dropped and its literal requeued, thus the batches only keep the matches of disjoint sets of literals.
+	 * With one thread a batch is one literal: this is the sequential algorithm. */
+	const unsigned int batchSize = (this->threads > 1) ? 4 * this->threads : 1;
+
+	std::vector<int> batch;
+	std::vector<SBVAMatch> matches(batchSize);
+	std::vector<char> worthIt(batchSize);
+	std::vector<SBVAScratch> scratches(this->threads);
+
+	/* touched[var] == stamp iff var is in a clause deleted during the current batch */
+	std::vector<unsigned int> touched(this->varCount + 1, 0);
+	unsigned int stamp = 0;
+
+	std::atomic<unsigned int> nextTask(0);
+	bool ending = false;
+	std::barrier sync(this->threads);
+
+	auto matchBatch = [&](SBVAScratch& scratch) {
+		for (unsigned int task = nextTask++; task < batch.size(); task = nextTask++)
+			worthIt[task] = this->matchLiteral(batch[task], matches[task], scratch);
+	};
+
+	auto worker = [&](unsigned int id) {
+		while (true) {
+			sync.arrive_and_wait();
+			if (ending)
+				return;
+			matchBatch(scratches[id]);
+			sync.arrive_and_wait();
 		}
+	};
 
-		for (auto& pair : clausesToRemove) {
-			int clauseGlobalIdx = pair.first;
-			int clauseMatrixIdx = pair.second;
-
-			if (validClausesToDelete.find(clauseMatrixIdx) == validClausesToDelete.end())
-				continue;
-
-			this->isClauseDeleted[clauseGlobalIdx] = true;
-			this->adjacencyDeleted++;
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < this->threads; i++)
+		pool.emplace_back(worker, i);
 
-			for (int lit : this->clauses[clauseGlobalIdx]) {
-				this->litCountAdjustement[LIT_IDX(lit)]--;
-				litsToUpdate.insert(lit);
-			}
+	this->replacementsCount = 0;
 
-			if (this->generateProof) {
-				proof.emplace_back(ProofClause{ this->clauses[clauseGlobalIdx], false });
-			}
+	while (!litQueue.empty()) {
+		/* Check if to stop */
+		if (this->stopPreprocessing || globalEnding ||
+			(this->maxReplacements > 0 && this->replacementsCount >= this->maxReplacements)) {
+			LOG0("SBVA %d is ending: stopPreprocessing %d, globalEnding %d, maxReplacement %u, replacementCount %u",
+				 this->getSolverId(),
+				 this->stopPreprocessing.load(),
+				 globalEnding.load(),
+				 this->maxReplacements,
+				 this->replacementsCount);
+			break;
 		}
 
-		/* Requeue modified literals */
+		batch.clear();
+		while (batch.size() < batchSize && !litQueue.empty())
+			batch.push_back(litQueue.pop());
 
-		for (int lit : litsToUpdate) /* currentLit.lit is always in litsToUpdate*/
-		{
-			litQueue.emplace(queuePair{ lit, REAL_LIT_COUNT(lit) }); /* can be rematched since clauses were deleted */
-			this->adjacencyMatrix[MATRIX_LIT_TO_IDX(lit)] = Eigen::SparseVector<int>(this->adjacencyMatrixWidth);
+		for (SBVAScratch& scratch : scratches) {
+			scratch.litMatches.resize(2 * this->varCount, 0);
+			scratch.litStamp.resize(2 * this->varCount, 0);
 		}
 
-		int realOccurences = this->litToClause[PLIT_IDX(newVar)].size() + this->litCountAdjustement[PLIT_IDX(newVar)];
-		litQueue.emplace(queuePair{ (int)this->varCount, (unsigned int)realOccurences }); /* occurences >= 0*/
-
-		realOccurences =
-			this->litToClause[NLIT_IDX(-1 * newVar)].size() + this->litCountAdjustement[NLIT_IDX(-1 * newVar)];
-		litQueue.emplace(queuePair{ -1 * newVar, (unsigned int)realOccurences });
+		nextTask = 0;
+		if (!pool.empty()) {
+			sync.arrive_and_wait();
+			matchBatch(scratches[0]);
+			sync.arrive_and_wait();
+		} else {
+			matchBatch(scratches[0]);
+		}
 
-		this->replacementsCount++;
+		stamp++;
+		for (unsigned int i = 0; i < batch.size(); i++) {
+			/* Nothing was touched before the first match of the batch */
+			if (i > 0 && !this->isMatchValid(matches[i], touched, stamp)) {
+				litQueue.update(batch[i], REAL_LIT_COUNT(batch[i]));
+				continue;
+			}
+			/* No match or not worth it: take another literal */
+			if (!worthIt[i])
+				continue;
+			if (this->maxReplacements > 0 && this->replacementsCount >= this->maxReplacements)
+				break;
+			this->applyMatch(matches[i], litQueue, touched, stamp);
+		}
 	}
 
+	ending = true;
+	if (!pool.empty())
+		sync.arrive_and_wait();
+	for (auto& thread : pool)
+		thread.join();
+
 	return SatResult::UNKNOWN;
 }
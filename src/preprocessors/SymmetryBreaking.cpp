@@ -0,0 +1,746 @@
+#include "preprocessors/SymmetryBreaking.hpp"
+#include "containers/ClauseUtils.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/System.hpp"
+#include "utils/hashfunc.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include <string>
+
+/// Generator mappings printed in the logs
+static const unsigned int LOGGED_MAPPINGS = 8;
+
+/// Clause order: by variable, then negative literal first
+static inline bool
+litLess(int lit1, int lit2)
+{
+	return std::abs(lit1) < std::abs(lit2) || (std::abs(lit1) == std::abs(lit2) && lit1 < lit2);
+}
+
+static inline uint64_t
+hashClause(const simpleClause& clause)
+{
+	return ClauseUtils::lookup3_hash_clause(clause.data(), clause.size());
+}
+
+static inline void
+mixTrace(uint64_t& trace, uint64_t value)
+{
+	trace = (trace ^ value) * fnv<uint64_t>::prime;
+}
+
+SymmetryBreaking::SymmetryBreaking(int _id)
+	: PreprocessorInterface(PreprocessorAlgorithm::SYMMETRY, _id)
+{
+	this->initializeTypeId<SymmetryBreaking>();
+
+	/* Status */
+	this->m_initialized = false;
+	this->stopPreprocessing = false;
+	this->unsat = false;
+	this->timedOut = false;
+
+	this->nodeCount = 0;
+	this->literalNodes = 0;
+	this->cellCount = 0;
+	this->queueHead = 0;
+	this->failures = 0;
+
+	/* Options */
+	this->timeout = __globalParameters__.symTimeout;
+	this->maxClauses = __globalParameters__.symMaxClauses;
+	this->breakLength = __globalParameters__.symBreakLength;
+	this->maxFailures = __globalParameters__.symBacktracks;
+	this->startTime = 0;
+
+	/* Stats */
+	this->varCount = 0;
+	this->auxCount = 0;
+	this->originalClauseCount = 0;
+	this->breakingCount = 0;
+	this->refinements = 0;
+	this->leaves = 0;
+	this->searchTime = 0;
+}
+
+SymmetryBreaking::~SymmetryBreaking()
+{
+	LOGDEBUG1("SYM %d deleted!", this->getSolverId());
+}
+
+void
+SymmetryBreaking::setSolverInterrupt()
+{
+	if (!this->stopPreprocessing) {
+		LOG1("Asked SYM %d to terminate", this->getSolverId());
+		this->stopPreprocessing = true;
+	}
+}
+
+void
+SymmetryBreaking::unsetSolverInterrupt()
+{
+	this->stopPreprocessing = false;
+}
+
+bool
+SymmetryBreaking::isTimeout() const
+{
+	return this->stopPreprocessing ||
+		   SystemResourceMonitor::getRelativeTimeSeconds() - this->startTime > this->timeout;
+}
+
+/* Formula */
+/* ------- */
+
+bool
+SymmetryBreaking::normalize(simpleClause& clause)
+{
+	std::sort(clause.begin(), clause.end(), litLess);
+	clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+	for (unsigned int i = 1; i < clause.size(); i++)
+		if (clause[i] == -clause[i - 1])
+			return false;
+	return true;
+}
+
+void
+SymmetryBreaking::insertClause(simpleClause&& clause)
+{
+	if (!this->normalize(clause))
+		return;
+
+	if (clause.empty()) {
+		this->unsat = true;
+		return;
+	}
+
+	// A duplicate would be a clause node without any image but itself
+	uint64_t hash = hashClause(clause);
+	auto range = this->clauseIndex.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+		if (this->clauses[it->second] == clause)
+			return;
+
+	this->clauseIndex.emplace(hash, this->clauses.size());
+	this->clauses.push_back(std::move(clause));
+}
+
+void
+SymmetryBreaking::addInitialClauses(const std::vector<simpleClause>& initClauses, unsigned int nbVariables)
+{
+	this->varCount = nbVariables;
+	this->clauses.reserve(initClauses.size());
+
+	for (unsigned int i = 0; i < initClauses.size() && !this->stopPreprocessing; i++)
+		this->insertClause(simpleClause(initClauses[i]));
+
+	this->originalClauseCount = this->clauses.size();
+	this->m_initialized = !this->stopPreprocessing;
+	LOG1("Loaded %zu clauses in SYM %d", this->clauses.size(), this->getSolverId());
+}
+
+void
+SymmetryBreaking::addInitialClauses(const lit_t* literals, unsigned int nbClauses, unsigned int nbVariables)
+{
+	this->varCount = nbVariables;
+	this->clauses.reserve(nbClauses);
+
+	for (unsigned int i = 0; i < nbClauses && !this->stopPreprocessing; i++) {
+		const lit_t* end = literals;
+		while (*end)
+			end++;
+		this->insertClause(simpleClause(literals, end));
+		literals = end + 1;
+	}
+
+	this->originalClauseCount = this->clauses.size();
+	this->m_initialized = !this->stopPreprocessing;
+	LOG1("Loaded %zu clauses in SYM %d", this->clauses.size(), this->getSolverId());
+}
+
+void
+SymmetryBreaking::loadFormula(const char* filename)
+{
+	std::vector<simpleClause> initClauses;
+	unsigned int nbVariables;
+
+	if (!Parsers::parseCNF(filename, initClauses, &nbVariables)) {
+		LOGERROR("Error at parsing!");
+		this->m_initialized = false;
+		return;
+	}
+
+	this->addInitialClauses(initClauses, nbVariables);
+}
+
+std::vector<simpleClause>
+SymmetryBreaking::getSimplifiedFormula()
+{
+	std::vector<simpleClause> formula;
+	formula.reserve(this->clauses.size() + this->breakingClauses.size());
+	formula.insert(formula.end(), this->clauses.begin(), this->clauses.end());
+	formula.insert(formula.end(), this->breakingClauses.begin(), this->breakingClauses.end());
+	return formula;
+}
+
+void
+SymmetryBreaking::releaseMemory()
+{
+	std::vector<simpleClause>().swap(this->clauses);
+	std::unordered_multimap<uint64_t, unsigned int>().swap(this->clauseIndex);
+	std::vector<simpleClause>().swap(this->breakingClauses);
+	std::vector<SymGenerator>().swap(this->generators);
+	std::vector<unsigned int>().swap(this->adjacencyStart);
+	std::vector<unsigned int>().swap(this->adjacency);
+	std::vector<unsigned int>().swap(this->elements);
+	std::vector<unsigned int>().swap(this->position);
+	std::vector<unsigned int>().swap(this->cellOf);
+	std::vector<unsigned int>().swap(this->cellSize);
+	std::vector<char>().swap(this->inQueue);
+	std::vector<unsigned int>().swap(this->count);
+	std::vector<Split>().swap(this->trail);
+	std::vector<Level>().swap(this->levels);
+	std::vector<unsigned int>().swap(this->leftLeaf);
+	std::vector<unsigned int>().swap(this->orbits);
+}
+
+/* Graph and partition */
+/* ------------------- */
+
+void
+SymmetryBreaking::buildGraph()
+{
+	this->literalNodes = 2 * this->varCount;
+	this->nodeCount = this->literalNodes + this->clauses.size();
+
+	// Degrees, shifted by one for the prefix sum
+	this->adjacencyStart.assign(this->nodeCount + 1, 0);
+	for (unsigned int node = 0; node < this->literalNodes; node++)
+		this->adjacencyStart[node + 1] = 1;
+	for (unsigned int idx = 0; idx < this->clauses.size(); idx++) {
+		this->adjacencyStart[this->literalNodes + idx + 1] = this->clauses[idx].size();
+		for (int lit : this->clauses[idx])
+			this->adjacencyStart[LIT_IDX(lit) + 1]++;
+	}
+	std::partial_sum(this->adjacencyStart.begin(), this->adjacencyStart.end(), this->adjacencyStart.begin());
+
+	this->adjacency.resize(this->adjacencyStart[this->nodeCount]);
+	std::vector<unsigned int> next(this->adjacencyStart.begin(), this->adjacencyStart.end() - 1);
+	for (unsigned int node = 0; node < this->literalNodes; node++)
+		this->adjacency[next[node]++] = node ^ 1;
+	for (unsigned int idx = 0; idx < this->clauses.size(); idx++) {
+		unsigned int clauseNode = this->literalNodes + idx;
+		for (int lit : this->clauses[idx]) {
+			unsigned int litNode = LIT_IDX(lit);
+			this->adjacency[next[clauseNode]++] = litNode;
+			this->adjacency[next[litNode]++] = clauseNode;
+		}
+	}
+}
+
+void
+SymmetryBreaking::initPartition()
+{
+	// Literals of the formula, clauses by size, and a color per unused variable not to search their permutations
+	auto color = [this](unsigned int node) -> uint64_t {
+		if (node >= this->literalNodes)
+			return this->clauses[node - this->literalNodes].size();
+		unsigned int first = node & ~1U;
+		if (this->adjacencyStart[first + 2] - this->adjacencyStart[first] > 2)
+			return 0;
+		return (1ULL << 32) + first / 2;
+	};
+
+	std::vector<uint64_t> colors(this->nodeCount);
+	for (unsigned int node = 0; node < this->nodeCount; node++)
+		colors[node] = color(node);
+
+	this->elements.resize(this->nodeCount);
+	std::iota(this->elements.begin(), this->elements.end(), 0);
+	std::sort(this->elements.begin(), this->elements.end(), [&colors](unsigned int node1, unsigned int node2) {
+		return colors[node1] < colors[node2];
+	});
+
+	this->position.resize(this->nodeCount);
+	this->cellOf.resize(this->nodeCount);
+	this->cellSize.assign(this->nodeCount, 0);
+	this->inQueue.assign(this->nodeCount, 0);
+	this->count.assign(this->nodeCount, 0);
+	this->queue.clear();
+	this->queueHead = 0;
+	this->cellCount = 0;
+
+	unsigned int start = 0;
+	for (unsigned int pos = 0; pos < this->nodeCount; pos++) {
+		unsigned int node = this->elements[pos];
+		if (pos > 0 && colors[node] != colors[this->elements[pos - 1]]) {
+			start = pos;
+		}
+		if (start == pos) {
+			this->cellCount++;
+			this->queue.push_back(start);
+			this->inQueue[start] = 1;
+		}
+		this->position[node] = pos;
+		this->cellOf[node] = start;
+		this->cellSize[start]++;
+	}
+}
+
+void
+SymmetryBreaking::swapPositions(unsigned int pos1, unsigned int pos2)
+{
+	unsigned int node1 = this->elements[pos1];
+	unsigned int node2 = this->elements[pos2];
+	this->elements[pos1] = node2;
+	this->elements[pos2] = node1;
+	this->position[node2] = pos1;
+	this->position[node1] = pos2;
+}
+
+uint64_t
+SymmetryBreaking::refine()
+{
+	uint64_t trace = fnv<uint64_t>::init;
+	unsigned int splitters = 0;
+	this->refinements++;
+
+	while (this->queueHead < this->queue.size() && this->cellCount < this->nodeCount) {
+		if ((++splitters & 1023) == 0 && this->isTimeout()) {
+			this->timedOut = true;
+			break;
+		}
+
+		unsigned int splitter = this->queue[this->queueHead++];
+		unsigned int size = this->cellSize[splitter];
+		this->inQueue[splitter] = 0;
+		mixTrace(trace, splitter);
+		mixTrace(trace, size);
+
+		// Number of neighbours of each node in the splitter cell
+		this->touched.clear();
+		for (unsigned int pos = splitter; pos < splitter + size; pos++) {
+			unsigned int node = this->elements[pos];
+			for (unsigned int edge = this->adjacencyStart[node]; edge < this->adjacencyStart[node + 1]; edge++)
+				if (this->count[this->adjacency[edge]]++ == 0)
+					this->touched.push_back(this->adjacency[edge]);
+		}
+
+		// The touched cells are split in position order, which does not depend on the labels of the nodes
+		std::sort(this->touched.begin(), this->touched.end(), [this](unsigned int node1, unsigned int node2) {
+			return this->cellOf[node1] < this->cellOf[node2] ||
+				   (this->cellOf[node1] == this->cellOf[node2] && this->count[node1] < this->count[node2]);
+		});
+
+		size_t end;
+		for (size_t begin = 0; begin < this->touched.size(); begin = end) {
+			unsigned int cell = this->cellOf[this->touched[begin]];
+			for (end = begin + 1; end < this->touched.size() && this->cellOf[this->touched[end]] == cell; end++)
+				;
+			if (this->cellSize[cell] > 1)
+				this->splitCell(cell, begin, end, trace);
+		}
+
+		for (unsigned int node : this->touched)
+			this->count[node] = 0;
+	}
+
+	// A discrete partition needs no more splitters
+	for (size_t i = this->queueHead; i < this->queue.size(); i++)
+		this->inQueue[this->queue[i]] = 0;
+	this->queue.clear();
+	this->queueHead = 0;
+
+	return trace;
+}
+
+void
+SymmetryBreaking::splitCell(unsigned int cell, size_t begin, size_t end, uint64_t& trace)
+{
+	const unsigned int size = this->cellSize[cell];
+	const unsigned int touchedCount = end - begin;
+	if (touchedCount == size && this->count[this->touched[begin]] == this->count[this->touched[end - 1]])
+		return;
+
+	// The touched nodes move to the tail of the cell by increasing count, the untouched ones stay first
+	const unsigned int tail = cell + size - touchedCount;
+	for (unsigned int i = 0; i < touchedCount; i++)
+		this->swapPositions(this->position[this->touched[begin + i]], tail + i);
+
+	// The first group keeps the start of the cell, and the cell of its nodes
+	unsigned int kept = size - touchedCount;
+	size_t first = begin;
+	if (kept == 0) {
+		while (first < end && this->count[this->touched[first]] == this->count[this->touched[begin]])
+			first++;
+		kept = first - begin;
+	}
+	this->cellSize[cell] = kept;
+	mixTrace(trace, cell);
+	mixTrace(trace, kept);
+
+	unsigned int largest = cell;
+	unsigned int newCells = 0;
+	size_t next;
+	for (size_t i = first; i < end; i = next) {
+		for (next = i + 1; next < end && this->count[this->touched[next]] == this->count[this->touched[i]]; next++)
+			;
+		unsigned int start = tail + (i - begin);
+		this->cellSize[start] = next - i;
+		for (size_t j = i; j < next; j++)
+			this->cellOf[this->touched[j]] = start;
+		if (this->cellSize[start] > this->cellSize[largest])
+			largest = start;
+		mixTrace(trace, this->count[this->touched[i]]);
+		mixTrace(trace, next - i);
+		newCells++;
+	}
+	this->cellCount += newCells;
+	this->trail.push_back({ cell, size, kept, newCells });
+
+	// A queued cell is replaced by all its parts, otherwise the largest part is not needed as a splitter
+	const bool queued = this->inQueue[cell];
+	for (unsigned int start = cell; start < cell + size; start += this->cellSize[start]) {
+		if (queued ? start == cell : start == largest)
+			continue;
+		this->queue.push_back(start);
+		this->inQueue[start] = 1;
+	}
+}
+
+void
+SymmetryBreaking::individualize(unsigned int node)
+{
+	unsigned int cell = this->cellOf[node];
+	unsigned int size = this->cellSize[cell];
+	unsigned int last = cell + size - 1;
+
+	this->swapPositions(this->position[node], last);
+	this->cellSize[cell] = size - 1;
+	this->cellSize[last] = 1;
+	this->cellOf[node] = last;
+	this->cellCount++;
+	this->trail.push_back({ cell, size, size - 1, 1 });
+
+	this->queue.push_back(last);
+	this->inQueue[last] = 1;
+}
+
+void
+SymmetryBreaking::undoTo(size_t mark)
+{
+	while (this->trail.size() > mark) {
+		const Split& split = this->trail.back();
+		for (unsigned int pos = split.start + split.kept; pos < split.start + split.size; pos++)
+			this->cellOf[this->elements[pos]] = split.start;
+		this->cellSize[split.start] = split.size;
+		this->cellCount -= split.newCells;
+		this->trail.pop_back();
+	}
+}
+
+/* Search */
+/* ------ */
+
+unsigned int
+SymmetryBreaking::findOrbit(unsigned int node)
+{
+	while (this->orbits[node] != node) {
+		this->orbits[node] = this->orbits[this->orbits[node]];
+		node = this->orbits[node];
+	}
+	return node;
+}
+
+void
+SymmetryBreaking::searchGenerators()
+{
+	this->buildGraph();
+	this->initPartition();
+	this->refine();
+	this->trail.clear();
+
+	// First path, individualizing the first node of the first non singleton cell
+	unsigned int cursor = 0;
+	while (!this->timedOut && this->cellCount < this->nodeCount) {
+		while (this->cellSize[this->cellOf[this->elements[cursor]]] == 1)
+			cursor++;
+		Level level{ cursor, this->cellSize[cursor], this->elements[cursor], this->trail.size(), 0 };
+		this->individualize(level.node);
+		level.trace = this->refine();
+		this->levels.push_back(level);
+	}
+	if (this->timedOut)
+		return;
+
+	this->leftLeaf = this->elements;
+	this->orbits.resize(this->nodeCount);
+	std::iota(this->orbits.begin(), this->orbits.end(), 0);
+
+	LOG1("[SYM %d] %u nodes, first path of %zu levels", this->getSolverId(), this->nodeCount, this->levels.size());
+
+	// The generators found at the deeper levels fix the nodes of the upper levels, their orbits prune the candidates
+	std::vector<unsigned int> tried(this->nodeCount, UINT_MAX);
+	for (size_t k = this->levels.size(); k-- > 0 && !this->timedOut;) {
+		const Level level = this->levels[k];
+		this->undoTo(level.trailMark);
+
+		std::vector<unsigned int> cell(this->elements.begin() + level.start,
+									   this->elements.begin() + level.start + level.size);
+		for (unsigned int node : cell) {
+			unsigned int orbit = this->findOrbit(node);
+			if (orbit == this->findOrbit(level.node) || tried[orbit] == k)
+				continue;
+			tried[orbit] = k;
+
+			if (this->isTimeout()) {
+				this->timedOut = true;
+				break;
+			}
+
+			this->failures = 0;
+			this->individualize(node);
+			if (this->refine() == level.trace)
+				this->descend(k + 1);
+			this->undoTo(level.trailMark);
+		}
+	}
+}
+
+SymmetryBreaking::Frame
+SymmetryBreaking::makeFrame(unsigned int level)
+{
+	const Level& left = this->levels[level];
+	Frame frame{ level, {}, 0, this->trail.size() };
+	if (this->cellOf[this->elements[left.start]] != left.start || this->cellSize[left.start] != left.size)
+		return frame;
+
+	// The node of the first path first: the deeper levels are often fixed by the generators
+	frame.candidates.assign(this->elements.begin() + left.start, this->elements.begin() + left.start + left.size);
+	auto it = std::find(frame.candidates.begin(), frame.candidates.end(), left.node);
+	if (it != frame.candidates.end())
+		std::iter_swap(frame.candidates.begin(), it);
+	return frame;
+}
+
+bool
+SymmetryBreaking::descend(unsigned int level)
+{
+	if (level == this->levels.size())
+		return this->checkLeaf();
+
+	std::vector<Frame> stack;
+	stack.push_back(this->makeFrame(level));
+	while (!stack.empty()) {
+		Frame& frame = stack.back();
+		if (frame.next > 0)
+			this->undoTo(frame.trailMark);
+		if (frame.next == frame.candidates.size() || this->failures > this->maxFailures || this->timedOut) {
+			stack.pop_back();
+			continue;
+		}
+
+		unsigned int current = frame.level;
+		this->individualize(frame.candidates[frame.next++]);
+		if (this->refine() != this->levels[current].trace) {
+			this->failures++;
+		} else if (current + 1 < this->levels.size()) {
+			stack.push_back(this->makeFrame(current + 1));
+		} else if (this->checkLeaf()) {
+			return true;
+		} else {
+			this->failures++;
+		}
+	}
+	return false;
+}
+
+bool
+SymmetryBreaking::checkLeaf()
+{
+	this->leaves++;
+	if (this->cellCount != this->nodeCount)
+		return false;
+
+	std::vector<unsigned int> image(this->literalNodes);
+	for (unsigned int pos = 0; pos < this->nodeCount; pos++) {
+		unsigned int from = this->leftLeaf[pos];
+		if (from >= this->literalNodes)
+			continue;
+		if (this->elements[pos] >= this->literalNodes)
+			return false;
+		image[from] = this->elements[pos];
+	}
+
+	if (!this->isSymmetry(image))
+		return false;
+
+	SymGenerator generator;
+	for (unsigned int var = 1; var <= this->varCount; var++) {
+		unsigned int node = 2 * (var - 1);
+		if (image[node] != node)
+			generator.emplace_back(var, IDX_LIT(image[node]));
+	}
+	if (generator.empty())
+		return false;
+
+	for (unsigned int pos = 0; pos < this->nodeCount; pos++)
+		this->orbits[this->findOrbit(this->leftLeaf[pos])] = this->findOrbit(this->elements[pos]);
+
+	std::string mappings;
+	for (unsigned int i = 0; i < generator.size() && i < LOGGED_MAPPINGS; i++)
+		mappings += " " + std::to_string(generator[i].first) + "->" + std::to_string(generator[i].second);
+	LOG1("[SYM %d] generator %zu, support %zu:%s%s",
+		 this->getSolverId(),
+		 this->generators.size(),
+		 generator.size(),
+		 mappings.c_str(),
+		 generator.size() > LOGGED_MAPPINGS ? " ..." : "");
+
+	this->generators.push_back(std::move(generator));
+	return true;
+}
+
+bool
+SymmetryBreaking::isSymmetry(const std::vector<unsigned int>& image)
+{
+	for (unsigned int node = 0; node < this->literalNodes; node += 2)
+		if (image[node + 1] != (image[node] ^ 1))
+			return false;
+
+	// Only the clauses of the moved literals may be mapped to other clauses
+	simpleClause mapped;
+	for (unsigned int node = 0; node < this->literalNodes; node++) {
+		if (image[node] == node)
+			continue;
+		for (unsigned int edge = this->adjacencyStart[node]; edge < this->adjacencyStart[node + 1]; edge++) {
+			unsigned int clauseNode = this->adjacency[edge];
+			if (clauseNode < this->literalNodes)
+				continue;
+
+			mapped.clear();
+			for (int lit : this->clauses[clauseNode - this->literalNodes])
+				mapped.push_back(IDX_LIT(image[LIT_IDX(lit)]));
+			std::sort(mapped.begin(), mapped.end(), litLess);
+
+			auto range = this->clauseIndex.equal_range(hashClause(mapped));
+			if (std::none_of(range.first, range.second, [&](const auto& entry) {
+					return this->clauses[entry.second] == mapped;
+				}))
+				return false;
+		}
+	}
+	return true;
+}
+
+/* Breaking */
+/* -------- */
+
+unsigned int
+SymmetryBreaking::breakGenerator(const SymGenerator& generator, unsigned int budget)
+{
+	/* x <= g(x) in lexicographic order: with e(i) meaning that the first i positions are equal,
+	 * e(i-1) -> (x(i) -> g(x(i))), and e(i-1) & x(i) = g(x(i)) -> e(i), split in two clauses by the first one. */
+	unsigned int added = 0;
+	int equal = 0;
+	const unsigned int positions = std::min<size_t>(generator.size(), this->breakLength);
+
+	for (unsigned int i = 0; i < positions && added < budget; i++) {
+		auto [var, image] = generator[i];
+		const bool last = (i + 1 == positions) || added + 3 > budget || image == -var;
+
+		simpleClause clause;
+		if (equal)
+			clause.push_back(-equal);
+		clause.push_back(-var);
+		if (image != -var)
+			clause.push_back(image);
+		this->breakingClauses.push_back(clause);
+		added++;
+
+		if (last)
+			break;
+
+		int next = this->varCount + ++this->auxCount;
+		simpleClause prefix;
+		if (equal)
+			prefix.push_back(-equal);
+		this->breakingClauses.push_back(prefix);
+		this->breakingClauses.back().insert(this->breakingClauses.back().end(), { -var, next });
+		this->breakingClauses.push_back(prefix);
+		this->breakingClauses.back().insert(this->breakingClauses.back().end(), { image, next });
+		added += 2;
+		equal = next;
+	}
+	return added;
+}
+
+SatResult
+SymmetryBreaking::solve(const std::vector<int>& cube)
+{
+	if (!this->m_initialized) {
+		LOGWARN("SYM %d wasn't initialized correctly, cannot run, returning", this->getSolverId());
+		return SatResult::UNKNOWN;
+	}
+
+	if (this->unsat)
+		return SatResult::UNSAT;
+
+	if (!cube.empty()) {
+		LOGWARN("SYM %d: the symmetries of the formula may not preserve the cube, no clause added",
+				this->getSolverId());
+		return SatResult::UNKNOWN;
+	}
+
+	this->startTime = SystemResourceMonitor::getRelativeTimeSeconds();
+	this->searchGenerators();
+	this->searchTime = SystemResourceMonitor::getRelativeTimeSeconds() - this->startTime;
+
+	unsigned int budget = this->maxClauses;
+	size_t broken = 0;
+	for (; broken < this->generators.size() && budget > 0; broken++)
+		budget -= this->breakGenerator(this->generators[broken], budget);
+	this->breakingCount = this->breakingClauses.size();
+
+	LOG0("[SYM %d] %zu generators in %.2fs%s, %zu broken: +%u clauses, +%u variables, %u -> %u clauses",
+		 this->getSolverId(),
+		 this->generators.size(),
+		 this->searchTime,
+		 this->timedOut ? " (timeout)" : "",
+		 broken,
+		 this->breakingCount,
+		 this->auxCount,
+		 this->originalClauseCount,
+		 this->originalClauseCount + this->breakingCount);
+
+	return SatResult::UNKNOWN;
+}
+
+/* Model */
+/* ----- */
+
+void
+SymmetryBreaking::restoreModel(std::vector<int>& model)
+{
+	if (model.size() > this->varCount)
+		model.resize(this->varCount);
+
+	LOG1("[SYM %d] restored model of size %zu", this->getSolverId(), model.size());
+}
+
+void
+SymmetryBreaking::printStatistics()
+{
+	LOG1("[SYM %d] varCount: %u, generators: %zu, refinements: %lu, leaves: %lu, breaking clauses: %u, aux: %u",
+		 this->getSolverId(),
+		 this->varCount,
+		 this->generators.size(),
+		 this->refinements,
+		 this->leaves,
+		 this->breakingCount,
+		 this->auxCount);
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+
+#include "preprocessors/PreprocessorInterface.hpp"
+#include "utils/Parsers.hpp"
+
+/// Symmetry of the formula, as the image of each moved variable, sorted by variable
+typedef std::vector<std::pair<int, int>> SymGenerator;
+
+/**
+ * @brief Static symmetry breaking: detection of the symmetries of the formula and lex-leader breaking clauses.
+ *
+ * The formula is encoded as a colored graph: a node per literal, linked to its negation, and a node per clause,
+ * linked to its literals and colored by its size. An automorphism of this graph is a permutation of the literals
+ * mapping the formula onto itself. Its generators are searched with an individualization-refinement algorithm:
+ *  - the partition of the nodes is refined until it is equitable (color refinement with splitter cells);
+ *  - a first path individualizes the first non singleton cell until the partition is discrete (the left leaf);
+ *  - at each level of this path, from the deepest one, the other nodes of the individualized cell are tried, and the
+ *    search descends with the same cells until a leaf whose refinement trace matches the left one. The mapping of the
+ *    two leaves is a generator if it maps every clause to a clause of the formula.
+ *
+ * The refinements only split cells, the splits are undone with a trail. The orbits of the generators found at the
+ * deeper levels prune the candidates.
+ *
+ * For each generator g, the lex-leader constraint x <= g(x) on its support (in variable order) is encoded with one
+ * auxiliary variable per position, within a budget of clauses. The constraints keep the lexicographically smallest
+ * model of each orbit, thus the formula stays satisfiable, and restoreModel() only drops the auxiliary variables.
+ *
+ * @ingroup preproc_solving
+ */
+class SymmetryBreaking : public PreprocessorInterface
+{
+  public:
+	SymmetryBreaking(int _id);
+
+	~SymmetryBreaking();
+
+	/// Variables of the formula and the auxiliary variables of the breaking clauses
+	unsigned int getVariablesCount() override { return this->varCount + this->auxCount; }
+
+	int getDivisionVariable() override { return 0; }
+
+	void setSolverInterrupt() override;
+
+	void unsetSolverInterrupt() override;
+
+	/**
+	 * @brief Search the generators and add their breaking clauses.
+	 * @param cube Must be empty: the symmetries of the formula may not preserve the cube.
+	 * @return UNSAT if the formula has an empty clause, UNKNOWN otherwise.
+	 */
+	SatResult solve(const std::vector<int>& cube = {}) override;
+
+	void addClause(ClauseExchangePtr) override {}
+
+	void addClauses(const std::vector<ClauseExchangePtr>&) override {}
+
+	void addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int nbVariables) override;
+
+	void addInitialClauses(const lit_t* literals, unsigned int nbClauses, unsigned int nbVariables) override;
+
+	void loadFormula(const char* filename) override;
+
+	/// The formula is never solved by the symmetry breaking
+	std::vector<int> getModel() override { return {}; }
+
+	void diversify(const SeedGenerator& = [](SolverInterface* s) { return s->getSolverId(); }) override {}
+
+	void printStatistics() override;
+
+	/// The clauses of the formula followed by the breaking clauses
+	std::vector<simpleClause> getSimplifiedFormula() override;
+
+	/// Drop the auxiliary variables, model[v-1] is v or -v
+	void restoreModel(std::vector<int>& model) override;
+
+	PreprocessorStats getPreprocessorStatistics() override
+	{
+		return { this->originalClauseCount + this->breakingCount, 0, 0, this->auxCount, 0 };
+	}
+
+	/// Release the graph and the clauses
+	void releaseMemory() override;
+
+  private:
+	/// Split of a cell, undone by merging back its tail into its first part
+	struct Split
+	{
+		unsigned int start;
+		unsigned int size;
+		unsigned int kept;
+		unsigned int newCells;
+	};
+
+	/// Individualization of the first path
+	struct Level
+	{
+		unsigned int start;
+		unsigned int size;
+		unsigned int node;
+		size_t trailMark;
+		uint64_t trace;
+	};
+
+	/// Search state of a level of the right path
+	struct Frame
+	{
+		unsigned int level;
+		std::vector<unsigned int> candidates;
+		size_t next;
+		size_t trailMark;
+	};
+
+	/// Sorted clause without duplicate literals, false if it is tautological
+	bool normalize(simpleClause& clause);
+
+	void insertClause(simpleClause&& clause);
+
+	/// Literal nodes first (LIT_IDX), then a node per clause
+	void buildGraph();
+
+	/// Cells of the nodes by color, all in the refinement queue
+	void initPartition();
+
+	/**
+	 * @brief Refine the partition with the queued splitter cells until it is equitable.
+	 * @return A hash of the splits, equal for two partitions refined the same way up to a relabeling.
+	 */
+	uint64_t refine();
+
+	/// Split a cell by the counts of the touched nodes touched[begin, end), sorted by count
+	void splitCell(unsigned int cell, size_t begin, size_t end, uint64_t& trace);
+
+	/// Move node to the end of its cell and make it a singleton cell, queued for the refinement
+	void individualize(unsigned int node);
+
+	/// Undo the splits after the trail mark
+	void undoTo(size_t mark);
+
+	void swapPositions(unsigned int pos1, unsigned int pos2);
+
+	/// Candidates of the right path at a level, empty if the cell does not match the left path
+	Frame makeFrame(unsigned int level);
+
+	/// Search a leaf matching the left leaf below the current partition, at the given level of the first path
+	bool descend(unsigned int level);
+
+	/// Keep the mapping of the left leaf to the current discrete partition if it is a symmetry of the formula
+	bool checkLeaf();
+
+	/// True if every clause touched by the mapping of the literal nodes is mapped to a clause of the formula
+	bool isSymmetry(const std::vector<unsigned int>& image);
+
+	unsigned int findOrbit(unsigned int node);
+
+	void searchGenerators();
+
+	/// Lex-leader clauses of a generator, at most budget clauses
+	unsigned int breakGenerator(const SymGenerator& generator, unsigned int budget);
+
+	bool isTimeout() const;
+
+	std::atomic<bool> stopPreprocessing;
+
+	/// Set when the empty clause is in the formula
+	bool unsat;
+
+	std::vector<simpleClause> clauses;
+
+	/// Clauses by lookup3 hash, for the symmetry checks
+	std::unordered_multimap<uint64_t, unsigned int> clauseIndex;
+
+	std::vector<simpleClause> breakingClauses;
+
+	std::vector<SymGenerator> generators;
+
+	// Graph
+	//------
+	unsigned int nodeCount;
+	unsigned int literalNodes;
+
+	/// Neighbours of node n in adjacency[adjacencyStart[n], adjacencyStart[n + 1])
+	std::vector<unsigned int> adjacencyStart;
+	std::vector<unsigned int> adjacency;
+
+	// Partition
+	//----------
+	/// The cells are contiguous in elements, a cell is identified by its first position
+	std::vector<unsigned int> elements;
+	std::vector<unsigned int> position;
+	std::vector<unsigned int> cellOf;
+
+	/// Size of the cell starting at a position
+	std::vector<unsigned int> cellSize;
+	unsigned int cellCount;
+
+	std::vector<unsigned int> queue;
+	size_t queueHead;
+	std::vector<char> inQueue;
+
+	/// Neighbours of the current splitter cell in touched, their number in count
+	std::vector<unsigned int> count;
+	std::vector<unsigned int> touched;
+
+	std::vector<Split> trail;
+
+	// Search
+	//-------
+	std::vector<Level> levels;
+	std::vector<unsigned int> leftLeaf;
+	std::vector<unsigned int> orbits;
+	unsigned int failures;
+
+	/// Set when the search is stopped, the generators found are kept
+	bool timedOut;
+
+	// Options
+	//--------
+	double timeout;
+	double startTime;
+	unsigned int maxClauses;
+	unsigned int breakLength;
+	unsigned int maxFailures;
+
+	// Stats
+	//------
+	unsigned int varCount;
+	unsigned int auxCount;
+	unsigned int originalClauseCount;
+	unsigned int breakingCount;
+	unsigned long refinements;
+	unsigned long leaves;
+	double searchTime;
+};
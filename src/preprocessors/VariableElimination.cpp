@@ -0,0 +1,618 @@
+#include "preprocessors/VariableElimination.hpp"
+#include "painless.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/System.hpp"
+
+#include <algorithm>
+#include <thread>
+
+/// Occurrence lists longer than this are not scanned for subsumed clauses
+static const unsigned int SUBSUME_OCC_LIMIT = 1000;
+
+/// Clause order: by variable, then negative literal first. Tautologies and duplicates are adjacent
+static inline bool
+litLess(int lit1, int lit2)
+{
+	return std::abs(lit1) < std::abs(lit2) || (std::abs(lit1) == std::abs(lit2) && lit1 < lit2);
+}
+
+/// True if the sorted clause1 is included in the sorted clause2
+static bool
+isSubset(const simpleClause& clause1, const simpleClause& clause2)
+{
+	unsigned int idx2 = 0;
+	for (int lit : clause1) {
+		while (idx2 < clause2.size() && litLess(clause2[idx2], lit))
+			idx2++;
+		if (idx2 == clause2.size() || clause2[idx2] != lit)
+			return false;
+		idx2++;
+	}
+	return true;
+}
+
+VariableElimination::VariableElimination(int _id)
+	: PreprocessorInterface(PreprocessorAlgorithm::BVE, _id)
+{
+	this->initializeTypeId<VariableElimination>();
+
+	/* Status */
+	this->m_initialized = false;
+	this->stopPreprocessing = false;
+	this->unsat = false;
+
+	/* Options */
+	this->threads = (__globalParameters__.bveThreads > 0) ? __globalParameters__.bveThreads : __globalParameters__.cpus;
+	this->occLimit = __globalParameters__.bveOccLimit;
+	this->resolventLimit = __globalParameters__.bveResolventSize;
+	this->timeout = __globalParameters__.bveTimeout;
+	this->startTime = 0;
+
+	/* Stats */
+	this->varCount = 0;
+	this->originalClauseCount = 0;
+	this->liveClauses = 0;
+	this->eliminatedCount = 0;
+	this->subsumedCount = 0;
+	this->rounds = 0;
+}
+
+VariableElimination::~VariableElimination()
+{
+	LOGDEBUG1("BVE %d deleted!", this->getSolverId());
+}
+
+void
+VariableElimination::setSolverInterrupt()
+{
+	if (!this->stopPreprocessing) {
+		LOG1("Asked BVE %d to terminate", this->getSolverId());
+		this->stopPreprocessing = true;
+	}
+}
+
+void
+VariableElimination::unsetSolverInterrupt()
+{
+	this->stopPreprocessing = false;
+}
+
+bool
+VariableElimination::isTimeout() const
+{
+	return SystemResourceMonitor::getRelativeTimeSeconds() - this->startTime > this->timeout;
+}
+
+template<typename Fct>
+void
+VariableElimination::parallelFor(unsigned int count, Fct fct)
+{
+	if (this->threads <= 1 || count < 2 * this->threads) {
+		for (unsigned int task = 0; task < count; task++)
+			fct(task, 0);
+		return;
+	}
+
+	std::atomic<unsigned int> nextTask(0);
+	auto worker = [&](unsigned int id) {
+		for (unsigned int task = nextTask++; task < count; task = nextTask++)
+			fct(task, id);
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < this->threads; i++)
+		pool.emplace_back(worker, i);
+	worker(0);
+	for (auto& thread : pool)
+		thread.join();
+}
+
+/* Formula */
+/* ------- */
+
+int
+VariableElimination::insertClause(simpleClause&& clause)
+{
+	std::sort(clause.begin(), clause.end(), litLess);
+	clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+	for (unsigned int i = 1; i < clause.size(); i++)
+		if (clause[i] == -clause[i - 1])
+			return -1;
+
+	if (clause.empty()) {
+		this->unsat = true;
+		return -1;
+	}
+
+	unsigned int idx = this->clauses.size();
+	uint64_t signature = 0;
+	for (int lit : clause) {
+		this->occurs[LIT_IDX(lit)].push_back(idx);
+		signature |= 1ULL << (LIT_IDX(lit) & 63);
+	}
+
+	this->clauses.push_back(std::move(clause));
+	this->isClauseDeleted.push_back(0);
+	this->signatures.push_back(signature);
+	this->liveClauses++;
+	return idx;
+}
+
+void
+VariableElimination::deleteClause(unsigned int idx)
+{
+	this->isClauseDeleted[idx] = 1;
+	this->liveClauses--;
+
+	for (int lit : this->clauses[idx]) {
+		unsigned int var = std::abs(lit);
+		this->occDead[LIT_IDX(lit)]++;
+		this->compactOccurrences(LIT_IDX(lit));
+
+		// Its number of occurrences decreased, the variable may be eliminated now
+		if (!this->isDirty[var]) {
+			this->isDirty[var] = 1;
+			this->dirtyVars.push_back(var);
+		}
+	}
+
+	simpleClause().swap(this->clauses[idx]);
+}
+
+void
+VariableElimination::compactOccurrences(unsigned int litIdx)
+{
+	std::vector<unsigned int>& occurrenceList = this->occurs[litIdx];
+	if (2 * this->occDead[litIdx] <= occurrenceList.size())
+		return;
+
+	std::erase_if(occurrenceList, [this](unsigned int idx) { return this->isClauseDeleted[idx]; });
+	this->occDead[litIdx] = 0;
+}
+
+void
+VariableElimination::addInitialClauses(const std::vector<simpleClause>& initClauses, unsigned int nbVariables)
+{
+	this->varCount = nbVariables;
+	this->occurs.assign(2 * nbVariables, {});
+	this->occDead.assign(2 * nbVariables, 0);
+	this->isEliminated.assign(nbVariables + 1, 0);
+	this->isFrozen.assign(nbVariables + 1, 0);
+	this->isDirty.assign(nbVariables + 1, 0);
+	this->clauses.reserve(initClauses.size());
+	this->isClauseDeleted.reserve(initClauses.size());
+	this->signatures.reserve(initClauses.size());
+
+	for (unsigned int i = 0; i < initClauses.size() && !this->stopPreprocessing; i++)
+		this->insertClause(simpleClause(initClauses[i]));
+
+	this->originalClauseCount = initClauses.size();
+	this->m_initialized = !this->stopPreprocessing;
+	LOG1("Loaded %u clauses in BVE %d", this->liveClauses, this->getSolverId());
+}
+
+void
+VariableElimination::addInitialClauses(const lit_t* literals, unsigned int nbClauses, unsigned int nbVariables)
+{
+	this->varCount = nbVariables;
+	this->occurs.assign(2 * nbVariables, {});
+	this->occDead.assign(2 * nbVariables, 0);
+	this->isEliminated.assign(nbVariables + 1, 0);
+	this->isFrozen.assign(nbVariables + 1, 0);
+	this->isDirty.assign(nbVariables + 1, 0);
+	this->clauses.reserve(nbClauses);
+	this->isClauseDeleted.reserve(nbClauses);
+	this->signatures.reserve(nbClauses);
+
+	for (unsigned int i = 0; i < nbClauses && !this->stopPreprocessing; i++) {
+		const lit_t* end = literals;
+		while (*end)
+			end++;
+		this->insertClause(simpleClause(literals, end));
+		literals = end + 1;
+	}
+
+	this->originalClauseCount = nbClauses;
+	this->m_initialized = !this->stopPreprocessing;
+	LOG1("Loaded %u clauses in BVE %d", this->liveClauses, this->getSolverId());
+}
+
+void
+VariableElimination::loadFormula(const char* filename)
+{
+	std::vector<simpleClause> initClauses;
+	unsigned int nbVariables;
+
+	if (!Parsers::parseCNF(filename, initClauses, &nbVariables)) {
+		LOGERROR("Error at parsing!");
+		this->m_initialized = false;
+		return;
+	}
+
+	this->addInitialClauses(initClauses, nbVariables);
+}
+
+std::vector<simpleClause>
+VariableElimination::getSimplifiedFormula()
+{
+	std::vector<simpleClause> simplified;
+	simplified.reserve(this->liveClauses);
+	for (unsigned int i = 0; i < this->clauses.size(); i++)
+		if (!this->isClauseDeleted[i])
+			simplified.push_back(this->clauses[i]);
+	return simplified;
+}
+
+void
+VariableElimination::releaseMemory()
+{
+	std::vector<simpleClause>().swap(this->clauses);
+	std::vector<char>().swap(this->isClauseDeleted);
+	std::vector<uint64_t>().swap(this->signatures);
+	std::vector<std::vector<unsigned int>>().swap(this->occurs);
+	std::vector<unsigned int>().swap(this->occDead);
+	std::vector<char>().swap(this->isDirty);
+	std::vector<int>().swap(this->dirtyVars);
+}
+
+bool
+VariableElimination::saveReconstruction(std::vector<int>& data)
+{
+	data.push_back(this->varCount);
+	data.insert(data.end(), this->eliminationStack.begin(), this->eliminationStack.end());
+	return true;
+}
+
+bool
+VariableElimination::loadReconstruction(const int* data, size_t size)
+{
+	if (size < 1 || data[0] < 0)
+		return false;
+	this->varCount = data[0];
+	this->eliminationStack.assign(data + 1, data + size);
+
+	// Each clause is followed by its size, the whole stack must be made of such clauses
+	size_t end = this->eliminationStack.size();
+	while (end > 0) {
+		unsigned int clauseSize = this->eliminationStack[end - 1];
+		if (clauseSize == 0 || clauseSize >= end)
+			return false;
+		end -= clauseSize + 1;
+	}
+	return true;
+}
+
+/* Elimination */
+/* ----------- */
+
+void
+VariableElimination::resolve(int var, BVEResult& result, BVEScratch& scratch)
+{
+	result.var = var;
+	result.worthIt = false;
+	result.resolvents.clear();
+
+	const std::vector<unsigned int>& positives = this->occurs[LIT_IDX(var)];
+	const std::vector<unsigned int>& negatives = this->occurs[LIT_IDX(-var)];
+
+	// The elimination must not increase the number of clauses
+	const unsigned int limit = this->occurrences(var) + this->occurrences(-var);
+	unsigned int produced = 0;
+
+	for (unsigned int pos : positives) {
+		if (this->isClauseDeleted[pos])
+			continue;
+
+		if (++scratch.stamp == 0) {
+			std::fill(scratch.mark.begin(), scratch.mark.end(), 0);
+			scratch.stamp = 1;
+		}
+		for (int lit : this->clauses[pos]) {
+			scratch.mark[std::abs(lit)] = scratch.stamp;
+			scratch.markSign[std::abs(lit)] = lit > 0;
+		}
+
+		for (unsigned int neg : negatives) {
+			if (this->isClauseDeleted[neg])
+				continue;
+
+			scratch.resolvent.clear();
+			bool tautology = false;
+			for (int lit : this->clauses[neg]) {
+				unsigned int litVar = std::abs(lit);
+				if (litVar == (unsigned int)var)
+					continue;
+				if (scratch.mark[litVar] == scratch.stamp) {
+					if (scratch.markSign[litVar] != (lit > 0)) {
+						tautology = true;
+						break;
+					}
+					continue;
+				}
+				scratch.resolvent.push_back(lit);
+			}
+			if (tautology)
+				continue;
+
+			for (int lit : this->clauses[pos])
+				if (lit != var)
+					scratch.resolvent.push_back(lit);
+
+			if (++produced > limit || scratch.resolvent.size() > this->resolventLimit)
+				return;
+
+			result.resolvents.insert(result.resolvents.end(), scratch.resolvent.begin(), scratch.resolvent.end());
+			result.resolvents.push_back(0);
+		}
+	}
+
+	result.worthIt = true;
+}
+
+void
+VariableElimination::eliminate(const BVEResult& result, std::vector<int>& added)
+{
+	const int var = result.var;
+
+	std::vector<unsigned int> removed;
+	for (int lit : { var, -var }) {
+		for (unsigned int idx : this->occurs[LIT_IDX(lit)]) {
+			if (this->isClauseDeleted[idx])
+				continue;
+			removed.push_back(idx);
+
+			// The literal of the eliminated variable first, then the size of the clause
+			this->eliminationStack.push_back(lit);
+			for (int other : this->clauses[idx])
+				if (other != lit)
+					this->eliminationStack.push_back(other);
+			this->eliminationStack.push_back(this->clauses[idx].size());
+		}
+	}
+
+	for (unsigned int idx : removed)
+		this->deleteClause(idx);
+
+	std::vector<unsigned int>().swap(this->occurs[LIT_IDX(var)]);
+	std::vector<unsigned int>().swap(this->occurs[LIT_IDX(-var)]);
+	this->occDead[LIT_IDX(var)] = this->occDead[LIT_IDX(-var)] = 0;
+	this->isEliminated[var] = 1;
+	this->eliminatedCount++;
+
+	const int* begin = result.resolvents.data();
+	const int* end = begin + result.resolvents.size();
+	while (begin < end) {
+		const int* zero = std::find(begin, end, 0);
+		int idx = this->insertClause(simpleClause(begin, zero));
+		if (idx >= 0)
+			added.push_back(idx);
+		begin = zero + 1;
+	}
+}
+
+/* Subsumption */
+/* ----------- */
+
+void
+VariableElimination::findSubsumed(unsigned int candidate, std::vector<unsigned int>& subsumed)
+{
+	if (this->isClauseDeleted[candidate])
+		return;
+
+	const simpleClause& clause = this->clauses[candidate];
+	const uint64_t signature = this->signatures[candidate];
+
+	// A subsumed clause contains every literal of the candidate, thus it is in the shortest occurrence list
+	int minLit = clause[0];
+	for (int lit : clause)
+		if (this->occurs[LIT_IDX(lit)].size() < this->occurs[LIT_IDX(minLit)].size())
+			minLit = lit;
+
+	const std::vector<unsigned int>& occurrenceList = this->occurs[LIT_IDX(minLit)];
+	if (occurrenceList.size() > SUBSUME_OCC_LIMIT)
+		return;
+
+	for (unsigned int other : occurrenceList) {
+		if (other == candidate || this->isClauseDeleted[other])
+			continue;
+		const simpleClause& otherClause = this->clauses[other];
+		if (otherClause.size() < clause.size() || (signature & ~this->signatures[other]))
+			continue;
+		if (otherClause.size() == clause.size() && other < candidate)
+			continue;
+		if (isSubset(clause, otherClause))
+			subsumed.push_back(other);
+	}
+}
+
+void
+VariableElimination::subsume(const std::vector<unsigned int>& candidates)
+{
+	std::vector<std::vector<unsigned int>> subsumed(this->threads);
+
+	this->parallelFor(candidates.size(), [&](unsigned int task, unsigned int id) {
+		this->findSubsumed(candidates[task], subsumed[id]);
+	});
+
+	for (auto& clausesOfThread : subsumed) {
+		for (unsigned int idx : clausesOfThread) {
+			if (!this->isClauseDeleted[idx]) {
+				this->deleteClause(idx);
+				this->subsumedCount++;
+			}
+		}
+	}
+}
+
+/* Solve */
+/* ----- */
+
+SatResult
+VariableElimination::solve(const std::vector<int>& cube)
+{
+	if (!this->m_initialized) {
+		LOGWARN("BVE %d wasn't initialized correctly, cannot run, returning", this->getSolverId());
+		return SatResult::UNKNOWN;
+	}
+
+	this->startTime = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	for (int lit : cube)
+		this->isFrozen[std::abs(lit)] = 1;
+
+	// Backward subsumption on the whole formula
+	std::vector<unsigned int> candidates;
+	for (unsigned int i = 0; i < this->clauses.size(); i++)
+		if (!this->isClauseDeleted[i])
+			candidates.push_back(i);
+	this->subsume(candidates);
+
+	std::fill(this->isDirty.begin(), this->isDirty.end(), 1);
+	this->isDirty[0] = 0;
+	this->dirtyVars.clear();
+	for (unsigned int var = 1; var <= this->varCount; var++)
+		this->dirtyVars.push_back(var);
+
+	std::vector<BVEScratch> scratches(this->threads);
+	for (BVEScratch& scratch : scratches) {
+		scratch.mark.assign(this->varCount + 1, 0);
+		scratch.markSign.assign(this->varCount + 1, 0);
+	}
+
+	/* touched[var] == stamp iff var is in a clause of a variable selected in the current round. Two selected variables
+	 * never occur in a same clause, thus the clauses of one are neither read nor modified by the elimination of the
+	 * other, whose resolvents only contain its neighbours. */
+	std::vector<unsigned int> touched(this->varCount + 1, 0);
+	unsigned int stamp = 0;
+
+	std::vector<std::pair<unsigned long, int>> queue;
+	std::vector<int> selected;
+	std::vector<BVEResult> results;
+	std::vector<int> added;
+
+	while (!this->unsat && !this->dirtyVars.empty()) {
+		if (this->stopPreprocessing || globalEnding || this->isTimeout()) {
+			LOG1("BVE %d is ending: stopPreprocessing %d, globalEnding %d, timeout %d",
+				 this->getSolverId(),
+				 this->stopPreprocessing.load(),
+				 globalEnding.load(),
+				 this->isTimeout());
+			break;
+		}
+
+		// Candidates ordered by their number of resolutions
+		queue.clear();
+		for (int var : this->dirtyVars) {
+			unsigned long positives = this->occurrences(var), negatives = this->occurrences(-var);
+			if (this->isEliminated[var] || this->isFrozen[var] || !(positives + negatives) ||
+				positives + negatives > this->occLimit) {
+				this->isDirty[var] = 0;
+				continue;
+			}
+			queue.emplace_back(positives * negatives, var);
+		}
+		std::sort(queue.begin(), queue.end());
+		this->dirtyVars.clear();
+
+		// Greedy selection of variables never occurring in a same clause
+		if (++stamp == 0) {
+			std::fill(touched.begin(), touched.end(), 0);
+			stamp = 1;
+		}
+		selected.clear();
+		for (auto [cost, var] : queue) {
+			if (touched[var] == stamp) {
+				this->dirtyVars.push_back(var);
+				continue;
+			}
+
+			for (int lit : { var, -var })
+				for (unsigned int idx : this->occurs[LIT_IDX(lit)])
+					if (!this->isClauseDeleted[idx])
+						for (int other : this->clauses[idx])
+							touched[std::abs(other)] = stamp;
+			this->isDirty[var] = 0;
+			selected.push_back(var);
+		}
+
+		results.resize(selected.size());
+		this->parallelFor(selected.size(), [&](unsigned int task, unsigned int id) {
+			this->resolve(selected[task], results[task], scratches[id]);
+		});
+
+		added.clear();
+		for (unsigned int i = 0; i < selected.size(); i++)
+			if (results[i].worthIt)
+				this->eliminate(results[i], added);
+
+		// The resolvents may subsume clauses of the formula
+		this->subsume(std::vector<unsigned int>(added.begin(), added.end()));
+
+		this->rounds++;
+	}
+
+	LOG0("[BVE %d] eliminated %u variables in %u rounds, subsumed %u clauses, %u -> %u clauses in %.2fs",
+		 this->getSolverId(),
+		 this->eliminatedCount,
+		 this->rounds,
+		 this->subsumedCount,
+		 this->originalClauseCount,
+		 this->liveClauses,
+		 SystemResourceMonitor::getRelativeTimeSeconds() - this->startTime);
+
+	if (this->unsat)
+		return SatResult::UNSAT;
+	if (!this->liveClauses)
+		return SatResult::SAT;
+	return SatResult::UNKNOWN;
+}
+
+/* Model */
+/* ----- */
+
+std::vector<int>
+VariableElimination::getModel()
+{
+	std::vector<int> model;
+	for (int var = 1; var <= (int)this->varCount; var++)
+		model.push_back(-var);
+	return model;
+}
+
+void
+VariableElimination::restoreModel(std::vector<int>& model)
+{
+	for (int var = model.size() + 1; var <= (int)this->varCount; var++)
+		model.push_back(-var);
+
+	// The clauses are satisfied in the reverse order of the eliminations, flipping the eliminated variable if needed
+	size_t end = this->eliminationStack.size();
+	while (end > 0) {
+		unsigned int size = this->eliminationStack[end - 1];
+		const int* clause = &this->eliminationStack[end - 1 - size];
+
+		bool satisfied = false;
+		for (unsigned int i = 0; i < size && !satisfied; i++)
+			satisfied = model[std::abs(clause[i]) - 1] == clause[i];
+		if (!satisfied)
+			model[std::abs(clause[0]) - 1] = clause[0];
+
+		end -= size + 1;
+	}
+
+	LOG1("[BVE %d] restored model of size %zu", this->getSolverId(), model.size());
+}
+
+void
+VariableElimination::printStatistics()
+{
+	LOG1("[BVE %d] varCount: %u, eliminated: %u, clauses: %u -> %u, subsumed: %u, rounds: %u",
+		 this->getSolverId(),
+		 this->varCount,
+		 this->eliminatedCount,
+		 this->originalClauseCount,
+		 this->liveClauses,
+		 this->subsumedCount,
+		 this->rounds);
+}
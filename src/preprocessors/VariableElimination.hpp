@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "preprocessors/PreprocessorInterface.hpp"
+#include "utils/Parsers.hpp"
+
+/// Resolvents of a variable computed by a worker of a BVE round, not yet applied
+struct BVEResult
+{
+	int var;
+
+	/// False if the resolvents would grow the formula or a resolvent is too long
+	bool worthIt;
+
+	/// Zero terminated resolvents
+	std::vector<int> resolvents;
+};
+
+/// Buffers of a BVE worker
+struct BVEScratch
+{
+	/// mark[var] == stamp iff var is in the current positive clause, its sign in markSign
+	std::vector<unsigned int> mark;
+	std::vector<char> markSign;
+	unsigned int stamp = 0;
+
+	std::vector<int> resolvent;
+};
+
+/**
+ * @brief Bounded Variable Elimination (BVE) with subsumption, shared by all the solvers of the portfolio.
+ *
+ * A variable is eliminated by replacing its clauses with their non tautological resolvents when this does not increase
+ * the number of clauses. The elimination runs in rounds: each round selects a set of candidate variables never
+ * occurring in a same clause, thus eliminating one of them neither reads nor modifies the clauses of another. The
+ * resolvents of the selected variables are computed concurrently, then applied in the selection order, and the
+ * clauses subsumed by the new resolvents are removed. A round only retries the variables whose clauses changed.
+ *
+ * The variables keep their numbering, the removed clauses are pushed on an elimination stack used by restoreModel()
+ * to extend a model of the simplified formula.
+ *
+ * @ingroup preproc_solving
+ */
+class VariableElimination : public PreprocessorInterface
+{
+  public:
+	VariableElimination(int _id);
+
+	~VariableElimination();
+
+	unsigned int getVariablesCount() override { return this->varCount; }
+
+	int getDivisionVariable() override { return 0; }
+
+	void setSolverInterrupt() override;
+
+	void unsetSolverInterrupt() override;
+
+	/**
+	 * @brief Eliminate the variables and remove the subsumed clauses.
+	 * @param cube Its variables are not eliminated.
+	 * @return UNSAT if the empty clause is derived, SAT if no clause is left, UNKNOWN otherwise.
+	 */
+	SatResult solve(const std::vector<int>& cube = {}) override;
+
+	void addClause(ClauseExchangePtr) override {}
+
+	void addClauses(const std::vector<ClauseExchangePtr>&) override {}
+
+	void addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int nbVariables) override;
+
+	void addInitialClauses(const lit_t* literals, unsigned int nbClauses, unsigned int nbVariables) override;
+
+	void loadFormula(const char* filename) override;
+
+	/// Model of the empty formula (all the variables false) when solve() answered SAT
+	std::vector<int> getModel() override;
+
+	void diversify(const SeedGenerator& = [](SolverInterface* s) { return s->getSolverId(); }) override {}
+
+	void printStatistics() override;
+
+	std::vector<simpleClause> getSimplifiedFormula() override;
+
+	/// Set the values of the eliminated variables, model[v-1] is v or -v
+	void restoreModel(std::vector<int>& model) override;
+
+	PreprocessorStats getPreprocessorStatistics() override
+	{
+		return { this->liveClauses, this->originalClauseCount - this->liveClauses, 0, 0, this->eliminatedCount };
+	}
+
+	/// Release the occurrence lists and the clauses, the elimination stack is kept for restoreModel()
+	void releaseMemory() override;
+
+	/// Save the variable count and the elimination stack
+	bool saveReconstruction(std::vector<int>& data) override;
+
+	bool loadReconstruction(const int* data, size_t size) override;
+
+  private:
+	/// Add a clause to the formula, returns its index or -1 if it is tautological
+	int insertClause(simpleClause&& clause);
+
+	void deleteClause(unsigned int idx);
+
+	/// Remove the deleted clauses from the occurrence list of a literal if they are the majority
+	void compactOccurrences(unsigned int litIdx);
+
+	unsigned int occurrences(int lit) const { return this->occurs[LIT_IDX(lit)].size() - this->occDead[LIT_IDX(lit)]; }
+
+	/**
+	 * @brief Compute the resolvents of a variable on the current formula, which is only read.
+	 * @details Called concurrently for variables never occurring in a same clause.
+	 */
+	void resolve(int var, BVEResult& result, BVEScratch& scratch);
+
+	/// Push the clauses of the variable on the elimination stack, replace them by the resolvents
+	void eliminate(const BVEResult& result, std::vector<int>& added);
+
+	/**
+	 * @brief Find the clauses subsumed by a clause, the formula is only read.
+	 * @details A clause equal to candidate is reported only if its index is greater, so that one of the two is kept
+	 * when both are checked.
+	 */
+	void findSubsumed(unsigned int candidate, std::vector<unsigned int>& subsumed);
+
+	/// Remove the clauses subsumed by the given clauses, with the worker threads
+	void subsume(const std::vector<unsigned int>& candidates);
+
+	/// Run fct(task, thread) for task in [0, count) on the worker threads
+	template<typename Fct> void parallelFor(unsigned int count, Fct fct);
+
+	bool isTimeout() const;
+
+	std::atomic<bool> stopPreprocessing;
+
+	/// Sorted clauses, a deleted clause is empty
+	std::vector<simpleClause> clauses;
+	std::vector<char> isClauseDeleted;
+
+	/// 64-bit signature of each clause, for the subsumption checks
+	std::vector<uint64_t> signatures;
+
+	/// Occurrence lists by LIT_IDX, the deleted clauses are removed lazily
+	std::vector<std::vector<unsigned int>> occurs;
+	std::vector<unsigned int> occDead;
+
+	std::vector<char> isEliminated;
+	std::vector<char> isFrozen;
+
+	/// Variables whose clauses changed since their last elimination attempt, and the list of these variables
+	std::vector<char> isDirty;
+	std::vector<int> dirtyVars;
+
+	/**
+	 * @brief Removed clauses of the eliminated variables, in elimination order.
+	 * @details Each clause is stored with the literal of its eliminated variable first, followed by its size.
+	 */
+	std::vector<int> eliminationStack;
+
+	/// Set when the empty clause is in the formula
+	bool unsat;
+
+	// Options
+	//--------
+	unsigned int threads;
+	unsigned int occLimit;
+	unsigned int resolventLimit;
+	double timeout;
+	double startTime;
+
+	// Stats
+	//------
+	unsigned int varCount;
+	unsigned int originalClauseCount;
+	unsigned int liveClauses;
+	unsigned int eliminatedCount;
+	unsigned int subsumedCount;
+	unsigned int rounds;
+};
@@ -105,4 +105,11 @@ BloomFilter::contains_or_insert(const int* clause, unsigned int size)
 		}
 	}
 	return true;
-}
\ No newline at end of file
+}
+
+void
+BloomFilter::clear()
+{
+	std::fill(bits_, bits_ + mem_size_, 0);
+	std::unordered_map<hash_t, uint8_t>().swap(count_per_checksum);
+}
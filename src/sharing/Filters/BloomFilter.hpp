@@ -67,4 +67,6 @@ class BloomFilter
 	uint8_t test_and_insert(size_t checksum, int max_limit_duplicas);
 	bool contains_or_insert(const int* clause, unsigned int size);
 	bool contains(const int* clause, unsigned int size);
+	/* Forget all the inserted clauses and release the duplicates counters, not thread safe */
+	void clear();
 };
\ No newline at end of file
@@ -86,24 +86,4 @@ void
 MallobSharing::incrementEpoch()
 {
 	++m_currentEpoch;
-}
-
-size_t
-MallobSharing::shrinkFilter()
-{
-	if (m_resharingPeriodInEpochs <= 0)
-		return 0;
-	size_t removedEntries = 0;
-	auto it = m_clauseMetaMap.begin();
-	while (it != m_clauseMetaMap.end()) {
-		const ClauseMeta& currentMeta = it->second;
-		if (m_currentEpoch - currentMeta.sharedEpoch > m_resharingPeriodInEpochs &&
-			m_currentEpoch - currentMeta.productionEpoch > m_resharingPeriodInEpochs) {
-			it = m_clauseMetaMap.erase(it);
-			removedEntries++;
-		} else {
-			++it;
-		}
-	}
-	return removedEntries;
 }
\ No newline at end of file
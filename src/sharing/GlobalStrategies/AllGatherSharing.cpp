@@ -73,29 +73,55 @@ AllGatherSharing::doSharing()
 		TESTRUNMPI(MPI_Comm_size(yes_comm, &yes_comm_size));
 
 		if (yes_comm_size < 2) {
-			return true; // can break and end the global sharer thread since it is doing nothing
+			// Nothing to gather, but the others wait for the end to be broadcast in a next round
+			return false;
 		} else {
 			LOG3("[Allgather] %d global sharers will share their clauses", yes_comm_size);
 		}
 
-		// get clauses to send and serialize
+		// get clauses to send, serialize and encode them
 		clausesToSendSerialized.clear();
 
 		gstats.sharedClauses += serializeClauses(clausesToSendSerialized);
-		// limit the receive buffer size to contain all the exported buffers
-		// resize is used to really allocate the memory (reserve doesn't work with C array access)
-		receivedClauses.clear();
-		receivedClauses.resize((totalSize)*yes_comm_size);
+		this->encodeClauses(clausesToSendSerialized.data(), clausesToSendSerialized.size(), encodedToSend);
+
+		// the encoded buffers have different sizes, they are gathered first
+		int encodedSize = encodedToSend.size();
+		receivedSizes.resize(yes_comm_size);
+		displacements.resize(yes_comm_size);
 
 		LOGDEBUG3("[Allgather] before allgather", mpi_rank);
 
-		//  C like fashion, it overwrites using pointer arithmetic
-		TESTRUNMPI(MPI_Allgather(
-			&clausesToSendSerialized[0], totalSize, MPI_INT, &receivedClauses[0], totalSize, MPI_INT, yes_comm));
+		TESTRUNMPI(MPI_Allgather(&encodedSize, 1, MPI_INT, receivedSizes.data(), 1, MPI_INT, yes_comm));
+
+		int receivedSize = 0;
+		for (int i = 0; i < yes_comm_size; i++) {
+			displacements[i] = receivedSize;
+			receivedSize += receivedSizes[i];
+		}
+		receivedEncoded.resize(receivedSize);
+
+		TESTRUNMPI(MPI_Allgatherv(encodedToSend.data(),
+								  encodedSize,
+								  MPI_BYTE,
+								  receivedEncoded.data(),
+								  receivedSizes.data(),
+								  displacements.data(),
+								  MPI_BYTE,
+								  yes_comm));
 		gstats.messagesSent += yes_comm_size;
 
-		// Now I have a vector of the all gathered buffers
-		deserializeClauses(receivedClauses, yes_comm_size);
+		// decode the buffers of the others, mine was serialized here
+		int yes_comm_rank;
+		TESTRUNMPI(MPI_Comm_rank(yes_comm, &yes_comm_rank));
+		receivedClauses.clear();
+		for (int i = 0; i < yes_comm_size; i++) {
+			if (i != yes_comm_rank)
+				this->decodeClauses(receivedEncoded.data() + displacements[i], receivedSizes[i], receivedClauses);
+		}
+
+		// Now I have a vector of the clauses of the others
+		deserializeClauses(receivedClauses);
 	}
 
 	LOG2("[Allgather] received cls %u shared cls %d", this->gstats.receivedClauses.load(), this->gstats.sharedClauses);
@@ -140,32 +166,21 @@ AllGatherSharing::serializeClauses(std::vector<int>& serialized_v_cls)
 		}
 	}
 
-	// fill with zeroes if needed
-	serialized_v_cls.insert(serialized_v_cls.end(), totalSize - dataCount, 0);
-
 	LOGDEBUG1("Serialized %u clauses into buffer of size %u", nb_clauses, serialized_v_cls.size());
 	return nb_clauses;
 }
 
 void
-AllGatherSharing::deserializeClauses(const std::vector<int>& serialized_v_cls, int num_buffers)
+AllGatherSharing::deserializeClauses(const std::vector<int>& serialized_v_cls)
 {
 	unsigned int i = 0;
 	int size, lbd;
 	ClauseExchangePtr p_cls;
 	int bufferSize = serialized_v_cls.size();
-	int single_buffer_size = bufferSize / num_buffers;
 
 	LOGDEBUG2("Deserializing Buffer of Size %u", bufferSize);
 
 	while (i < bufferSize) {
-		// Check for the end marker
-		if (serialized_v_cls[i] == 0) {
-			// Move to the next buffer
-			i = ((i / single_buffer_size) + 1) * single_buffer_size;
-			continue;
-		}
-
 		size = serialized_v_cls[i++];
 		lbd = serialized_v_cls[i++];
 
@@ -187,4 +202,11 @@ AllGatherSharing::deserializeClauses(const std::vector<int>& serialized_v_cls, i
 
 		i += size;
 	}
-}
\ No newline at end of file
+}
+
+void
+AllGatherSharing::shrinkMemory()
+{
+	SharingStrategy::shrinkMemory();
+	this->b_filter.clear();
+}
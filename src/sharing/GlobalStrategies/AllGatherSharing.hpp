@@ -52,9 +52,14 @@ class AllGatherSharing : public GlobalSharingStrategy
 	void joinProcess(int winnerRank, SatResult res, const std::vector<int>& model) override;
 
   protected:
+	/**
+	 * @brief Clears the database and the bloom filter.
+	 */
+	void shrinkMemory() override;
+
 	/**
 	 * @brief Serializes clauses for sharing.
-	 * @details Serialization Pattern ([size][lbd][literals])*0+
+	 * @details Serialization Pattern ([size][lbd][literals])*
 	 * @param serialized_v_cls Vector to store the serialized clauses.
 	 * @return The number of clauses serialized.
 	 */
@@ -62,10 +67,9 @@ class AllGatherSharing : public GlobalSharingStrategy
 
 	/**
 	 * @brief Deserializes received clauses.
-	 * @param serialized_v_cls Vector containing the serialized clauses.
-	 * @param num_buffers Number of buffers received.
+	 * @param serialized_v_cls Vector containing the decoded clauses of the other processes.
 	 */
-	void deserializeClauses(const std::vector<int>& serialized_v_cls, int num_buffers);
+	void deserializeClauses(const std::vector<int>& serialized_v_cls);
 
 	int totalSize; ///< Total size of the buffer for clause sharing
 	int color;	   ///< Color used for MPI communicator splitting
@@ -73,5 +77,10 @@ class AllGatherSharing : public GlobalSharingStrategy
 	std::vector<int> clausesToSendSerialized; ///< Buffer for serialized clauses to send
 	std::vector<int> receivedClauses;		  ///< Buffer for received serialized clauses
 
+	std::vector<uint8_t> encodedToSend;	  ///< Encoded clauses to send
+	std::vector<uint8_t> receivedEncoded; ///< Encoded buffers of all the processes
+	std::vector<int> receivedSizes;		  ///< Size in bytes of each encoded buffer
+	std::vector<int> displacements;		  ///< Offset of each encoded buffer
+
 	BloomFilter b_filter; ///< Bloom filter for duplicate clause detection
 };
\ No newline at end of file
@@ -4,7 +4,13 @@
 #include "utils/Logger.hpp"
 #include "utils/MpiUtils.hpp"
 #include "utils/Parameters.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
 #include <random>
+#include <thread>
 
 GenericGlobalSharing::GenericGlobalSharing(const std::shared_ptr<ClauseDatabase>& clauseDB,
 										   const std::vector<int>& subscriptions,
@@ -14,6 +20,19 @@ GenericGlobalSharing::GenericGlobalSharing(const std::shared_ptr<ClauseDatabase>
 	, subscriptions(subscriptions)
 	, subscribers(subscribers)
 	, totalSize(bufferSize)
+	, topology(GlobalTopology::CUSTOM)
+	, degree(1)
+{
+}
+
+GenericGlobalSharing::GenericGlobalSharing(const std::shared_ptr<ClauseDatabase>& clauseDB,
+										   GlobalTopology topology,
+										   unsigned int degree,
+										   unsigned long bufferSize)
+	: GlobalSharingStrategy(clauseDB)
+	, totalSize(bufferSize)
+	, topology(topology)
+	, degree(std::max(1u, degree))
 {
 }
 
@@ -34,8 +53,25 @@ GenericGlobalSharing::initMpiVariables()
 		return false;
 	}
 
-	LOGVECTOR(&this->subscriptions[0], subscriptions.size(), "[Generic Sharing] Producers: ");
-	LOGVECTOR(&this->subscribers[0], subscribers.size(), "[Generic Sharing] Consumers: ");
+	if (topology == GlobalTopology::GOSSIP) {
+		LOG0("[Generic] Gossip with a fan-out of %u", degree);
+	} else {
+		if (topology != GlobalTopology::CUSTOM) {
+			subscriptions = computeNeighbours(topology, mpi_rank, mpi_world_size, degree);
+			// The ring is unidirectional: clauses go from a process to its successor
+			if (topology == GlobalTopology::RING)
+				subscribers = { (mpi_rank + 1) % mpi_world_size };
+			else
+				subscribers = subscriptions;
+		}
+		LOGVECTOR(this->subscriptions.data(), subscriptions.size(), "[Generic Sharing] Producers: ");
+		LOGVECTOR(this->subscribers.data(), subscribers.size(), "[Generic Sharing] Consumers: ");
+	}
+
+	if (totalSize == 0) {
+		LOGWARN("[Generic] The receives are posted in advance and need a bounded buffer, gshr-lit set to 2000");
+		totalSize = 2000;
+	}
 
 	return GlobalSharingStrategy::initMpiVariables();
 }
@@ -44,9 +80,7 @@ bool
 GenericGlobalSharing::doSharing()
 {
 	// Sharing Management
-	int received_size;
-	int old_size;
-	MPI_Status status;
+	int received_size, completed;
 
 	MPI_Request tmp_request;
 
@@ -56,51 +90,98 @@ GenericGlobalSharing::doSharing()
 		return true;
 	}
 
-	/* Sharing */
+	if (topology == GlobalTopology::GOSSIP)
+		drawGossipPartners(round);
+	round++;
+
+	/* Forward the clauses received in the last round, in at most half of the buffer */
+	encodedToSend.clear();
+	unsigned int forwardBudget = totalSize / 2;
+	unsigned int forwardedLits = 0;
+
+	for (unsigned int hops = 1; hops < toForward.size(); hops++) {
+		std::vector<int>& clauses = toForward[hops];
+		clausesToSendSerialized.clear();
+		unsigned int i = 0;
+		while (i < clauses.size()) {
+			int size = clauses[i];
+			if (forwardedLits + size > forwardBudget) {
+				forwardDropped++;
+			} else {
+				clausesToSendSerialized.insert(
+					clausesToSendSerialized.end(), clauses.begin() + i, clauses.begin() + i + 2 + size);
+				this->b_filter_send.insert(&clauses[i + 2], size);
+				forwardedLits += size;
+				forwardedClauses++;
+			}
+			i += 2 + size;
+		}
+		clauses.clear();
+		appendSection(clausesToSendSerialized, hops);
+	}
+
+	/* Then my clauses */
 	clausesToSendSerialized.clear();
-	gstats.sharedClauses += serializeClauses(clausesToSendSerialized);
-	unsigned int serializedSize = clausesToSendSerialized.size();
+	gstats.sharedClauses +=
+		serializeClauses(clausesToSendSerialized, totalSize - forwardedLits);
+	appendSection(clausesToSendSerialized, 0);
+	unsigned int encodedSize = encodedToSend.size();
 
 	// Send to my subscribers my clauses
 	for (unsigned int i = 0; i < subscribers.size(); i++) {
-		TESTRUNMPI(MPI_Isend(&clausesToSendSerialized[0],
-							 serializedSize,
-							 MPI_INT,
+		TESTRUNMPI(MPI_Isend(encodedToSend.data(),
+							 encodedSize,
+							 MPI_BYTE,
 							 subscribers[i],
 							 MYMPI_CLAUSES,
 							 MPI_COMM_WORLD,
 							 &tmp_request));
-		LOG2("[Generic] Sent a message of size %d to %d", serializedSize, subscribers[i]);
+		LOG2("[Generic] Sent a message of size %d to %d", encodedSize, subscribers[i]);
 		sendRequests.push_back(tmp_request);
 		gstats.messagesSent++;
 	}
 
-	// Check if my subscriptions sent me any clauses
-	receivedClauses.clear();
+	// Receive the messages of my subscriptions in their order of arrival, a late one does not delay the others
+	receiveBuffers.resize(subscriptions.size());
+	receiveRequests.resize(subscriptions.size());
+	receiveIndices.resize(subscriptions.size());
+	receiveStatuses.resize(subscriptions.size());
 
 	for (unsigned int i = 0; i < subscriptions.size(); i++) {
-
-		old_size = receivedClauses.size();
-
-		TESTRUNMPI(MPI_Probe(subscriptions[i], MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
-		TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &received_size));
-
-		receivedClauses.resize(old_size + received_size);
-		LOGDEBUG2("Oldsize = %d, NewSize = %d", old_size, old_size + received_size);
-		MPI_Recv(&receivedClauses[old_size],
-				 received_size,
-				 MPI_INT,
-				 subscriptions[i],
-				 MYMPI_CLAUSES,
-				 MPI_COMM_WORLD,
-				 &status);
-		LOG2("[Generic] Received a message of size %d from %d", received_size, subscriptions[i]);
+		receiveBuffers[i].resize(maxMessageSize());
+		TESTRUNMPI(MPI_Irecv(receiveBuffers[i].data(),
+							 receiveBuffers[i].size(),
+							 MPI_BYTE,
+							 subscriptions[i],
+							 MYMPI_CLAUSES,
+							 MPI_COMM_WORLD,
+							 &receiveRequests[i]));
 	}
 
-	deserializeClauses(receivedClauses);
+	unsigned int pending = subscriptions.size();
+	std::chrono::microseconds wait(1);
+
+	while (pending > 0) {
+		TESTRUNMPI(MPI_Testsome(
+			receiveRequests.size(), receiveRequests.data(), &completed, receiveIndices.data(), receiveStatuses.data()));
+		if (completed == 0 || completed == MPI_UNDEFINED) {
+			// Back off up to a millisecond, a round lasts gshr-sleep
+			std::this_thread::sleep_for(wait);
+			wait = std::min(wait * 2, std::chrono::microseconds(1000));
+			continue;
+		}
+		wait = std::chrono::microseconds(1);
 
-	for (auto sendRequest : this->sendRequests)
-		TESTRUNMPI(MPI_Wait(&sendRequest, &status));
+		for (int k = 0; k < completed; k++) {
+			int i = receiveIndices[k];
+			TESTRUNMPI(MPI_Get_count(&receiveStatuses[k], MPI_BYTE, &received_size));
+			LOG2("[Generic] Received a message of size %d from %d", received_size, subscriptions[i]);
+			readSections(receiveBuffers[i].data(), received_size);
+		}
+		pending -= completed;
+	}
+
+	TESTRUNMPI(MPI_Waitall(sendRequests.size(), sendRequests.data(), MPI_STATUSES_IGNORE));
 
 	sendRequests.clear();
 	LOG2("[Generic] received cls %u shared cls %d", this->gstats.receivedClauses.load(), this->gstats.sharedClauses);
@@ -108,23 +189,120 @@ GenericGlobalSharing::doSharing()
 	return false;
 }
 
+void
+GenericGlobalSharing::printStats()
+{
+	GlobalSharingStrategy::printStats();
+
+	unsigned long total = 0, weighted = 0;
+	unsigned int maxDelay = 0;
+	std::string histogram;
+	for (unsigned int hops = 1; hops < delays.size(); hops++) {
+		if (!delays[hops])
+			continue;
+		total += delays[hops];
+		weighted += hops * delays[hops];
+		maxDelay = hops;
+		histogram += " " + std::to_string(hops) + ":" + std::to_string(delays[hops]);
+	}
+	if (total)
+		LOGSTAT("[Generic] Propagation delay in rounds: average %.2f, max %u, new clauses per delay%s",
+				(double)weighted / total,
+				maxDelay,
+				histogram.c_str());
+	LOGSTAT("[Generic] Forwarded clauses %lu, dropped for lack of space %lu", forwardedClauses, forwardDropped);
+}
+
+//==============================
+// Topologies
+//==============================
+
+std::vector<int>
+GenericGlobalSharing::computeNeighbours(GlobalTopology topology, int rank, int size, unsigned int degree)
+{
+	std::vector<int> neighbours;
+
+	switch (topology) {
+		case GlobalTopology::RING:
+			// Only the predecessor, the successor is the subscriber
+			neighbours.push_back((rank - 1 + size) % size);
+			break;
+		case GlobalTopology::HYPERCUBE:
+			// Without a power of two, the upper ranks still have their neighbour of the lower half
+			for (int bit = 1; bit < size; bit <<= 1)
+				if ((rank ^ bit) < size)
+					neighbours.push_back(rank ^ bit);
+			break;
+		case GlobalTopology::TREE:
+			if (rank > 0)
+				neighbours.push_back((rank - 1) / degree);
+			for (long child = (long)degree * rank + 1; child <= (long)degree * rank + degree && child < size; child++)
+				neighbours.push_back(child);
+			break;
+		case GlobalTopology::TORUS: {
+			// The most square grid, a prime number of processes gives a ring
+			int rows = std::sqrt(size);
+			while (size % rows)
+				rows--;
+			int cols = size / rows;
+			int row = rank / cols, col = rank % cols;
+			neighbours.push_back(((row - 1 + rows) % rows) * cols + col);
+			neighbours.push_back(((row + 1) % rows) * cols + col);
+			neighbours.push_back(row * cols + (col - 1 + cols) % cols);
+			neighbours.push_back(row * cols + (col + 1) % cols);
+			break;
+		}
+		default:
+			LOGERROR("[Generic] The topology %d has no fixed neighbours", static_cast<int>(topology));
+			break;
+	}
+
+	std::sort(neighbours.begin(), neighbours.end());
+	neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+	neighbours.erase(std::remove(neighbours.begin(), neighbours.end(), rank), neighbours.end());
+	return neighbours;
+}
+
+void
+GenericGlobalSharing::drawGossipPartners(unsigned long round)
+{
+	std::vector<int> partners(mpi_world_size);
+
+	subscribers.clear();
+	subscriptions.clear();
+
+	// Every process draws the same permutations: the one sending to me is known without a message
+	for (unsigned int k = 0; k < degree; k++) {
+		std::seed_seq seed{ static_cast<unsigned int>(round), k };
+		std::mt19937 rng(seed);
+		std::iota(partners.begin(), partners.end(), 0);
+		std::shuffle(partners.begin(), partners.end(), rng);
+
+		if (partners[mpi_rank] != mpi_rank)
+			subscribers.push_back(partners[mpi_rank]);
+		for (int sender = 0; sender < mpi_world_size; sender++)
+			if (partners[sender] == mpi_rank && sender != mpi_rank)
+				subscriptions.push_back(sender);
+	}
+}
+
 //==============================
 // Serialization/Deseralization
 //==============================
 
 int
-GenericGlobalSharing::serializeClauses(std::vector<int>& serialized_v_cls)
+GenericGlobalSharing::serializeClauses(std::vector<int>& serialized_v_cls, unsigned int budget)
 {
 	unsigned int clausesSelected = 0;
 	ClauseExchangePtr tmp_cls;
 
-	unsigned int dataCount = serialized_v_cls.size();
+	unsigned int dataCount = 0;
 
-	while (m_clauseDB->getOneClause(tmp_cls) && (totalSize <= 0 || dataCount < totalSize)) {
-		if (totalSize > 0 && dataCount + tmp_cls->size > totalSize) {
+	while (dataCount < budget && m_clauseDB->getOneClause(tmp_cls)) {
+		if (dataCount + tmp_cls->size > budget) {
 			LOGDEBUG2("[Generic] Serialization overflow avoided, %d/%d, wanted to add %d",
 					  dataCount,
-					  totalSize,
+					  budget,
 					  tmp_cls->size);
 			this->importClause(tmp_cls); // reinsert to clauseToSend if doesn't fit
 			break;
@@ -136,6 +314,8 @@ GenericGlobalSharing::serializeClauses(std::vector<int>& serialized_v_cls)
 			serialized_v_cls.push_back(tmp_cls->lbd);
 			serialized_v_cls.insert(serialized_v_cls.end(), tmp_cls->begin(), tmp_cls->end());
 			this->b_filter_send.insert(tmp_cls->lits, tmp_cls->size);
+			// it comes back forwarded by the neighbours
+			this->b_filter_recv.insert(tmp_cls->lits, tmp_cls->size);
 			clausesSelected++;
 
 			dataCount += (tmp_cls->size);
@@ -144,14 +324,11 @@ GenericGlobalSharing::serializeClauses(std::vector<int>& serialized_v_cls)
 		}
 	}
 
-	if (totalSize > 0 && dataCount > totalSize + 2 * clausesSelected) {
-		LOGWARN("Panic!! datacount(%d) > totalsize(%d).", dataCount, totalSize);
-	}
 	return clausesSelected;
 }
 
 void
-GenericGlobalSharing::deserializeClauses(std::vector<int>& serialized_v_cls)
+GenericGlobalSharing::deserializeClauses(std::vector<int>& serialized_v_cls, unsigned int hops)
 {
 	unsigned int i = 0;
 	int size;
@@ -159,6 +336,11 @@ GenericGlobalSharing::deserializeClauses(std::vector<int>& serialized_v_cls)
 	ClauseExchangePtr p_cls;
 	int bufferSize = serialized_v_cls.size();
 
+	if (hops >= toForward.size()) {
+		toForward.resize(hops + 1);
+		delays.resize(hops + 1, 0);
+	}
+
 	while (i < bufferSize) {
 		size = serialized_v_cls[i++];
 		lbd = serialized_v_cls[i++];
@@ -175,6 +357,8 @@ GenericGlobalSharing::deserializeClauses(std::vector<int>& serialized_v_cls)
 				gstats.receivedClauses++;
 			this->b_filter_recv.insert(serialized_v_cls.data() + i,
 									   size); // either added or not wanted (> maxClauseSize)
+			delays[hops]++;
+			toForward[hops].insert(toForward[hops].end(), &serialized_v_cls[i - 2], &serialized_v_cls[i + size]);
 		} else {
 			gstats.receivedDuplicas++;
 		}
@@ -182,3 +366,58 @@ GenericGlobalSharing::deserializeClauses(std::vector<int>& serialized_v_cls)
 		i += size;
 	}
 }
+
+void
+GenericGlobalSharing::appendSection(const std::vector<int>& serialized, unsigned int hops)
+{
+	if (serialized.empty())
+		return;
+
+	this->encodeClauses(serialized.data(), serialized.size(), encodedSection);
+
+	uint32_t header[2] = { hops, static_cast<uint32_t>(encodedSection.size()) };
+	size_t position = encodedToSend.size();
+	encodedToSend.resize(position + sizeof(header) + encodedSection.size());
+	std::memcpy(encodedToSend.data() + position, header, sizeof(header));
+	std::memcpy(encodedToSend.data() + position + sizeof(header), encodedSection.data(), encodedSection.size());
+}
+
+size_t
+GenericGlobalSharing::maxMessageSize() const
+{
+	// Each section is non empty: at most totalSize sections of 8 header bytes and a version byte. The serialized
+	// clauses have at most 3 * totalSize integers (size and lbd), encoded in at most 7 bytes each
+	return 9UL * totalSize + 21UL * totalSize;
+}
+
+void
+GenericGlobalSharing::readSections(const uint8_t* received, size_t count)
+{
+	uint32_t header[2];
+	size_t position = 0;
+
+	while (position + sizeof(header) <= count) {
+		std::memcpy(header, received + position, sizeof(header));
+		position += sizeof(header);
+		if (position + header[1] > count) {
+			LOGERROR("[Generic] Truncated section of %u bytes", header[1]);
+			break;
+		}
+
+		receivedClauses.clear();
+		this->decodeClauses(received + position, header[1], receivedClauses);
+		// The delay counts the hop to this process
+		deserializeClauses(receivedClauses, header[0] + 1);
+		position += header[1];
+	}
+}
+
+void
+GenericGlobalSharing::shrinkMemory()
+{
+	SharingStrategy::shrinkMemory();
+	this->b_filter_send.clear();
+	this->b_filter_recv.clear();
+	for (auto& clauses : toForward)
+		clauses.clear();
+}
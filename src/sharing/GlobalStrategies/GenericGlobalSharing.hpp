@@ -2,6 +2,17 @@
 
 #include "GlobalSharingStrategy.hpp"
 
+/// Topologies of GenericGlobalSharing (gshr-topo)
+enum class GlobalTopology
+{
+	RING = 0,
+	HYPERCUBE = 1,
+	TREE = 2,
+	TORUS = 3,
+	GOSSIP = 4,
+	CUSTOM = 5, ///< Subscriptions and subscribers given to the constructor
+};
+
 /**
  * @class GenericGlobalSharing
  * @brief Implements a generic global sharing strategy for clause exchange.
@@ -9,6 +20,14 @@
  *
  * This class extends GlobalSharingStrategy to provide a generic implementation
  * for clause sharing among MPI processes.
+ *
+ * The neighbours of a fixed topology (ring, hypercube, k-ary tree, 2D torus) are computed once in initMpiVariables,
+ * each edge is used in both directions except in the ring, where a process sends to its successor only. In gossip, every process sends to k partners per round, drawn by all the
+ * processes from the same generator: each one knows from whom it receives without any extra message.
+ *
+ * The clauses received for the first time are forwarded to the neighbours in the next round, with the number of hops
+ * they made. Thus a clause reaches every process of a connected topology, and its propagation delay in rounds is its
+ * number of hops when received.
  */
 class GenericGlobalSharing : public GlobalSharingStrategy
 {
@@ -25,20 +44,33 @@ class GenericGlobalSharing : public GlobalSharingStrategy
 						 const std::vector<int>& subscribers,
 						 unsigned long bufferSize);
 
+	/**
+	 * @brief Constructor for GenericGlobalSharing on a topology, the neighbours are computed in initMpiVariables.
+	 * @param clauseDB Shared pointer to the clause database.
+	 * @param topology The topology of the processes.
+	 * @param degree Arity of the tree, or fan-out of the gossip.
+	 * @param bufferSize Size of the buffer to send to subscribers
+	 */
+	GenericGlobalSharing(const std::shared_ptr<ClauseDatabase>& clauseDB,
+						 GlobalTopology topology,
+						 unsigned int degree,
+						 unsigned long bufferSize);
+
 	/**
 	 * @brief Destructor for GenericGlobalSharing.
 	 */
 	~GenericGlobalSharing();
 
 	/**
-	 * @brief Initializes MPI-related variables.
+	 * @brief Initializes MPI-related variables and the neighbours of this process.
 	 * @return true if initialization was successful, false otherwise.
 	 */
 	bool initMpiVariables() override;
 
 	/**
-	 * @brief Performs the clause sharing operation. An MPI process starts by serializing its clauses then sends them
-	 * via asynchronous sends to all its subscribers, then waits on the reception of its different subscriptions.
+	 * @brief Performs the clause sharing operation. An MPI process starts by serializing its clauses and the ones to
+	 * forward, then sends them via asynchronous sends to all its subscribers of the round, then posts a receive per
+	 * subscription of the round and handles the messages in their order of arrival.
 	 * @return true if sharing is complete and the process can terminate, false otherwise.
 	 */
 	bool doSharing() override;
@@ -51,23 +83,78 @@ class GenericGlobalSharing : public GlobalSharingStrategy
 	 */
 	void joinProcess(int winnerRank, SatResult res, const std::vector<int>& model) override;
 
+	/**
+	 * @brief Prints the global statistics and the propagation delays.
+	 */
+	void printStats() override;
+
+	/**
+	 * @brief Computes the subscriptions of a process in a fixed topology, each edge in both directions except in the
+	 * ring, where it is the predecessor only.
+	 * @param topology The topology, neither GOSSIP nor CUSTOM.
+	 * @param rank The rank of the process.
+	 * @param size The number of processes.
+	 * @param degree Arity of the tree.
+	 * @return The sorted ranks of the neighbours, without duplicates nor rank.
+	 */
+	static std::vector<int> computeNeighbours(GlobalTopology topology, int rank, int size, unsigned int degree);
+
   protected:
+	/**
+	 * @brief Clears the database and the bloom filters.
+	 */
+	void shrinkMemory() override;
+
+	/**
+	 * @brief Draws the gossip partners of a round, the same on all the processes.
+	 * @param round The round number.
+	 */
+	void drawGossipPartners(unsigned long round);
+
 	/**
 	 * @brief Serializes clauses for sharing.
 	 * @param serialized_v_cls Vector to store the serialized clauses.
+	 * @param budget Number of literals to serialize at most.
 	 * @details Serialization Pattern ([size][lbd][literals])*
 	 * @return The number of clauses serialized.
 	 */
-	int serializeClauses(std::vector<int>& serialized_v_cls);
+	int serializeClauses(std::vector<int>& serialized_v_cls, unsigned int budget);
 
 	/**
-	 * @brief Deserializes received clauses.
+	 * @brief Deserializes received clauses, the new ones are kept to be forwarded.
 	 * @param serialized_v_cls Vector containing the serialized clauses.
+	 * @param hops Number of hops made by the clauses, thus their propagation delay in rounds.
 	 */
-	void deserializeClauses(std::vector<int>& serialized_v_cls);
+	void deserializeClauses(std::vector<int>& serialized_v_cls, unsigned int hops);
+
+	/**
+	 * @brief Appends an encoded section ([hops][bytes][encoded clauses]) to encodedToSend.
+	 * @param serialized The serialized clauses.
+	 * @param hops Number of hops made by the clauses.
+	 */
+	void appendSection(const std::vector<int>& serialized, unsigned int hops);
+
+	/**
+	 * @brief Bounds the size of a message, given the buffer size.
+	 * @return The size in bytes of a receive buffer.
+	 */
+	size_t maxMessageSize() const;
+
+	/**
+	 * @brief Decodes and deserializes the sections of a received message.
+	 * @param received The received message.
+	 * @param count The number of bytes in received.
+	 */
+	void readSections(const uint8_t* received, size_t count);
 
 	unsigned int totalSize; ///< Total size of the buffer for clause sharing
 
+	GlobalTopology topology; ///< Topology of the processes
+
+	unsigned int degree; ///< Arity of the tree, or fan-out of the gossip
+
+	unsigned long round = 0; ///< Current round, the gossip partners depend on it
+
 	std::vector<MPI_Request> sendRequests; ///< MPI requests for non-blocking sends
 
 	BloomFilter b_filter_send; ///< Bloom filter for avoiding duplicate clause sends
@@ -78,7 +165,29 @@ class GenericGlobalSharing : public GlobalSharingStrategy
 
 	std::vector<int> receivedClauses; ///< Buffer for received serialized clauses
 
+	std::vector<uint8_t> encodedToSend; ///< Encoded clauses to send, kept until the sends complete
+
+	std::vector<uint8_t> encodedSection; ///< Encoded clauses of one section
+
+	std::vector<std::vector<uint8_t>> receiveBuffers; ///< Buffer of the received message, by subscription
+
+	std::vector<MPI_Request> receiveRequests; ///< MPI requests for non-blocking receives, by subscription
+
+	std::vector<int> receiveIndices; ///< Subscriptions of the completed receives
+
+	std::vector<MPI_Status> receiveStatuses; ///< Statuses of the completed receives
+
+	std::vector<std::vector<int>> toForward; ///< Serialized clauses to forward, by number of hops
+
 	std::vector<int> subscriptions; ///< List of MPI ranks to receive clauses from
 
 	std::vector<int> subscribers; ///< List of MPI ranks to send clauses to
-};
\ No newline at end of file
+
+	// Stats
+	//------
+	std::vector<unsigned long> delays; ///< Number of new clauses received, by propagation delay in rounds
+
+	unsigned long forwardedClauses = 0;
+
+	unsigned long forwardDropped = 0; ///< Clauses not forwarded, the buffer was full
+};
@@ -2,6 +2,7 @@
 #include "painless.hpp"
 #include "utils/MpiUtils.hpp"
 #include "utils/Parameters.hpp"
+#include "working/DistributedTermination.hpp"
 #include <list>
 
 // for now the loops works only for root = 0
@@ -27,6 +28,28 @@ GlobalSharingStrategy::printStats()
 			gstats.receivedDuplicas,
 			gstats.sharedDuplicasAvoided,
 			gstats.messagesSent);
+	if (gstats.encodedLiterals)
+		LOGSTAT("Global Strategy: %lu literals encoded in %lu bytes (%.2f bytes per literal, %.2f as integers)",
+				gstats.encodedLiterals,
+				gstats.encodedBytes,
+				(double)gstats.encodedBytes / gstats.encodedLiterals,
+				(double)gstats.rawBytes / gstats.encodedLiterals);
+}
+
+void
+GlobalSharingStrategy::encodeClauses(const int* serialized, size_t count, std::vector<uint8_t>& encoded)
+{
+	encoded.clear();
+	gstats.encodedLiterals += mpiutils::encodeClauses(serialized, count, encoded);
+	gstats.encodedBytes += encoded.size();
+	gstats.rawBytes += count * sizeof(int);
+}
+
+void
+GlobalSharingStrategy::decodeClauses(const uint8_t* encoded, size_t count, std::vector<int>& serialized)
+{
+	if (!mpiutils::decodeClauses(encoded, count, serialized))
+		LOGERROR("[GStrat] Dropped the rest of a malformed clause buffer");
 }
 
 std::chrono::microseconds
@@ -99,6 +122,17 @@ GlobalSharingStrategy::joinProcess(int winnerRank, SatResult res, const std::vec
 
 bool
 GlobalSharingStrategy::doSharing()
+{
+	int receivedFinalResultBcast = prepareEndingDecision();
+
+	// Broadcast from MY_MPI_ROOT "most significant 16bits are the winner_rank"
+	TESTRUNMPI(MPI_Bcast(&receivedFinalResultBcast, 1, MPI_INT, MY_MPI_ROOT, MPI_COMM_WORLD));
+
+	return applyEndingDecision(receivedFinalResultBcast);
+}
+
+int
+GlobalSharingStrategy::prepareEndingDecision()
 {
 	// Ending Management
 	int end_flag;
@@ -116,7 +150,10 @@ GlobalSharingStrategy::doSharing()
 	}
 
 	if (mpi_rank == MY_MPI_ROOT) {
-		if (globalEnding) // to check if the root found the solution
+		if (DistributedTermination::isActive()) // the termination listener decides, the round ends on its decision
+		{
+			receivedFinalResultBcast = DistributedTermination::getDecision();
+		} else if (globalEnding) // to check if the root found the solution
 		{
 			receivedFinalResultBcast = static_cast<int>(finalResult.load());
 			LOGDEBUG1("[GStrat] It is the end, now I will send end to all descendants (%d)", receivedFinalResultBcast);
@@ -145,9 +182,12 @@ GlobalSharingStrategy::doSharing()
 				  (int)(rank_winner << 16));
 	}
 
-	// Broadcast from MY_MPI_ROOT "most significant 16bits are the winner_rank"
-	TESTRUNMPI(MPI_Bcast(&receivedFinalResultBcast, 1, MPI_INT, MY_MPI_ROOT, MPI_COMM_WORLD));
+	return receivedFinalResultBcast;
+}
 
+bool
+GlobalSharingStrategy::applyEndingDecision(int receivedFinalResultBcast)
+{
 	if (receivedFinalResultBcast != 0) {
 		finalResult = static_cast<SatResult>(receivedFinalResultBcast & 0x0000FFFF);
 		mpi_winner = (receivedFinalResultBcast & 0xFFFF0000) >> 16;
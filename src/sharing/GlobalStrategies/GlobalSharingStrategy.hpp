@@ -115,6 +115,36 @@ class GlobalSharingStrategy : public SharingStrategy
 	virtual bool doSharing() override;
 
   protected:
+	/**
+	 * @brief First half of the ending detection of doSharing: a non-root process sends its end to the root, the root
+	 * computes the decision to broadcast.
+	 * @return The decision packed as winner rank << 16 | result on the root, 0 while undecided and on the others.
+	 */
+	int prepareEndingDecision();
+
+	/**
+	 * @brief Second half of the ending detection of doSharing: applies the decision broadcast by the root.
+	 * @param receivedFinalResultBcast The broadcast decision.
+	 * @return True if it is the end, the process must then call joinProcess.
+	 */
+	bool applyEndingDecision(int receivedFinalResultBcast);
+
+	/**
+	 * @brief Encodes serialized clauses ([size][lbd][literals])* for the wire, see mpiutils::encodeClauses.
+	 * @param serialized The serialized clauses.
+	 * @param count The number of integers in serialized.
+	 * @param encoded The vector receiving the encoded bytes, cleared first.
+	 */
+	void encodeClauses(const int* serialized, size_t count, std::vector<uint8_t>& encoded);
+
+	/**
+	 * @brief Decodes a buffer received from the wire, see mpiutils::decodeClauses.
+	 * @param encoded The encoded bytes.
+	 * @param count The number of bytes.
+	 * @param serialized The vector where the decoded clauses are appended.
+	 */
+	void decodeClauses(const uint8_t* encoded, size_t count, std::vector<int>& serialized);
+
 	GlobalSharingStatistics gstats; ///< Statistics for global sharing
 	bool requests_sent; ///< Flag indicating if requests to end were sent to the root
 	std::vector<MPI_Request> recv_end_requests; ///< MPI requests for non-blocking receive of end signals
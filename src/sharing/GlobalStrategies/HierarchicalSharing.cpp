@@ -0,0 +1,255 @@
+#include "HierarchicalSharing.hpp"
+#include "containers/ClauseUtils.hpp"
+#include "painless.hpp"
+#include "utils/Logger.hpp"
+#include "utils/MpiUtils.hpp"
+#include "utils/Parameters.hpp"
+
+#include <cstring>
+
+HierarchicalSharing::HierarchicalSharing(const std::shared_ptr<ClauseDatabase>& clauseDB, unsigned long bufferSize)
+	: GlobalSharingStrategy(clauseDB)
+	, totalSize(bufferSize)
+{
+}
+
+HierarchicalSharing::~HierarchicalSharing()
+{
+	if (m_window != MPI_WIN_NULL) {
+		TESTRUNMPI(MPI_Win_unlock_all(m_window));
+		TESTRUNMPI(MPI_Win_free(&m_window));
+	}
+	if (m_leaderComm != MPI_COMM_NULL)
+		TESTRUNMPI(MPI_Comm_free(&m_leaderComm));
+	if (m_nodeComm != MPI_COMM_NULL)
+		TESTRUNMPI(MPI_Comm_free(&m_nodeComm));
+}
+
+void
+HierarchicalSharing::joinProcess(int winnerRank, SatResult res, const std::vector<int>& model)
+{
+	this->GlobalSharingStrategy::joinProcess(winnerRank, res, model);
+}
+
+bool
+HierarchicalSharing::initMpiVariables()
+{
+	if (mpi_world_size < 2) {
+		LOGWARN("[Hierarchical] I am alone or MPI was not initialized, no need for distributed mode, initialization "
+				"aborted");
+		return false;
+	}
+
+	/* Node and leaders communicators */
+	TESTRUNMPI(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, mpi_rank, MPI_INFO_NULL, &m_nodeComm));
+	TESTRUNMPI(MPI_Comm_rank(m_nodeComm, &m_nodeRank));
+	TESTRUNMPI(MPI_Comm_size(m_nodeComm, &m_nodeSize));
+
+	TESTRUNMPI(MPI_Comm_split(MPI_COMM_WORLD, m_nodeRank == 0 ? 0 : MPI_UNDEFINED, mpi_rank, &m_leaderComm));
+	if (m_leaderComm != MPI_COMM_NULL)
+		TESTRUNMPI(MPI_Comm_size(m_leaderComm, &m_nodeCount));
+	TESTRUNMPI(MPI_Bcast(&m_nodeCount, 1, MPI_INT, 0, m_nodeComm));
+
+	/* Shared window: two slots per process, and two remote slots for the leader */
+	if (m_nodeCount > 1)
+		m_remoteCapacity = (unsigned long)totalSize * (mpi_world_size - m_nodeSize);
+
+	MPI_Aint segmentSize = 2 * (1 + totalSize);
+	if (m_nodeRank == 0)
+		segmentSize += 2 * (1 + m_remoteCapacity);
+
+	int* base;
+	TESTRUNMPI(MPI_Win_allocate_shared(
+		segmentSize * sizeof(int), sizeof(int), MPI_INFO_NULL, m_nodeComm, &base, &m_window));
+
+	m_segments.resize(m_nodeSize);
+	for (int r = 0; r < m_nodeSize; r++) {
+		MPI_Aint size;
+		int dispUnit;
+		TESTRUNMPI(MPI_Win_shared_query(m_window, r, &size, &dispUnit, &m_segments[r]));
+	}
+
+	// Passive epoch for the whole run, the node barriers order the accesses
+	TESTRUNMPI(MPI_Win_lock_all(MPI_MODE_NOCHECK, m_window));
+	std::memset(base, 0, segmentSize * sizeof(int));
+
+	if (m_nodeRank == 0)
+		m_counts.resize(m_nodeCount);
+
+	LOG0("[Hierarchical] Process %d is %d/%d on its node, %d nodes", mpi_rank, m_nodeRank, m_nodeSize, m_nodeCount);
+
+	return GlobalSharingStrategy::initMpiVariables();
+}
+
+bool
+HierarchicalSharing::doSharing()
+{
+	/* Ending Detection */
+	if (GlobalSharingStrategy::doSharing()) {
+		this->joinProcess(mpi_winner, finalResult, {});
+		return true;
+	}
+
+	int parity = m_round++ & 1;
+
+	/* Write my clauses in my slot */
+	int* mySlot = localSlot(m_nodeRank, parity);
+	mySlot[0] = serializeClauses(mySlot + 1);
+
+	TESTRUNMPI(MPI_Win_sync(m_window));
+	TESTRUNMPI(MPI_Barrier(m_nodeComm));
+	TESTRUNMPI(MPI_Win_sync(m_window));
+
+	/* The leaders exchange the clauses of their nodes */
+	if (m_leaderComm != MPI_COMM_NULL && m_nodeCount > 1) {
+		m_nodeClauses.clear();
+		for (int r = 0; r < m_nodeSize; r++) {
+			int* slot = localSlot(r, parity);
+			m_nodeClauses.insert(m_nodeClauses.end(), slot + 1, slot + 1 + slot[0]);
+		}
+
+		this->encodeClauses(m_nodeClauses.data(), m_nodeClauses.size(), m_encodedNode);
+
+		int sendCount = m_encodedNode.size();
+		TESTRUNMPI(MPI_Allgather(&sendCount, 1, MPI_INT, m_counts.data(), 1, MPI_INT, m_leaderComm));
+
+		int leaderRank;
+		TESTRUNMPI(MPI_Comm_rank(m_leaderComm, &leaderRank));
+		m_displacements.resize(m_nodeCount);
+		int total = 0;
+		for (int i = 0; i < m_nodeCount; i++) {
+			m_displacements[i] = total;
+			total += m_counts[i];
+		}
+		m_gatheredEncoded.resize(total);
+
+		TESTRUNMPI(MPI_Allgatherv(m_encodedNode.data(),
+								  sendCount,
+								  MPI_BYTE,
+								  m_gatheredEncoded.data(),
+								  m_counts.data(),
+								  m_displacements.data(),
+								  MPI_BYTE,
+								  m_leaderComm));
+		gstats.messagesSent += m_nodeCount - 1;
+
+		// Publish the clauses of the other nodes
+		m_gatheredClauses.clear();
+		for (int i = 0; i < m_nodeCount; i++) {
+			if (i != leaderRank)
+				this->decodeClauses(m_gatheredEncoded.data() + m_displacements[i], m_counts[i], m_gatheredClauses);
+		}
+		// A malformed or oversized batch must not overflow the slot: keep the clauses that fit
+		if (m_gatheredClauses.size() > m_remoteCapacity) {
+			size_t kept = 0;
+			while (kept + 2 <= m_gatheredClauses.size() && kept + 2 + m_gatheredClauses[kept] <= m_remoteCapacity)
+				kept += 2 + m_gatheredClauses[kept];
+			LOGERROR("[Hierarchical] Dropped %zu of the %zu integers of the other nodes, the remote slot holds %lu",
+					 m_gatheredClauses.size() - kept,
+					 m_gatheredClauses.size(),
+					 m_remoteCapacity);
+			m_gatheredClauses.resize(kept);
+		}
+
+		int* remote = remoteSlot(parity);
+		std::memcpy(remote + 1, m_gatheredClauses.data(), m_gatheredClauses.size() * sizeof(int));
+		remote[0] = m_gatheredClauses.size();
+	}
+
+	TESTRUNMPI(MPI_Win_sync(m_window));
+	TESTRUNMPI(MPI_Barrier(m_nodeComm));
+	TESTRUNMPI(MPI_Win_sync(m_window));
+
+	/* Read in place the slots of the node, then the clauses of the other nodes */
+	for (int r = 0; r < m_nodeSize; r++) {
+		if (r == m_nodeRank)
+			continue;
+		int* slot = localSlot(r, parity);
+		deserializeClauses(slot + 1, slot[0]);
+		m_intraNodeInts += slot[0];
+	}
+	if (m_nodeCount > 1) {
+		int* remote = remoteSlot(parity);
+		deserializeClauses(remote + 1, remote[0]);
+	}
+
+	LOG2("[Hierarchical] received cls %u shared cls %d", this->gstats.receivedClauses.load(), this->gstats.sharedClauses);
+
+	return false;
+}
+
+void
+HierarchicalSharing::printStats()
+{
+	GlobalSharingStrategy::printStats();
+	LOGSTAT("[Hierarchical] Integers read from the shared window of the node: %lu", m_intraNodeInts);
+}
+
+//==============================
+// Serialization/Deseralization
+//==============================
+
+unsigned int
+HierarchicalSharing::serializeClauses(int* slot)
+{
+	unsigned int dataCount = 0;
+	ClauseExchangePtr tmp_cls;
+
+	while (dataCount < totalSize && m_clauseDB->getOneClause(tmp_cls)) {
+		if (dataCount + 2 + tmp_cls->size > totalSize) {
+			this->importClause(tmp_cls); // reinsert the clause to the database to not lose it
+			break;
+		}
+
+		// check with bloom filter if clause will be sent. If already sent, the clause is directly released
+		if (!this->b_filter_send.contains(tmp_cls->lits, tmp_cls->size)) {
+			slot[dataCount++] = tmp_cls->size;
+			slot[dataCount++] = tmp_cls->lbd;
+			std::copy(tmp_cls->begin(), tmp_cls->end(), slot + dataCount);
+			dataCount += tmp_cls->size;
+			this->b_filter_send.insert(tmp_cls->lits, tmp_cls->size);
+			gstats.sharedClauses++;
+		} else {
+			gstats.sharedDuplicasAvoided++;
+		}
+	}
+
+	return dataCount;
+}
+
+void
+HierarchicalSharing::deserializeClauses(const int* data, unsigned int count)
+{
+	unsigned int i = 0;
+	int size, lbd;
+	ClauseExchangePtr p_cls;
+
+	while (i + 2 <= count) {
+		size = data[i++];
+		lbd = data[i++];
+
+		if (i + size > count) {
+			LOGERROR("Deserialization error: Incomplete clause data");
+			break;
+		}
+
+		if (!this->b_filter_recv.contains(data + i, size)) {
+			p_cls = ClauseExchange::create(data + i, data + i + size, lbd, this->getSharingId());
+			if (this->exportClause(p_cls))
+				gstats.receivedClauses++;
+			this->b_filter_recv.insert(data + i, size);
+		} else {
+			gstats.receivedDuplicas++;
+		}
+
+		i += size;
+	}
+}
+
+void
+HierarchicalSharing::shrinkMemory()
+{
+	SharingStrategy::shrinkMemory();
+	this->b_filter_send.clear();
+	this->b_filter_recv.clear();
+}
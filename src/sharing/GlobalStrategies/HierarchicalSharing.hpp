@@ -0,0 +1,114 @@
+#pragma once
+
+#include "GlobalSharingStrategy.hpp"
+
+/**
+ * @class HierarchicalSharing
+ * @brief Two-level global sharing: shared memory between the processes of a node, MPI_Allgatherv between the nodes.
+ *
+ * @ingroup global_sharing
+ *
+ * The processes of a node (MPI_COMM_TYPE_SHARED) allocate one MPI-3 shared window. At each round, every process writes
+ * its clauses ([size][lbd][literals])* in its own slot, and the others read them in place: no message is exchanged
+ * inside a node. The leader of each node (its process of rank 0) concatenates the slots of its node, exchanges them
+ * encoded (mpiutils::encodeClauses) with the other leaders, and publishes the clauses of the other nodes in its remote
+ * slot, read in place by the processes of its node. The slots are double buffered on the parity of the round, two node
+ * barriers separate the writes and the reads.
+ */
+class HierarchicalSharing : public GlobalSharingStrategy
+{
+  public:
+	/**
+	 * @brief Constructor for HierarchicalSharing.
+	 * @param clauseDB Shared pointer to the clause database.
+	 * @param bufferSize Size (in integers, metadata included) of the slot of each process.
+	 */
+	HierarchicalSharing(const std::shared_ptr<ClauseDatabase>& clauseDB, unsigned long bufferSize);
+
+	/**
+	 * @brief Destructor, frees the window and the communicators.
+	 */
+	~HierarchicalSharing();
+
+	/**
+	 * @brief Splits the node and leaders communicators and allocates the shared window.
+	 * @return true if initialization was successful, false otherwise.
+	 */
+	bool initMpiVariables() override;
+
+	/**
+	 * @brief Performs the clause sharing operation: write the own slot, exchange between the leaders, then read the
+	 * slots of the node and the remote slot of the leader.
+	 * @return true if sharing is complete and the process can terminate, false otherwise.
+	 */
+	bool doSharing() override;
+
+	/**
+	 * @brief Handles the process of joining when a solution is found.
+	 * @param winnerRank The rank of the process that found the solution.
+	 * @param res The result of the SAT solving process.
+	 * @param model The satisfying assignment, if any.
+	 */
+	void joinProcess(int winnerRank, SatResult res, const std::vector<int>& model) override;
+
+	/**
+	 * @brief Prints the global statistics and the intra-node volume.
+	 */
+	void printStats() override;
+
+  protected:
+	/**
+	 * @brief Clears the database and the bloom filters.
+	 */
+	void shrinkMemory() override;
+
+	/**
+	 * @brief Serializes clauses in a slot.
+	 * @param slot Destination, of totalSize integers.
+	 * @return The number of integers written.
+	 */
+	unsigned int serializeClauses(int* slot);
+
+	/**
+	 * @brief Deserializes the clauses of a slot and exports them to the clients.
+	 * @param data The serialized clauses.
+	 * @param count The number of integers in data.
+	 */
+	void deserializeClauses(const int* data, unsigned int count);
+
+	/// Slot (count then data) of a process of the node for a round parity
+	int* localSlot(int nodeRank, int parity) { return m_segments[nodeRank] + parity * (1 + totalSize); }
+
+	/// Slot (count then data) of the clauses of the other nodes, in the segment of the leader
+	int* remoteSlot(int parity) { return m_segments[0] + 2 * (1 + totalSize) + parity * (1 + m_remoteCapacity); }
+
+	unsigned int totalSize; ///< Size of the slot of each process
+
+	unsigned long m_remoteCapacity = 0; ///< Size of the remote slot, for the clauses of all the other nodes
+
+	MPI_Comm m_nodeComm = MPI_COMM_NULL;   ///< Processes sharing the memory of this node
+	MPI_Comm m_leaderComm = MPI_COMM_NULL; ///< Leaders of the nodes, null on the other processes
+	MPI_Win m_window = MPI_WIN_NULL;	   ///< Shared window of the node
+
+	int m_nodeRank = 0;
+	int m_nodeSize = 1;
+	int m_nodeCount = 1;
+
+	std::vector<int*> m_segments; ///< Segment of each process of the node, mapped in this process
+
+	unsigned long m_round = 0;
+
+	/* Leader buffers */
+	std::vector<int> m_nodeClauses;		  ///< Concatenated slots of the node
+	std::vector<uint8_t> m_encodedNode;	  ///< Encoded clauses of the node
+	std::vector<uint8_t> m_gatheredEncoded; ///< Encoded clauses of all the nodes
+	std::vector<int> m_gatheredClauses;	  ///< Decoded clauses of the other nodes
+	std::vector<int> m_counts;
+	std::vector<int> m_displacements;
+
+	unsigned long m_intraNodeInts = 0; ///< Integers read in place from the slots of the node
+
+	BloomFilter b_filter_send; ///< Bloom filter for avoiding duplicate clause sends
+
+	BloomFilter b_filter_recv; ///< Bloom filter for avoiding duplicate clause receives
+};
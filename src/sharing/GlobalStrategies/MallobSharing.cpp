@@ -6,6 +6,7 @@
 #include "utils/Parameters.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <random>
 
 #define MALLOB_MPI_ROOT 0
@@ -173,6 +174,7 @@ MallobSharing::doSharing()
 	int root_size = 0;
 	int buffer_size = 0;
 	int nb_buffers_aggregated = 1; // my buffer is accounted here
+	int child_aggregated = 0;
 
 	// Compute Compensation Factor
 	if (father == MPI_UNDEFINED)
@@ -194,20 +196,23 @@ MallobSharing::doSharing()
 		buffers.clear();
 
 		TESTRUNMPI(MPI_Probe(right_child, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
-		TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &received_buffer_size));
-		receivedClausesRight.resize(received_buffer_size);
+		TESTRUNMPI(MPI_Get_count(&status, MPI_BYTE, &received_buffer_size));
+		receivedEncoded.resize(received_buffer_size);
 
 		LOGDEBUG2("Parent %d waiting for right child %d on MPI_Recv", mpi_rank, right_child);
-		TESTRUNMPI(MPI_Recv(&receivedClausesRight[0],
+		TESTRUNMPI(MPI_Recv(receivedEncoded.data(),
 							received_buffer_size,
-							MPI_INT,
+							MPI_BYTE,
 							right_child,
 							MYMPI_CLAUSES,
 							MPI_COMM_WORLD,
 							&status));
 
-		nb_buffers_aggregated += receivedClausesRight.back(); // get nb buffers aggregated of my right child
-		receivedClausesRight.pop_back();					  // remove the nb_buffers_aggregated
+		// the encoded clauses are followed by the number of buffers aggregated by my right child
+		received_buffer_size -= sizeof(int);
+		std::memcpy(&child_aggregated, receivedEncoded.data() + received_buffer_size, sizeof(int));
+		nb_buffers_aggregated += child_aggregated;
+		this->decodeClauses(receivedEncoded.data(), received_buffer_size, receivedClausesRight);
 
 		// add the clauses to the mergeBuffer
 		buffers.push_back(std::ref(receivedClausesRight));
@@ -217,19 +222,22 @@ MallobSharing::doSharing()
 			receivedClausesLeft.clear();
 
 			TESTRUNMPI(MPI_Probe(left_child, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
-			TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &received_buffer_size));
-			receivedClausesLeft.resize(received_buffer_size);
+			TESTRUNMPI(MPI_Get_count(&status, MPI_BYTE, &received_buffer_size));
+			receivedEncoded.resize(received_buffer_size);
 			LOGDEBUG2("Parent %d waiting for left child %d on MPI_Recv", mpi_rank, left_child);
-			TESTRUNMPI(MPI_Recv(&receivedClausesLeft[0],
+			TESTRUNMPI(MPI_Recv(receivedEncoded.data(),
 								received_buffer_size,
-								MPI_INT,
+								MPI_BYTE,
 								left_child,
 								MYMPI_CLAUSES,
 								MPI_COMM_WORLD,
 								&status));
 
-			nb_buffers_aggregated += receivedClausesLeft.back(); // get nb buffers aggregated of my right child
-			receivedClausesLeft.pop_back();						 // remove the nb_buffers_aggregated
+			// the encoded clauses are followed by the number of buffers aggregated by my left child
+			received_buffer_size -= sizeof(int);
+			std::memcpy(&child_aggregated, receivedEncoded.data() + received_buffer_size, sizeof(int));
+			nb_buffers_aggregated += child_aggregated;
+			this->decodeClauses(receivedEncoded.data(), received_buffer_size, receivedClausesLeft);
 
 			// add the clause to the mergeBuffer
 			buffers.push_back(std::ref(receivedClausesLeft));
@@ -243,8 +251,13 @@ MallobSharing::doSharing()
 	int clauseCount = mergeSerializedBuffersWithMine(buffers, clausesToSendSerialized, lastEpochReceivedLits);
 	gstats.sharedClauses += clauseCount;
 
-	if (father != MPI_UNDEFINED)								  // not needed in root
-		clausesToSendSerialized.push_back(nb_buffers_aggregated); // number of buffers aggregated
+	// Encoded once: sent to my father, or to my children if root
+	this->encodeClauses(clausesToSendSerialized.data(), clausesToSendSerialized.size(), encodedToSend);
+
+	if (father != MPI_UNDEFINED) { // not needed in root
+		encodedToSend.resize(encodedToSend.size() + sizeof(int));
+		std::memcpy(encodedToSend.data() + encodedToSend.size() - sizeof(int), &nb_buffers_aggregated, sizeof(int));
+	}
 
 	LOGDEBUG1("[Tree] TotalSize = %d(%d)(%f%%), Buffer to send size=%u(nflits:%u), clauses %u",
 			  COMPENSATED_SIZE,
@@ -260,43 +273,42 @@ MallobSharing::doSharing()
 		LOGDEBUG1("%d->%d : buff:%d", mpi_rank, father, clausesToSendSerialized.size());
 
 		// Send to my parent my clauses.
-		TESTRUNMPI(MPI_Send(&clausesToSendSerialized[0],
-							clausesToSendSerialized.size(),
-							MPI_INT,
-							father,
-							MYMPI_CLAUSES,
-							MPI_COMM_WORLD));
+		TESTRUNMPI(
+			MPI_Send(encodedToSend.data(), encodedToSend.size(), MPI_BYTE, father, MYMPI_CLAUSES, MPI_COMM_WORLD));
 		gstats.messagesSent++;
 
 		// Wait for my parent's response
 		LOGDEBUG2("Me %d waiting for my parent's %d response ", mpi_rank, father);
 		TESTRUNMPI(MPI_Probe(father, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
-		TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &received_buffer_size));
-		receivedClausesFather.resize(received_buffer_size);
+		TESTRUNMPI(MPI_Get_count(&status, MPI_BYTE, &received_buffer_size));
+		encodedFromFather.resize(received_buffer_size);
 
 		TESTRUNMPI(MPI_Recv(
-			&receivedClausesFather[0], received_buffer_size, MPI_INT, father, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
+			encodedFromFather.data(), received_buffer_size, MPI_BYTE, father, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
+		this->decodeClauses(encodedFromFather.data(), received_buffer_size, receivedClausesFather);
 	}
 
 	// If it is the root just send merged buffer, otherwise pass on the received buffer from the father
 	std::reference_wrapper<std::vector<int>> finalMergedBuffer =
 		(father == MPI_UNDEFINED) ? std::ref(clausesToSendSerialized) : std::ref(receivedClausesFather);
+	std::reference_wrapper<std::vector<uint8_t>> finalEncodedBuffer =
+		(father == MPI_UNDEFINED) ? std::ref(encodedToSend) : std::ref(encodedFromFather);
 
-	// Response to my children
+	// Response to my children, the encoded buffer is forwarded as is
 	if (nb_children >= 1) {
 		LOGDEBUG2("Me %d responding to my right child %d", mpi_rank, right_child);
-		TESTRUNMPI(MPI_Send(&finalMergedBuffer.get()[0],
-							finalMergedBuffer.get().size(),
-							MPI_INT,
+		TESTRUNMPI(MPI_Send(finalEncodedBuffer.get().data(),
+							finalEncodedBuffer.get().size(),
+							MPI_BYTE,
 							right_child,
 							MYMPI_CLAUSES,
 							MPI_COMM_WORLD));
 		gstats.messagesSent++;
 		if (nb_children == 2) {
 			LOGDEBUG2("Me %d responding to my left child %d", mpi_rank, left_child);
-			TESTRUNMPI(MPI_Send(&finalMergedBuffer.get()[0],
-								finalMergedBuffer.get().size(),
-								MPI_INT,
+			TESTRUNMPI(MPI_Send(finalEncodedBuffer.get().data(),
+								finalEncodedBuffer.get().size(),
+								MPI_BYTE,
 								left_child,
 								MYMPI_CLAUSES,
 								MPI_COMM_WORLD));
@@ -400,6 +412,34 @@ MallobSharing::doSharing()
 	return false;
 }
 
+size_t
+MallobSharing::shrinkFilter()
+{
+	if (m_resharingPeriodInEpochs <= 0)
+		return 0;
+	size_t removedEntries = 0;
+	auto it = m_clauseMetaMap.begin();
+	while (it != m_clauseMetaMap.end()) {
+		const ClauseMeta& currentMeta = it->second;
+		if (m_currentEpoch - currentMeta.sharedEpoch > m_resharingPeriodInEpochs &&
+			m_currentEpoch - currentMeta.productionEpoch > m_resharingPeriodInEpochs) {
+			it = m_clauseMetaMap.erase(it);
+			removedEntries++;
+		} else {
+			++it;
+		}
+	}
+	return removedEntries;
+}
+
+void
+MallobSharing::shrinkMemory()
+{
+	SharingStrategy::shrinkMemory();
+	LOG1("[Mallob] Exact filter of %zu entries cleared on memory pressure", m_clauseMetaMap.size());
+	decltype(m_clauseMetaMap)().swap(m_clauseMetaMap);
+}
+
 //==============================
 // Serialization/Deseralization
 //==============================
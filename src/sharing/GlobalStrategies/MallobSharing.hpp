@@ -145,6 +145,10 @@ class MallobSharing : public GlobalSharingStrategy
 	std::vector<int> receivedClausesRight;	  ///< Buffer for clauses received from right child
 	std::vector<int> receivedClausesFather;	  ///< Buffer for clauses received from parent
 
+	std::vector<uint8_t> encodedToSend;		///< Encoded clauses to send, to the parent or to the children if root
+	std::vector<uint8_t> receivedEncoded;	///< Encoded buffer received from a child
+	std::vector<uint8_t> encodedFromFather; ///< Encoded buffer received from parent, forwarded to the children
+
 	std::vector<ClauseExchangePtr> deserializedClauses; ///< Buffer for deserialized clauses
 
 	pl::Bitset myBitVector; ///< Bitset for tracking shared clauses
@@ -261,6 +265,11 @@ class MallobSharing : public GlobalSharingStrategy
 	 */
 	size_t shrinkFilter();
 
+	/**
+	 * @brief Clears the database and the whole exact filter, the forgotten clauses may be reshared.
+	 */
+	void shrinkMemory() override;
+
   private:
 	unsigned m_sharingPerSecond;   /**< Number of sharing operations per second. */
 	unsigned m_maxProducerId;	   /**< Maximum ID for producers, equivalent to the maximum ID in the producers. */
@@ -0,0 +1,343 @@
+#include "RmaMailboxSharing.hpp"
+#include "containers/ClauseUtils.hpp"
+#include "painless.hpp"
+#include "utils/Logger.hpp"
+#include "utils/MpiUtils.hpp"
+#include "utils/Parameters.hpp"
+
+#include <cstring>
+
+// for now the loops works only for root = 0
+#define MY_MPI_ROOT 0
+
+RmaMailboxSharing::RmaMailboxSharing(const std::shared_ptr<ClauseDatabase>& clauseDB,
+									 unsigned long bufferSize,
+									 unsigned long mailboxBytes)
+	: GlobalSharingStrategy(clauseDB)
+	, totalSize(bufferSize)
+	, ringBytes((mailboxBytes + 7) & ~7UL)
+{
+}
+
+RmaMailboxSharing::~RmaMailboxSharing()
+{
+	if (m_window != MPI_WIN_NULL) {
+		TESTRUNMPI(MPI_Win_unlock_all(m_window));
+		TESTRUNMPI(MPI_Win_free(&m_window));
+	}
+	if (m_endComm != MPI_COMM_NULL)
+		TESTRUNMPI(MPI_Comm_free(&m_endComm));
+}
+
+void
+RmaMailboxSharing::joinProcess(int winnerRank, SatResult res, const std::vector<int>& model)
+{
+	this->GlobalSharingStrategy::joinProcess(winnerRank, res, model);
+}
+
+bool
+RmaMailboxSharing::initMpiVariables()
+{
+	if (mpi_world_size < 2) {
+		LOGWARN("[Rma] I am alone or MPI was not initialized, no need for distributed mode, initialization aborted");
+		return false;
+	}
+
+	// A batch is its length then at most 7 bytes per integer after the codec version, it must fit in a mailbox
+	unsigned long maxBatch = ringBytes > 5 ? (ringBytes - 5) / 7 : 0;
+	if (totalSize > maxBatch) {
+		LOGWARN("[Rma] Batches of %u integers don't fit in mailboxes of %lu bytes, reduced to %lu",
+				totalSize,
+				ringBytes,
+				maxBatch);
+		totalSize = maxBatch;
+	}
+
+	MPI_Aint windowSize = mailbox(mpi_world_size);
+	TESTRUNMPI(MPI_Win_allocate(windowSize, 1, MPI_INFO_NULL, MPI_COMM_WORLD, &m_base, &m_window));
+
+	// The batches are read in the local memory of the window, the puts must be visible there
+	int* model;
+	int found;
+	TESTRUNMPI(MPI_Win_get_attr(m_window, MPI_WIN_MODEL, &model, &found));
+	if (!found || *model != MPI_WIN_UNIFIED) {
+		LOGWARN("[Rma] The MPI library doesn't provide the unified memory model, initialization aborted");
+		TESTRUNMPI(MPI_Win_free(&m_window));
+		return false;
+	}
+
+	// The counters must be zero before the first access of the others
+	std::memset(m_base, 0, windowSize);
+	TESTRUNMPI(MPI_Barrier(MPI_COMM_WORLD));
+
+	// Passive epoch for the whole run
+	TESTRUNMPI(MPI_Win_lock_all(MPI_MODE_NOCHECK, m_window));
+
+	m_written.assign(mpi_world_size, 0);
+	m_remoteRead.assign(mpi_world_size, 0);
+	m_read.assign(mpi_world_size, 0);
+	m_available.assign(mpi_world_size, 0);
+
+	TESTRUNMPI(MPI_Comm_dup(MPI_COMM_WORLD, &m_endComm));
+	TESTRUNMPI(MPI_Ibcast(&m_endBuffer, 1, MPI_INT, MY_MPI_ROOT, m_endComm, &m_endRequest));
+
+	LOG0("[Rma] Mailboxes of %lu bytes for %d processes", ringBytes, mpi_world_size - 1);
+
+	return GlobalSharingStrategy::initMpiVariables();
+}
+
+bool
+RmaMailboxSharing::doSharing()
+{
+	/* Ending Detection, without waiting for the others */
+	if (testEnding()) {
+		this->joinProcess(mpi_winner, finalResult, {});
+		return true;
+	}
+
+	/* Put my batch: its length then the encoded clauses */
+	clausesToSendSerialized.clear();
+	gstats.sharedClauses += serializeClauses(clausesToSendSerialized);
+
+	if (!clausesToSendSerialized.empty()) {
+		this->encodeClauses(clausesToSendSerialized.data(), clausesToSendSerialized.size(), encodedToSend);
+		uint32_t length = encodedToSend.size();
+		encodedToSend.insert(encodedToSend.begin(), sizeof(length), 0);
+		std::memcpy(encodedToSend.data(), &length, sizeof(length));
+		putBatch();
+	}
+
+	/* Read what the others put in my mailboxes */
+	readMailboxes();
+
+	LOG2("[Rma] received cls %u shared cls %d", this->gstats.receivedClauses.load(), this->gstats.sharedClauses);
+
+	return false;
+}
+
+bool
+RmaMailboxSharing::testEnding()
+{
+	int flag;
+
+	TESTRUNMPI(MPI_Test(&m_endRequest, &flag, MPI_STATUS_IGNORE));
+	while (flag) {
+		if (applyEndingDecision(m_endBuffer))
+			return true;
+
+		m_endBuffer = prepareEndingDecision();
+		TESTRUNMPI(MPI_Ibcast(&m_endBuffer, 1, MPI_INT, MY_MPI_ROOT, m_endComm, &m_endRequest));
+
+		// The root posts one broadcast per round, the others catch up with the completed ones
+		if (mpi_rank == MY_MPI_ROOT)
+			break;
+		TESTRUNMPI(MPI_Test(&m_endRequest, &flag, MPI_STATUS_IGNORE));
+	}
+	return false;
+}
+
+void
+RmaMailboxSharing::putBatch()
+{
+	const uint64_t record = encodedToSend.size();
+	const MPI_Aint myMailbox = mailbox(mpi_rank);
+	uint64_t unused = 0;
+
+	/* Room left in my mailboxes */
+	for (int t = 0; t < mpi_world_size; t++) {
+		if (t != mpi_rank)
+			TESTRUNMPI(MPI_Fetch_and_op(
+				&unused, &m_remoteRead[t], MPI_UINT64_T, t, myMailbox + sizeof(uint64_t), MPI_NO_OP, m_window));
+	}
+	TESTRUNMPI(MPI_Win_flush_all(m_window));
+
+	/* Data, in two parts when it wraps around the ring */
+	std::vector<char> written(mpi_world_size, false);
+	for (int t = 0; t < mpi_world_size; t++) {
+		if (t == mpi_rank)
+			continue;
+		if (m_written[t] - m_remoteRead[t] + record > ringBytes) {
+			batchesDropped++;
+			continue;
+		}
+
+		uint64_t offset = m_written[t] % ringBytes;
+		const int first = std::min<uint64_t>(record, ringBytes - offset);
+		const int second = record - first;
+		TESTRUNMPI(MPI_Put(encodedToSend.data(),
+						   first,
+						   MPI_BYTE,
+						   t,
+						   myMailbox + 2 * sizeof(uint64_t) + offset,
+						   first,
+						   MPI_BYTE,
+						   m_window));
+		if (second > 0)
+			TESTRUNMPI(MPI_Put(encodedToSend.data() + first,
+							   second,
+							   MPI_BYTE,
+							   t,
+							   myMailbox + 2 * sizeof(uint64_t),
+							   second,
+							   MPI_BYTE,
+							   m_window));
+
+		m_written[t] += record;
+		written[t] = true;
+		batchesPut++;
+		gstats.messagesSent++;
+	}
+	TESTRUNMPI(MPI_Win_flush_all(m_window));
+
+	/* The counters are published once the data is in the mailboxes */
+	for (int t = 0; t < mpi_world_size; t++) {
+		if (written[t])
+			TESTRUNMPI(MPI_Accumulate(
+				&m_written[t], 1, MPI_UINT64_T, t, myMailbox, 1, MPI_UINT64_T, MPI_REPLACE, m_window));
+	}
+	TESTRUNMPI(MPI_Win_flush_all(m_window));
+}
+
+void
+RmaMailboxSharing::readMailboxes()
+{
+	uint64_t unused = 0;
+	uint32_t length;
+	bool read = false;
+
+	for (int s = 0; s < mpi_world_size; s++) {
+		if (s != mpi_rank)
+			TESTRUNMPI(MPI_Fetch_and_op(
+				&unused, &m_available[s], MPI_UINT64_T, mpi_rank, mailbox(s), MPI_NO_OP, m_window));
+	}
+	TESTRUNMPI(MPI_Win_flush(mpi_rank, m_window));
+	TESTRUNMPI(MPI_Win_sync(m_window));
+
+	for (int s = 0; s < mpi_world_size; s++) {
+		if (s == mpi_rank || m_read[s] == m_available[s])
+			continue;
+
+		while (m_read[s] + sizeof(length) <= m_available[s]) {
+			readRing(s, m_read[s], reinterpret_cast<uint8_t*>(&length), sizeof(length));
+			if (m_read[s] + sizeof(length) + length > m_available[s]) {
+				LOGERROR("[Rma] Truncated batch of %u bytes from %d", length, s);
+				m_read[s] = m_available[s];
+				break;
+			}
+
+			receivedEncoded.resize(length);
+			readRing(s, m_read[s] + sizeof(length), receivedEncoded.data(), length);
+			m_read[s] += sizeof(length) + length;
+
+			receivedClauses.clear();
+			this->decodeClauses(receivedEncoded.data(), length, receivedClauses);
+			deserializeClauses(receivedClauses);
+			batchesRead++;
+		}
+
+		TESTRUNMPI(MPI_Accumulate(&m_read[s],
+								  1,
+								  MPI_UINT64_T,
+								  mpi_rank,
+								  mailbox(s) + sizeof(uint64_t),
+								  1,
+								  MPI_UINT64_T,
+								  MPI_REPLACE,
+								  m_window));
+		read = true;
+	}
+
+	if (read)
+		TESTRUNMPI(MPI_Win_flush(mpi_rank, m_window));
+}
+
+void
+RmaMailboxSharing::readRing(int sender, uint64_t offset, uint8_t* dest, size_t count)
+{
+	const uint8_t* ring = m_base + mailbox(sender) + 2 * sizeof(uint64_t);
+	uint64_t position = offset % ringBytes;
+	size_t first = std::min<uint64_t>(count, ringBytes - position);
+
+	std::memcpy(dest, ring + position, first);
+	std::memcpy(dest + first, ring, count - first);
+}
+
+void
+RmaMailboxSharing::printStats()
+{
+	GlobalSharingStrategy::printStats();
+	LOGSTAT("[Rma] Batches put %lu, lost in full mailboxes %lu, read %lu", batchesPut, batchesDropped, batchesRead);
+}
+
+//==============================
+// Serialization/Deseralization
+//==============================
+
+int
+RmaMailboxSharing::serializeClauses(std::vector<int>& serialized_v_cls)
+{
+	int nb_clauses = 0;
+	unsigned int dataCount = 0;
+	ClauseExchangePtr tmp_cls;
+
+	while (dataCount < totalSize && m_clauseDB->getOneClause(tmp_cls)) {
+		if (dataCount + 2 + tmp_cls->size > totalSize) {
+			this->importClause(tmp_cls); // reinsert the clause to the database to not lose it
+			break;
+		}
+
+		// check with bloom filter if clause will be sent. If already sent, the clause is directly released
+		if (!this->b_filter_send.contains(tmp_cls->lits, tmp_cls->size)) {
+			serialized_v_cls.push_back(tmp_cls->size);
+			serialized_v_cls.push_back(tmp_cls->lbd);
+			serialized_v_cls.insert(serialized_v_cls.end(), tmp_cls->begin(), tmp_cls->end());
+			this->b_filter_send.insert(tmp_cls->lits, tmp_cls->size);
+			nb_clauses++;
+
+			dataCount += (tmp_cls->size + 2);
+		} else {
+			gstats.sharedDuplicasAvoided++;
+		}
+	}
+
+	return nb_clauses;
+}
+
+void
+RmaMailboxSharing::deserializeClauses(const std::vector<int>& serialized_v_cls)
+{
+	unsigned int i = 0;
+	int size, lbd;
+	ClauseExchangePtr p_cls;
+	unsigned int bufferSize = serialized_v_cls.size();
+
+	while (i + 2 <= bufferSize) {
+		size = serialized_v_cls[i++];
+		lbd = serialized_v_cls[i++];
+
+		if (i + size > bufferSize) {
+			LOGERROR("Deserialization error: Incomplete clause data");
+			break;
+		}
+
+		if (!this->b_filter_recv.contains(serialized_v_cls.data() + i, size)) {
+			p_cls =
+				ClauseExchange::create(&serialized_v_cls[i], &serialized_v_cls[i + size], lbd, this->getSharingId());
+			if (this->exportClause(p_cls))
+				gstats.receivedClauses++;
+			this->b_filter_recv.insert(serialized_v_cls.data() + i, size);
+		} else {
+			gstats.receivedDuplicas++;
+		}
+
+		i += size;
+	}
+}
+
+void
+RmaMailboxSharing::shrinkMemory()
+{
+	SharingStrategy::shrinkMemory();
+	this->b_filter_send.clear();
+	this->b_filter_recv.clear();
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "GlobalSharingStrategy.hpp"
+
+/**
+ * @class RmaMailboxSharing
+ * @brief Asynchronous global sharing: the clauses are written with MPI_Put in mailboxes of the other processes.
+ *
+ * @ingroup global_sharing
+ *
+ * Each process exposes a window with one mailbox per other process: a ring buffer of bytes and two counters, the
+ * bytes written by the sender and the bytes read by the owner. At each round, a process encodes its clauses
+ * (mpiutils::encodeClauses) in one batch, reads the counters of its mailboxes in the other processes, and puts the
+ * batch in the ones with enough room, then publishes the new written counters. A full mailbox loses the batch, the
+ * sender never waits for the receiver. Then the process reads the batches written in its own mailboxes since the last
+ * round and publishes its read counters. All the accesses are in one passive epoch (MPI_Win_lock_all) for the whole
+ * run, the counters are updated with atomic operations.
+ *
+ * No collective is called in the rounds: the ending decision of the root is carried by a sequence of MPI_Ibcast on a
+ * duplicate of MPI_COMM_WORLD, each process posts the next one once the previous is completed.
+ */
+class RmaMailboxSharing : public GlobalSharingStrategy
+{
+  public:
+	/**
+	 * @brief Constructor for RmaMailboxSharing.
+	 * @param clauseDB Shared pointer to the clause database.
+	 * @param bufferSize Number of literals of a batch.
+	 * @param mailboxBytes Size in bytes of the ring buffer of each mailbox.
+	 */
+	RmaMailboxSharing(const std::shared_ptr<ClauseDatabase>& clauseDB,
+					  unsigned long bufferSize,
+					  unsigned long mailboxBytes);
+
+	/**
+	 * @brief Destructor, frees the window and the ending communicator.
+	 */
+	~RmaMailboxSharing();
+
+	/**
+	 * @brief Allocates the window of the mailboxes and posts the first ending broadcast.
+	 * @return true if initialization was successful, false otherwise.
+	 */
+	bool initMpiVariables() override;
+
+	/**
+	 * @brief Performs the clause sharing operation: put the batch in the mailboxes of the others, then read the own
+	 * mailboxes.
+	 * @return true if sharing is complete and the process can terminate, false otherwise.
+	 */
+	bool doSharing() override;
+
+	/**
+	 * @brief Handles the process of joining when a solution is found.
+	 * @param winnerRank The rank of the process that found the solution.
+	 * @param res The result of the SAT solving process.
+	 * @param model The satisfying assignment, if any.
+	 */
+	void joinProcess(int winnerRank, SatResult res, const std::vector<int>& model) override;
+
+	/**
+	 * @brief Prints the global statistics and the mailbox ones.
+	 */
+	void printStats() override;
+
+  protected:
+	/**
+	 * @brief Clears the database and the bloom filters.
+	 */
+	void shrinkMemory() override;
+
+	/**
+	 * @brief Tests the pending ending broadcast, and posts the next ones while they are completed.
+	 * @return true if the end was decided.
+	 */
+	bool testEnding();
+
+	/**
+	 * @brief Puts the encoded batch in the mailboxes of the other processes having enough room.
+	 */
+	void putBatch();
+
+	/**
+	 * @brief Reads the batches written in the own mailboxes since the last round.
+	 */
+	void readMailboxes();
+
+	/**
+	 * @brief Copies bytes out of the ring buffer of a mailbox of this process.
+	 * @param sender The rank owning the mailbox.
+	 * @param offset Offset in the stream of bytes written by the sender.
+	 * @param dest Destination.
+	 * @param count Number of bytes.
+	 */
+	void readRing(int sender, uint64_t offset, uint8_t* dest, size_t count);
+
+	/**
+	 * @brief Serializes clauses for sharing.
+	 * @param serialized_v_cls Vector to store the serialized clauses.
+	 * @details Serialization Pattern ([size][lbd][literals])*
+	 * @return The number of clauses serialized.
+	 */
+	int serializeClauses(std::vector<int>& serialized_v_cls);
+
+	/**
+	 * @brief Deserializes received clauses and exports them to the clients.
+	 * @param serialized_v_cls Vector containing the serialized clauses.
+	 */
+	void deserializeClauses(const std::vector<int>& serialized_v_cls);
+
+	/// Displacement in bytes of the mailbox of sender in a window
+	MPI_Aint mailbox(int sender) const { return sender * (2 * sizeof(uint64_t) + ringBytes); }
+
+	unsigned int totalSize; ///< Number of integers of a batch (sizes, lbds and literals), capped to a mailbox
+
+	unsigned long ringBytes; ///< Size of the ring buffer of each mailbox, a multiple of 8
+
+	MPI_Win m_window = MPI_WIN_NULL; ///< Mailboxes of this process
+	uint8_t* m_base = nullptr;		 ///< Local memory of the window
+
+	MPI_Comm m_endComm = MPI_COMM_NULL; ///< Duplicate of MPI_COMM_WORLD for the ending broadcasts
+	MPI_Request m_endRequest = MPI_REQUEST_NULL;
+	int m_endBuffer = 0;
+
+	std::vector<uint64_t> m_written;	///< Bytes written in my mailbox of each process
+	std::vector<uint64_t> m_remoteRead; ///< Bytes read by each process in my mailbox, fetched at each round
+	std::vector<uint64_t> m_read;		///< Bytes read in the mailbox of each process in my window
+	std::vector<uint64_t> m_available;	///< Bytes written in the mailbox of each process in my window
+
+	std::vector<int> clausesToSendSerialized; ///< Buffer for serialized clauses to send
+	std::vector<int> receivedClauses;		  ///< Buffer for received serialized clauses
+	std::vector<uint8_t> encodedToSend;		  ///< Batch of this round, a length then the encoded clauses
+	std::vector<uint8_t> receivedEncoded;	  ///< Buffer for a received batch
+
+	// Stats
+	//------
+	unsigned long batchesPut = 0;
+	unsigned long batchesDropped = 0; ///< Batches not put, the mailbox of the receiver was full
+	unsigned long batchesRead = 0;
+
+	BloomFilter b_filter_send; ///< Bloom filter for avoiding duplicate clause sends
+
+	BloomFilter b_filter_recv; ///< Bloom filter for avoiding duplicate clause receives
+};
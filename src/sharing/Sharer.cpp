@@ -39,6 +39,7 @@ mainThrSharing(void* arg)
 		// Sharing phase
 		sharingTime = SystemResourceMonitor::getAbsoluteTimeSeconds();
 		can_break = shr->sharingStrategies[lastStrategy]->doSharing();
+		shr->sharingStrategies[lastStrategy]->handleShrinkRequest();
 		sharingTime = SystemResourceMonitor::getAbsoluteTimeSeconds() - sharingTime;
 
 		sleepTime = shr->sharingStrategies[lastStrategy]->getSleepingTime();
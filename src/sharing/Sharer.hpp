@@ -62,6 +62,12 @@ class Sharer
      */
     inline void setThreadAffinity(int coreId) { this->sharer->setThreadAffinity(coreId); }
 
+    /**
+     * @brief Set the thread affinity for this sharer to a set of cores (e.g. a NUMA node).
+     * @param coreIds The IDs of the cores.
+     */
+    inline void setThreadAffinity(const std::vector<int>& coreIds) { this->sharer->setThreadAffinity(coreIds); }
+
     /**
      * @brief Get the ID of this sharer.
      * @return The sharer's ID.
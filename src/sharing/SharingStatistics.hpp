@@ -29,4 +29,13 @@ struct GlobalSharingStatistics : public SharingStatistics
 
 	/// @brief Number of sent messages
 	unsigned long messagesSent{0};
+
+	/// @brief Literals encoded for the wire
+	unsigned long encodedLiterals{0};
+
+	/// @brief Bytes of the encoded buffers
+	unsigned long encodedBytes{0};
+
+	/// @brief Bytes of the same buffers as integers
+	unsigned long rawBytes{0};
 };
\ No newline at end of file
@@ -78,6 +78,20 @@ class SharingStrategy : public SharingEntity
 				stats.filteredAtImport.load());
 	}
 
+	/**
+	 * @brief Ask the strategy to release memory, the request is handled by its sharer between two rounds.
+	 */
+	void requestShrink() { m_shrinkRequested = true; }
+
+	/**
+	 * @brief Release memory if it was requested. Called by the sharer thread, thus not concurrent with doSharing.
+	 */
+	void handleShrinkRequest()
+	{
+		if (m_shrinkRequested.exchange(false))
+			shrinkMemory();
+	}
+
 	/**
 	 * @brief Add this to the producers' clients list
 	 * @warning Be Careful! connect only constructor lists, (otherwise this strategy can be added twice)
@@ -130,6 +144,16 @@ class SharingStrategy : public SharingEntity
 	}
 
   protected:
+	/**
+	 * @brief Release the memory held by the strategy, by default the clauses waiting in the database are dropped.
+	 */
+	virtual void shrinkMemory()
+	{
+		m_clauseDB->shrinkDatabase();
+		m_clauseDB->clearDatabase();
+		LOG1("[SharingStrategy %d] Database cleared on memory pressure", getSharingId());
+	}
+
 	/**
 	 * @brief A SharingStrategy doesn't send a clause to the source client (->from must store the sharingId of its producer)
 	 */
@@ -149,6 +173,9 @@ class SharingStrategy : public SharingEntity
 	/// Sharing statistics.
 	SharingStatistics stats;
 
+	/// Set by requestShrink, reset when handled
+	std::atomic<bool> m_shrinkRequested{ false };
+
 	/* Producers Management */
 
 	/// The set holding the references to the producers
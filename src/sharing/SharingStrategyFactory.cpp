@@ -5,13 +5,19 @@
 
 #include "sharing/GlobalStrategies/AllGatherSharing.hpp"
 #include "sharing/GlobalStrategies/GenericGlobalSharing.hpp"
+#include "sharing/GlobalStrategies/HierarchicalSharing.hpp"
 #include "sharing/GlobalStrategies/MallobSharing.hpp"
+#include "sharing/GlobalStrategies/RmaMailboxSharing.hpp"
 
 #include "SharingStrategyFactory.hpp"
 #include "containers/ClauseDatabases/ClauseDatabaseFactory.hpp"
+#include "utils/Placement.hpp"
+
+#include <map>
 
 int SharingStrategyFactory::selectedLocal = 0;
 int SharingStrategyFactory::selectedGlobal = 0;
+std::vector<int> SharingStrategyFactory::localStrategyNodes;
 
 void
 SharingStrategyFactory::instantiateLocalStrategies(int strategyNumber,
@@ -45,6 +51,8 @@ SharingStrategyFactory::instantiateLocalStrategies(int strategyNumber,
 
 	switch (strategyNumber) {
 		case 1:
+			if (__globalParameters__.numaSharingGroups && instantiateNumaStrategies(localStrategies, allEntities))
+				break;
 			LOG0("LSTRAT>> HordeSatSharing(1Grp)");
 			localStrategies.emplace_back(new HordeSatSharing(lsharedDB,
 															 __globalParameters__.sharedLiteralsPerProducer,
@@ -98,16 +106,46 @@ SharingStrategyFactory::instantiateLocalStrategies(int strategyNumber,
 	SharingStrategyFactory::selectedLocal = strategyNumber;
 }
 
+bool
+SharingStrategyFactory::instantiateNumaStrategies(std::vector<std::shared_ptr<SharingStrategy>>& localStrategies,
+												  const std::vector<std::shared_ptr<SharingEntity>>& allEntities)
+{
+	if (!ThreadPlacement::isEnabled() || ThreadPlacement::getNodeCount() < 2) {
+		LOGWARN("NUMA sharing groups need a pinning policy (-pin) on several nodes, a single group is used");
+		return false;
+	}
+
+	std::map<int, std::vector<std::shared_ptr<SharingEntity>>> producersPerNode;
+	for (unsigned i = 0; i < allEntities.size(); i++)
+		producersPerNode[ThreadPlacement::getNode(ThreadPlacement::getCore(i))].push_back(allEntities[i]);
+
+	if (producersPerNode.size() < 2) {
+		LOGWARN("All the solvers are on the same NUMA node, a single group is used");
+		return false;
+	}
+
+	LOG0("LSTRAT>> HordeSatSharing (%zu Grp of producers, one per NUMA node)", producersPerNode.size());
+
+	localStrategyNodes.clear();
+	for (auto& [node, producers] : producersPerNode) {
+		localStrategies.emplace_back(
+			new HordeSatSharing(ClauseDatabaseFactory::createDatabase(__globalParameters__.localSharingDB.at(0)),
+								__globalParameters__.sharedLiteralsPerProducer,
+								__globalParameters__.hordeInitialLbdLimit,
+								__globalParameters__.hordeInitRound,
+								producers,
+								allEntities));
+		localStrategyNodes.push_back(node);
+		LOG0("LSTRAT>> Group of node %d has %zu producers", node, producers.size());
+	}
+	return true;
+}
+
 void
 SharingStrategyFactory::instantiateGlobalStrategies(
 	int strategyNumber,
 	std::vector<std::shared_ptr<GlobalSharingStrategy>>& globalStrategies)
 {
-	int right_neighbor = (mpi_rank - 1 + mpi_world_size) % mpi_world_size;
-	int left_neighbor = (mpi_rank + 1) % mpi_world_size;
-	std::vector<int> subscriptions;
-	std::vector<int> subscribers;
-
 	ClauseDatabaseFactory::initialize(
 		__globalParameters__.maxClauseSize, __globalParameters__.globalSharedLiterals * 10, 2, 1);
 
@@ -133,18 +171,35 @@ SharingStrategyFactory::instantiateGlobalStrategies(
 															__globalParameters__.mallobMaxCompensation,
 															__globalParameters__.mallobResharePeriod));
 			break;
-		case 3:
-			LOG0("GSTRAT>> GenericGlobalSharing As RingSharing");
-			subscriptions.push_back(right_neighbor);
-			subscriptions.push_back(left_neighbor);
-			subscribers.push_back(right_neighbor);
-			subscribers.push_back(left_neighbor);
+		case 3: {
+			static const char* topologies[] = { "Ring", "Hypercube", "Tree", "Torus", "Gossip" };
+			int topology = __globalParameters__.globalTopology;
+			if (topology < 0 || topology > static_cast<int>(GlobalTopology::GOSSIP)) {
+				LOGWARN("The topology %d isn't defined, a ring is used", topology);
+				topology = static_cast<int>(GlobalTopology::RING);
+			}
+			LOG0("GSTRAT>> GenericGlobalSharing As %sSharing (degree %u)",
+				 topologies[topology],
+				 __globalParameters__.globalTopologyDegree);
 
 			globalStrategies.emplace_back(new GenericGlobalSharing(gsharedDB,
-																   subscriptions,
-																   subscribers,
+																   static_cast<GlobalTopology>(topology),
+																   __globalParameters__.globalTopologyDegree,
 																   __globalParameters__.globalSharedLiterals));
 			break;
+		}
+		case 4:
+			LOG0("GSTRAT>> HierarchicalSharing");
+			globalStrategies.emplace_back(new HierarchicalSharing(gsharedDB,
+																  __globalParameters__.globalSharedLiterals));
+			break;
+		case 5:
+			LOG0("GSTRAT>> RmaMailboxSharing");
+			// A literal is encoded in about 2 bytes, a mailbox holds about 8 batches
+			globalStrategies.emplace_back(new RmaMailboxSharing(gsharedDB,
+																__globalParameters__.globalSharedLiterals,
+																16UL * __globalParameters__.globalSharedLiterals));
+			break;
 		default:
 			LOGERROR("Global Strategy %d is not defined", strategyNumber);
 			std::abort();
@@ -174,6 +229,12 @@ SharingStrategyFactory::launchSharers(std::vector<std::shared_ptr<SharingStrateg
 		for (unsigned int i = 0; i < sharingStrategies.size(); i++) {
 			sharers.emplace_back(new Sharer(i, sharingStrategies[i]));
 		}
+
+		// The local strategies are first, each sharer works on the node of its group of producers
+		for (unsigned int i = 0; i < localStrategyNodes.size() && i < sharers.size(); i++) {
+			sharers[i]->setThreadAffinity(ThreadPlacement::getNodeCores(localStrategyNodes[i]));
+			LOG0("Placement: sharer %u pinned on NUMA node %d", i, localStrategyNodes[i]);
+		}
 	}
 }
 
@@ -187,6 +248,9 @@ SharingStrategyFactory::addEntitiesToLocal(std::vector<std::shared_ptr<SharingSt
 		case 5:
 			LOG0("UPDATE>> 1Grp");
 			for (auto newSolver : newSolvers) {
+				/* With NUMA groups, every group shares to all the solvers */
+				for (unsigned int i = 1; i < localStrategyNodes.size(); i++)
+					localStrategies[i]->addClient(newSolver);
 				localStrategies[0]->addClient(newSolver);
 				localStrategies[0]->addProducer(newSolver);
 				localStrategies[0]->connectProducer(newSolver);
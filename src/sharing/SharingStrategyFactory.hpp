@@ -39,6 +39,9 @@ struct SharingStrategyFactory
     /// The selected global sharing strategy number (0-3).
     static int selectedGlobal;
 
+    /// NUMA node of each local strategy when the producers are grouped per node (-numa-shr-groups).
+    static std::vector<int> localStrategyNodes;
+
     /**
      * @brief Instantiate local sharing strategies.
      * @param strategyNumber The number of the strategy to instantiate:
@@ -65,6 +68,16 @@ struct SharingStrategyFactory
     static void instantiateGlobalStrategies(int strategyNumber,
                                             std::vector<std::shared_ptr<GlobalSharingStrategy>>& globalStrategies);
 
+    /**
+     * @brief Instantiate one HordeSatSharing per NUMA node, the producers are the solvers placed on the node and the
+     * consumers are all the solvers.
+     * @param localStrategies Vector to store the created local strategies.
+     * @param allEntities The solvers, in the order of their placement index.
+     * @return False if the solvers are on a single node.
+     */
+    static bool instantiateNumaStrategies(std::vector<std::shared_ptr<SharingStrategy>>& localStrategies,
+                                          const std::vector<std::shared_ptr<SharingEntity>>& allEntities);
+
     /**
      * @brief Launch sharer threads for the given sharing strategies.
      * @param sharingStrategies Vector of sharing strategies to be executed.
@@ -397,6 +397,20 @@ Cadical::bumpVariableActivity(const int var, const int times)
 
 /* Statistics And More */
 #include "cadical/src/stats.hpp"
+SolvingCdclStatistics
+Cadical::getStatistics()
+{
+	SolvingCdclStatistics stats = SolverCdclInterface::getStatistics();
+	CaDiCaL::Stats* cstats = solver->getStatistics();
+
+	stats.conflicts = cstats->conflicts;
+	stats.propagations = cstats->propagations.search;
+	stats.restarts = cstats->restarts;
+	stats.decisions = cstats->decisions;
+
+	return stats;
+}
+
 void
 Cadical::printStatistics()
 {
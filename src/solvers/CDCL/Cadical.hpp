@@ -94,6 +94,9 @@ class Cadical
 
 	/* Statistics And More */
 
+	/// Get a snapshot of the solver counters.
+	SolvingCdclStatistics getStatistics() override;
+
 	/// Get solver statistics.
 	void printStatistics() override;
 
@@ -445,12 +445,16 @@ GlucoseSyrup::addInitialClauses(const lit_t* literals, unsigned int clsCount, un
 {
 	unsigned int clausesCount = 0;
 	int lit;
-	for (unsigned int i = 0; clausesCount < clsCount; i++) {
-		Glucose::vec<Glucose::Lit> mcls;
 
-		while (solver->nVars() < nbVars) {
-			solver->newVar();
-		}
+	while (solver->nVars() < nbVars) {
+		solver->newVar();
+	}
+
+	// Reused for all the clauses, addClause copies it
+	Glucose::vec<Glucose::Lit> mcls;
+
+	for (unsigned int i = 0; clausesCount < clsCount; i++) {
+		mcls.clear();
 
 		for (lit = *literals; lit; literals++, lit = *literals) {
 			if(!lit) break;
@@ -473,15 +477,24 @@ GlucoseSyrup::addInitialClauses(const lit_t* literals, unsigned int clsCount, un
 		"The Glucose Solver %d loaded all the %u clauses with %u variables", this->getSolverId(), clausesCount, nbVars);
 }
 
-void
-GlucoseSyrup::printStatistics()
+SolvingCdclStatistics
+GlucoseSyrup::getStatistics()
 {
-	SolvingCdclStatistics stats;
+	SolvingCdclStatistics stats = SolverCdclInterface::getStatistics();
 
 	stats.conflicts = solver->conflicts;
 	stats.propagations = solver->propagations;
 	stats.restarts = solver->starts;
 	stats.decisions = solver->decisions;
+
+	return stats;
+}
+
+void
+GlucoseSyrup::printStatistics()
+{
+	SolvingCdclStatistics stats = getStatistics();
+
 	std::cout << std::left << std::setw(15) << ("| G" + std::to_string(this->getSolverTypeId())) << std::setw(20)
 			  << ("| " + std::to_string(stats.conflicts)) << std::setw(20)
 			  << ("| " + std::to_string(stats.propagations)) << std::setw(17) << ("| " + std::to_string(stats.restarts))
@@ -34,6 +34,8 @@ kissatImportClause(void* painless_interface, kissat* internal_solver)
 
 	if (!painless_kissat->m_clausesToImport->getOneClause(clause)) {
 		painless_kissat->m_clausesToImport->shrinkDatabase();
+		// Last call of the import loop at the root level, where the phases can be changed
+		painless_kissat->exchangePhases();
 		return false;
 	}
 
@@ -137,6 +139,29 @@ Kissat::setPhase(const unsigned int var, const bool phase)
 	kissat_set_phase(this->solver, var, (phase) ? 1 : -1);
 }
 
+void
+Kissat::exchangePhases()
+{
+	if (!this->m_publishedPhases)
+		return;
+
+	unsigned int quality;
+	if (this->readProposedPhases(quality)) {
+		// The best phases are used by the next best rephasing, the target phases by the stable mode
+		for (unsigned int var = 1; var < this->m_phaseBuffer.size(); var++)
+			kissat_set_phase(this->solver, var, this->m_phaseBuffer[var] ? 1 : -1);
+		LOGDEBUG1("Kissat %d adopted phases with %u unsatisfied clauses", this->getSolverId(), quality);
+	}
+
+	// The best trail only changes in stable mode, and is reset by the rephasing
+	unsigned int bestAssigned = kissat_get_best_assigned(this->solver);
+	if (bestAssigned && bestAssigned != this->publishedBestAssigned && this->isPhasePublicationDue()) {
+		this->m_publishedPhases->publish(
+			[this](unsigned int var) { return kissat_get_best_phase(this->solver, var) > 0; }, bestAssigned);
+		this->publishedBestAssigned = bestAssigned;
+	}
+}
+
 // Bump activity for a given variable
 void
 Kissat::bumpVariableActivity(const int var, const int times)
@@ -270,6 +295,23 @@ Kissat::importClauses(const std::vector<ClauseExchangePtr>& clauses)
 	}
 }
 
+SolvingCdclStatistics
+Kissat::getStatistics()
+{
+	SolvingCdclStatistics stats = SolverCdclInterface::getStatistics();
+	KissatMainStatistics kstats;
+
+	/* Despite their names, the fields are the raw counters (see kissat_get_main_statistics) */
+	kissat_get_main_statistics(this->solver, &kstats);
+
+	stats.conflicts = kstats.conflictsPerSec;
+	stats.propagations = kstats.propagationsPerSec;
+	stats.restarts = kstats.restarts;
+	stats.decisions = kstats.decisionsPerConf;
+
+	return stats;
+}
+
 void
 Kissat::printStatistics()
 {
@@ -492,6 +534,12 @@ Kissat::diversify(const SeedGenerator& getSeed)
 	kissatOptions.at("preprocessprobe") = typeId % (1 << 2);
 	kissatOptions.at("preprocessweep") = typeId % (1);
 
+	// The probing service finds the failed literals and the backbone once for all the solvers
+	if (__globalParameters__.probe) {
+		kissatOptions.at("preprocessprobe") = 0;
+		kissatOptions.at("preprocessbackbone") = 0;
+	}
+
 	// kissatOptions.at("preprocessrounds") = (typeId % 3) + 1;
 
 	switch (this->family) {
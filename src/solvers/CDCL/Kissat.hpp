@@ -87,6 +87,9 @@ class Kissat : public SolverCdclInterface
 
 	/* Statistics And More */
 
+	/// Get a snapshot of the solver counters.
+	SolvingCdclStatistics getStatistics() override;
+
 	/// Get solver statistics.
 	void printStatistics() override;
 
@@ -109,6 +112,9 @@ class Kissat : public SolverCdclInterface
   protected:
 	/// Compute kissat family for diversification
 	void computeFamily();
+
+	/// Called at the root level: adopt the proposed phases and publish the best phases if the best trail changed
+	void exchangePhases();
 	
   protected:
 	/// Pointer to a Kissat solver.
@@ -124,6 +130,9 @@ class Kissat : public SolverCdclInterface
 
 	unsigned int originalVars;
 
+	/// Height of the best trail at the last publication to the phase exchange
+	unsigned int publishedBestAssigned = 0;
+
 	/// Termination callback.
 	friend int kissatTerminate(void* solverPtr);
 
@@ -370,10 +370,10 @@ Lingeling::printWinningLog()
 	LOGSTAT("The winner is Lingeling(%d, %u) ", this->getSolverId(), this->getSolverTypeId());
 }
 
-void
-Lingeling::printStatistics()
+SolvingCdclStatistics
+Lingeling::getStatistics()
 {
-	SolvingCdclStatistics stats;
+	SolvingCdclStatistics stats = SolverCdclInterface::getStatistics();
 
 	stats.conflicts = lglgetconfs(solver);
 	stats.decisions = lglgetdecs(solver);
@@ -381,6 +381,14 @@ Lingeling::printStatistics()
 	stats.memPeak = lglmaxmb(solver);
 	stats.restarts = lglgetrestarts(solver);
 
+	return stats;
+}
+
+void
+Lingeling::printStatistics()
+{
+	SolvingCdclStatistics stats = getStatistics();
+
 	std::cout << std::left << std::setw(15) << ("| L" + std::to_string(this->getSolverTypeId())) << std::setw(20)
 			  << ("| " + std::to_string(stats.conflicts)) << std::setw(20)
 			  << ("| " + std::to_string(stats.propagations)) << std::setw(17) << ("| " + std::to_string(stats.restarts))
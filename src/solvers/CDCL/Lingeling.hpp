@@ -58,6 +58,9 @@ class Lingeling : public SolverCdclInterface
 	/// Add a list of learned clauses to the formula.
 	void importClauses(const std::vector<ClauseExchangePtr>& clauses);
 
+	/// Get a snapshot of the solver counters.
+	SolvingCdclStatistics getStatistics() override;
+
 	/// Print solver statistics.
 	void printStatistics();
 
@@ -340,16 +340,16 @@ MapleCOMSPSSolver::addInitialClauses(const lit_t* literals, unsigned int clsCoun
 		solver->newVar();
 	}
 
-	for (unsigned int i = 0; clausesCount < clsCount; i++) {
+	// Reused for all the clauses, addClause copies it
+	MapleCOMSPS::vec<MapleCOMSPS::Lit> mcls;
 
-		MapleCOMSPS::vec<MapleCOMSPS::Lit> mcls;
-		std::vector<lit_t> clause;
+	for (unsigned int i = 0; clausesCount < clsCount; i++) {
+		mcls.clear();
 
 		for (lit = *literals; lit; literals++, lit = *literals) {
 			if (!lit)
 				break;
 			mcls.push(MINI_LIT(lit));
-			clause.push_back(lit);
 		}
 
 		// Jump zero
@@ -375,16 +375,24 @@ MapleCOMSPSSolver::importClauses(const std::vector<ClauseExchangePtr>& clauses)
 	}
 }
 
-void
-MapleCOMSPSSolver::printStatistics()
+SolvingCdclStatistics
+MapleCOMSPSSolver::getStatistics()
 {
-	SolvingCdclStatistics stats;
+	SolvingCdclStatistics stats = SolverCdclInterface::getStatistics();
 
 	stats.conflicts = solver->conflicts;
 	stats.propagations = solver->propagations;
 	stats.restarts = solver->starts;
 	stats.decisions = solver->decisions;
 
+	return stats;
+}
+
+void
+MapleCOMSPSSolver::printStatistics()
+{
+	SolvingCdclStatistics stats = getStatistics();
+
 	std::cout << std::left << std::setw(15) << ("| MC" + std::to_string(this->getSolverTypeId())) << std::setw(20)
 			  << ("| " + std::to_string(stats.conflicts)) << std::setw(20)
 			  << ("| " + std::to_string(stats.propagations)) << std::setw(17) << ("| " + std::to_string(stats.restarts))
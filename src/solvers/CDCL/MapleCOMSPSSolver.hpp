@@ -79,6 +79,9 @@ class MapleCOMSPSSolver : public SolverCdclInterface
 	/// Add a list of learned clauses to the formula.
 	void importClauses(const std::vector<ClauseExchangePtr>& clauses);
 
+	/// Get a snapshot of the solver counters.
+	SolvingCdclStatistics getStatistics() override;
+
 	/// Get solver statistics.
 	void printStatistics();
 
@@ -287,9 +287,11 @@ MiniSat::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigne
 		solver->newVar();
 	}
 
-	for (unsigned int i = 0; clausesCount < clsCount; i++) {
+	// Reused for all the clauses, addClause copies it
+	Minisat::vec<Minisat::Lit> mcls;
 
-		Minisat::vec<Minisat::Lit> mcls;
+	for (unsigned int i = 0; clausesCount < clsCount; i++) {
+		mcls.clear();
 
 		for (lit = *literals; lit; literals++, lit = *literals) {
 			if (!lit)
@@ -321,16 +323,24 @@ MiniSat::importClauses(const std::vector<ClauseExchangePtr>& clauses)
 	}
 }
 
-void
-MiniSat::printStatistics()
+SolvingCdclStatistics
+MiniSat::getStatistics()
 {
-	SolvingCdclStatistics stats;
+	SolvingCdclStatistics stats = SolverCdclInterface::getStatistics();
 
 	stats.conflicts = solver->conflicts;
 	stats.propagations = solver->propagations;
 	stats.restarts = solver->starts;
 	stats.decisions = solver->decisions;
 
+	return stats;
+}
+
+void
+MiniSat::printStatistics()
+{
+	SolvingCdclStatistics stats = getStatistics();
+
 	std::cout << std::left << std::setw(15) << ("| M" + std::to_string(this->getSolverTypeId())) << std::setw(20)
 			  << ("| " + std::to_string(stats.conflicts)) << std::setw(20)
 			  << ("| " + std::to_string(stats.propagations)) << std::setw(17) << ("| " + std::to_string(stats.restarts))
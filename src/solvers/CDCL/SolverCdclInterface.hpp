@@ -36,6 +36,7 @@ struct SolvingCdclStatistics
 		decisions = 0;
 		conflicts = 0;
 		restarts = 0;
+		exports = 0;
 		memPeak = 0;
 	}
 
@@ -43,6 +44,7 @@ struct SolvingCdclStatistics
 	unsigned long decisions;	///< Number of decisions taken.
 	unsigned long conflicts;	///< Number of reached conflicts.
 	unsigned long restarts;		///< Number of restarts.
+	unsigned long exports;		///< Number of learnt clauses accepted by the clients.
 	double memPeak;				///< Maximum memory used in Ko.
 };
 
@@ -83,6 +85,23 @@ class SolverCdclInterface
 	 */
 	virtual std::vector<int> getSatAssumptions() = 0;
 
+	/**
+	 * @brief Get a snapshot of the solver counters, can be called concurrently to solve.
+	 * @return The statistics, counters not provided by the underlying solver are left to 0.
+	 */
+	virtual SolvingCdclStatistics getStatistics()
+	{
+		SolvingCdclStatistics stats;
+		stats.exports = m_exportedClauses.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	/**
+	 * @brief Replace the import database, used to allocate it from the thread (and NUMA node) of the solver.
+	 * @warning Must be called before the solver is launched and before any sharing round.
+	 */
+	void setImportDatabase(const std::shared_ptr<ClauseDatabase>& clauseDB) { m_clausesToImport = clauseDB; }
+
 	/**
 	 * @brief Print winning log information
 	 */
@@ -115,8 +134,23 @@ class SolverCdclInterface
 	SolverCdclType m_cdclType;
 
   protected:
+	/**
+	 * @brief Counts the exported clauses accepted by a client, used by getStatistics
+	 */
+	bool exportClauseToClient(const ClauseExchangePtr& clause, std::shared_ptr<SharingEntity> client) override
+	{
+		if (client->importClause(clause)) {
+			m_exportedClauses.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
 	/// @brief Database used to import clauses. Can be common with other solvers
 	std::shared_ptr<ClauseDatabase> m_clausesToImport;
+
+	/// @brief Number of exported clauses accepted by the clients
+	std::atomic<unsigned long> m_exportedClauses{ 0 };
 };
 
 /**
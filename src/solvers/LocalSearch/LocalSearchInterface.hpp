@@ -1,7 +1,12 @@
 #pragma once
 
+#include "sharing/SharingEntity.hpp"
 #include "solvers/SolverInterface.hpp"
 
+#include <climits>
+#include <mutex>
+#include <utility>
+
 /**
  * @defgroup localsearch_solving  Local Search Solvers
  * @ingroup solving
@@ -14,6 +19,7 @@ enum LocalSearchType
 {
 	YALSAT = 0,
 	TASSAT = 1,
+	PROBSAT = 2,
 };
 
 /// Local search statistics
@@ -21,6 +27,7 @@ struct LocalSearchStats
 {
 	unsigned int numberUnsatClauses;
 	unsigned int numberFlips;
+	double flipsPerSecond;
 	/*TODO add all needed stats */
 };
 
@@ -28,8 +35,13 @@ struct LocalSearchStats
  * @brief Interface for Local Search solvers
  *
  * This class specializes SolverInterface to provide a common interface for all Local Search solvers.
+ * It is also a SharingEntity consuming the learned units and binaries only: they are buffered by the sharing threads
+ * and fetched by the solver at its next check (fetchImportedClauses), where it freezes the fixed variables and adds
+ * the binaries it supports. A local search never exports clauses.
  */
-class LocalSearchInterface : public SolverInterface
+class LocalSearchInterface
+	: public SolverInterface
+	, public SharingEntity
 {
   public:
 	/**
@@ -39,6 +51,7 @@ class LocalSearchInterface : public SolverInterface
 	 */
 	LocalSearchInterface(int solverId, LocalSearchType _lsType)
 		: SolverInterface(SolverAlgorithmType::LOCAL_SEARCH, solverId)
+		, SharingEntity()
 		, lsType(_lsType)
 	{
 	}
@@ -72,7 +85,57 @@ class LocalSearchInterface : public SolverInterface
 	 */
 	unsigned int getNbUnsat() { return this->lsStats.numberUnsatClauses; }
 
+	/**
+	 * @brief Buffer a learned unit, or binary if the solver supports them, the larger clauses are refused.
+	 * @return true if the clause was buffered.
+	 */
+	bool importClause(const ClauseExchangePtr& clause) override
+	{
+		if (!clause->size || clause->size > this->m_importMaxSize)
+			return false;
+
+		std::lock_guard<std::mutex> lock(this->m_importMutex);
+		if (clause->size == 1)
+			this->m_importUnits.push_back(clause->lits[0]);
+		else
+			this->m_importBinaries.emplace_back(clause->lits[0], clause->lits[1]);
+		this->m_hasImports.store(true, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Buffer the learned units and binaries of a vector of clauses.
+	 */
+	void importClauses(const std::vector<ClauseExchangePtr>& clauses) override
+	{
+		for (const ClauseExchangePtr& clause : clauses)
+			this->importClause(clause);
+	}
+
   protected:
+	/**
+	 * @brief Take the clauses imported since the last call, called by the solver between two flips.
+	 * @param units Replaced by the imported units.
+	 * @param binaries Replaced by the imported binaries.
+	 * @return false if nothing was imported (the vectors are then left untouched).
+	 */
+	bool fetchImportedClauses(std::vector<lit_t>& units, std::vector<std::pair<lit_t, lit_t>>& binaries)
+	{
+		if (!this->m_hasImports.load(std::memory_order_acquire))
+			return false;
+
+		units.clear();
+		binaries.clear();
+		std::lock_guard<std::mutex> lock(this->m_importMutex);
+		units.swap(this->m_importUnits);
+		binaries.swap(this->m_importBinaries);
+		this->m_hasImports.store(false, std::memory_order_relaxed);
+		return true;
+	}
+
+	/// @brief Largest size of the imported clauses, the solvers that cannot add binaries set it to 1
+	unsigned int m_importMaxSize = 2;
+
 	/// @brief Type of the local search
 	LocalSearchType lsType;
 
@@ -81,6 +144,16 @@ class LocalSearchInterface : public SolverInterface
 
 	/// @brief Vector holding the model or the final trail
 	std::vector<int> finalTrail;
+
+	/// @brief Unsatisfied clauses of the last assignment published to the phase exchange
+	unsigned int publishedUnsat = UINT_MAX;
+
+  private:
+	/// @brief Clauses imported by the sharing threads and not fetched yet
+	std::mutex m_importMutex;
+	std::vector<lit_t> m_importUnits;
+	std::vector<std::pair<lit_t, lit_t>> m_importBinaries;
+	std::atomic<bool> m_hasImports{ false };
 };
 
 /**
@@ -0,0 +1,718 @@
+#include "ProbSat.hpp"
+#include "containers/FormulaArena.hpp"
+#include "utils/ErrorCodes.hpp"
+#include "utils/Logger.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/Parsers.hpp"
+#include "utils/System.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PROBSAT_AVX2
+#endif
+
+/// Width of the candidates vectors, the literals are padded accordingly
+static const unsigned int CANDIDATES_PADDING = 8;
+
+/// Entries of the break value probability table
+static const unsigned int PROBABILITIES_SIZE = 64;
+
+/// Flips between two checks of the termination, the restarts and the phase exchange
+static const unsigned long CHECK_INTERVAL = 1024;
+
+/// Clause stores shared by the walkers, one per formula arena
+static std::mutex sharedClausesMutex;
+static std::map<std::weak_ptr<const FormulaArena>, std::weak_ptr<const ProbSatClauses>, std::owner_less<>>
+	sharedClauses;
+
+/* Candidates evaluation */
+/* --------------------- */
+
+static void
+evaluateCandidatesScalar(const lit_t* lits, unsigned int size, const uint32_t* breaks, uint32_t* out)
+{
+	for (unsigned int i = 0; i < size; i++)
+		out[i] = breaks[std::abs(lits[i])];
+}
+
+#ifdef PROBSAT_AVX2
+__attribute__((target("avx2"))) static void
+evaluateCandidatesAvx2(const lit_t* lits, unsigned int size, const uint32_t* breaks, uint32_t* out)
+{
+	for (unsigned int i = 0; i < size; i += CANDIDATES_PADDING) {
+		__m256i vars = _mm256_abs_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lits + i)));
+		__m256i values = _mm256_i32gather_epi32(reinterpret_cast<const int*>(breaks), vars, 4);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), values);
+	}
+}
+#endif
+
+/* Clause store */
+/* ------------ */
+
+static std::shared_ptr<const ProbSatClauses>
+buildClauses(const lit_t* literals, unsigned int clsCount, unsigned int varCount)
+{
+	auto clauses = std::make_shared<ProbSatClauses>();
+
+	size_t literalsCount = 0;
+	const lit_t* end = literals;
+	for (unsigned int count = 0; count < clsCount; end++) {
+		if (*end)
+			varCount = std::max<unsigned int>(varCount, std::abs(*end));
+		else
+			count++;
+	}
+	literalsCount = end - literals - clsCount;
+	if (literalsCount + CANDIDATES_PADDING >= UINT32_MAX) {
+		LOGERROR("The number of literals %zu is too high for ProbSat!", literalsCount);
+		exit(PERR_NOT_SUPPORTED);
+	}
+
+	clauses->varCount = varCount;
+	clauses->clauseStart.reserve(clsCount + 1);
+	clauses->literals.reserve(literalsCount + CANDIDATES_PADDING);
+
+	// Duplicate literals are removed and tautologies dropped, the critical variables rely on it
+	std::vector<signed char> marks(varCount + 1, 0);
+	for (const lit_t* lit = literals; lit < end; lit++) {
+		size_t start = clauses->literals.size();
+		bool tautology = false;
+		for (; *lit; lit++) {
+			signed char sign = *lit > 0 ? 1 : -1;
+			signed char& mark = marks[std::abs(*lit)];
+			if (mark == -sign)
+				tautology = true;
+			else if (!mark) {
+				mark = sign;
+				clauses->literals.push_back(*lit);
+			}
+		}
+		for (size_t i = start; i < clauses->literals.size(); i++)
+			marks[std::abs(clauses->literals[i])] = 0;
+
+		if (tautology) {
+			clauses->literals.resize(start);
+			continue;
+		}
+		if (start == clauses->literals.size())
+			clauses->hasEmptyClause = true;
+		clauses->clauseStart.push_back(start);
+		clauses->maxLength = std::max<unsigned int>(clauses->maxLength, clauses->literals.size() - start);
+	}
+	clauses->clauseCount = clauses->clauseStart.size();
+	clauses->clauseStart.push_back(clauses->literals.size());
+	clauses->literals.resize(clauses->literals.size() + CANDIDATES_PADDING, 0);
+
+	// Occurrence lists
+	clauses->occurrenceStart.assign(2 * (varCount + 1) + 1, 0);
+	for (uint32_t c = 0; c < clauses->clauseCount; c++)
+		for (uint32_t i = clauses->clauseStart[c]; i < clauses->clauseStart[c + 1]; i++)
+			clauses->occurrenceStart[ProbSatClauses::litIndex(clauses->literals[i]) + 1]++;
+	for (size_t i = 1; i < clauses->occurrenceStart.size(); i++)
+		clauses->occurrenceStart[i] += clauses->occurrenceStart[i - 1];
+
+	clauses->occurrences.resize(clauses->occurrenceStart.back());
+	std::vector<uint32_t> fill(clauses->occurrenceStart.begin(), clauses->occurrenceStart.end() - 1);
+	for (uint32_t c = 0; c < clauses->clauseCount; c++)
+		for (uint32_t i = clauses->clauseStart[c]; i < clauses->clauseStart[c + 1]; i++)
+			clauses->occurrences[fill[ProbSatClauses::litIndex(clauses->literals[i])]++] = c;
+
+	return clauses;
+}
+
+/* Solver */
+/* ------ */
+
+ProbSat::ProbSat(int _id, unsigned long flipsLimit, unsigned long maxNoise)
+	: LocalSearchInterface(_id, LocalSearchType::PROBSAT)
+	, terminateSolver(false)
+	, m_flipsLimit(flipsLimit)
+	, m_maxNoise(maxNoise)
+	, m_rng(_id)
+	, m_evaluate(evaluateCandidatesScalar)
+	, m_binaryLiterals(CANDIDATES_PADDING, 0)
+{
+	initializeTypeId<ProbSat>();
+#ifdef PROBSAT_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		m_evaluate = evaluateCandidatesAvx2;
+#endif
+}
+
+ProbSat::~ProbSat()
+{
+	LOGDEBUG1("ProbSat %d deleted!", this->getSolverId());
+}
+
+unsigned int
+ProbSat::getVariablesCount()
+{
+	return this->m_clauses ? this->m_clauses->varCount : 0;
+}
+
+int
+ProbSat::getDivisionVariable()
+{
+	return (rand() % getVariablesCount()) + 1;
+}
+
+void
+ProbSat::setSolverInterrupt()
+{
+	if (!this->terminateSolver) {
+		LOG1("Asked ProbSat %d to terminate", this->getSolverId());
+		this->terminateSolver = true;
+	}
+}
+
+void
+ProbSat::unsetSolverInterrupt()
+{
+	this->terminateSolver = false;
+}
+
+void
+ProbSat::setPhase(const unsigned int var, const bool phase)
+{
+	if (var >= this->m_initialPhases.size())
+		this->m_initialPhases.resize(var + 1, -1);
+	this->m_initialPhases[var] = phase;
+}
+
+void
+ProbSat::addClause(ClauseExchangePtr clause)
+{
+	LOGWARN("ProbSat %d does not support adding clauses after loading the formula", this->getSolverId());
+}
+
+void
+ProbSat::addClauses(const std::vector<ClauseExchangePtr>& clauses)
+{
+	for (auto clause : clauses) {
+		addClause(clause);
+	}
+}
+
+void
+ProbSat::addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int nbVars)
+{
+	std::vector<lit_t> literals;
+	for (const simpleClause& clause : clauses) {
+		literals.insert(literals.end(), clause.begin(), clause.end());
+		literals.push_back(0);
+	}
+	this->m_clauses = buildClauses(literals.data(), clauses.size(), nbVars);
+
+	this->setInitialized(true);
+
+	LOG2("ProbSat %d loaded all the %zu clauses with %u variables", this->getSolverId(), clauses.size(), nbVars);
+}
+
+void
+ProbSat::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars)
+{
+	this->m_clauses = buildClauses(literals, clsCount, nbVars);
+
+	this->setInitialized(true);
+
+	LOG2("ProbSat %d loaded all the %u clauses with %u variables", this->getSolverId(), clsCount, nbVars);
+}
+
+void
+ProbSat::addInitialFormula(const std::shared_ptr<const FormulaArena>& formula)
+{
+	const unsigned int clsCount = formula->getClausesCount();
+	const unsigned int nbVars = formula->getVariablesCount();
+
+	/* The first walker loading the formula builds the clause store, the next ones search on it */
+	{
+		std::lock_guard<std::mutex> lock(sharedClausesMutex);
+		std::erase_if(sharedClauses, [](const auto& entry) { return entry.first.expired(); });
+		std::weak_ptr<const ProbSatClauses>& shared = sharedClauses[formula];
+		this->m_clauses = shared.lock();
+		if (!this->m_clauses) {
+			this->m_clauses = buildClauses(formula->data(), clsCount, nbVars);
+			shared = this->m_clauses;
+			LOG2("ProbSat %d loaded all the %u clauses with %u variables", this->getSolverId(), clsCount, nbVars);
+		} else
+			LOG2("ProbSat %d shares the %u clauses with %u variables", this->getSolverId(), clsCount, nbVars);
+	}
+
+	this->setInitialized(true);
+}
+
+void
+ProbSat::loadFormula(const char* filename)
+{
+	unsigned int parsedVarCount;
+	std::vector<std::vector<int>> clauses;
+	if (!Parsers::parseCNF(filename, clauses, &parsedVarCount)) {
+		PABORT(PERR_PARSING, "Error at parsing!");
+	}
+	this->addInitialClauses(clauses, parsedVarCount);
+}
+
+inline const lit_t*
+ProbSat::clauseLiterals(uint32_t clause, unsigned int& size) const
+{
+	const ProbSatClauses& clauses = *this->m_clauses;
+	if (clause < clauses.clauseCount) {
+		size = clauses.clauseStart[clause + 1] - clauses.clauseStart[clause];
+		return clauses.literals.data() + clauses.clauseStart[clause];
+	}
+	size = 2;
+	return this->m_binaryLiterals.data() + 2 * (clause - clauses.clauseCount);
+}
+
+void
+ProbSat::initializeClause(uint32_t clause)
+{
+	unsigned int size;
+	const lit_t* lits = this->clauseLiterals(clause, size);
+
+	uint32_t count = 0, critical = 0;
+	for (unsigned int i = 0; i < size; i++) {
+		if (this->m_values[std::abs(lits[i])] == (lits[i] > 0)) {
+			count++;
+			critical ^= std::abs(lits[i]);
+		}
+	}
+	this->m_trueCount[clause] = count;
+	this->m_critical[clause] = critical;
+	if (count == 1)
+		this->m_breaks[critical]++;
+	else if (!count) {
+		this->m_unsatPosition[clause] = this->m_unsat.size();
+		this->m_unsat.push_back(clause);
+		for (unsigned int i = 0; i < size; i++)
+			this->m_makes[std::abs(lits[i])]++;
+	}
+}
+
+void
+ProbSat::initializeTry()
+{
+	std::fill(this->m_breaks.begin(), this->m_breaks.end(), 0);
+	std::fill(this->m_makes.begin(), this->m_makes.end(), 0);
+	this->m_unsat.clear();
+
+	for (uint32_t c = 0; c < this->m_trueCount.size(); c++)
+		this->initializeClause(c);
+}
+
+unsigned int
+ProbSat::pickVariable(uint32_t clause)
+{
+	unsigned int size;
+	const lit_t* lits = this->clauseLiterals(clause, size);
+	uint32_t* breaks = this->m_candidateBreaks.data();
+
+	// The fixed variables are not candidates, a clause with only fixed variables is falsified by the imported units
+	if (this->m_fixedCount) {
+		lit_t* candidates = this->m_candidateLits.data();
+		unsigned int count = 0;
+		for (unsigned int i = 0; i < size; i++)
+			if (this->m_fixedValues[std::abs(lits[i])] < 0)
+				candidates[count++] = lits[i];
+		if (!count)
+			return 0;
+		lits = candidates;
+		size = count;
+	}
+
+	this->m_evaluate(lits, size, this->m_breaks.data(), breaks);
+
+	if (!this->m_walkSat) {
+		float sum = 0;
+		for (unsigned int i = 0; i < size; i++) {
+			sum += this->m_probabilities[std::min<uint32_t>(breaks[i], PROBABILITIES_SIZE - 1)];
+			this->m_candidateWeights[i] = sum;
+		}
+		float pick = std::uniform_real_distribution<float>(0, sum)(this->m_rng);
+		for (unsigned int i = 0; i + 1 < size; i++)
+			if (pick < this->m_candidateWeights[i])
+				return std::abs(lits[i]);
+		return std::abs(lits[size - 1]);
+	}
+
+	uint32_t minBreak = *std::min_element(breaks, breaks + size);
+	if (minBreak && std::uniform_real_distribution<double>(0, 1)(this->m_rng) < this->m_noise)
+		return std::abs(lits[std::uniform_int_distribution<unsigned int>(0, size - 1)(this->m_rng)]);
+
+	// Minimal break, then maximal make, random among the ties
+	unsigned int best = 0, ties = 0;
+	uint32_t bestMake = 0;
+	for (unsigned int i = 0; i < size; i++) {
+		if (breaks[i] != minBreak)
+			continue;
+		uint32_t make = this->m_makes[std::abs(lits[i])];
+		if (!ties || make > bestMake) {
+			best = i;
+			bestMake = make;
+			ties = 1;
+		} else if (make == bestMake && std::uniform_int_distribution<unsigned int>(0, ties++)(this->m_rng) == 0)
+			best = i;
+	}
+	return std::abs(lits[best]);
+}
+
+inline void
+ProbSat::satisfyLiteral(uint32_t clause, unsigned int var)
+{
+	uint32_t count = this->m_trueCount[clause]++;
+	if (!count) {
+		uint32_t last = this->m_unsat.back();
+		this->m_unsat[this->m_unsatPosition[clause]] = last;
+		this->m_unsatPosition[last] = this->m_unsatPosition[clause];
+		this->m_unsat.pop_back();
+		unsigned int size;
+		const lit_t* lits = this->clauseLiterals(clause, size);
+		for (unsigned int i = 0; i < size; i++)
+			this->m_makes[std::abs(lits[i])]--;
+		this->m_breaks[var]++;
+		this->m_critical[clause] = var;
+	} else {
+		if (count == 1)
+			this->m_breaks[this->m_critical[clause]]--;
+		this->m_critical[clause] ^= var;
+	}
+}
+
+inline void
+ProbSat::falsifyLiteral(uint32_t clause, unsigned int var)
+{
+	uint32_t count = --this->m_trueCount[clause];
+	this->m_critical[clause] ^= var;
+	if (!count) {
+		this->m_unsatPosition[clause] = this->m_unsat.size();
+		this->m_unsat.push_back(clause);
+		unsigned int size;
+		const lit_t* lits = this->clauseLiterals(clause, size);
+		for (unsigned int i = 0; i < size; i++)
+			this->m_makes[std::abs(lits[i])]++;
+		this->m_breaks[var]--;
+	} else if (count == 1)
+		this->m_breaks[this->m_critical[clause]]++;
+}
+
+void
+ProbSat::flip(unsigned int var)
+{
+	const ProbSatClauses& clauses = *this->m_clauses;
+	const bool value = !this->m_values[var];
+	this->m_values[var] = value;
+	const lit_t trueLit = value ? var : -static_cast<lit_t>(var);
+
+	// Clauses in which the literal becomes true
+	uint32_t index = ProbSatClauses::litIndex(trueLit);
+	for (uint32_t o = clauses.occurrenceStart[index]; o < clauses.occurrenceStart[index + 1]; o++)
+		this->satisfyLiteral(clauses.occurrences[o], var);
+	if (!this->m_binaryOccurrences.empty())
+		for (uint32_t c : this->m_binaryOccurrences[index])
+			this->satisfyLiteral(c, var);
+
+	// Clauses in which the literal becomes false
+	index = ProbSatClauses::litIndex(-trueLit);
+	for (uint32_t o = clauses.occurrenceStart[index]; o < clauses.occurrenceStart[index + 1]; o++)
+		this->falsifyLiteral(clauses.occurrences[o], var);
+	if (!this->m_binaryOccurrences.empty())
+		for (uint32_t c : this->m_binaryOccurrences[index])
+			this->falsifyLiteral(c, var);
+
+	this->m_flips++;
+	if (!this->m_bestSaved) {
+		this->m_sinceBest.push_back(var);
+		if (this->m_sinceBest.size() > this->m_clauses->varCount)
+			this->saveBest();
+	}
+}
+
+void
+ProbSat::updateBest()
+{
+	if (this->m_unsat.size() < this->m_bestUnsat) {
+		this->m_bestUnsat = this->m_unsat.size();
+		this->m_bestSaved = false;
+		this->m_sinceBest.clear();
+		this->m_lastImprovement = this->m_flips;
+	}
+}
+
+void
+ProbSat::saveBest()
+{
+	if (this->m_bestSaved)
+		return;
+	this->m_bestValues = this->m_values;
+	for (uint32_t var : this->m_sinceBest)
+		this->m_bestValues[var] = !this->m_bestValues[var];
+	this->m_sinceBest.clear();
+	this->m_bestSaved = true;
+}
+
+void
+ProbSat::restart()
+{
+	this->saveBest();
+	this->m_restarts++;
+
+	unsigned int quality;
+	if (this->readProposedPhases(quality)) {
+		unsigned int count = std::min<size_t>(this->m_phaseBuffer.size(), this->m_values.size());
+		for (unsigned int var = 1; var < count; var++)
+			this->m_values[var] = this->m_phaseBuffer[var] != 0;
+		LOGDEBUG1("[ProbSat %d] phases of a trail of %u variables adopted", this->getSolverId(), quality);
+	} else if (this->m_rng() & 1) {
+		this->m_values = this->m_bestValues;
+	} else {
+		for (unsigned int var = 1; var < this->m_values.size(); var++)
+			this->m_values[var] = this->m_rng() & 1;
+	}
+	this->applyFixedValues();
+
+	this->initializeTry();
+	this->updateBest();
+	this->m_lastImprovement = this->m_flips;
+}
+
+void
+ProbSat::publishBestPhases()
+{
+	if (this->m_bestUnsat < this->publishedUnsat && this->isPhasePublicationDue()) {
+		this->saveBest();
+		this->m_publishedPhases->publish([this](unsigned int var) { return this->m_bestValues[var] != 0; },
+										 this->m_bestUnsat);
+		this->publishedUnsat = this->m_bestUnsat;
+	}
+}
+
+void
+ProbSat::applyFixedValues()
+{
+	if (!this->m_fixedCount)
+		return;
+	for (unsigned int var = 1; var < this->m_fixedValues.size(); var++)
+		if (this->m_fixedValues[var] >= 0)
+			this->m_values[var] = this->m_fixedValues[var];
+}
+
+void
+ProbSat::addBinary(lit_t lit1, lit_t lit2)
+{
+	const uint32_t clause = this->m_trueCount.size();
+	this->m_binaryLiterals.insert(this->m_binaryLiterals.end() - CANDIDATES_PADDING, { lit1, lit2 });
+
+	if (this->m_binaryOccurrences.empty())
+		this->m_binaryOccurrences.resize(2 * (this->m_clauses->varCount + 1));
+	this->m_binaryOccurrences[ProbSatClauses::litIndex(lit1)].push_back(clause);
+	this->m_binaryOccurrences[ProbSatClauses::litIndex(lit2)].push_back(clause);
+
+	this->m_trueCount.push_back(0);
+	this->m_critical.push_back(0);
+	this->m_unsatPosition.push_back(0);
+	this->initializeClause(clause);
+}
+
+void
+ProbSat::importLearnedClauses()
+{
+	if (!this->fetchImportedClauses(this->m_importedUnits, this->m_importedBinaries))
+		return;
+	const ProbSatClauses& clauses = *this->m_clauses;
+
+	for (lit_t lit : this->m_importedUnits) {
+		unsigned int var = std::abs(lit);
+		if (var > clauses.varCount || this->m_fixedValues[var] >= 0)
+			continue;
+		this->m_fixedValues[var] = lit > 0;
+		this->m_fixedCount++;
+		if (this->m_values[var] != (lit > 0))
+			this->flip(var);
+	}
+
+	// The walker keeps at most as many binaries as the formula has clauses
+	bool added = false;
+	for (auto [lit1, lit2] : this->m_importedBinaries) {
+		if (this->m_binaries.size() >= clauses.clauseCount)
+			break;
+		unsigned int var1 = std::abs(lit1), var2 = std::abs(lit2);
+		if (var1 > clauses.varCount || var2 > clauses.varCount || var1 == var2)
+			continue;
+		if (!this->m_binaries.insert(std::minmax(lit1, lit2)).second)
+			continue;
+		this->addBinary(lit1, lit2);
+		added = true;
+	}
+
+	// The best assignment was counted on fewer clauses, the current one replaces it
+	if (added)
+		this->m_bestUnsat = UINT_MAX;
+	this->updateBest();
+
+	LOG2("[ProbSat %d] %zu units and %zu binaries imported (%u fixed variables, %zu binaries)",
+		 this->getSolverId(),
+		 this->m_importedUnits.size(),
+		 this->m_importedBinaries.size(),
+		 this->m_fixedCount,
+		 this->m_binaries.size());
+}
+
+SatResult
+ProbSat::solve(const std::vector<int>& cube)
+{
+	if (!this->m_clauses || !this->m_clauses->clauseCount) {
+		LOGWARN("No Clause was added, returning SAT from solver");
+		// Any assignment is a model, getModel must still find one value per variable
+		this->m_values.assign(this->getVariablesCount() + 1, 0);
+		this->m_sinceBest.clear();
+		this->m_bestSaved = false;
+		return SatResult::SAT;
+	}
+	const ProbSatClauses& clauses = *this->m_clauses;
+	if (clauses.hasEmptyClause)
+		return SatResult::UNKNOWN;
+
+	for (int lit : cube)
+		this->setPhase(std::abs(lit), lit > 0);
+
+	/* Strategy, the defaults of probSAT for the maximal clause length */
+	if (clauses.maxLength <= 3) {
+		this->m_polynomial = true;
+		this->m_cb = 2.38;
+	} else {
+		this->m_polynomial = false;
+		this->m_cb = clauses.maxLength == 4 ? 3.0 : clauses.maxLength == 5 ? 3.7 : clauses.maxLength == 6 ? 5.1 : 5.4;
+	}
+	this->m_cb *= this->m_cbFactor;
+	this->m_probabilities.resize(PROBABILITIES_SIZE);
+	for (unsigned int b = 0; b < PROBABILITIES_SIZE; b++)
+		this->m_probabilities[b] =
+			this->m_polynomial ? std::pow(this->m_eps + b, -this->m_cb) : std::pow(this->m_cb, -static_cast<double>(b));
+	this->m_restartInterval = std::max<unsigned long>(100'000, 10UL * clauses.clauseCount);
+
+	/* Walker state, the imported binaries follow the clauses of the formula */
+	const size_t walkerClauses = clauses.clauseCount + this->m_binaries.size();
+	const unsigned int candidates = std::max(clauses.maxLength, 2U) + CANDIDATES_PADDING;
+	this->m_values.assign(clauses.varCount + 1, 0);
+	this->m_trueCount.resize(walkerClauses);
+	this->m_critical.resize(walkerClauses);
+	this->m_unsatPosition.resize(walkerClauses);
+	this->m_breaks.resize(clauses.varCount + 1);
+	this->m_makes.resize(clauses.varCount + 1);
+	this->m_fixedValues.resize(clauses.varCount + 1, -1);
+	this->m_candidateLits.resize(candidates, 0);
+	this->m_candidateBreaks.resize(candidates);
+	this->m_candidateWeights.resize(candidates);
+
+	for (unsigned int var = 1; var <= clauses.varCount; var++) {
+		bool phaseSet = var < this->m_initialPhases.size() && this->m_initialPhases[var] >= 0;
+		this->m_values[var] = phaseSet ? this->m_initialPhases[var] : this->m_rng() & 1;
+	}
+	this->applyFixedValues();
+	this->initializeTry();
+	this->m_bestUnsat = UINT_MAX;
+	this->updateBest();
+
+	/* Search */
+	const double start = SystemResourceMonitor::getRelativeTimeSeconds();
+	while (!this->m_unsat.empty() && !this->terminateSolver && this->m_flips < this->m_flipsLimit) {
+		uint32_t clause =
+			this->m_unsat[std::uniform_int_distribution<uint32_t>(0, this->m_unsat.size() - 1)(this->m_rng)];
+		unsigned int var = this->pickVariable(clause);
+		if (!var) {
+			// No flip can satisfy the clause without contradicting the units, no model extends them
+			LOG1("[ProbSat %d] A clause conflicts with the imported units, search stopped", this->getSolverId());
+			break;
+		}
+		this->flip(var);
+		this->updateBest();
+
+		if (this->m_flips % CHECK_INTERVAL)
+			continue;
+		this->importLearnedClauses();
+		if (this->m_publishedPhases)
+			this->publishBestPhases();
+		if (this->m_flips - this->m_lastImprovement > this->m_restartInterval)
+			this->restart();
+	}
+	this->m_searchTime += SystemResourceMonitor::getRelativeTimeSeconds() - start;
+
+	this->lsStats.numberFlips = this->m_flips;
+	this->lsStats.numberUnsatClauses = this->m_bestUnsat;
+	this->lsStats.flipsPerSecond = this->m_searchTime > 0 ? this->m_flips / this->m_searchTime : 0;
+
+	LOGSTAT("[ProbSat %d] Number of remaining unsats %u / %u, Number of Flips %lu (%.0f flips/s).",
+			this->getSolverId(),
+			this->m_bestUnsat,
+			clauses.clauseCount,
+			this->m_flips,
+			this->lsStats.flipsPerSecond);
+
+	return this->m_unsat.empty() ? SatResult::SAT : SatResult::UNKNOWN;
+}
+
+std::vector<int>
+ProbSat::getModel()
+{
+	std::vector<int> model;
+	unsigned int varCount = this->getVariablesCount();
+
+	this->saveBest();
+	for (unsigned int i = 1; i <= varCount; i++) {
+		model.emplace_back(this->m_bestValues[i] ? i : -i);
+	}
+
+	return model;
+}
+
+void
+ProbSat::printStatistics()
+{
+	LOGSTAT("[ProbSat %d] flips: %lu, flips/s: %.0f, restarts: %lu, best unsat: %u, fixed variables: %u, imported "
+			"binaries: %zu",
+			this->getSolverId(),
+			this->m_flips,
+			this->m_searchTime > 0 ? this->m_flips / this->m_searchTime : 0,
+			this->m_restarts,
+			this->m_bestUnsat,
+			this->m_fixedCount,
+			this->m_binaries.size());
+}
+
+void
+ProbSat::printParameters()
+{
+	LOG0("ProbSat %d: %s, cb: %.2f (%s), noise: %.3f, restart interval: %lu, candidates evaluation: %s",
+		 this->getSolverId(),
+		 this->m_walkSat ? "WalkSAT" : "probSAT",
+		 this->m_cb,
+		 this->m_polynomial ? "polynomial" : "exponential",
+		 this->m_noise,
+		 this->m_restartInterval,
+		 this->m_evaluate == evaluateCandidatesScalar ? "scalar" : "avx2");
+}
+
+void
+ProbSat::diversify(const SeedGenerator& getSeed)
+{
+	this->m_rng.seed(getSeed(this));
+
+	std::uniform_int_distribution<int> uniform_dist(1, m_maxNoise);
+
+	// Half of the walkers use WalkSAT, the others probSAT
+	this->m_walkSat = this->getSolverTypeId() % 2;
+
+	// Perturbation of the probSAT base within 10% of the default
+	this->m_cbFactor = 0.9 + 0.2 * uniform_dist(this->m_rng) / m_maxNoise;
+
+	// WalkSAT noise around its usual 0.567
+	this->m_noise = 0.4 + 0.3 * uniform_dist(this->m_rng) / m_maxNoise;
+
+	LOG2("Diversification of ProbSat(%d,%u) done", this->getSolverId(), this->getSolverTypeId());
+}
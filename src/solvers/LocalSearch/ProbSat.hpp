@@ -0,0 +1,225 @@
+#pragma once
+
+#define PROBSAT_
+
+#include "containers/SimpleTypes.hpp"
+#include "solvers/LocalSearch/LocalSearchInterface.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Read-only clause store of the native local search, shared by all the walkers loading the same formula.
+ *
+ * The clauses and the occurrence lists are stored in flat arrays (CSR): the literals of clause c are
+ * literals[clauseStart[c], clauseStart[c + 1]) and the clauses containing a literal are indexed by litIndex().
+ * Duplicate literals are removed and tautologies dropped while loading.
+ * @ingroup localSearch
+ */
+struct ProbSatClauses
+{
+	/// Index of a literal in the occurrence lists
+	static uint32_t litIndex(lit_t lit) { return 2 * std::abs(lit) + (lit < 0); }
+
+	unsigned int varCount = 0;
+	unsigned int clauseCount = 0;
+	unsigned int maxLength = 0;
+	bool hasEmptyClause = false;
+
+	std::vector<uint32_t> clauseStart;
+	/// Padded with zeros so that the candidates of the last clause can be loaded by full vectors
+	std::vector<lit_t> literals;
+
+	std::vector<uint32_t> occurrenceStart;
+	std::vector<uint32_t> occurrences;
+};
+
+/**
+ * @brief Native probSAT / WalkSAT local search on painless's own formula representation.
+ *
+ * Each instance is one walker. The walkers loading the same formula arena share one read-only ProbSatClauses, so a
+ * portfolio of several walkers (-solver=ppp...) holds the clauses once. The state of a walker is kept in flat arrays:
+ * per clause the number of true literals and the xor of their variables (the critical variable when only one is true),
+ * per variable the break and make counts, and the list of unsatisfied clauses.
+ *
+ * A step picks a random unsatisfied clause and gathers the break values of its candidates, with AVX2 gathers when the
+ * CPU supports them (detected at runtime, the build flags are not changed):
+ *  - probSAT flips a candidate with a probability given by a table indexed by its break value;
+ *  - WalkSAT flips a zero-break candidate if any, else a random one with the noise probability, else one of the minimal
+ *    break (ties broken by the highest make).
+ *
+ * The search restarts when the best assignment has not improved for a number of flips proportional to the formula, from
+ * the phases proposed by the phase exchange when there are new ones, else from the best assignment or a random one.
+ *
+ * The units and binaries learned by the CDCL solvers are imported between two flips: the variable of a unit is set to
+ * its value and never flipped again, a binary is appended to the clauses of the walker (after the shared ones).
+ * @ingroup localSearch
+ */
+class ProbSat : public LocalSearchInterface
+{
+  public:
+	ProbSat(int _id, unsigned long flipsLimit, unsigned long maxNoise);
+
+	~ProbSat();
+
+	unsigned int getVariablesCount();
+
+	int getDivisionVariable();
+
+	void setSolverInterrupt();
+
+	void unsetSolverInterrupt();
+
+	void setPhase(const unsigned int var, const bool phase);
+
+	SatResult solve(const std::vector<int>& cube);
+
+	void addClause(ClauseExchangePtr clause);
+
+	void addClauses(const std::vector<ClauseExchangePtr>& clauses);
+
+	void addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int nbVars) override;
+
+	void addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars) override;
+
+	/// Search on the clause store built by the first walker loading the same arena, if it is still alive
+	void addInitialFormula(const std::shared_ptr<const FormulaArena>& formula) override;
+
+	void loadFormula(const char* filename);
+
+	std::vector<int> getModel();
+
+	void printStatistics();
+
+	void printParameters();
+
+	void diversify(const SeedGenerator& getSeed);
+
+  private:
+	/// Fill the break values of the candidates of a clause (up to a multiple of 8 entries are written)
+	using EvaluateCandidates = void (*)(const lit_t* lits, unsigned int size, const uint32_t* breaks, uint32_t* out);
+
+	/// Literals of a clause, of the shared store or an imported binary
+	const lit_t* clauseLiterals(uint32_t clause, unsigned int& size) const;
+
+	/// Compute the counters of a clause from m_values
+	void initializeClause(uint32_t clause);
+
+	/// Start a try from m_values: compute the counters and the unsatisfied clauses
+	void initializeTry();
+
+	/// Update the counters of a clause in which a literal of var becomes true
+	void satisfyLiteral(uint32_t clause, unsigned int var);
+
+	/// Update the counters of a clause in which a literal of var becomes false
+	void falsifyLiteral(uint32_t clause, unsigned int var);
+
+	/// Pick the variable to flip in an unsatisfied clause, 0 when all its variables are fixed
+	unsigned int pickVariable(uint32_t clause);
+
+	/// Flip a variable and update the counters
+	void flip(unsigned int var);
+
+	/// Record the current assignment as the best if it has fewer unsatisfied clauses
+	void updateBest();
+
+	/// Store the best assignment in m_bestValues if it is only known through the flips since it was reached
+	void saveBest();
+
+	/// Choose the assignment of the next try
+	void restart();
+
+	/// Publish the best assignment to the phase exchange if it improved
+	void publishBestPhases();
+
+	/// Set the fixed variables to their value in m_values
+	void applyFixedValues();
+
+	/// Fix the variables of the imported units and add the imported binaries
+	void importLearnedClauses();
+
+	/// Append a binary to the clauses of the walker
+	void addBinary(lit_t lit1, lit_t lit2);
+
+	std::shared_ptr<const ProbSatClauses> m_clauses;
+
+	/// @brief State attribute to test if the solver should terminate or not
+	std::atomic<bool> terminateSolver;
+
+	/// @brief The maximum number of flips the search can reach
+	unsigned long m_flipsLimit;
+
+	/// @brief The maximum noise in randomization
+	unsigned long m_maxNoise;
+
+	std::mt19937 m_rng;
+
+	EvaluateCandidates m_evaluate;
+
+	// Strategy
+	//---------
+	bool m_walkSat = false;
+	bool m_polynomial = true;
+	double m_cb = 2.38;
+	double m_eps = 1.0;
+	/// Diversification of m_cb, applied to the default of the formula
+	double m_cbFactor = 1.0;
+	/// WalkSAT noise, in [0, 1]
+	double m_noise = 0.567;
+	/// Probability of a break value, the last entry is used for the larger ones
+	std::vector<float> m_probabilities;
+	unsigned long m_restartInterval = 0;
+
+	// Walker state
+	//-------------
+	std::vector<char> m_values;
+	std::vector<uint32_t> m_trueCount;
+	std::vector<uint32_t> m_critical;
+	std::vector<uint32_t> m_breaks;
+	std::vector<uint32_t> m_makes;
+	std::vector<uint32_t> m_unsat;
+	std::vector<uint32_t> m_unsatPosition;
+
+	/// Initial phases (cube and setPhase), -1 when unset
+	std::vector<signed char> m_initialPhases;
+
+	/// Candidates buffers of pickVariable
+	std::vector<lit_t> m_candidateLits;
+	std::vector<uint32_t> m_candidateBreaks;
+	std::vector<float> m_candidateWeights;
+
+	// Imported clauses
+	//-----------------
+	/// Value of the fixed variables, -1 when free
+	std::vector<signed char> m_fixedValues;
+	unsigned int m_fixedCount = 0;
+
+	/// Literals of the binaries, clause clauseCount + i is the binary i, padded like the shared literals
+	std::vector<lit_t> m_binaryLiterals;
+	/// Binaries containing a literal (by litIndex), empty until the first binary is imported
+	std::vector<std::vector<uint32_t>> m_binaryOccurrences;
+	std::set<std::pair<lit_t, lit_t>> m_binaries;
+
+	/// Buffers of fetchImportedClauses
+	std::vector<lit_t> m_importedUnits;
+	std::vector<std::pair<lit_t, lit_t>> m_importedBinaries;
+
+	/// Best assignment, it is the current one with the variables of m_sinceBest flipped unless m_bestSaved
+	std::vector<char> m_bestValues;
+	std::vector<uint32_t> m_sinceBest;
+	bool m_bestSaved = false;
+	unsigned int m_bestUnsat = UINT_MAX;
+	unsigned long m_lastImprovement = 0;
+
+	// Stats
+	//------
+	unsigned long m_flips = 0;
+	unsigned long m_restarts = 0;
+	double m_searchTime = 0;
+};
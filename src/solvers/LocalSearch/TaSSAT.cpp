@@ -1,10 +1,22 @@
 #include "TaSSAT.hpp"
+#include "containers/FormulaArena.hpp"
 #include "utils/ErrorCodes.hpp"
 #include "utils/NumericConstants.hpp"
 #include "utils/Parameters.hpp"
 #include "utils/Parsers.hpp"
 #include "utils/System.hpp"
 
+#include <map>
+#include <mutex>
+
+/// Iterations of the inner loop between two checks of the imported units and of the best assignment for the phase
+/// exchange
+static const unsigned long PHASE_EXCHANGE_INTERVAL = 1024;
+
+/// Prepared solvers whose connected clauses are shared read-only, one per formula arena
+static std::mutex sharedClausesMutex;
+static std::map<std::weak_ptr<const FormulaArena>, std::weak_ptr<Yals>, std::owner_less<>> sharedClauses;
+
 TaSSAT::TaSSAT(int _id, unsigned long flipsLimit, unsigned long maxNoise)
 	: m_flipsLimit(flipsLimit)
 	, m_maxNoise(maxNoise)
@@ -24,12 +36,17 @@ TaSSAT::TaSSAT(int _id, unsigned long flipsLimit, unsigned long maxNoise)
 	m_currpct = 0.075f;
 	m_initialweight = 100.f;
 	m_randomPick = 0.1f;
+
+	// The connected clauses are shared by the instances, the binaries cannot be added to them
+	this->m_importMaxSize = 1;
 }
 
 TaSSAT::~TaSSAT()
 {
 	// void tass_del (Yals *);
-	tass_del(this->myyals);
+	// A solver whose clauses are shared is deleted with the last solver sharing them
+	if (this->m_sharedClauses.get() != this->myyals)
+		tass_del(this->myyals);
 	LOGDEBUG1("TaSSAT %d deleted!", this->getSolverId());
 }
 
@@ -101,9 +118,11 @@ TaSSAT::solve(const std::vector<int>& cube)
 	lsStats.numberFlips = 0;
 	m_descentsCount = 0;
 
+	double start = SystemResourceMonitor::getRelativeTimeSeconds();
 	tass_init_outer_restart_interval(myyals);
 	LOGDEBUG1("After Outer Loop Init");
 	while (!this->terminateSolver) {
+		this->adoptProposedPhases();
 		tass_init_one_outer_iteration(myyals);
 		LOGDEBUG1("After One Outer Loop Iteration Init");
 		if (tass_need_to_run_max_tries(myyals)) {
@@ -116,14 +135,17 @@ TaSSAT::solve(const std::vector<int>& cube)
 	}
 
 	int res = tass_get_res(myyals);
+	double searchTime = SystemResourceMonitor::getRelativeTimeSeconds() - start;
 
 	this->lsStats.numberUnsatClauses = tass_nunsat_external(myyals);
+	this->lsStats.flipsPerSecond = searchTime > 0 ? this->lsStats.numberFlips / searchTime : 0;
 
-	LOGSTAT("[TaSSAT %d] Number of remaining unsats %d / %d, Number of Flips %d.",
+	LOGSTAT("[TaSSAT %d] Number of remaining unsats %d / %d, Number of Flips %d (%.0f flips/s).",
 			this->getSolverId(),
 			this->lsStats.numberUnsatClauses,
 			this->clausesCount,
-			this->lsStats.numberFlips);
+			this->lsStats.numberFlips,
+			this->lsStats.flipsPerSecond);
 
 	return static_cast<SatResult>(res);
 }
@@ -134,6 +156,43 @@ TaSSAT::setPhase(const unsigned int var, const bool phase)
 	tass_setphase(this->myyals, (phase) ? var : -var);
 }
 
+void
+TaSSAT::adoptProposedPhases()
+{
+	unsigned int quality;
+	if (!this->readProposedPhases(quality))
+		return;
+
+	// Consumed by the initial assignment pick of tass_init_one_outer_iteration
+	for (unsigned int var = 1; var < this->m_phaseBuffer.size(); var++)
+		tass_setphase(this->myyals, this->m_phaseBuffer[var] ? var : -var);
+	LOGDEBUG1("[TaSSAT %d] phases of a trail of %u variables adopted", this->getSolverId(), quality);
+}
+
+void
+TaSSAT::publishBestPhases()
+{
+	// tass_minimum is the number of unsatisfied clauses of the best assignment, read by tass_deref
+	unsigned int minimum = tass_minimum(this->myyals);
+	if (minimum < this->publishedUnsat && this->isPhasePublicationDue()) {
+		this->m_publishedPhases->publish([this](unsigned int var) { return tass_deref(this->myyals, var) > 0; },
+										 minimum);
+		this->publishedUnsat = minimum;
+	}
+}
+
+void
+TaSSAT::importUnits()
+{
+	if (!this->fetchImportedClauses(this->m_importedUnits, this->m_importedBinaries))
+		return;
+
+	for (lit_t lit : this->m_importedUnits)
+		tass_fix(this->myyals, lit);
+	this->m_fixedCount += this->m_importedUnits.size();
+	LOG2("[TaSSAT %d] %zu units imported", this->getSolverId(), this->m_importedUnits.size());
+}
+
 void
 TaSSAT::addClause(ClauseExchangePtr clause)
 {
@@ -154,7 +213,7 @@ TaSSAT::addClauses(const std::vector<ClauseExchangePtr>& clauses)
 void
 TaSSAT::addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int nbVars)
 {
-	if (clauses.size() > 33 * MILLION) {
+	if (clauses.size() > 536 * MILLION) {
 		LOGERROR("The number of clauses %u is too high for TaSSAT!", clauses.size());
 		exit(PERR_NOT_SUPPORTED);
 	}
@@ -174,17 +233,43 @@ TaSSAT::addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int
 void
 TaSSAT::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars)
 {
-	this->clausesCount = 0;
-	int lit;
-	for (lit = *literals; this->clausesCount < clsCount; literals++, lit=*literals) {
-		tass_add(this->myyals, lit);
-		if(!lit)
-			this->clausesCount++;
+	if (clsCount > 536 * MILLION) {
+		LOGERROR("The number of clauses %u is too high for TaSSAT!", clsCount);
+		exit(PERR_NOT_SUPPORTED);
 	}
+	this->clausesCount = clsCount;
+
+	tass_add_clauses(this->myyals, literals, clsCount, nbVars);
+	tass_prepare(this->myyals, static_cast<char>(true));
+	this->m_sharedClauses = std::shared_ptr<Yals>(this->myyals, tass_del);
+	LOG2("TaSSAT %d loaded all the %lu clauses with %u variables", this->getSolverId(), this->clausesCount, nbVars);
 
 	this->setInitialized(true);
+}
 
-	LOG2("TaSSAT %d loaded all the %d clauses with %u variables", this->getSolverId(), this->clausesCount, nbVars);
+void
+TaSSAT::addInitialFormula(const std::shared_ptr<const FormulaArena>& formula)
+{
+	/* The first solver loading the formula prepares its clauses, the next ones search on them */
+	std::lock_guard<std::mutex> lock(sharedClausesMutex);
+	std::erase_if(sharedClauses, [](const auto& entry) { return entry.first.expired(); });
+	std::weak_ptr<Yals>& shared = sharedClauses[formula];
+	std::shared_ptr<Yals> primary = shared.lock();
+	if (!primary) {
+		this->addInitialClauses(formula->data(), formula->getClausesCount(), formula->getVariablesCount());
+		shared = this->m_sharedClauses;
+		return;
+	}
+
+	this->clausesCount = formula->getClausesCount();
+	tass_share(this->myyals, primary.get());
+	this->m_sharedClauses = primary;
+	LOG2("TaSSAT %d shares the %lu clauses with %u variables",
+		 this->getSolverId(),
+		 this->clausesCount,
+		 formula->getVariablesCount());
+
+	this->setInitialized(true);
 }
 
 void
@@ -215,6 +300,7 @@ TaSSAT::getModel()
 void
 TaSSAT::printStatistics()
 {
+	LOGSTAT("[TaSSAT %d] imported units: %lu", this->getSolverId(), this->m_fixedCount);
 	tass_stats(this->myyals);
 }
 
@@ -277,7 +363,13 @@ TaSSAT::simpleInnerLoop()
 	tass_init_inner_restart_interval(myyals);
 	LOGDEBUG1("Entering yals inner loop");
 
+	unsigned long iterations = 0;
 	while (!(res = tass_done(myyals)) && !tass_need_to_restart_outer(myyals) && !this->terminateSolver) {
+		if (!(++iterations % PHASE_EXCHANGE_INTERVAL)) {
+			this->importUnits();
+			if (this->m_publishedPhases)
+				this->publishBestPhases();
+		}
 		if (tass_need_to_restart_inner(myyals)) {
 			tass_restart_inner(myyals);
 			if (!tass_getopt(myyals, "liwetonly"))
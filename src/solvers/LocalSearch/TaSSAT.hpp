@@ -59,6 +59,9 @@ class TaSSAT : public LocalSearchInterface
 
 	void addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int nbVars);
 
+	/// Search on the clauses prepared by the first TaSSAT loading the same arena, if it is still alive
+	void addInitialFormula(const std::shared_ptr<const FormulaArena>& formula) override;
+
 	void loadFormula(const char* filename);
 
 	std::vector<int> getModel();
@@ -85,9 +88,21 @@ class TaSSAT : public LocalSearchInterface
 	/// @return SAT if solved, otherwise UNKNOWN if flips limit is reached
 	SatResult simpleInnerLoop();
 
+	/// @brief Set the proposed phases, if new, as the phases of the next outer iteration
+	void adoptProposedPhases();
+
+	/// @brief Publish the best assignment to the phase exchange if it improved
+	void publishBestPhases();
+
+	/// @brief Fix the variables of the imported units, forced at the next tass_done
+	void importUnits();
+
   private:
 	Yals* myyals;
 
+	/// @brief The solver whose connected clauses are used by this one (possibly itself), deleted with the last user
+	std::shared_ptr<Yals> m_sharedClauses;
+
 	/// @brief State attribute to test if the solver should terminate or not
 	std::atomic<bool> terminateSolver;
 
@@ -103,6 +118,13 @@ class TaSSAT : public LocalSearchInterface
 	/// @brief The maximum noise in randomization
 	unsigned long m_maxNoise;
 
+	/// @brief Buffers of fetchImportedClauses
+	std::vector<lit_t> m_importedUnits;
+	std::vector<std::pair<lit_t, lit_t>> m_importedBinaries;
+
+	/// @brief Number of imported units
+	unsigned long m_fixedCount = 0;
+
 	/// @brief Enable the multiple pick mode
 	bool m_enableMultiplePicks;
 
@@ -1,10 +1,18 @@
 #include "YalSat.hpp"
+#include "containers/FormulaArena.hpp"
 #include "utils/ErrorCodes.hpp"
 #include "utils/NumericConstants.hpp"
 #include "utils/Parameters.hpp"
 #include "utils/Parsers.hpp"
 #include "utils/System.hpp"
 
+#include <map>
+#include <mutex>
+
+/// Prepared solvers whose connected clauses are shared read-only, one per formula arena
+static std::mutex sharedClausesMutex;
+static std::map<std::weak_ptr<const FormulaArena>, std::weak_ptr<Yals>, std::owner_less<>> sharedClauses;
+
 /* For termination callback check */
 int
 yalsat_terminate(void* p_YalSat)
@@ -12,8 +20,10 @@ yalsat_terminate(void* p_YalSat)
 	YalSat* cpp_YalSat = (YalSat*)p_YalSat;
 	if (cpp_YalSat->terminateSolver)
 		return 1;
-	else
-		return 0;
+
+	cpp_YalSat->importUnits();
+	cpp_YalSat->exchangePhases();
+	return 0;
 }
 
 YalSat::YalSat(int _id, unsigned long flipsLimit, unsigned long maxNoise)
@@ -26,12 +36,17 @@ YalSat::YalSat(int _id, unsigned long flipsLimit, unsigned long maxNoise)
 	this->solver = yals_new();
 	yals_seterm(this->solver, yalsat_terminate, this);
 	this->clausesCount = 0;
+
+	// The connected clauses are shared by the instances, the binaries cannot be added to them
+	this->m_importMaxSize = 1;
 }
 
 YalSat::~YalSat()
 {
 	// void yals_del (Yals *);
-	yals_del(this->solver);
+	// A solver whose clauses are shared is deleted with the last solver sharing them
+	if (this->m_sharedClauses.get() != this->solver)
+		yals_del(this->solver);
 	LOGDEBUG1("Yalsat %d deleted!", this->getSolverId());
 }
 
@@ -74,16 +89,20 @@ YalSat::solve(const std::vector<int>& cube)
 		yals_setphase(this->solver, lit);
 	}
 
+	double start = SystemResourceMonitor::getRelativeTimeSeconds();
 	res = yals_sat(this->solver);
+	double searchTime = SystemResourceMonitor::getRelativeTimeSeconds() - start;
 
 	this->lsStats.numberFlips = yals_flips(this->solver);
 	this->lsStats.numberUnsatClauses = yals_minimum(this->solver);
+	this->lsStats.flipsPerSecond = searchTime > 0 ? this->lsStats.numberFlips / searchTime : 0;
 
-	LOGSTAT("[YalSat %d] Number of remaining unsats %d / %d, Number of Flips %d.",
+	LOGSTAT("[YalSat %d] Number of remaining unsats %d / %d, Number of Flips %d (%.0f flips/s).",
 			this->getSolverId(),
 			this->lsStats.numberUnsatClauses,
 			this->clausesCount,
-			this->lsStats.numberFlips);
+			this->lsStats.numberFlips,
+			this->lsStats.flipsPerSecond);
 
 	if (static_cast<int>(SatResult::SAT) != res) {
 		return SatResult::UNKNOWN;
@@ -98,6 +117,43 @@ YalSat::setPhase(const unsigned int var, const bool phase)
 	yals_setphase(this->solver, (phase) ? var : -var);
 }
 
+void
+YalSat::exchangePhases()
+{
+	if (!this->m_publishedPhases)
+		return;
+
+	unsigned int quality;
+	if (this->readProposedPhases(quality)) {
+		// The phases are only read at the next outer restart, the older ones are replaced
+		yals_clearphases(this->solver);
+		for (unsigned int var = 1; var < this->m_phaseBuffer.size(); var++)
+			yals_setphase(this->solver, this->m_phaseBuffer[var] ? var : -var);
+		LOGDEBUG1("[YalSat %d] phases of a trail of %u variables adopted", this->getSolverId(), quality);
+	}
+
+	// yals_minimum is the number of unsatisfied clauses of the best assignment, read by yals_deref
+	unsigned int minimum = yals_minimum(this->solver);
+	if (minimum < this->publishedUnsat && this->isPhasePublicationDue()) {
+		this->m_publishedPhases->publish([this](unsigned int var) { return yals_deref(this->solver, var) > 0; },
+										 minimum);
+		this->publishedUnsat = minimum;
+	}
+}
+
+void
+YalSat::importUnits()
+{
+	if (!this->fetchImportedClauses(this->m_importedUnits, this->m_importedBinaries))
+		return;
+
+	// Forced by yalsat at the next check of the termination, then never flipped
+	for (lit_t lit : this->m_importedUnits)
+		yals_fix(this->solver, lit);
+	this->m_fixedCount += this->m_importedUnits.size();
+	LOG2("[YalSat %d] %zu units imported", this->getSolverId(), this->m_importedUnits.size());
+}
+
 void
 YalSat::addClause(ClauseExchangePtr clause)
 {
@@ -118,7 +174,7 @@ YalSat::addClauses(const std::vector<ClauseExchangePtr>& clauses)
 void
 YalSat::addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int nbVars)
 {
-	if (clauses.size() > 33 * MILLION) {
+	if (clauses.size() > 536 * MILLION) {
 		LOGERROR("The number of clauses %u is too high for yalsat!", clauses.size());
 		exit(PERR_NOT_SUPPORTED);
 	}
@@ -138,17 +194,43 @@ YalSat::addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int
 void
 YalSat::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars)
 {
-	this->clausesCount = 0;
-	int lit;
-	for (lit = *literals; this->clausesCount < clsCount; literals++, lit=*literals) {
-		yals_add(this->solver, lit);
-		if(!lit)
-			this->clausesCount++;
+	if (clsCount > 536 * MILLION) {
+		LOGERROR("The number of clauses %u is too high for yalsat!", clsCount);
+		exit(PERR_NOT_SUPPORTED);
 	}
+	this->clausesCount = clsCount;
+
+	yals_add_clauses(this->solver, literals, clsCount, nbVars);
+	yals_prepare(this->solver);
+	this->m_sharedClauses = std::shared_ptr<Yals>(this->solver, yals_del);
+	LOG2("Yalsat %d loaded all the %lu clauses with %u variables", this->getSolverId(), this->clausesCount, nbVars);
 
 	this->setInitialized(true);
+}
 
-	LOG2("Yalsat %d loaded all the %d clauses with %u variables", this->getSolverId(), this->clausesCount, nbVars);
+void
+YalSat::addInitialFormula(const std::shared_ptr<const FormulaArena>& formula)
+{
+	/* The first solver loading the formula prepares its clauses, the next ones search on them */
+	std::lock_guard<std::mutex> lock(sharedClausesMutex);
+	std::erase_if(sharedClauses, [](const auto& entry) { return entry.first.expired(); });
+	std::weak_ptr<Yals>& shared = sharedClauses[formula];
+	std::shared_ptr<Yals> primary = shared.lock();
+	if (!primary) {
+		this->addInitialClauses(formula->data(), formula->getClausesCount(), formula->getVariablesCount());
+		shared = this->m_sharedClauses;
+		return;
+	}
+
+	this->clausesCount = formula->getClausesCount();
+	yals_share(this->solver, primary.get());
+	this->m_sharedClauses = primary;
+	LOG2("Yalsat %d shares the %lu clauses with %u variables",
+		 this->getSolverId(),
+		 this->clausesCount,
+		 formula->getVariablesCount());
+
+	this->setInitialized(true);
 }
 
 void
@@ -179,6 +261,7 @@ YalSat::getModel()
 void
 YalSat::printStatistics()
 {
+	LOGSTAT("[YalSat %d] imported units: %lu", this->getSolverId(), this->m_fixedCount);
 	yals_stats(this->solver);
 }
 
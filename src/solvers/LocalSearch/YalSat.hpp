@@ -41,6 +41,9 @@ class YalSat : public LocalSearchInterface
 
 	void addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars) override;
 
+	/// Search on the clauses prepared by the first YalSat loading the same arena, if it is still alive
+	void addInitialFormula(const std::shared_ptr<const FormulaArena>& formula) override;
+
 	void loadFormula(const char* filename);
 
 	std::vector<int> getModel();
@@ -54,8 +57,18 @@ class YalSat : public LocalSearchInterface
 	friend int yalsat_terminate(void* p_YalSat);
 
   private:
+	/// @brief Called by the termination callback: adopt the proposed phases at the next outer restart, and publish the
+	/// best assignment if it improved
+	void exchangePhases();
+
+	/// @brief Called by the termination callback: fix the variables of the imported units
+	void importUnits();
+
 	Yals* solver;
 
+	/// @brief The solver whose connected clauses are used by this one (possibly itself), deleted with the last user
+	std::shared_ptr<Yals> m_sharedClauses;
+
 	/// @brief State attribute to test if the solver should terminate or not
 	std::atomic<bool> terminateSolver;
 
@@ -67,4 +80,11 @@ class YalSat : public LocalSearchInterface
 
 	/// @brief The maximum noise in randomization
 	unsigned long m_maxNoise;
+
+	/// @brief Buffers of fetchImportedClauses
+	std::vector<lit_t> m_importedUnits;
+	std::vector<std::pair<lit_t, lit_t>> m_importedBinaries;
+
+	/// @brief Number of imported units
+	unsigned long m_fixedCount = 0;
 };
\ No newline at end of file
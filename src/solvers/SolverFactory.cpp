@@ -16,6 +16,7 @@
 #include "solvers/CDCL/MiniSat.hpp"
 #include "solvers/LocalSearch/YalSat.hpp"
 #include "solvers/LocalSearch/TaSSAT.hpp"
+#include "solvers/LocalSearch/ProbSat.hpp"
 
 #include "containers/ClauseDatabases/ClauseDatabaseFactory.hpp"
 
@@ -69,7 +70,12 @@ SolverFactory::createSolver(char type, char importDBType, std::shared_ptr<Solver
 		return SolverAlgorithmType::UNKNOWN;
 	}
 
+	return createSolver(type, importDBType, id, createdSolver);
+}
 
+SolverAlgorithmType
+SolverFactory::createSolver(char type, char importDBType, int id, std::shared_ptr<SolverInterface>& createdSolver)
+{
 	std::shared_ptr<ClauseDatabase> importDB;
 
 	importDB = ClauseDatabaseFactory::createDatabase(importDBType);
@@ -145,6 +151,13 @@ SolverFactory::createSolver(char type, char importDBType, std::shared_ptr<Solver
 			// break;
 #endif
 
+#ifdef PROBSAT_
+		case 'p':
+			createdSolver = std::make_shared<ProbSat>(id, __globalParameters__.localSearchFlips, __globalParameters__.maxDivNoise);
+			return SolverAlgorithmType::LOCAL_SEARCH;
+			// break;
+#endif
+
 		default:
 			LOGERROR("The SolverCdclType %c specified is not available!", type);
 			exit(PERR_UNKNOWN_SOLVER);
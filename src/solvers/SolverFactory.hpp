@@ -27,6 +27,19 @@ class SolverFactory
 											char importDbType,
 											std::shared_ptr<SolverInterface>& createdSolver);
 
+	/**
+	 * @brief Creates a solver of the specified type with a given id, the maximum number of solvers is not checked.
+	 * @param type Character representing the solver type.
+	 * @param importDBType Character representing the import database type.
+	 * @param id The id of the solver, used to replace a solver at runtime.
+	 * @param createdSolver Shared pointer to store the created solver.
+	 * @return The algorithm type of the created solver.
+	 */
+	static SolverAlgorithmType createSolver(char type,
+											char importDBType,
+											int id,
+											std::shared_ptr<SolverInterface>& createdSolver);
+
 	/**
 	 * @brief Creates a solver of the specified type and adds it to the appropriate vector.
 	 * @param type Character representing the solver type.
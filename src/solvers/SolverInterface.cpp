@@ -1,9 +1,18 @@
 #include "SolverInterface.hpp"
+#include "containers/FormulaArena.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/System.hpp"
 
 //------------------------------------------------------------------------------
 // Public Member Functions
 //------------------------------------------------------------------------------
 
+void
+SolverInterface::addInitialFormula(const std::shared_ptr<const FormulaArena>& formula)
+{
+	this->addInitialClauses(formula->data(), formula->getClausesCount(), formula->getVariablesCount());
+}
+
 void
 SolverInterface::printWinningLog()
 {
@@ -23,6 +32,31 @@ SolverInterface::printParameters()
 	LOGWARN("printParameters is not implemented");
 }
 
+//------------------------------------------------------------------------------
+// Protected Member Functions
+//------------------------------------------------------------------------------
+
+bool
+SolverInterface::isPhasePublicationDue()
+{
+	if (!this->m_publishedPhases)
+		return false;
+
+	double now = SystemResourceMonitor::getRelativeTimeSeconds();
+	if (now - this->m_lastPhasePublication < __globalParameters__.phaseExchangePeriod / 1000.0)
+		return false;
+
+	this->m_lastPhasePublication = now;
+	return true;
+}
+
+bool
+SolverInterface::readProposedPhases(unsigned int& quality)
+{
+	return this->m_proposedPhases &&
+		   this->m_proposedPhases->read(this->m_phaseBuffer, quality, this->m_proposedPhasesVersion);
+}
+
 //------------------------------------------------------------------------------
 // Constructor & Destructor
 //------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 
 #include "containers/ClauseExchange.hpp"
 #include "containers/ClauseUtils.hpp"
+#include "containers/PhaseSnapshot.hpp"
 #include "utils/Logger.hpp"
 
 #include <atomic>
@@ -19,6 +20,8 @@
 #include <unordered_map>
 #include <vector>
 
+class FormulaArena;
+
 /**
  * @defgroup solving SAT Solvers
  * @ingroup solving
@@ -122,6 +125,12 @@ class SolverInterface
 	 */
 	virtual void addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars) = 0;
 
+	/**
+	 * @brief Add the initial clauses of a shared formula arena, through addInitialClauses by default.
+	 * @param formula The arena, its identity can be used to share data derived from it between solvers.
+	 */
+	virtual void addInitialFormula(const std::shared_ptr<const FormulaArena>& formula);
+
 	/**
 	 * @brief Load formula from a given dimacs file.
 	 * @param filename The name of the file to load from.
@@ -202,6 +211,18 @@ class SolverInterface
 		return (it != s_instanceCounts.end()) ? it->second.load() : 0;
 	}
 
+	/**
+	 * @brief Connect the solver to the phase exchange, before it is launched.
+	 * @param published Snapshot of the best assignment found by the solver, the solver is its only writer.
+	 * @param proposed Snapshot of the phases proposed to the solver, adopted at its next restart.
+	 * @details Solvers not supporting the exchange ignore both snapshots.
+	 */
+	void setPhaseExchange(std::shared_ptr<PhaseSnapshot> published, std::shared_ptr<const PhaseSnapshot> proposed)
+	{
+		this->m_publishedPhases = std::move(published);
+		this->m_proposedPhases = std::move(proposed);
+	}
+
 	/**
 	 * @brief Constructor for SolverInterface.
 	 * @param algoType The algorithm type.
@@ -243,12 +264,31 @@ class SolverInterface
 		LOGDEBUG1("I am solver of type %s: id %d, typeId: %u", typeid(Derived).name(), m_solverId, m_solverTypeId);
 	}
 
+	/**
+	 * @brief Check if the solver may publish its best assignment, at most once per phase exchange period.
+	 * @return True if the solver is connected to the phase exchange and the period elapsed since its last publication.
+	 */
+	bool isPhasePublicationDue();
+
+	/**
+	 * @brief Read the proposed phases if they changed since the last call, from the thread of the solver.
+	 * @param quality Set to the quality of the proposed assignment.
+	 * @return True if m_phaseBuffer holds new phases, m_phaseBuffer[var] for var in [1, m_phaseBuffer.size()).
+	 */
+	bool readProposedPhases(unsigned int& quality);
+
   protected:
 	SolverAlgorithmType m_algoType;	 /**< Algorithm family of this solver. */
 	std::atomic<bool> m_initialized; /**< Initialization status. */
 	unsigned int m_solverTypeId;	 /**< ID local to the solver type. */
 	int m_solverId;					 /**< Main ID of the solver. */
 
+	std::shared_ptr<PhaseSnapshot> m_publishedPhases;	   /**< Best assignment, null if not connected. */
+	std::shared_ptr<const PhaseSnapshot> m_proposedPhases; /**< Phases proposed by the phase exchange. */
+	uint64_t m_proposedPhasesVersion = 0;				   /**< Version of the last proposed phases read. */
+	std::vector<char> m_phaseBuffer;					   /**< Last proposed phases read. */
+	double m_lastPhasePublication = 0;					   /**< Time of the last publication. */
+
 	/**
 	 * @brief Number of existing instances of derived classes.
 	 */
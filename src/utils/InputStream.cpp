@@ -0,0 +1,404 @@
+#include "utils/InputStream.hpp"
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Parsers {
+
+/// Detect the compression from the first bytes of a file
+static InputStream::Compression
+detectCompression(const unsigned char* magic, size_t size)
+{
+	if (size >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+		return InputStream::Compression::GZIP;
+	if (size >= 6 && !memcmp(magic, "\xfd" "7zXZ\0", 6))
+		return InputStream::Compression::XZ;
+	if (size >= 3 && !memcmp(magic, "BZh", 3))
+		return InputStream::Compression::BZIP2;
+	if (size >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+		return InputStream::Compression::ZSTD;
+	return InputStream::Compression::NONE;
+}
+
+std::unique_ptr<InputStream>
+InputStream::open(const char* filename)
+{
+	int fd = ::open(filename, O_RDONLY);
+	if (fd < 0) {
+		LOGERROR("Couldn't open file: %s (%s)", filename, strerror(errno));
+		return nullptr;
+	}
+
+	unsigned char magic[6];
+	ssize_t magicSize = pread(fd, magic, sizeof(magic), 0);
+	if (magicSize < 0) {
+		LOGERROR("Couldn't read file: %s (%s)", filename, strerror(errno));
+		close(fd);
+		return nullptr;
+	}
+
+	std::unique_ptr<InputStream> stream(new InputStream(filename, detectCompression(magic, magicSize)));
+
+	if (!stream->openSource(fd))
+		return nullptr;
+
+	if (stream->m_compression != Compression::NONE)
+		LOG1("Reading %s compressed input %s", stream->getCompressionName(), filename);
+
+	stream->m_reader = std::thread(&InputStream::readerLoop, stream.get());
+	return stream;
+}
+
+InputStream::InputStream(const char* filename, Compression compression)
+	: m_filename(filename)
+	, m_compression(compression)
+	, m_chunks(CHUNK_COUNT, std::vector<char>(CHUNK_SIZE))
+{
+	for (size_t i = 0; i < CHUNK_COUNT; i++)
+		m_free.push_back(i);
+}
+
+InputStream::~InputStream()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_freeCond.notify_all();
+
+	if (m_reader.joinable())
+		m_reader.join();
+
+	closeSource();
+}
+
+const char*
+InputStream::getCompressionName() const
+{
+	switch (m_compression) {
+		case Compression::NONE:
+			return "plain";
+		case Compression::GZIP:
+			return "gzip";
+		case Compression::XZ:
+			return "xz";
+		case Compression::BZIP2:
+			return "bzip2";
+		case Compression::ZSTD:
+			return "zstd";
+	}
+	return "unknown";
+}
+
+bool
+InputStream::openSource(int fd)
+{
+	switch (m_compression) {
+		case Compression::NONE:
+			m_fd = fd;
+			posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+			return true;
+
+		case Compression::GZIP:
+			m_gzFile = gzdopen(fd, "rb");
+			if (!m_gzFile) {
+				LOGERROR("Couldn't initialize zlib on %s", m_filename.c_str());
+				close(fd);
+				return false;
+			}
+			gzbuffer(m_gzFile, CHUNK_SIZE);
+			return true;
+
+		case Compression::XZ:
+			// The file may hold several concatenated streams, as written by pxz
+			if (lzma_stream_decoder(&m_lzma, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+				LOGERROR("Couldn't initialize liblzma on %s", m_filename.c_str());
+				close(fd);
+				return false;
+			}
+			break;
+
+		case Compression::BZIP2:
+			if (BZ2_bzDecompressInit(&m_bzip, 0, 0) != BZ_OK) {
+				LOGERROR("Couldn't initialize libbz2 on %s", m_filename.c_str());
+				close(fd);
+				return false;
+			}
+			break;
+
+		case Compression::ZSTD:
+			// The frames following the first one are decoded by the same stream
+			m_zstd = ZSTD_createDStream();
+			if (!m_zstd || ZSTD_isError(ZSTD_initDStream(m_zstd))) {
+				LOGERROR("Couldn't initialize libzstd on %s", m_filename.c_str());
+				ZSTD_freeDStream(m_zstd);
+				m_zstd = nullptr;
+				close(fd);
+				return false;
+			}
+			break;
+	}
+
+	m_fd = fd;
+	m_decoding = true;
+	m_compressed.resize(CHUNK_SIZE);
+	posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	return true;
+}
+
+long
+InputStream::readSource(char* buffer, size_t size)
+{
+	if (m_gzFile) {
+		int bytes = gzread(m_gzFile, buffer, size);
+		int errnum = Z_OK;
+		const char* message = gzerror(m_gzFile, &errnum);
+		// A truncated file ends with Z_BUF_ERROR
+		if (bytes < 0 || (bytes == 0 && errnum != Z_OK && errnum != Z_STREAM_END)) {
+			LOGERROR("zlib error on %s: %s", m_filename.c_str(), message);
+			return -1;
+		}
+		return bytes;
+	}
+
+	if (m_decoding)
+		return decodeSource(buffer, size);
+
+	// Fill the whole buffer, read may return less than asked
+	size_t total = 0;
+	while (total < size) {
+		ssize_t bytes = ::read(m_fd, buffer + total, size - total);
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			LOGERROR("Read error on %s: %s", m_filename.c_str(), strerror(errno));
+			return -1;
+		}
+		if (bytes == 0)
+			break;
+		total += bytes;
+	}
+	return total;
+}
+
+long
+InputStream::decodeSource(char* buffer, size_t size)
+{
+	const bool xz = (m_compression == Compression::XZ);
+	const bool zstd = (m_compression == Compression::ZSTD);
+	size_t total = 0;
+
+	while (total < size && !m_decoded) {
+		if (!pendingInput() && !m_inputEnded) {
+			ssize_t bytes = ::read(m_fd, m_compressed.data(), m_compressed.size());
+			if (bytes < 0) {
+				if (errno == EINTR)
+					continue;
+				LOGERROR("Read error on %s: %s", m_filename.c_str(), strerror(errno));
+				return -1;
+			}
+			m_inputEnded = (bytes == 0);
+			if (xz) {
+				m_lzma.next_in = reinterpret_cast<const uint8_t*>(m_compressed.data());
+				m_lzma.avail_in = bytes;
+			} else if (zstd) {
+				m_zstdIn = { m_compressed.data(), static_cast<size_t>(bytes), 0 };
+			} else {
+				m_bzip.next_in = m_compressed.data();
+				m_bzip.avail_in = bytes;
+			}
+		}
+
+		// The end of the file after a bzip2 stream or a zstd frame
+		if (m_streamEnded && m_inputEnded && !pendingInput()) {
+			m_decoded = true;
+			break;
+		}
+
+		if (xz) {
+			m_lzma.next_out = reinterpret_cast<uint8_t*>(buffer + total);
+			m_lzma.avail_out = size - total;
+
+			lzma_ret ret = lzma_code(&m_lzma, m_inputEnded ? LZMA_FINISH : LZMA_RUN);
+			total = size - m_lzma.avail_out;
+
+			if (ret == LZMA_STREAM_END)
+				m_decoded = true;
+			else if (ret == LZMA_BUF_ERROR) {
+				LOGERROR("liblzma error on %s: unexpected end of file", m_filename.c_str());
+				return -1;
+			} else if (ret != LZMA_OK) {
+				LOGERROR("liblzma error %d on %s", ret, m_filename.c_str());
+				return -1;
+			}
+		} else if (zstd) {
+			size_t before = total;
+			ZSTD_outBuffer out = { buffer, size, total };
+
+			// 0 once a frame is decoded and flushed, the file may hold several frames as written by pzstd
+			size_t ret = ZSTD_decompressStream(m_zstd, &out, &m_zstdIn);
+			total = out.pos;
+
+			if (ZSTD_isError(ret)) {
+				LOGERROR("libzstd error on %s: %s", m_filename.c_str(), ZSTD_getErrorName(ret));
+				return -1;
+			}
+			m_streamEnded = (ret == 0);
+			if (!m_streamEnded && m_inputEnded && !pendingInput() && total == before) {
+				LOGERROR("libzstd error on %s: unexpected end of file", m_filename.c_str());
+				return -1;
+			}
+		} else {
+			size_t before = total;
+			m_bzip.next_out = buffer + total;
+			m_bzip.avail_out = size - total;
+
+			int ret = BZ2_bzDecompress(&m_bzip);
+			total = size - m_bzip.avail_out;
+			m_streamEnded = false;
+
+			if (ret == BZ_STREAM_END) {
+				// The file may hold several concatenated streams, as written by pbzip2
+				char* pendingIn = m_bzip.next_in;
+				unsigned int pendingCount = m_bzip.avail_in;
+				BZ2_bzDecompressEnd(&m_bzip);
+				m_bzip = bz_stream{};
+				if (BZ2_bzDecompressInit(&m_bzip, 0, 0) != BZ_OK) {
+					LOGERROR("Couldn't initialize libbz2 on %s", m_filename.c_str());
+					m_decoding = false;
+					return -1;
+				}
+				m_bzip.next_in = pendingIn;
+				m_bzip.avail_in = pendingCount;
+				m_streamEnded = true;
+			} else if (ret != BZ_OK) {
+				LOGERROR("libbz2 error %d on %s", ret, m_filename.c_str());
+				return -1;
+			} else if (m_inputEnded && !m_bzip.avail_in && total == before) {
+				LOGERROR("libbz2 error on %s: unexpected end of file", m_filename.c_str());
+				return -1;
+			}
+		}
+	}
+
+	return total;
+}
+
+size_t
+InputStream::pendingInput() const
+{
+	switch (m_compression) {
+		case Compression::XZ:
+			return m_lzma.avail_in;
+		case Compression::BZIP2:
+			return m_bzip.avail_in;
+		case Compression::ZSTD:
+			return m_zstdIn.size - m_zstdIn.pos;
+		default:
+			return 0;
+	}
+}
+
+void
+InputStream::closeSource()
+{
+	if (m_decoding) {
+		if (m_compression == Compression::XZ)
+			lzma_end(&m_lzma);
+		else if (m_compression == Compression::ZSTD)
+			ZSTD_freeDStream(m_zstd);
+		else
+			BZ2_bzDecompressEnd(&m_bzip);
+		m_zstd = nullptr;
+		m_decoding = false;
+	}
+
+	if (m_gzFile) {
+		gzclose(m_gzFile);
+		m_gzFile = nullptr;
+	}
+
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+}
+
+void
+InputStream::readerLoop()
+{
+	while (true) {
+		size_t idx;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_freeCond.wait(lock, [this] { return m_stop || !m_free.empty(); });
+			if (m_stop)
+				return;
+			idx = m_free.front();
+			m_free.pop_front();
+		}
+
+		long bytes = readSource(m_chunks[idx].data(), CHUNK_SIZE);
+
+		if (bytes <= 0) {
+			m_failed = bytes < 0;
+			bytes = 0;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_filled.emplace_back(idx, bytes);
+		}
+		m_filledCond.notify_one();
+
+		if (!bytes)
+			return;
+	}
+}
+
+bool
+InputStream::nextChunk()
+{
+	if (m_ended)
+		return false;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (m_chunkIdx < CHUNK_COUNT) {
+		m_free.push_back(m_chunkIdx);
+		m_freeCond.notify_one();
+	}
+
+	m_filledCond.wait(lock, [this] { return !m_filled.empty(); });
+	auto [idx, len] = m_filled.front();
+	m_filled.pop_front();
+
+	m_chunkIdx = idx;
+	m_chunk = m_chunks[idx].data();
+	m_pos = 0;
+	m_len = len;
+	m_ended = (len == 0);
+
+	return !m_ended;
+}
+
+size_t
+InputStream::read(char* buffer, size_t size)
+{
+	size_t total = 0;
+	while (total < size) {
+		if (m_pos == m_len && !nextChunk())
+			break;
+		size_t count = std::min(size - total, m_len - m_pos);
+		memcpy(buffer + total, m_chunk + m_pos, count);
+		m_pos += count;
+		total += count;
+	}
+	return total;
+}
+
+} // namespace Parsers
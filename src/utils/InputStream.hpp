@@ -0,0 +1,166 @@
+/**
+ * @file InputStream.hpp
+ * @brief Buffered, possibly compressed, input of the CNF parsers.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bzlib.h>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <lzma.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+#include <zstd.h>
+
+namespace Parsers {
+
+/**
+ * @brief Sequential input stream over a plain or compressed file.
+ *
+ * The compression is detected from the magic bytes of the file, not from its extension:
+ * gzip, xz, bzip2 and zstd are decompressed in-process with zlib, liblzma, libbz2 and libzstd.
+ *
+ * A reader thread fills a ring of chunks while the parser consumes the previous ones, so that reading and decompression
+ * overlap with parsing.
+ * @ingroup utils
+ */
+class InputStream
+{
+  public:
+	enum class Compression
+	{
+		NONE,
+		GZIP,
+		XZ,
+		BZIP2,
+		ZSTD
+	};
+
+	/**
+	 * @brief Open a file and start its reader thread.
+	 * @param filename The path to the file.
+	 * @return The stream, or nullptr if the file cannot be opened or its decompressor cannot be initialized.
+	 */
+	static std::unique_ptr<InputStream> open(const char* filename);
+
+	~InputStream();
+
+	InputStream(const InputStream&) = delete;
+	InputStream& operator=(const InputStream&) = delete;
+
+	/**
+	 * @brief Read the next character.
+	 * @return The character as an unsigned char, or EOF.
+	 */
+	inline int get()
+	{
+		if (m_pos < m_len || nextChunk())
+			return (unsigned char)m_chunk[m_pos++];
+		return EOF;
+	}
+
+	/**
+	 * @brief Put back the character returned by the last get(), like ungetc. EOF is ignored.
+	 */
+	inline void unget(int c)
+	{
+		if (c != EOF && m_pos > 0)
+			m_pos--;
+	}
+
+	/**
+	 * @brief Read up to size characters.
+	 * @return The number of characters read, less than size only at the end of the stream.
+	 */
+	size_t read(char* buffer, size_t size);
+
+	/// True if reading or decompressing failed, the stream then ends early.
+	bool hasFailed() const { return m_failed; }
+
+	Compression getCompression() const { return m_compression; }
+
+	/// Printable name of the compression.
+	const char* getCompressionName() const;
+
+  private:
+	InputStream(const char* filename, Compression compression);
+
+	/// Open the source, returns false on error
+	bool openSource(int fd);
+
+	/// Fill buffer from the source, returns the number of bytes read, 0 at the end, -1 on error
+	long readSource(char* buffer, size_t size);
+
+	/// readSource for xz, bzip2 and zstd, the compressed bytes are read from m_fd
+	long decodeSource(char* buffer, size_t size);
+
+	/// Compressed bytes read from m_fd but not yet given to the decoder
+	size_t pendingInput() const;
+
+	/// Close the source
+	void closeSource();
+
+	/// Reader thread loop.
+	void readerLoop();
+
+	/// Release the current chunk and wait for the next one, returns false at the end of the stream.
+	bool nextChunk();
+
+	/// Size of a chunk.
+	static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+	/// Number of chunks, one is parsed while the others are filled.
+	static constexpr size_t CHUNK_COUNT = 4;
+
+	std::string m_filename;
+
+	Compression m_compression;
+
+	/// Source, depending on the compression
+	int m_fd = -1;
+	gzFile m_gzFile = nullptr;
+
+	/// Decoders of xz, bzip2 and zstd, fed with m_compressed
+	lzma_stream m_lzma = LZMA_STREAM_INIT;
+	bz_stream m_bzip{};
+	ZSTD_DStream* m_zstd = nullptr;
+	ZSTD_inBuffer m_zstdIn{};
+	bool m_decoding = false;
+	bool m_decoded = false;		///< The last stream of the file was decoded
+	bool m_streamEnded = false; ///< A bzip2 stream or a zstd frame ended, another one may follow
+	bool m_inputEnded = false;
+	std::vector<char> m_compressed;
+
+	std::vector<std::vector<char>> m_chunks;
+
+	/// Ready chunks (index, length), a length of 0 ends the stream
+	std::deque<std::pair<size_t, size_t>> m_filled;
+
+	/// Chunks available to the reader
+	std::deque<size_t> m_free;
+
+	std::mutex m_mutex;
+	std::condition_variable m_filledCond;
+	std::condition_variable m_freeCond;
+
+	/// Current chunk of the parser
+	const char* m_chunk = nullptr;
+	size_t m_chunkIdx = CHUNK_COUNT;
+	size_t m_pos = 0;
+	size_t m_len = 0;
+	bool m_ended = false;
+
+	bool m_stop = false;
+	std::atomic<bool> m_failed = false;
+
+	std::thread m_reader;
+};
+
+} // namespace Parsers
@@ -1,6 +1,7 @@
 #include "MpiUtils.hpp"
 #include "Logger.hpp"
 #include "containers/SimpleTypes.hpp"
+#include "Parameters.hpp"
 #include "painless.hpp"
 #include <mpi.h>
 
@@ -8,8 +9,8 @@
 #include <numeric>
 #include <vector>
 
+#include <climits>
 #include <cstring>
-#include <zlib.h>
 
 int mpi_rank = -1;
 int mpi_world_size = -1;
@@ -17,41 +18,6 @@ int mpi_winner = -1;
 
 namespace mpiutils {
 
-// Helper function for compression
-static std::vector<unsigned char>
-compressBuffer(const std::vector<int>& input)
-{
-	std::vector<unsigned char> output;
-	unsigned long compressedSize = compressBound(input.size() * sizeof(int));
-	output.resize(compressedSize);
-
-	if (compress2(output.data(),
-				  &compressedSize,
-				  reinterpret_cast<const unsigned char*>(input.data()),
-				  input.size() * sizeof(int),
-				  Z_BEST_SPEED) != Z_OK) {
-		throw std::runtime_error("Compression failed");
-	}
-
-	output.resize(compressedSize);
-	return output;
-}
-
-// Helper function for decompression
-static std::vector<int>
-decompressBuffer(const std::vector<unsigned char>& input, size_t originalSize)
-{
-	std::vector<int> output(originalSize / sizeof(int));
-	unsigned long decompressedSize = originalSize;
-
-	if (uncompress(reinterpret_cast<unsigned char*>(output.data()), &decompressedSize, input.data(), input.size()) !=
-		Z_OK) {
-		throw std::runtime_error("Decompression failed");
-	}
-
-	return output;
-}
-
 bool
 serializeClauses(const std::vector<simpleClause>& clauses, std::vector<int>& serializedClauses)
 {
@@ -102,127 +68,459 @@ deserializeClauses(const std::vector<int>& serializedClauses, std::vector<simple
 	return true;
 }
 
-bool
-sendFormula(simpleClause& serializedClauses, unsigned int* clsCount, unsigned int* varCount, int rootRank)
+//==============================
+// Compact clause encoding
+//==============================
+
+static inline uint32_t
+zigzag(int lit)
 {
-	// Broadcast varCount
-	TESTRUNMPI(MPI_Bcast(varCount, 1, MPI_UNSIGNED, rootRank, MPI_COMM_WORLD));
-	// Broadcast clsCount
-	TESTRUNMPI(MPI_Bcast(clsCount, 1, MPI_UNSIGNED, rootRank, MPI_COMM_WORLD));
+	return (static_cast<uint32_t>(lit) << 1) ^ static_cast<uint32_t>(lit >> 31);
+}
 
-	LOGDEBUG1("VarCount = %u, ClsCount = %u", *varCount, *clsCount);
-	std::vector<unsigned char> compressedBuffer;
-	int64_t originalSize = 0;
-	int64_t compressedSize = 0;
+static inline int
+unzigzag(uint32_t code)
+{
+	return static_cast<int>(code >> 1) ^ -static_cast<int>(code & 1);
+}
 
-	if (mpi_rank == rootRank) {
-		LOGDEBUG1("Root clauses number: %u", *clsCount);
-
-		originalSize = static_cast<int64_t>(serializedClauses.size() * sizeof(int));
-		try {
-			compressedBuffer = compressBuffer(serializedClauses);
-			compressedSize = static_cast<int64_t>(compressedBuffer.size());
-		} catch (const std::exception& e) {
-			LOGERROR("Compression failed: %s", e.what());
-			originalSize = -1; // Use as error flag
+static inline uint8_t*
+writeVarint(uint8_t* out, uint32_t value)
+{
+	while (value >= 0x80) {
+		*out++ = static_cast<uint8_t>(value) | 0x80;
+		value >>= 7;
+	}
+	*out++ = static_cast<uint8_t>(value);
+	return out;
+}
+
+// Returns nullptr if the varint is truncated or longer than 5 bytes
+static inline const uint8_t*
+readVarint(const uint8_t* in, const uint8_t* end, uint32_t& value)
+{
+	value = 0;
+	for (unsigned int shift = 0; in < end && shift < 35; shift += 7) {
+		uint8_t byte = *in++;
+		value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return in;
+	}
+	return nullptr;
+}
+
+// Decodes the gaps of the count literals of a clause. The gaps of one byte, the most frequent ones, are read eight at a
+// time from a 64 bits word: the lowest continuation bit gives the number of leading single byte gaps.
+static inline const uint8_t*
+decodeLiterals(const uint8_t* in, const uint8_t* end, uint32_t count, int* out)
+{
+	uint32_t code = 0;
+	uint32_t gap;
+	uint32_t i = 0;
+
+	while (i < count) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		if (count - i >= 8 && end - in >= 8) {
+			uint64_t word;
+			std::memcpy(&word, in, sizeof(word));
+			uint64_t continuations = word & 0x8080808080808080ULL;
+			unsigned int singles = continuations ? __builtin_ctzll(continuations) >> 3 : 8;
+			for (unsigned int k = 0; k < singles; k++) {
+				code += static_cast<uint32_t>(word >> (8 * k)) & 0x7F;
+				out[i++] = unzigzag(code);
+			}
+			in += singles;
+			if (singles == 8)
+				continue;
 		}
+#endif
+		if (!(in = readVarint(in, end, gap)))
+			return nullptr;
+		code += gap;
+		out[i++] = unzigzag(code);
 	}
+	return in;
+}
+
+// Writes the zigzag codes of the literals of a clause, sorted, as the varints of their gaps
+static inline uint8_t*
+encodeLiterals(uint8_t* out, const int* literals, unsigned int size, std::vector<uint32_t>& codes)
+{
+	codes.resize(size);
+	std::transform(literals, literals + size, codes.begin(), zigzag);
+	std::sort(codes.begin(), codes.end());
+
+	uint32_t previous = 0;
+	for (uint32_t code : codes) {
+		out = writeVarint(out, code - previous);
+		previous = code;
+	}
+	return out;
+}
+
+size_t
+encodeClauses(const int* data, size_t count, std::vector<uint8_t>& encoded)
+{
+	size_t literals = 0;
+	size_t start = encoded.size();
+	std::vector<uint32_t> codes;
+
+	// At most 5 bytes per integer, and a clause count per clause (at least 3 integers each)
+	encoded.resize(start + 1 + 7 * count);
+	uint8_t* out = encoded.data() + start;
+	*out++ = CLAUSE_CODEC_VERSION;
+
+	size_t i = 0;
+	while (i + 2 <= count && data[i] > 0) {
+		int size = data[i];
+		int lbd = data[i + 1];
+
+		// Consecutive clauses with the same size and lbd share a header
+		size_t groupEnd = i;
+		uint32_t clauses = 0;
+		while (groupEnd + 2 + size <= count && data[groupEnd] == size && data[groupEnd + 1] == lbd) {
+			groupEnd += 2 + size;
+			clauses++;
+		}
+		if (!clauses) {
+			LOGERROR("Encoding error: Incomplete clause data");
+			break;
+		}
 
-	// Broadcast the original size (or error flag)
-	TESTRUNMPI(MPI_Bcast(&originalSize, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
+		out = writeVarint(out, size);
+		out = writeVarint(out, lbd);
+		out = writeVarint(out, clauses);
 
-	if (originalSize == -1) {
-		LOGERROR("Root failed to serialize or compress clauses");
+		for (; i < groupEnd; i += 2 + size)
+			out = encodeLiterals(out, data + i + 2, size, codes);
+		literals += static_cast<size_t>(clauses) * size;
+	}
+
+	encoded.resize(out - encoded.data());
+	return literals;
+}
+
+bool
+decodeClauses(const uint8_t* data, size_t count, std::vector<int>& serializedClauses)
+{
+	const uint8_t* in = data;
+	const uint8_t* end = data + count;
+	uint32_t size, lbd, clauses;
+
+	if (!count || *in++ != CLAUSE_CODEC_VERSION) {
+		LOGERROR("Decoding error: Unknown clause encoding version %d", count ? data[0] : -1);
 		return false;
 	}
 
-	// Broadcast the compressed size
-	TESTRUNMPI(MPI_Bcast(&compressedSize, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
+	while (in < end) {
+		if (!(in = readVarint(in, end, size)) || !(in = readVarint(in, end, lbd)) ||
+			!(in = readVarint(in, end, clauses)) || !size ||
+			static_cast<uint64_t>(size) * clauses > static_cast<uint64_t>(end - in)) {
+			LOGERROR("Decoding error: Invalid group header");
+			return false;
+		}
 
-	// Resize buffer for non-root processes
-	if (mpi_rank != rootRank) {
-		compressedBuffer.resize(compressedSize);
-		LOGDEBUG1("Data to transfer: %ld bytes (compressed from %ld bytes)", compressedSize, originalSize);
+		size_t position = serializedClauses.size();
+		serializedClauses.resize(position + static_cast<size_t>(clauses) * (2 + size));
+		int* out = serializedClauses.data() + position;
+
+		for (uint32_t c = 0; c < clauses; c++) {
+			*out++ = size;
+			*out++ = lbd;
+			if (!(in = decodeLiterals(in, end, size, out))) {
+				LOGERROR("Decoding error: Incomplete clause data");
+				serializedClauses.resize(position);
+				return false;
+			}
+			out += size;
+		}
 	}
 
-	// Broadcast the compressed data
-	TESTRUNMPI(MPI_Bcast(compressedBuffer.data(), compressedSize, MPI_UNSIGNED_CHAR, rootRank, MPI_COMM_WORLD));
+	return true;
+}
 
-	if (mpi_rank != rootRank) {
-		try {
-			serializedClauses = decompressBuffer(compressedBuffer, originalSize);
-		} catch (const std::exception& e) {
-			LOGERROR("Decompression failed: %s", e.what());
+size_t
+encodeFormula(const int* literals, size_t count, std::vector<uint8_t>& encoded)
+{
+	// Groups are bounded to keep the worst case reserved for a group small
+	const uint32_t maxGroupClauses = 4096;
+	size_t clauses = 0;
+	size_t position = encoded.size();
+	std::vector<uint32_t> codes;
+
+	encoded.resize(position + 1);
+	encoded[position++] = CLAUSE_CODEC_VERSION;
+
+	size_t i = 0;
+	while (i < count) {
+		size_t size = std::find(literals + i, literals + count, 0) - (literals + i);
+		if (i + size == count) {
+			LOGERROR("Encoding error: The last clause is not terminated");
+			break;
+		}
+
+		// Consecutive clauses with the same size share a header
+		size_t groupEnd = i + size + 1;
+		uint32_t groupClauses = 1;
+		while (groupClauses < maxGroupClauses && groupEnd + size < count &&
+			   std::find(literals + groupEnd, literals + groupEnd + size + 1, 0) == literals + groupEnd + size) {
+			groupEnd += size + 1;
+			groupClauses++;
+		}
+
+		// At most 5 bytes per literal and per header varint
+		size_t needed = position + 10 + 5 * (groupEnd - i);
+		if (needed > encoded.size())
+			encoded.resize(std::max(2 * encoded.size(), needed));
+		uint8_t* out = encoded.data() + position;
+
+		out = writeVarint(out, size);
+		out = writeVarint(out, groupClauses);
+		for (; i < groupEnd; i += size + 1)
+			out = encodeLiterals(out, literals + i, size, codes);
+
+		position = out - encoded.data();
+		clauses += groupClauses;
+	}
+
+	encoded.resize(position);
+	return clauses;
+}
+
+bool
+decodeFormula(const uint8_t* data, size_t count, std::vector<int>& literals)
+{
+	const uint8_t* in = data;
+	const uint8_t* end = data + count;
+	uint32_t size, clauses;
+
+	if (!count || *in++ != CLAUSE_CODEC_VERSION) {
+		LOGERROR("Decoding error: Unknown formula encoding version %d", count ? data[0] : -1);
+		return false;
+	}
+
+	while (in < end) {
+		if (!(in = readVarint(in, end, size)) || !(in = readVarint(in, end, clauses)) ||
+			static_cast<uint64_t>(size) * clauses > static_cast<uint64_t>(end - in)) {
+			LOGERROR("Decoding error: Invalid group header");
 			return false;
 		}
+
+		size_t position = literals.size();
+		literals.resize(position + static_cast<size_t>(clauses) * (size + 1));
+		int* out = literals.data() + position;
+
+		for (uint32_t c = 0; c < clauses; c++) {
+			if (!(in = decodeLiterals(in, end, size, out))) {
+				LOGERROR("Decoding error: Incomplete clause data");
+				literals.resize(position);
+				return false;
+			}
+			out += size;
+			*out++ = 0;
+		}
 	}
 
 	return true;
 }
 
-bool
-sendFormula(std::vector<simpleClause>& clauses, unsigned int* varCount, int rootRank)
+//==============================
+// Formula broadcast
+//==============================
+
+// End of the chunk starting at begin: the first clause end after chunkSize literals
+static size_t
+nextChunkEnd(const simpleClause& literals, size_t begin, size_t chunkSize)
 {
-	// Broadcast varCount
-	TESTRUNMPI(MPI_Bcast(varCount, 1, MPI_UNSIGNED, rootRank, MPI_COMM_WORLD));
+	size_t end = std::min(begin + chunkSize, literals.size());
+	while (end < literals.size() && literals[end - 1] != 0)
+		end++;
+	return end;
+}
 
-	LOGDEBUG1("VarCount = %u", *varCount);
+// Root: encodes the chunk [begin, end) in a slot, its last 8 bytes are left for the size of the next chunk
+static int64_t
+encodeChunk(const simpleClause& literals, size_t begin, size_t end, std::vector<uint8_t>& slot)
+{
+	slot.clear();
+	if (begin < end)
+		encodeFormula(literals.data() + begin, end - begin, slot);
+	int64_t size = slot.size();
+	slot.resize(slot.size() + sizeof(int64_t));
+	return size;
+}
 
-	std::vector<int> serializedClauses;
-	std::vector<unsigned char> compressedBuffer;
-	int64_t originalSize = 0;
-	int64_t compressedSize = 0;
+// Chunked pipeline: the root encodes chunk i+1 while chunk i is broadcast, the others decode chunk i while chunk i+1
+// is received. Each chunk carries the encoded size of the next one (0 after the last), so that a receiver can post the
+// broadcast of the next chunk before decoding the current one.
+static bool
+pipelineFormula(simpleClause& literals, int rootRank)
+{
+	const size_t chunkSize = std::max(1, __globalParameters__.formulaChunk);
+	int64_t size = 0;
+	int64_t next = 0;
+	size_t chunks = 0;
+	size_t bytes = 0;
+	bool decoded = true;
 
 	if (mpi_rank == rootRank) {
-		LOGDEBUG1("Root clauses number: %u", clauses.size());
-		// Serialize clauses
-		if (!serializeClauses(clauses, serializedClauses)) {
-			LOGERROR("Error serializing clauses");
-			originalSize = -1; // Use as error flag
-		} else {
-			originalSize = static_cast<int64_t>(serializedClauses.size() * sizeof(int));
-			try {
-				compressedBuffer = compressBuffer(serializedClauses);
-				compressedSize = static_cast<int64_t>(compressedBuffer.size());
-			} catch (const std::exception& e) {
-				LOGERROR("Compression failed: %s", e.what());
-				originalSize = -1; // Use as error flag
+		// Three slots: one broadcast, one posted, one encoded ahead
+		std::vector<uint8_t> slots[3];
+		MPI_Request requests[3] = { MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL };
+
+		size_t begin = 0;
+		size_t end = nextChunkEnd(literals, begin, chunkSize);
+		size = encodeChunk(literals, begin, end, slots[0]);
+		TESTRUNMPI(MPI_Bcast(&size, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
+
+		for (unsigned int k = 0; size > 0; k++) {
+			std::vector<uint8_t>& current = slots[k % 3];
+			std::vector<uint8_t>& following = slots[(k + 1) % 3];
+
+			// The slot of the next chunk was broadcast two chunks ago
+			TESTRUNMPI(MPI_Wait(&requests[(k + 1) % 3], MPI_STATUS_IGNORE));
+			begin = end;
+			end = nextChunkEnd(literals, begin, chunkSize);
+			next = encodeChunk(literals, begin, end, following);
+
+			std::memcpy(current.data() + size, &next, sizeof(int64_t));
+			TESTRUNMPI(MPI_Ibcast(
+				current.data(), size + sizeof(int64_t), MPI_BYTE, rootRank, MPI_COMM_WORLD, &requests[k % 3]));
+			chunks++;
+			bytes += size;
+			size = next;
+		}
+
+		TESTRUNMPI(MPI_Waitall(3, requests, MPI_STATUSES_IGNORE));
+	} else {
+		std::vector<uint8_t> slots[2];
+		MPI_Request request = MPI_REQUEST_NULL;
+
+		literals.clear();
+		TESTRUNMPI(MPI_Bcast(&size, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
+		if (size > 0) {
+			slots[0].resize(size + sizeof(int64_t));
+			TESTRUNMPI(MPI_Ibcast(slots[0].data(), slots[0].size(), MPI_BYTE, rootRank, MPI_COMM_WORLD, &request));
+		}
+
+		for (unsigned int k = 0; size > 0; k++) {
+			std::vector<uint8_t>& current = slots[k % 2];
+			std::vector<uint8_t>& following = slots[(k + 1) % 2];
+
+			TESTRUNMPI(MPI_Wait(&request, MPI_STATUS_IGNORE));
+			std::memcpy(&next, current.data() + size, sizeof(int64_t));
+
+			if (next > 0) {
+				following.resize(next + sizeof(int64_t));
+				TESTRUNMPI(
+					MPI_Ibcast(following.data(), following.size(), MPI_BYTE, rootRank, MPI_COMM_WORLD, &request));
 			}
+
+			// A decoding error is reported once all the chunks are received, the broadcasts must be completed
+			decoded = decoded && decodeFormula(current.data(), size, literals);
+			chunks++;
+			bytes += size;
+			size = next;
 		}
 	}
 
-	// Broadcast the original size (or error flag)
-	TESTRUNMPI(MPI_Bcast(&originalSize, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
+	LOG1("Formula broadcast in %zu chunks, %zu encoded bytes", chunks, bytes);
+	return decoded;
+}
 
-	if (originalSize == -1) {
-		LOGERROR("Root failed to serialize or compress clauses");
-		return false;
+// Scatter then allgather: each process receives a piece of the encoded formula from the root, then the pieces are
+// gathered by all. The volume sent by the root does not grow with the number of processes.
+static bool
+scatterAllgatherFormula(simpleClause& literals, int rootRank)
+{
+	std::vector<uint8_t> encoded;
+	int64_t size = 0;
+
+	if (mpi_rank == rootRank) {
+		encodeFormula(literals.data(), literals.size(), encoded);
+		size = encoded.size();
 	}
+	TESTRUNMPI(MPI_Bcast(&size, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
 
-	// Broadcast the compressed size
-	TESTRUNMPI(MPI_Bcast(&compressedSize, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
+	int64_t piece = (size + mpi_world_size - 1) / mpi_world_size;
+	if (piece > INT_MAX) {
+		LOGWARN("The pieces of the formula exceed the MPI counts, the chunked broadcast is used");
+		return pipelineFormula(literals, rootRank);
+	}
 
-	// Resize buffer for non-root processes
-	if (mpi_rank != rootRank) {
-		compressedBuffer.resize(compressedSize);
-		LOGDEBUG1("Data to transfer: %ld bytes (compressed from %ld bytes)", compressedSize, originalSize);
+	std::vector<int> counts(mpi_world_size);
+	std::vector<int> displacements(mpi_world_size);
+	for (int r = 0; r < mpi_world_size; r++) {
+		displacements[r] = std::min(size, r * piece);
+		counts[r] = std::min(size, (r + 1) * piece) - displacements[r];
 	}
 
-	// Broadcast the compressed data
-	TESTRUNMPI(MPI_Bcast(compressedBuffer.data(), compressedSize, MPI_UNSIGNED_CHAR, rootRank, MPI_COMM_WORLD));
+	encoded.resize(size);
+	uint8_t* myPiece = encoded.data() + displacements[mpi_rank];
+	TESTRUNMPI(MPI_Scatterv(encoded.data(),
+							counts.data(),
+							displacements.data(),
+							MPI_BYTE,
+							mpi_rank == rootRank ? MPI_IN_PLACE : myPiece,
+							counts[mpi_rank],
+							MPI_BYTE,
+							rootRank,
+							MPI_COMM_WORLD));
+	TESTRUNMPI(MPI_Allgatherv(
+		MPI_IN_PLACE, 0, MPI_BYTE, encoded.data(), counts.data(), displacements.data(), MPI_BYTE, MPI_COMM_WORLD));
+
+	LOG1("Formula scattered and gathered in %ld encoded bytes", size);
 
 	if (mpi_rank != rootRank) {
-		try {
-			serializedClauses = decompressBuffer(compressedBuffer, originalSize);
-		} catch (const std::exception& e) {
-			LOGERROR("Decompression failed: %s", e.what());
-			return false;
+		literals.clear();
+		return decodeFormula(encoded.data(), size, literals);
+	}
+	return true;
+}
+
+bool
+sendFormula(simpleClause& serializedClauses, unsigned int* clsCount, unsigned int* varCount, int rootRank)
+{
+	// Broadcast varCount
+	TESTRUNMPI(MPI_Bcast(varCount, 1, MPI_UNSIGNED, rootRank, MPI_COMM_WORLD));
+	// Broadcast clsCount
+	TESTRUNMPI(MPI_Bcast(clsCount, 1, MPI_UNSIGNED, rootRank, MPI_COMM_WORLD));
+
+	LOGDEBUG1("VarCount = %u, ClsCount = %u", *varCount, *clsCount);
+
+	bool received = (__globalParameters__.formulaBroadcast == 1) ? scatterAllgatherFormula(serializedClauses, rootRank)
+																   : pipelineFormula(serializedClauses, rootRank);
+	if (!received)
+		LOGERROR("Error receiving the formula");
+	return received;
+}
+
+bool
+sendFormula(std::vector<simpleClause>& clauses, unsigned int* varCount, int rootRank)
+{
+	simpleClause literals;
+	unsigned int clsCount = clauses.size();
+
+	if (mpi_rank == rootRank) {
+		LOGDEBUG1("Root clauses number: %u", clauses.size());
+		for (const simpleClause& clause : clauses) {
+			literals.insert(literals.end(), clause.begin(), clause.end());
+			literals.push_back(0);
 		}
+	}
 
-		// Deserialize clauses
-		if (!deserializeClauses(serializedClauses, clauses)) {
-			LOGERROR("Error deserializing clauses");
-			return false;
+	if (!sendFormula(literals, &clsCount, varCount, rootRank))
+		return false;
+
+	if (mpi_rank != rootRank) {
+		clauses.clear();
+		clauses.reserve(clsCount);
+		auto begin = literals.begin();
+		for (auto it = literals.begin(); it != literals.end(); ++it) {
+			if (*it == 0) {
+				clauses.emplace_back(begin, it);
+				begin = it + 1;
+			}
 		}
 		LOGDEBUG1("Worker: deserialized %u clauses", clauses.size());
 	}
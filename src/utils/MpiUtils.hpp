@@ -2,6 +2,7 @@
 
 #include "ErrorCodes.hpp"
 #include "containers/ClauseUtils.hpp"
+#include <cstdint>
 #include <vector>
 
 #define MY_MPI_END 2012
@@ -13,6 +14,9 @@
 
 #define COLOR_YES 10
 
+/// Version of the compact clause encoding, first byte of every encoded buffer
+#define CLAUSE_CODEC_VERSION 1
+
 #define TESTRUNMPI(func)                                                                                               \
 	do {                                                                                                               \
 		int result = (func);                                                                                           \
@@ -44,6 +48,9 @@ bool
 sendFormula(std::vector<simpleClause>& clauses, unsigned int* varCount, int rootRank);
 
 /// @brief Sends a formula represented by clauses and variable count over MPI.
+/// @details The formula is encoded with encodeFormula. By default it is broadcast in chunks of formula-chunk literals:
+/// the root encodes a chunk while the previous one is transferred, and the other processes decode a chunk while the
+/// next one is received. With formula-bcast 1, the encoded formula is scattered then gathered by all the processes.
 /// @param clauses The vector of zero ending clauses representing the formula.
 /// @param varCount The number of variables in the formula (pointer).
 /// @param rootRank The mpi process rank broadcasting the formula.
@@ -66,6 +73,42 @@ serializeClauses(const std::vector<simpleClause>& clauses, std::vector<int>& ser
 bool
 deserializeClauses(const std::vector<int>& serializedClauses, std::vector<simpleClause>& clauses);
 
+/// @brief Encodes serialized clauses ([size][lbd][literals])* in the compact wire format.
+/// @details The version byte is followed by groups of consecutive clauses of same size and lbd: a header of three
+/// varints (size, lbd, number of clauses), then the literals of each clause. The literals are zigzag mapped (the
+/// variable then the sign), sorted, and written as the varint of the first one followed by the varints of the gaps.
+/// The order of the clauses is kept, the order of the literals of a clause is not.
+/// @param data The serialized clauses, a size of 0 ends the buffer (padding).
+/// @param count The number of integers in data.
+/// @param encoded The vector where the encoded bytes are appended.
+/// @return The number of literals encoded.
+size_t
+encodeClauses(const int* data, size_t count, std::vector<uint8_t>& encoded);
+
+/// @brief Decodes a buffer of encodeClauses.
+/// @param data The encoded bytes.
+/// @param count The number of bytes in data.
+/// @param serializedClauses The vector where the decoded clauses ([size][lbd][literals])* are appended.
+/// @return Returns false if the version is unknown or the buffer is truncated.
+bool
+decodeClauses(const uint8_t* data, size_t count, std::vector<int>& serializedClauses);
+
+/// @brief Encodes zero ending clauses in the compact format of encodeClauses, without lbd in the group headers.
+/// @param literals The zero ending clauses.
+/// @param count The number of integers in literals.
+/// @param encoded The vector where the encoded bytes are appended.
+/// @return The number of clauses encoded.
+size_t
+encodeFormula(const int* literals, size_t count, std::vector<uint8_t>& encoded);
+
+/// @brief Decodes a buffer of encodeFormula.
+/// @param data The encoded bytes.
+/// @param count The number of bytes in data.
+/// @param literals The vector where the decoded zero ending clauses are appended.
+/// @return Returns false if the version is unknown or the buffer is truncated.
+bool
+decodeFormula(const uint8_t* data, size_t count, std::vector<int>& literals);
+
 /// @brief The winner determined by the root will send the model if the answer was SATISFIABLE
 void
 sendModelToRoot();
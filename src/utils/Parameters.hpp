@@ -24,6 +24,10 @@
 	PARAM(test, bool, "test", false, "Use Test working strategy")                                                      \
 	PARAM(noModel, bool, "no-model", false, "Disable model output")                                                    \
 	PARAM(enableDistributed, bool, "dist", false, "Enable distributed solving, thus initializes MPI")                  \
+	PARAM(endPollPeriod, int, "end-poll", 1, "Polling period (ms) of the distributed termination (0 = disabled)")      \
+	PARAM(formulaBroadcast, int, "formula-bcast", 0, "Formula broadcast: 0 = chunked pipeline, 1 = scatter+allgather") \
+	PARAM(formulaChunk, int, "formula-chunk", 1'000'000, "Literals per chunk of the formula broadcast")                \
+	PARAM(pinning, std::string, "pin", "none", "Thread placement: none, compact, scatter or a core list (0-7,16)")     \
                                                                                                                        \
 	CATEGORY("Portfolio")                                                                                              \
 	PARAM(solver, std::string, "solver", "kcl", "Portfolio of solvers")                                                \
@@ -46,11 +50,38 @@
 		  "ga-cross-rate",                                                                                             \
 		  0.5f,                                                                                                        \
 		  "The crossover rate (probability), i.e chances to create a crossover point")                                 \
+	PARAM(banditPeriod,                                                                                                \
+		  int,                                                                                                         \
+		  "bandit-period",                                                                                             \
+		  0,                                                                                                           \
+		  "Period in seconds of the bandit portfolio reconfiguration (0 = disabled)")                                  \
+	PARAM(banditMinAge, int, "bandit-min-age", 3, "Number of bandit periods a solver runs before being replaceable")   \
+	PARAM(banditExploration, float, "bandit-ucb-c", 0.5f, "Exploration constant of the bandit UCB score")              \
+	PARAM(banditReplaceRatio,                                                                                          \
+		  float,                                                                                                       \
+		  "bandit-replace-ratio",                                                                                      \
+		  0.25f,                                                                                                       \
+		  "A solver is replaced if its score is below this ratio of the best score")                                   \
+	PARAM(banditWarmClauses, unsigned, "bandit-warm-cls", 10'000, "Recently shared clauses kept for the warm-starts")  \
+	PARAM(memGovernor, bool, "mem-governor", false, "Size the portfolio and release memory under memory pressure")     \
+	PARAM(memLimit, int, "mem-limit", 0, "Memory budget in MB of the governor (0 = available memory at startup)")      \
+	PARAM(memCheckPeriod, int, "mem-check-period", 1000, "Period in milliseconds of the memory governor checks")       \
+	PARAM(memPressureRatio,                                                                                            \
+		  float,                                                                                                       \
+		  "mem-pressure-ratio",                                                                                        \
+		  0.9f,                                                                                                        \
+		  "Fraction of the memory budget above which the governor releases memory")                                    \
                                                                                                                        \
 	CATEGORY("Solving")                                                                                                \
 	PARAM(glucoseSplitHeuristic, int, "glc-split-heur", 1, "Split heuristic")                                          \
 	PARAM(defaultClauseBufferSize, int, "default-clsbuff-size", 1000, "Default ClauseBuffer size")                     \
 	PARAM(localSearchFlips, int, "ls-flips", -1, "Number of local search flips")                                       \
+	PARAM(noLsImport, bool, "no-ls-import", false, "Do not import learned units and binaries into local search")       \
+	PARAM(phaseExchangePeriod,                                                                                         \
+		  int,                                                                                                         \
+		  "phase-exchange",                                                                                            \
+		  0,                                                                                                           \
+		  "Period in milliseconds of the phase exchange between local search and CDCL (0 = disabled)")                 \
                                                                                                                        \
 	CATEGORY("Preprocessing")                                                                                          \
 	SUBCATEGORY("PRS options")                                                                                         \
@@ -58,14 +89,48 @@
 	PARAM(prsGaussVar, int, "prs-gauss-var", 100'000, "PRS Gauss variable limit")                                      \
 	PARAM(prsCardVar, int, "prs-card-var", 100'000, "PRS cardinality variable limit")                                  \
 	PARAM(prsCircuitCls, int, "prs-circuit-cls", 1'000'000, "PRS circuit clause limit")                                \
+	PARAM(prsCircuitThreads, int, "prs-circuit-threads", 0, "PRS circuit simulation threads (0 = -c)")                 \
+	PARAM(prsCircuitCheck, bool, "prs-circuit-check", false, "Check the PRS circuit simulation against Bitset")        \
 	PARAM(prsGaussClsSize, int, "prs-gauss-cls-size", 6, "PRS Gauss clause size limit")                                \
 	PARAM(prsGaussCls, int, "prs-gauss-cls", 1'000'000, "PRS Gauss clause limit")                                      \
+	PARAM(prsGaussThreads, int, "prs-gauss-threads", 0, "PRS Gauss elimination threads (0 = -c)")                      \
 	PARAM(prsBinCls, int, "prs-bin-cls", 10'000'000, "PRS binary clause limit")                                        \
 	PARAM(prsCardCls, int, "prs-card-cls", 1'000'000, "PRS cardinality clause limit")                                  \
+	PARAM(prsCircuit, bool, "prs-circuit", false, "Run the PRS circuit equivalence check")                             \
+	PARAM(prsGauss, bool, "prs-gauss", true, "Run the PRS Gauss elimination alongside the card elimination")           \
+	PARAM(prsCircuitTimeout, float, "prs-circuit-timeout", 60.0f, "PRS circuit check time budget (s)")                 \
+	PARAM(prsGaussTimeout, float, "prs-gauss-timeout", 60.0f, "PRS Gauss elimination time budget (s)")                 \
+	PARAM(prsCardTimeout, float, "prs-card-timeout", 30.0f, "PRS cardinality elimination time budget (s)")             \
+	PARAM(prsPipeline, bool, "prs-pipeline", false, "Solve the original formula while PRS runs")                       \
+	PARAM(prsPipelineRestart, float, "prs-pipeline-restart", 0.5f, "CDCL fraction restarted on the PRS formula")       \
+                                                                                                                       \
+	SUBCATEGORY("BVE")                                                                                                 \
+	PARAM(bve, bool, "bve", false, "Run the bounded variable elimination before solving")                              \
+	PARAM(bveThreads, int, "bve-threads", 0, "BVE resolution threads (0 = -c)")                                        \
+	PARAM(bveOccLimit, int, "bve-occ-limit", 16, "BVE maximum occurrences of an eliminated variable")                  \
+	PARAM(bveResolventSize, int, "bve-resolvent-size", 32, "BVE maximum resolvent size")                               \
+	PARAM(bveTimeout, float, "bve-timeout", 30.0f, "BVE time budget (s)")                                              \
+                                                                                                                       \
+	SUBCATEGORY("Preprocessing Cache")                                                                                 \
+	PARAM(prepCache, std::string, "prep-cache", "", "Directory of the PRS/BVE result cache (empty = disabled)")        \
+                                                                                                                       \
+	SUBCATEGORY("Symmetry")                                                                                            \
+	PARAM(sym, bool, "sym", false, "Add symmetry breaking clauses before solving")                                     \
+	PARAM(symTimeout, float, "sym-timeout", 10.0f, "Time budget of the symmetry search (s)")                           \
+	PARAM(symMaxClauses, int, "sym-max-clauses", 100'000, "Maximum number of symmetry breaking clauses")               \
+	PARAM(symBreakLength, int, "sym-break-length", 50, "Maximum support variables broken per generator")               \
+	PARAM(symBacktracks, int, "sym-backtracks", 64, "Failed leaves or refinements per candidate image")                \
+                                                                                                                       \
+	SUBCATEGORY("Probing")                                                                                             \
+	PARAM(probe, bool, "probe", false, "Run the probing service (failed literals, equivalences, backbone)")            \
+	PARAM(probeThreads, int, "probe-threads", 1, "Probing service threads, in addition to the solvers")                \
+	PARAM(probePeriod, int, "probe-period", 10, "Seconds between two probing rounds (0 = a single round)")             \
+	PARAM(probeRoundTime, float, "probe-round-time", 5.0f, "Time budget of a probing round (s)")                       \
                                                                                                                        \
 	SUBCATEGORY("SBVA")                                                                                                \
 	PARAM(sbvaTimeout, int, "sbva-timeout", 500, "SBVA timeout")                                                       \
 	PARAM(sbvaCount, int, "sbva-count", 12, "SBVA threads count")                                                      \
+	PARAM(sbvaThreads, int, "sbva-threads", 1, "SBVA matching threads per instance")                                   \
 	PARAM(sbvaMaxClause, int, "sbva-max-clause", 10'000'000, "SBVA maximum clause count")                              \
 	PARAM(sbvaMaxAdd, int, "sbva-max-add", 0, "SBVA maximum additions (0 = unlimited)")                                \
 	PARAM(sbvaNoShuffle, bool, "no-sbva-shuffle", false, "Disable SBVA shuffle")                                       \
@@ -79,12 +144,15 @@
 	PARAM(globalSharingSleep, int, "gshr-sleep", 600'000, "Sleep time for sharer after each round of global sharing")  \
 	PARAM(oneSharer, bool, "one-sharer", false, "Use only one sharer")                                                 \
 	PARAM(globalSharedLiterals, int, "gshr-lit", 2000, "Number of literals shared globally")                           \
+	PARAM(globalTopology, int, "gshr-topo", 0, "Topology of gshr-strat 3: ring, hypercube, tree, torus or gossip")     \
+	PARAM(globalTopologyDegree, unsigned, "gshr-degree", 2, "Arity of the tree, or fan-out of the gossip")             \
 	PARAM(sharedLiteralsPerProducer,                                                                                   \
 		  int,                                                                                                         \
 		  "shr-lit-per-prod",                                                                                          \
 		  1500,                                                                                                        \
 		  "Number of literals shared per producer. It is mainly used for local sharing")                               \
 	PARAM(simpleShareLimit, int, "simple-limit", 10, "Simple share clause size limit")                                 \
+	PARAM(numaSharingGroups, bool, "numa-shr-groups", false, "HordeSat with one group of producers per NUMA node")     \
 	PARAM(importDB, std::string, "importDB", "d", "Solver import dabatase type")                                       \
 	PARAM(importDBCap, unsigned, "importDB-cap", 10'000, "Solver import dabatase capacity")                            \
 	PARAM(localSharingDB, std::string, "lshrDB", "d", "Local Sharing Strategy import dabatase type")                   \
@@ -143,6 +211,7 @@ extern Parameters __globalParameters__;
 		 " " BOLD "c" RESET " - CaDiCaL solver\n"                                                                      \
 		 " " BOLD "y" RESET " - YalSAT local search solver\n"                                                          \
 		 " " BOLD "t" RESET " - TaSSAT local search solver\n"                                                          \
+		 " " BOLD "p" RESET " - ProbSAT/WalkSAT native local search solver (walkers share the clauses)\n"              \
 		 "\n" BLUE "Import Database Types " YELLOW "(-importDB=<char>)" RESET " :\n" DETAILED_HELP_DATABASES "\n"      \
 		 "Working strategies:\n" RESET " " BOLD "Simple Portfolio" RESET                                               \
 		 " (the default strategy): Run solvers in parallel with diversified configurations\n"                          \
@@ -156,6 +225,14 @@ extern Parameters __globalParameters__;
 		 "\n" BLUE "Diversification:\n" RESET "  " YELLOW "-max-div-noise" RESET                                       \
 		 ": Sets maximum noise for random diversification between solvers\n"                                           \
 		 "  Higher values create more diverse solver configurations\n"                                                 \
+		 "\n" BLUE "Bandit Reconfiguration:\n" RESET "  " YELLOW "-bandit-period" RESET                                \
+		 ": Every period, the CDCL solvers are scored on their conflicts, propagations and exports.\n"                 \
+		 "  Each solver type is an arm of a UCB bandit, the worst solver is replaced by a new diversified\n"           \
+		 "  solver of the best arm, warm-started with the " YELLOW "-bandit-warm-cls" RESET " last shared clauses\n"   \
+		 "\n" BLUE "Memory Governor:\n" RESET "  " YELLOW "-mem-governor" RESET                                        \
+		 ": Launches only the solvers fitting in " YELLOW "-mem-limit" RESET ", then every " YELLOW                    \
+		 "-mem-check-period" RESET "\n  ms, releases the sharing databases and filters under pressure and"             \
+		 "\n  evicts the least productive CDCL solver if the pressure persists\n"                                      \
 		 "\n" FUNC_STYLE                                                                                               \
 		 "Note: Solver availability depends on compile-time options (GLUCOSE_, LINGELING_, etc.)\n" RESET
 
@@ -167,7 +244,12 @@ extern Parameters __globalParameters__;
 		 "    " BOLD "3" RESET ": Split by activity\n"                                                                 \
 		 "    " BOLD "4" RESET ": Split by phase\n"                                                                    \
 		 "\n" BLUE "Local Search:\n" RESET "  " YELLOW "-ls-flips" RESET ": Number of local search flips (" GREEN      \
-		 "-1" RESET " = use default)\n"
+		 "-1" RESET " = use default)\n"                                                                                \
+		 "  " YELLOW "-no-ls-import" RESET ": Do not import the learned units (fixed variables) and binaries\n"        \
+		 "\n" BLUE "Phase Exchange:\n" RESET "  " YELLOW "-phase-exchange" RESET                                       \
+		 ": Every period, the lowest-unsat local search assignment is proposed to the CDCL solvers\n"                  \
+		 "  as their best and target phases, and the best CDCL trail seeds the next local search restarts.\n"          \
+		 "  Supported by Kissat, YalSAT, TaSSAT and ProbSAT (" GREEN "0" RESET " = disabled)\n"
 
 #define DETAILED_HELP_PREPROCESSING                                                                                    \
 	BLUE "SBVA (Structured Binary Variable Addition):\n" RESET                                                         \
@@ -176,19 +258,58 @@ extern Parameters __globalParameters__;
 		 "\n"                                                                                                          \
 		 "  " YELLOW "-sbva-timeout" RESET ": Maximum processing time in seconds (" GREEN "500" RESET ")\n"            \
 		 "  " YELLOW "-sbva-count" RESET ": Number of parallel SBVA threads (" GREEN "12" RESET ")\n"                  \
+		 "  " YELLOW "-sbva-threads" RESET ": Threads matching literals in one SBVA instance (" GREEN "1" RESET ")\n"  \
 		 "  " YELLOW "-sbva-max-clause" RESET ": Maximum clauses for SBVA to process (" GREEN "10,000,000" RESET ")\n" \
 		 "  " YELLOW "-sbva-max-add" RESET ": Maximum variable additions (" GREEN "0" RESET " = unlimited)\n"          \
 		 "  " YELLOW "-no-sbva-shuffle" RESET ": Disable random shuffling during SBVA\n"                               \
+		 "\n" BLUE "BVE (Bounded Variable Elimination):\n" RESET                                                       \
+		 "  Eliminates variables by resolution when the formula does not grow, once for all the solvers.\n"            \
+		 "  " YELLOW "-bve" RESET ": Run the elimination before solving, after PRS if enabled\n"                       \
+		 "  " YELLOW "-bve-threads" RESET ": Resolution threads (" GREEN "0" RESET " = -c)\n"                          \
+		 "  " YELLOW "-bve-occ-limit" RESET ": Maximum occurrences of an eliminated variable (" GREEN "16" RESET ")\n" \
+		 "  " YELLOW "-bve-resolvent-size" RESET ": Maximum resolvent size (" GREEN "32" RESET ")\n"                   \
+		 "  " YELLOW "-bve-timeout" RESET ": Time budget in seconds (" GREEN "30" RESET ")\n"                          \
+		 "\n" BLUE "Preprocessing Cache:\n" RESET                                                                      \
+		 "  The formula simplified by PRS and BVE and their model reconstruction data, stored on disk and\n"           \
+		 "  reused by the next runs on the same formula, parameters and preprocessor sources.\n"                       \
+		 "  " YELLOW "-prep-cache" RESET ": Cache directory, created if needed (" GREEN "empty" RESET " = disabled)\n" \
+		 "\n" BLUE "Symmetry Breaking:\n" RESET                                                                        \
+		 "  Generators of the symmetries of the formula, found on its colored literal graph, and their lex-leader\n"   \
+		 "  clauses added for all the solvers, after PRS and BVE. Not supported with the PRS pipeline.\n"              \
+		 "  " YELLOW "-sym" RESET ": Add the symmetry breaking clauses before solving\n"                               \
+		 "  " YELLOW "-sym-timeout" RESET ": Time budget of the search in seconds (" GREEN "10" RESET ")\n"            \
+		 "  " YELLOW "-sym-max-clauses" RESET ": Maximum number of added clauses (" GREEN "100,000" RESET ")\n"        \
+		 "  " YELLOW "-sym-break-length" RESET ": Support variables broken per generator (" GREEN "50" RESET ")\n"     \
+		 "  " YELLOW "-sym-backtracks" RESET ": Failures allowed per candidate image (" GREEN "64" RESET ")\n"         \
+		 "\n" BLUE "Probing Service:\n" RESET                                                                          \
+		 "  Failed literals, equivalent literals and backbone literals found once for all the solvers,\n"              \
+		 "  shared as units and binary clauses. Kissat then skips its own probing and backbone preprocessing.\n"       \
+		 "  " YELLOW "-probe" RESET ": Run the service alongside the solvers\n"                                        \
+		 "  " YELLOW "-probe-threads" RESET ": Threads of the service (" GREEN "1" RESET ")\n"                         \
+		 "  " YELLOW "-probe-period" RESET ": Seconds between two rounds (" GREEN "10" RESET ", 0 = a single round)\n" \
+		 "  " YELLOW "-probe-round-time" RESET ": Time budget of a round in seconds (" GREEN "5" RESET ")\n"           \
 		 "\n" BLUE "PRS Preprocessing Techniques Details:\n" RESET "  " YELLOW "-prs-circuit-var" RESET                \
 		 ": Circuit variable threshold (" GREEN "100,000" RESET ")\n"                                                  \
 		 "  " YELLOW "-prs-gauss-var" RESET ": Gaussian elimination variable threshold (" GREEN "100,000" RESET ")\n"  \
 		 "  " YELLOW "-prs-card-var" RESET ": Cardinality constraint variable threshold (" GREEN "100,000" RESET ")\n" \
 		 "  " YELLOW "-prs-circuit-cls" RESET ": Circuit clause threshold (" GREEN "1,000,000" RESET ")\n"             \
+		 "  " YELLOW "-prs-circuit-threads" RESET ": Circuit simulation threads (" GREEN "0" RESET " = -c)\n"          \
+		 "  " YELLOW "-prs-circuit-check" RESET ": Check each simulated signature against the reference Bitset one\n"  \
 		 "  " YELLOW "-prs-gauss-cls-size" RESET ": Gaussian elimination clause size threshold (" GREEN "6" RESET      \
 		 ")\n"                                                                                                         \
 		 "  " YELLOW "-prs-gauss-cls" RESET ": Gaussian elimination clause threshold (" GREEN "1,000,000" RESET ")\n"  \
+		 "  " YELLOW "-prs-gauss-threads" RESET ": Gaussian elimination threads (" GREEN "0" RESET " = -c)\n"          \
 		 "  " YELLOW "-prs-bin-cls" RESET ": Binary clause threshold (" GREEN "10,000,000" RESET ")\n"                 \
-		 "  " YELLOW "-prs-card-cls" RESET ": Cardinality constraint clause threshold (" GREEN "1,000,000" RESET ")\n"
+		 "  " YELLOW "-prs-card-cls" RESET ": Cardinality constraint clause threshold (" GREEN "1,000,000" RESET ")\n" \
+		 "  " YELLOW "-prs-circuit" RESET ": Run the circuit equivalence check before propagation\n"                   \
+		 "  " YELLOW "-prs-gauss" RESET ": Run the Gaussian elimination with card (" GREEN "1" RESET ")\n"             \
+		 "  " YELLOW "-prs-circuit-timeout" RESET ": Circuit check time budget in seconds (" GREEN "60" RESET ")\n"    \
+		 "  " YELLOW "-prs-gauss-timeout" RESET ": Gauss elimination time budget in seconds (" GREEN "60" RESET ")\n"  \
+		 "  " YELLOW "-prs-card-timeout" RESET ": Cardinality elimination time budget in seconds (" GREEN "30" RESET   \
+		 ")\n"                                                                                                         \
+		 "  " YELLOW "-prs-pipeline" RESET ": Start the solvers on the original formula while PRS runs,\n"             \
+		 "    then restart some of them on the simplified formula\n"                                                   \
+		 "  " YELLOW "-prs-pipeline-restart" RESET ": Fraction of the CDCL solvers restarted (" GREEN "0.5" RESET ")\n"
 
 #define DETAILED_HELP_SHARING                                                                                          \
 	BLUE "Local Sharing Strategies " YELLOW "(-shr-strat)" BLUE ":\n" RESET "  " BOLD "1" RESET                        \
@@ -199,7 +320,14 @@ extern Parameters __globalParameters__;
 		 "\n" BLUE "Global Sharing Strategies " YELLOW "(-gshr-strat)" BLUE ":\n" RESET "  " BOLD "1" RESET            \
 		 ": AllGatherSharing - Exchange clauses using MPI_Allgather (default)\n"                                       \
 		 "  " BOLD "2" RESET ": MallobSharing - Mallob-based exchange algorithm (adaptive)\n"                          \
-		 "  " BOLD "3" RESET ": GenericGlobalSharing (Ring topology)\n"                                                \
+		 "  " BOLD "3" RESET ": GenericGlobalSharing - Messages on a topology (" YELLOW "-gshr-topo" RESET "):\n"      \
+		 "     " BOLD "0" RESET " ring (default), " BOLD "1" RESET " hypercube, " BOLD "2" RESET " k-ary tree,"        \
+		 " " BOLD "3" RESET " 2D torus, " BOLD "4" RESET " gossip to k random processes per round\n"                   \
+		 "     k is " YELLOW "-gshr-degree" RESET " (" GREEN "2" RESET "), the received clauses are forwarded\n"       \
+		 "  " BOLD "4" RESET ": HierarchicalSharing - Shared memory window inside a node, MPI_Allgatherv between\n"    \
+		 "     the leaders of the nodes\n"                                                                             \
+		 "  " BOLD "5" RESET ": RmaMailboxSharing - Asynchronous, MPI_Put of the clauses in mailboxes of the others,\n"\
+		 "     a full mailbox loses the batch instead of waiting for its reader\n"                                     \
 		 "\n" BLUE "Clause Database Types " YELLOW "(-lshrDB, -gshrDB)" RESET ":\n" DETAILED_HELP_DATABASES "\n"       \
 		 "Size and quality limits:\n" RESET "  " YELLOW "-max-cls-size" RESET ": Maximum clause size to share\n"       \
 		 "  " YELLOW "-shr-lit-per-prod" RESET ": Literals per producer for local sharing\n"                           \
@@ -212,6 +340,20 @@ extern Parameters __globalParameters__;
 		 "  " YELLOW "-v" RESET ": Verbosity level (" GREEN "0-5" RESET ")\n"                                          \
 		 "\n" BLUE "Distributed solving:\n" RESET "  " YELLOW "-dist" RESET ": Enable distributed solving using MPI\n" \
 		 "  Each node runs its own solvers and participates in global clause sharing\n"                                \
+		 "  " YELLOW "-end-poll" RESET ": Polling period in ms of the termination listener (" GREEN "1" RESET ")\n"    \
+		 "  The end of a process stops the others without waiting for a global sharing round,\n"                       \
+		 "  " GREEN "0" RESET " detects it in the sharing rounds only\n"                                               \
+		 "  " YELLOW "-formula-bcast" RESET ": " BOLD "0" RESET ": the root encodes and broadcasts the formula"        \
+		 " in chunks, the others decode a chunk while receiving the next one\n"                                        \
+		 "    " BOLD "1" RESET ": the encoded formula is scattered, then gathered by all the processes\n"              \
+		 "  " YELLOW "-formula-chunk" RESET ": Literals per chunk of the broadcast (" GREEN "1,000,000" RESET ")\n"    \
+		 "\n" BLUE "Thread placement " YELLOW "(-pin)" BLUE ":\n" RESET "  " BOLD "compact" RESET                      \
+		 ": Solvers fill a NUMA node before the next one\n"                                                            \
+		 "  " BOLD "scatter" RESET ": Solvers are distributed round-robin over the NUMA nodes\n"                       \
+		 "  " BOLD "<list>" RESET ": Explicit list of cores, e.g. 0-7,16\n"                                            \
+		 "  The import database and the formula of each solver are allocated on the node of its core.\n"               \
+		 "  With " YELLOW "-numa-shr-groups" RESET ", HordeSat uses one group of producers per node, each sharer\n"    \
+		 "  is pinned on the cores of its node\n"                                                                      \
 		 "\n" BLUE "Output options:\n" RESET "  " YELLOW "-no-model" RESET                                             \
 		 ": Only report satisfiability, not the model\n"
 /**
@@ -6,6 +6,7 @@
 #include <stdio.h>
 
 #include "ErrorCodes.hpp"
+#include "InputStream.hpp"
 #include "Logger.hpp"
 #include "NumericConstants.hpp"
 #include "Parameters.hpp"
@@ -48,40 +49,40 @@ TautologyFilter::operator()(simpleClause& clause)
 
 // Parser Helpers
 // Utility functions
-inline char
-skipWhitespace(FILE* f)
+inline int
+skipWhitespace(InputStream& f)
 {
-	char c;
-	while (isspace(c = fgetc(f)))
+	int c;
+	while (isspace(c = f.get()))
 		;
 	return c;
 }
 
 inline void
-skipLine(FILE* f)
+skipLine(InputStream& f)
 {
-	char c;
-	while ((c = fgetc(f)) != '\n' && c != EOF)
+	int c;
+	while ((c = f.get()) != '\n' && c != EOF)
 		;
 }
 
 inline int
-parseNumber(FILE* f, int firstDigit)
+parseNumber(InputStream& f, int firstDigit)
 {
 	int num = firstDigit - '0';
-	char c;
-	while (isdigit(c = fgetc(f))) {
+	int c;
+	while (isdigit(c = f.get())) {
 		num = num * 10 + (c - '0');
 	}
-	ungetc(c, f); // Put back the non-digit character
+	f.unget(c); // Put back the non-digit character
 	return num;
 }
 
 // Parse the problem definition line
 bool
-parseCNFParameters(FILE* f, unsigned int& varCount, unsigned int& clauseCount)
+parseCNFParameters(InputStream& f, unsigned int& varCount, unsigned int& clauseCount)
 {
-	char c;
+	int c;
 	while ((c = skipWhitespace(f)) != EOF) {
 		if (c == 'c') {
 			skipLine(f);
@@ -92,7 +93,7 @@ parseCNFParameters(FILE* f, unsigned int& varCount, unsigned int& clauseCount)
 			c = skipWhitespace(f);
 			// Skip "nf"
 			for (int i = 0; i < 2; i++) {
-				if (fgetc(f) == EOF) {
+				if (f.get() == EOF) {
 					LOGERROR("EOF Detected to early");
 					return false;
 				}
@@ -122,10 +123,10 @@ parseCNFParameters(FILE* f, unsigned int& varCount, unsigned int& clauseCount)
 
 // Parse a single clause
 static bool
-parseClause(FILE* f, simpleClause& cls)
+parseClause(InputStream& f, simpleClause& cls)
 {
 	cls.clear();
-	char c;
+	int c;
 	bool neg = false;
 
 	while ((c = skipWhitespace(f)) != EOF) {
@@ -159,17 +160,14 @@ parseClause(FILE* f, simpleClause& cls)
 bool
 parseCNF(const char* filename, Formula& parsedFormula, const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
 {
-	FILE* f = fopen(filename, "r");
-	if (f == NULL) {
-		LOGERROR("Couldn't open file: %s", filename);
+	std::unique_ptr<InputStream> input = InputStream::open(filename);
+	if (!input)
 		return false;
-	}
+	InputStream& f = *input;
 
 	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0;
-	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount)) {
-		fclose(f);
+	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount))
 		return false;
-	}
 
 	parsedFormula.setVarCount(parsedVarCount);
 
@@ -193,13 +191,15 @@ parseCNF(const char* filename, Formula& parsedFormula, const std::vector<std::un
 			if (keepClause && !parsedFormula.push_clause(std::move(cls))) {
 				finalResult = SatResult::UNSAT;
 				LOGDEBUG1("Parse stopping because of UNSAT");
-				fclose(f);
 				return true;
 			}
 		}
 	}
 
-	fclose(f);
+	if (f.hasFailed()) {
+		LOGERROR("Could not read the whole file %s", filename);
+		return false;
+	}
 
 	assert(parsedClauseCount - filteredOutCount == parsedFormula.getAllClauseCount());
 	LOG0("Successfully parsed %u clauses (filtered out: %u) with %u variables in %s.",
@@ -218,17 +218,14 @@ parseCNF(const char* filename,
 		 const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
 {
 
-	FILE* f = fopen(filename, "r");
-	if (f == NULL) {
-		LOGERROR("Couldn't open file: %s", filename);
+	std::unique_ptr<InputStream> input = InputStream::open(filename);
+	if (!input)
 		return false;
-	}
+	InputStream& f = *input;
 
 	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0;
-	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount)) {
-		fclose(f);
+	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount))
 		return false;
-	}
 
 	*varCount = parsedVarCount;
 
@@ -256,7 +253,10 @@ parseCNF(const char* filename,
 		cls.clear();
 	}
 
-	fclose(f);
+	if (f.hasFailed()) {
+		LOGERROR("Could not read the whole file %s", filename);
+		return false;
+	}
 
 	assert(parsedClauseCount - filteredOutCount == clauses.size());
 	LOG0("Successfully parsed %u clauses (filtered out: %u) with %u variables in %s.",
@@ -275,18 +275,15 @@ parseCNF(const char* filename,
 		 unsigned int* clsCount,
 		 const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
 {
-	FILE* f = fopen(filename, "r");
-	if (f == NULL) {
-		LOGERROR("Couldn't open file: %s", filename);
+	std::unique_ptr<InputStream> input = InputStream::open(filename);
+	if (!input)
 		return false;
-	}
+	InputStream& f = *input;
 
 	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0, clsCount_ = 0;
 	size_t litCounts = 0;
-	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount)) {
-		fclose(f);
+	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount))
 		return false;
-	}
 
 	*varCount = parsedVarCount;
 
@@ -318,7 +315,10 @@ parseCNF(const char* filename,
 		cls.clear();
 	}
 
-	fclose(f);
+	if (f.hasFailed()) {
+		LOGERROR("Could not read the whole file %s", filename);
+		return false;
+	}
 
 	assert(parsedClauseCount - filteredOutCount == clsCount_);
 
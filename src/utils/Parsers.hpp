@@ -8,12 +8,15 @@
 #include "../solvers/SolverInterface.hpp"
 #include "containers/ClauseUtils.hpp"
 #include "containers/Formula.hpp"
+#include "utils/InputStream.hpp"
 #include <algorithm>
 #include <functional>
 
 /**
  * @ingroup utils
  * @brief A set of helper functions for CNF file parsing
+ *
+ * The files may be compressed with gzip, xz, bzip2 or zstd, they are decompressed on the fly (see InputStream).
  */
 namespace Parsers {
 
@@ -152,12 +155,12 @@ parseCNF(const char* filename, Formula& formula, const std::vector<std::unique_p
 /**
  * @brief Parse the CNF parameters (variable count and clause count) from a file.
  *
- * @param f File pointer to parse from.
+ * @param f Input stream to parse from.
  * @param varCount Reference to store the number of variables.
  * @param clauseCount Reference to store the number of clauses.
  * @return true if parsing was successful, false otherwise.
  */
 bool
-parseCNFParameters(FILE* f, unsigned int& varCount, unsigned int& clauseCount);
+parseCNFParameters(InputStream& f, unsigned int& varCount, unsigned int& clauseCount);
 
 } // namespace Parsers
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "utils/Placement.hpp"
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <sched.h>
+#include <sstream>
+
+namespace ThreadPlacement {
+
+/// Core order of the policy, empty if the placement is disabled
+static std::vector<int> coreOrder;
+
+/// Node of each allowed core
+static std::map<int, int> coreNode;
+
+/// Allowed cores of each node
+static std::map<int, std::vector<int>> nodeCores;
+
+/// Parse a sysfs cpu list such as "0-3,8,10-11"
+static std::vector<int>
+parseCpuList(const std::string& list)
+{
+	std::vector<int> cpus;
+	std::stringstream ss(list);
+	std::string range;
+
+	while (std::getline(ss, range, ',')) {
+		if (range.empty())
+			continue;
+		size_t dash = range.find('-');
+		try {
+			int first = std::stoi(range.substr(0, dash));
+			int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+			for (int cpu = first; cpu <= last; cpu++)
+				cpus.push_back(cpu);
+		} catch (const std::exception&) {
+			return {};
+		}
+	}
+	return cpus;
+}
+
+static void
+readTopology()
+{
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) {
+		LOGWARN("Placement: sched_getaffinity failed, all cores are considered allowed");
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			CPU_SET(cpu, &allowed);
+	}
+
+	coreNode.clear();
+	nodeCores.clear();
+
+	DIR* dir = opendir("/sys/devices/system/node");
+	if (dir) {
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != nullptr) {
+			int node;
+			if (sscanf(entry->d_name, "node%d", &node) != 1)
+				continue;
+			std::ifstream cpulist("/sys/devices/system/node/" + std::string(entry->d_name) + "/cpulist");
+			std::string list;
+			if (!std::getline(cpulist, list))
+				continue;
+			for (int cpu : parseCpuList(list)) {
+				if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+					coreNode[cpu] = node;
+					nodeCores[node].push_back(cpu);
+				}
+			}
+		}
+		closedir(dir);
+	}
+
+	// No NUMA information, a single node with all the allowed cores
+	if (coreNode.empty()) {
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &allowed)) {
+				coreNode[cpu] = 0;
+				nodeCores[0].push_back(cpu);
+			}
+		}
+	}
+
+	for (auto& [node, cores] : nodeCores)
+		std::sort(cores.begin(), cores.end());
+}
+
+bool
+initialize(const std::string& policy)
+{
+	coreOrder.clear();
+
+	if (policy.empty() || policy == "none")
+		return true;
+
+	readTopology();
+
+	if (policy == "compact") {
+		for (auto& [node, cores] : nodeCores)
+			coreOrder.insert(coreOrder.end(), cores.begin(), cores.end());
+	} else if (policy == "scatter") {
+		size_t maxCores = 0;
+		for (auto& [node, cores] : nodeCores)
+			maxCores = std::max(maxCores, cores.size());
+		for (size_t i = 0; i < maxCores; i++) {
+			for (auto& [node, cores] : nodeCores) {
+				if (i < cores.size())
+					coreOrder.push_back(cores[i]);
+			}
+		}
+	} else {
+		std::vector<int> explicitCores = parseCpuList(policy);
+		if (explicitCores.empty()) {
+			LOGERROR("Placement: cannot parse the policy '%s', threads will not be pinned", policy.c_str());
+			return false;
+		}
+		for (int core : explicitCores) {
+			if (!coreNode.count(core)) {
+				LOGWARN("Placement: core %d is not available, it is ignored", core);
+				continue;
+			}
+			coreOrder.push_back(core);
+		}
+	}
+
+	return !coreOrder.empty();
+}
+
+bool
+isEnabled()
+{
+	return !coreOrder.empty();
+}
+
+int
+getCore(unsigned int index)
+{
+	if (coreOrder.empty())
+		return -1;
+	return coreOrder[index % coreOrder.size()];
+}
+
+int
+getNode(int core)
+{
+	auto it = coreNode.find(core);
+	return (it == coreNode.end()) ? 0 : it->second;
+}
+
+unsigned int
+getNodeCount()
+{
+	return std::max<size_t>(1, nodeCores.size());
+}
+
+std::vector<int>
+getNodeCores(int node)
+{
+	auto it = nodeCores.find(node);
+	return (it == nodeCores.end()) ? std::vector<int>() : it->second;
+}
+
+bool
+pinCurrentThread(int core)
+{
+	if (core < 0)
+		return false;
+	return pinCurrentThread(std::vector<int>{ core });
+}
+
+bool
+pinCurrentThread(const std::vector<int>& cores)
+{
+	if (cores.empty())
+		return false;
+
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	for (int core : cores)
+		CPU_SET(core, &cpuset);
+
+	return sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) == 0;
+}
+
+void
+printPlacement()
+{
+	if (coreOrder.empty()) {
+		LOG0("Placement: threads are not pinned");
+		return;
+	}
+
+	for (auto& [node, cores] : nodeCores)
+		LOG0("Placement: NUMA node %d has %zu allowed cores", node, cores.size());
+
+	std::string order;
+	for (int core : coreOrder)
+		order += std::to_string(core) + " ";
+	LOG0("Placement: core order %s", order.c_str());
+}
+}
@@ -0,0 +1,84 @@
+/**
+ * @file Placement.hpp
+ * @brief Thread placement over the cores and NUMA nodes of the machine.
+ * @details The topology is read from /sys/devices/system, only the cores allowed for the process are used.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @ingroup utils
+ * @brief Utilities to pin the threads of painless on the cores and NUMA nodes of the machine.
+ *
+ * The placement policy is given by the -pin parameter:
+ * - none: threads are left to the OS scheduler
+ * - compact: consecutive thread indexes fill a NUMA node before the next one
+ * - scatter: consecutive thread indexes are distributed round-robin over the NUMA nodes
+ * - a comma separated list of core ids, thread index i is pinned on the (i % size) core of the list
+ */
+namespace ThreadPlacement {
+
+/**
+ * @brief Read the topology and build the core order of the given policy.
+ * @param policy The placement policy (none, compact, scatter or explicit list of cores).
+ * @return False if the policy could not be parsed, placement is then disabled.
+ */
+bool
+initialize(const std::string& policy);
+
+/**
+ * @brief Check if the threads are to be pinned.
+ */
+bool
+isEnabled();
+
+/**
+ * @brief Get the core of a thread given its placement index.
+ * @param index The placement index of the thread (solvers are numbered first).
+ * @return The core id, or -1 if placement is disabled.
+ */
+int
+getCore(unsigned int index);
+
+/**
+ * @brief Get the NUMA node of a core.
+ * @return The node id, 0 if unknown.
+ */
+int
+getNode(int core);
+
+/**
+ * @brief Get the number of NUMA nodes used by the placement.
+ */
+unsigned int
+getNodeCount();
+
+/**
+ * @brief Get the allowed cores of a NUMA node.
+ */
+std::vector<int>
+getNodeCores(int node);
+
+/**
+ * @brief Pin the calling thread on a core, memory allocated afterwards is first-touched on its node.
+ * @return True if the affinity was set.
+ */
+bool
+pinCurrentThread(int core);
+
+/**
+ * @brief Pin the calling thread on a set of cores.
+ * @return True if the affinity was set.
+ */
+bool
+pinCurrentThread(const std::vector<int>& cores);
+
+/**
+ * @brief Log the topology and the core order.
+ */
+void
+printPlacement();
+}
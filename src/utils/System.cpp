@@ -94,6 +94,30 @@ getAvailableMemoryKB()
 	return availableKB;
 }
 
+long
+getProcessRSSKB()
+{
+	std::ifstream status_file("/proc/self/status");
+	if (!status_file.is_open()) {
+		LOGERROR("Failed to open /proc/self/status");
+		return 0;
+	}
+
+	std::string line;
+	while (std::getline(status_file, line)) {
+		if (line.compare(0, 6, "VmRSS:") == 0) {
+			long value = 0;
+			std::istringstream iss(line.substr(6));
+			if (iss >> value)
+				return value;
+			break;
+		}
+	}
+
+	LOGERROR("Failed to find or parse VmRSS");
+	return 0;
+}
+
 bool
 setMemoryLimitKB(rlim_t limitInKB)
 {
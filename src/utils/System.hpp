@@ -79,6 +79,13 @@ getFreeMemoryKB();
 long
 getAvailableMemoryKB();
 
+/**
+ * @brief Get the resident set size of the process in kilobytes (VmRSS of /proc/self/status).
+ * @return Long representing the RSS in KB, 0 on failure.
+ */
+long
+getProcessRSSKB();
+
 /**
  * @brief Set the memory limit for the process.
  * @param limitInKB The memory limit to set in kilobytes.
@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <vector>
 
 #define TESTRUN(cmd, msg)                                                                                              \
 	int res = cmd;                                                                                                     \
@@ -60,6 +61,16 @@ class Thread
 		pthread_setaffinity_np(this->myTid, sizeof(cpu_set_t), &cpuset);
 	}
 
+	void setThreadAffinity(const std::vector<int>& coreIds)
+	{
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		for (int coreId : coreIds)
+			CPU_SET(coreId, &cpuset);
+
+		pthread_setaffinity_np(this->myTid, sizeof(cpu_set_t), &cpuset);
+	}
+
   protected:
 	/// The id of the pthread.
 	pthread_t myTid;
@@ -0,0 +1,178 @@
+#include "working/DistributedTermination.hpp"
+#include "painless.hpp"
+#include "utils/Logger.hpp"
+#include "utils/MpiUtils.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/System.hpp"
+#include "working/WorkingStrategy.hpp"
+
+#include <chrono>
+
+// for now the loops works only for root = 0
+#define MY_MPI_ROOT 0
+
+std::atomic<bool> DistributedTermination::s_active(false);
+std::atomic<int> DistributedTermination::s_decision(0);
+
+DistributedTermination::DistributedTermination(WorkingStrategy* portfolio)
+	: m_portfolio(portfolio)
+{
+	TESTRUNMPI(MPI_Comm_dup(MPI_COMM_WORLD, &m_comm));
+}
+
+DistributedTermination::~DistributedTermination()
+{
+	join();
+	s_active = false;
+	TESTRUNMPI(MPI_Comm_free(&m_comm));
+}
+
+bool
+DistributedTermination::isSupported()
+{
+	int provided;
+	TESTRUNMPI(MPI_Query_thread(&provided));
+	return provided == MPI_THREAD_MULTIPLE;
+}
+
+void
+DistributedTermination::start()
+{
+	s_active = true;
+	m_thread = std::thread(&DistributedTermination::mainLoop, this);
+}
+
+void
+DistributedTermination::join()
+{
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+void
+DistributedTermination::printStats()
+{
+	if (mpi_rank == MY_MPI_ROOT)
+		LOGSTAT("Termination: decided at %.3f s (%s), all the processes stopped %.2f ms after the decision",
+				m_decisionTime,
+				m_endedLocally ? "local answer" : "received answer",
+				(m_lastAckTime - m_decisionTime) * 1000);
+	else if (m_endedLocally)
+		LOGSTAT("Termination: answered at %.3f s, decision received %.2f ms later",
+				m_localEndTime,
+				(m_bcastTime - m_localEndTime) * 1000);
+	else
+		LOGSTAT("Termination: decision received at %.3f s", m_bcastTime);
+}
+
+int
+DistributedTermination::getLocalResult()
+{
+	// The timeout sets globalEnding before finalResult
+	SatResult res = finalResult;
+	return static_cast<int>(res == SatResult::UNKNOWN ? SatResult::TIMEOUT : res);
+}
+
+void
+DistributedTermination::applyDecision(int packed)
+{
+	finalResult = static_cast<SatResult>(packed & 0x0000FFFF);
+	mpi_winner = (packed & 0xFFFF0000) >> 16;
+	globalEnding = true;
+
+	m_portfolio->setSolverInterrupt();
+
+	mutexGlobalEnd.lock();
+	condGlobalEnd.notify_all();
+	mutexGlobalEnd.unlock();
+	LOG1("[Termination] The end was decided by the root: result %d, winner %d", packed & 0x0000FFFF, mpi_winner);
+}
+
+void
+DistributedTermination::mainLoop()
+{
+	if (mpi_rank == MY_MPI_ROOT)
+		rootLoop();
+	else
+		workerLoop();
+}
+
+void
+DistributedTermination::rootLoop()
+{
+	const auto period = std::chrono::milliseconds(__globalParameters__.endPollPeriod);
+	int decision = 0;
+	int index, flag;
+	MPI_Status status;
+	MPI_Request bcastRequest;
+
+	m_recvBuffers.resize(mpi_world_size - 1);
+	m_recvRequests.resize(mpi_world_size - 1);
+	for (int i = 0; i < mpi_world_size - 1; i++)
+		TESTRUNMPI(MPI_Irecv(&m_recvBuffers[i], 1, MPI_INT, i + 1, MY_MPI_END, m_comm, &m_recvRequests[i]));
+
+	/* Decision: the first result received or the local one */
+	while (!decision) {
+		TESTRUNMPI(MPI_Testany(m_recvRequests.size(), m_recvRequests.data(), &index, &flag, &status));
+		if (flag && index != MPI_UNDEFINED) {
+			int result = m_recvBuffers[index];
+			int winner = (result != (int)SatResult::TIMEOUT) ? status.MPI_SOURCE : MY_MPI_ROOT;
+			decision = result | (winner << 16);
+			LOG1("[Termination] Result %d received from process %d", result, status.MPI_SOURCE);
+		} else if (globalEnding) {
+			m_endedLocally = true;
+			decision = getLocalResult() | (MY_MPI_ROOT << 16);
+		} else
+			std::this_thread::sleep_for(period);
+	}
+	m_decisionTime = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	m_bcastBuffer = decision;
+	TESTRUNMPI(MPI_Ibcast(&m_bcastBuffer, 1, MPI_INT, MY_MPI_ROOT, m_comm, &bcastRequest));
+	s_decision = decision;
+
+	if (m_endedLocally)
+		mpi_winner = MY_MPI_ROOT;
+	else
+		applyDecision(decision);
+
+	/* Every other process sends one message: its own result or the acknowledgement of the decision */
+	TESTRUNMPI(MPI_Waitall(m_recvRequests.size(), m_recvRequests.data(), MPI_STATUSES_IGNORE));
+	m_lastAckTime = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	TESTRUNMPI(MPI_Wait(&bcastRequest, MPI_STATUS_IGNORE));
+}
+
+void
+DistributedTermination::workerLoop()
+{
+	const auto period = std::chrono::milliseconds(__globalParameters__.endPollPeriod);
+	bool sent = false;
+	int flag = 0;
+	MPI_Request bcastRequest, sendRequest;
+
+	TESTRUNMPI(MPI_Ibcast(&m_bcastBuffer, 1, MPI_INT, MY_MPI_ROOT, m_comm, &bcastRequest));
+
+	while (!flag) {
+		if (!sent && globalEnding) {
+			m_endedLocally = true;
+			m_localEndTime = SystemResourceMonitor::getRelativeTimeSeconds();
+			m_sendBuffer = getLocalResult();
+			TESTRUNMPI(MPI_Isend(&m_sendBuffer, 1, MPI_INT, MY_MPI_ROOT, MY_MPI_END, m_comm, &sendRequest));
+			sent = true;
+		}
+		TESTRUNMPI(MPI_Test(&bcastRequest, &flag, MPI_STATUS_IGNORE));
+		if (!flag)
+			std::this_thread::sleep_for(period);
+	}
+	m_bcastTime = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	applyDecision(m_bcastBuffer);
+
+	// The acknowledgement is sent once the solvers are interrupted
+	if (!sent) {
+		m_sendBuffer = 0;
+		TESTRUNMPI(MPI_Isend(&m_sendBuffer, 1, MPI_INT, MY_MPI_ROOT, MY_MPI_END, m_comm, &sendRequest));
+	}
+	TESTRUNMPI(MPI_Wait(&sendRequest, MPI_STATUS_IGNORE));
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class WorkingStrategy;
+
+/**
+ * @brief Asynchronous termination of a distributed run, independent of the global sharing period.
+ *
+ * Each process runs a listener thread polling its own duplicate of MPI_COMM_WORLD every endPollPeriod milliseconds. A
+ * process ending on its own (answer or timeout) sends its result to the root. The root decides at the first result it
+ * gets, received or its own, and posts a non-blocking broadcast of the result and the winner rank. The other processes
+ * interrupt their solvers as soon as the broadcast completes, then acknowledge it. The root measures the delay from its
+ * decision to the last acknowledgement, and a non-root winner the delay from its answer to the broadcast.
+ *
+ * The global sharing strategies keep ending in a common round, the root broadcasts the decision of the listener in it
+ * (see getDecision), so that all the processes agree on the winner.
+ * @warning Requires MPI_THREAD_MULTIPLE, the listener calls MPI concurrently with the sharers.
+ * @ingroup working
+ */
+class DistributedTermination
+{
+  public:
+	/**
+	 * @brief Constructor, duplicates MPI_COMM_WORLD: it is collective, every process must construct it.
+	 * @param portfolio The strategy interrupted at a remote ending, it must outlive this object.
+	 */
+	DistributedTermination(WorkingStrategy* portfolio);
+
+	~DistributedTermination();
+
+	/// True if MPI was initialized with MPI_THREAD_MULTIPLE.
+	static bool isSupported();
+
+	/// True while a listener is running in this process, the global sharing rounds then use its decision.
+	static bool isActive() { return s_active; }
+
+	/**
+	 * @brief Decision of the root, packed as in the global sharing rounds: winner rank << 16 | result.
+	 * @return 0 while undecided (and always on the non-root processes).
+	 */
+	static int getDecision() { return s_decision; }
+
+	/// Launch the listener thread.
+	void start();
+
+	/// Wait for the listener thread, it ends once the decision is known to all the processes.
+	void join();
+
+	/// Print the termination latencies.
+	void printStats();
+
+  protected:
+	/// Main loop of the listener thread.
+	void mainLoop();
+
+	/// Root: wait for the first result, broadcast the decision, then collect the acknowledgements.
+	void rootLoop();
+
+	/// Non-root: send the local result, wait for the broadcast, then acknowledge it.
+	void workerLoop();
+
+	/// Result of a local ending, a timeout if the result is not set yet.
+	static int getLocalResult();
+
+	/// Set the final result and the winner of a remote decision, then interrupt the solvers.
+	void applyDecision(int packed);
+
+	WorkingStrategy* m_portfolio;
+
+	std::thread m_thread;
+
+	/// Duplicate of MPI_COMM_WORLD, the termination messages never match the sharing ones
+	MPI_Comm m_comm;
+
+	/// Packed decision, broadcast from the root
+	int m_bcastBuffer = 0;
+
+	/// Result sent to the root (0 for an acknowledgement)
+	int m_sendBuffer = 0;
+
+	/// Root: one result or acknowledgement per non-root process
+	std::vector<int> m_recvBuffers;
+
+	std::vector<MPI_Request> m_recvRequests;
+
+	// Stats
+	//------
+	double m_localEndTime = 0;
+	double m_decisionTime = 0;
+	double m_lastAckTime = 0;
+	double m_bcastTime = 0;
+	bool m_endedLocally = false;
+
+	static std::atomic<bool> s_active;
+	static std::atomic<int> s_decision;
+};
@@ -0,0 +1,196 @@
+#include "working/MemoryGovernor.hpp"
+#include "painless.hpp"
+#include "utils/Logger.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/System.hpp"
+#include "working/PortfolioSimple.hpp"
+
+#include <algorithm>
+
+MemoryGovernor::MemoryGovernor(PortfolioSimple* portfolio)
+	: m_portfolio(portfolio)
+	, m_budgetKB(getBudgetKB())
+{
+}
+
+MemoryGovernor::~MemoryGovernor()
+{
+	join();
+}
+
+long
+MemoryGovernor::getBudgetKB()
+{
+	if (__globalParameters__.memLimit > 0)
+		return (long)__globalParameters__.memLimit * 1024;
+	return SystemResourceMonitor::getAvailableMemoryKB() + SystemResourceMonitor::getProcessRSSKB();
+}
+
+long
+MemoryGovernor::estimateSolverMemoryKB(const FormulaArena& formula)
+{
+	unsigned long literals = formula.getLiteralsCount();
+	unsigned long clauses = formula.getClausesCount();
+	unsigned long varCount = formula.getVariablesCount();
+
+	/* 4 bytes per literal in the arena, 24 bytes of header and 2 watches of 8 bytes per clause, about 160 bytes of
+	 * per-variable data (values, phases, heap, trail, reasons). The learnt clauses are accounted as much again. */
+	unsigned long bytes = literals * 4 + clauses * (24 + 16) + varCount * 160;
+
+	return (long)(2 * bytes / 1024) + 1;
+}
+
+unsigned int
+MemoryGovernor::getMaxSolvers(const FormulaArena& formula, unsigned int maxSolvers)
+{
+	long estimateKB = estimateSolverMemoryKB(formula);
+	long freeBudgetKB =
+		(long)(getBudgetKB() * __globalParameters__.memPressureRatio) - SystemResourceMonitor::getProcessRSSKB();
+
+	unsigned int fitting = (freeBudgetKB > 0) ? (unsigned int)(freeBudgetKB / estimateKB) : 0;
+	unsigned int count = std::max(1u, std::min(maxSolvers, fitting));
+
+	LOG0("MemoryGovernor: %ld KB estimated per solver, %ld KB of budget left, %u/%u solvers will be launched",
+		 estimateKB,
+		 freeBudgetKB,
+		 count,
+		 maxSolvers);
+
+	return count;
+}
+
+void
+MemoryGovernor::start()
+{
+	LOG0("MemoryGovernor: budget of %ld MB, checked every %d ms", m_budgetKB / 1024, __globalParameters__.memCheckPeriod);
+	m_thread = std::thread(&MemoryGovernor::mainLoop, this);
+}
+
+void
+MemoryGovernor::join()
+{
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+void
+MemoryGovernor::mainLoop()
+{
+	const double period = __globalParameters__.memCheckPeriod / 1000.0;
+
+	while (!globalEnding) {
+		// Sliced wait, the timeout sets globalEnding after its notification
+		double start = SystemResourceMonitor::getRelativeTimeSeconds();
+		while (!globalEnding && SystemResourceMonitor::getRelativeTimeSeconds() - start < period) {
+			std::unique_lock<std::mutex> lock(mutexGlobalEnd);
+			condGlobalEnd.wait_for(lock, std::chrono::milliseconds(std::min(200, __globalParameters__.memCheckPeriod)));
+		}
+
+		if (globalEnding || m_portfolio->strategyEnding)
+			break;
+
+		check();
+	}
+}
+
+void
+MemoryGovernor::check()
+{
+	long rssKB = SystemResourceMonitor::getProcessRSSKB();
+	long availableKB = SystemResourceMonitor::getAvailableMemoryKB();
+	long totalKB = SystemResourceMonitor::getTotalMemoryKB();
+
+	m_peakRssKB = std::max(m_peakRssKB, rssKB);
+
+	bool pressure = rssKB > m_budgetKB * __globalParameters__.memPressureRatio ||
+					availableKB < totalKB * (1 - __globalParameters__.memPressureRatio);
+
+	LOGDEBUG1("MemoryGovernor: rss %ld KB, available %ld KB, pressure %d", rssKB, availableKB, pressure);
+
+	if (!pressure) {
+		m_shrunk = false;
+	} else if (!m_shrunk) {
+		LOGWARN("MemoryGovernor: memory pressure (rss %ld KB, available %ld KB), releasing databases",
+				rssKB,
+				availableKB);
+		shrink();
+		m_shrunk = true;
+	} else {
+		LOGWARN("MemoryGovernor: memory pressure persists (rss %ld KB, available %ld KB), evicting a solver",
+				rssKB,
+				availableKB);
+		evict();
+		m_shrunk = false;
+	}
+
+	// Productivity of the solvers over the last period
+	std::lock_guard<std::mutex> lock(m_portfolio->reconfigurationMutex);
+	for (auto& cdcl : m_portfolio->cdclSolvers) {
+		SolvingCdclStatistics stats = cdcl->getStatistics();
+		auto& last = m_lastCounters[cdcl->getSolverId()];
+		last.first = stats.exports;
+		last.second = stats.conflicts;
+	}
+}
+
+void
+MemoryGovernor::shrink()
+{
+	for (auto& lstrat : m_portfolio->localStrategies)
+		lstrat->requestShrink();
+	for (auto& gstrat : m_portfolio->globalStrategies)
+		gstrat->requestShrink();
+
+	m_shrinks++;
+}
+
+void
+MemoryGovernor::evict()
+{
+	std::lock_guard<std::mutex> lock(m_portfolio->reconfigurationMutex);
+	auto& solvers = m_portfolio->cdclSolvers;
+
+	if (solvers.size() <= 1) {
+		LOG1("MemoryGovernor: only %zu CDCL solver left, nothing to evict", solvers.size());
+		return;
+	}
+
+	size_t victim = solvers.size();
+	unsigned long victimExports = 0, victimConflicts = 0;
+
+	for (size_t i = 0; i < solvers.size(); i++) {
+		SolvingCdclStatistics stats = solvers[i]->getStatistics();
+		auto& last = m_lastCounters[solvers[i]->getSolverId()];
+		unsigned long exports = (stats.exports > last.first) ? stats.exports - last.first : 0;
+		unsigned long conflicts = (stats.conflicts > last.second) ? stats.conflicts - last.second : 0;
+
+		if (victim == solvers.size() || exports < victimExports ||
+			(exports == victimExports && conflicts < victimConflicts)) {
+			victim = i;
+			victimExports = exports;
+			victimConflicts = conflicts;
+		}
+	}
+
+	std::shared_ptr<SolverCdclInterface> solver = solvers[victim];
+
+	if (!m_portfolio->detachSolver(solver))
+		return;
+
+	solvers.erase(solvers.begin() + victim);
+	m_lastCounters.erase(solver->getSolverId());
+	m_evictions++;
+
+	LOGWARN("MemoryGovernor: solver %d evicted (%lu exports, %lu conflicts during the last period), %zu CDCL solvers "
+			"left",
+			solver->getSolverId(),
+			victimExports,
+			victimConflicts,
+			solvers.size());
+}
+
+void
+MemoryGovernor::printStats()
+{
+	LOGSTAT("MemoryGovernor: peak rss %ld KB, %u shrinks, %u evictions", m_peakRssKB, m_shrinks, m_evictions);
+}
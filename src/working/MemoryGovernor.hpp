@@ -0,0 +1,85 @@
+#pragma once
+
+#include "containers/FormulaArena.hpp"
+
+#include <thread>
+#include <unordered_map>
+
+class PortfolioSimple;
+
+/**
+ * @brief Memory governor of a PortfolioSimple, to avoid being killed by the OOM killer.
+ *
+ * At startup, the number of solvers is bounded using a per-solver memory estimate derived from the formula. Then, every
+ * memCheckPeriod milliseconds, the RSS of the process and the available memory of the machine are checked. Under
+ * pressure, the governor first asks the sharing strategies to drop their databases and filters. If the pressure
+ * persists at the next check, the least productive CDCL solver (fewest exported clauses, then fewest conflicts since
+ * the last check) is stopped and released.
+ * @ingroup working
+ */
+class MemoryGovernor
+{
+  public:
+	/**
+	 * @brief Constructor.
+	 * @param portfolio The portfolio to govern, it must outlive this object.
+	 */
+	MemoryGovernor(PortfolioSimple* portfolio);
+
+	~MemoryGovernor();
+
+	/**
+	 * @brief Rough estimate of the memory used by one CDCL solver on a formula: clause arena, watches, per-variable
+	 * data, and room for the learnt clauses.
+	 * @return The estimate in KB.
+	 */
+	static long estimateSolverMemoryKB(const FormulaArena& formula);
+
+	/**
+	 * @brief Maximum number of solvers fitting in the memory budget, at least 1 and at most maxSolvers.
+	 */
+	static unsigned int getMaxSolvers(const FormulaArena& formula, unsigned int maxSolvers);
+
+	/// Launch the governor thread.
+	void start();
+
+	/// Wait for the governor thread, it ends on globalEnding.
+	void join();
+
+	/// Print the number of shrinks and evictions, and the peak RSS.
+	void printStats();
+
+  protected:
+	/// Memory budget in KB
+	static long getBudgetKB();
+
+	/// Main loop of the governor thread.
+	void mainLoop();
+
+	/// Check the memory and react to pressure.
+	void check();
+
+	/// Ask all the databases and filters to release their memory.
+	void shrink();
+
+	/// Stop and release the least productive CDCL solver.
+	void evict();
+
+	PortfolioSimple* m_portfolio;
+
+	std::thread m_thread;
+
+	long m_budgetKB;
+
+	/// Set after a shrink, an eviction happens if the pressure is still there at the next check
+	bool m_shrunk = false;
+
+	/// Exports and conflicts of each solver at the last check, indexed by solver id
+	std::unordered_map<unsigned int, std::pair<unsigned long, unsigned long>> m_lastCounters;
+
+	unsigned int m_shrinks = 0;
+
+	unsigned int m_evictions = 0;
+
+	long m_peakRssKB = 0;
+};
@@ -0,0 +1,147 @@
+#include "working/PhaseExchange.hpp"
+#include "painless.hpp"
+#include "utils/Logger.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/System.hpp"
+
+#include <algorithm>
+
+PhaseExchange::PhaseExchange(unsigned int varCount,
+							 const std::vector<std::shared_ptr<SolverCdclInterface>>& cdclSolvers,
+							 const std::vector<std::shared_ptr<LocalSearchInterface>>& localSolvers)
+	: m_varCount(varCount)
+	, m_toCdcl(std::make_shared<PhaseSnapshot>(varCount))
+	, m_toLocalSearch(std::make_shared<PhaseSnapshot>(varCount))
+{
+	for (auto& cdcl : cdclSolvers)
+		connect(cdcl);
+
+	for (auto& local : localSolvers) {
+		m_localSearchPhases.push_back(std::make_shared<PhaseSnapshot>(varCount));
+		local->setPhaseExchange(m_localSearchPhases.back(), m_toLocalSearch);
+	}
+	m_localSearchVersions.resize(m_localSearchPhases.size(), 0);
+}
+
+PhaseExchange::~PhaseExchange()
+{
+	join();
+}
+
+void
+PhaseExchange::connect(const std::shared_ptr<SolverCdclInterface>& solver)
+{
+	std::lock_guard<std::mutex> lock(m_cdclMutex);
+	m_cdclPhases.push_back(std::make_shared<PhaseSnapshot>(m_varCount));
+	m_cdclVersions.push_back(0);
+	m_cdclSolvers.push_back(solver.get());
+	solver->setPhaseExchange(m_cdclPhases.back(), m_toCdcl);
+}
+
+void
+PhaseExchange::disconnect(const std::shared_ptr<SolverCdclInterface>& solver)
+{
+	std::lock_guard<std::mutex> lock(m_cdclMutex);
+	auto it = std::find(m_cdclSolvers.begin(), m_cdclSolvers.end(), solver.get());
+	if (it == m_cdclSolvers.end())
+		return;
+
+	size_t idx = it - m_cdclSolvers.begin();
+	m_cdclSolvers.erase(it);
+	m_cdclPhases.erase(m_cdclPhases.begin() + idx);
+	m_cdclVersions.erase(m_cdclVersions.begin() + idx);
+}
+
+void
+PhaseExchange::start()
+{
+	LOG0("[Phases] Exchange launched between %zu local search and %zu CDCL solvers",
+		 m_localSearchPhases.size(),
+		 m_cdclPhases.size());
+	m_thread = std::thread(&PhaseExchange::mainLoop, this);
+}
+
+void
+PhaseExchange::join()
+{
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+void
+PhaseExchange::mainLoop()
+{
+	const double period = __globalParameters__.phaseExchangePeriod / 1000.0;
+
+	while (!globalEnding) {
+		// Sliced wait, the timeout sets globalEnding after its notification
+		double start = SystemResourceMonitor::getRelativeTimeSeconds();
+		while (!globalEnding && SystemResourceMonitor::getRelativeTimeSeconds() - start < period) {
+			std::unique_lock<std::mutex> lock(mutexGlobalEnd);
+			condGlobalEnd.wait_for(lock,
+								   std::chrono::milliseconds(std::min(200, __globalParameters__.phaseExchangePeriod)));
+		}
+
+		if (globalEnding)
+			break;
+
+		exchange();
+	}
+}
+
+void
+PhaseExchange::exchange()
+{
+	m_periods++;
+	unsigned int quality;
+
+	/* Local search to CDCL */
+	/* -------------------- */
+	bool improved = false;
+	for (size_t i = 0; i < m_localSearchPhases.size(); i++) {
+		if (m_localSearchPhases[i]->read(m_phases, quality, m_localSearchVersions[i]) && quality < m_bestUnsat) {
+			m_bestUnsat = quality;
+			m_bestPhases.swap(m_phases);
+			improved = true;
+		}
+	}
+
+	if (improved) {
+		m_toCdcl->publish([this](unsigned int var) { return m_bestPhases[var] != 0; }, m_bestUnsat);
+		m_toCdclCount++;
+		LOG1("[Phases] local search assignment with %u unsatisfied clauses proposed to the CDCL solvers", m_bestUnsat);
+	}
+
+	/* CDCL to local search */
+	/* -------------------- */
+	unsigned int longestTrail = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_cdclMutex);
+		for (size_t i = 0; i < m_cdclPhases.size(); i++) {
+			if (m_cdclPhases[i]->read(m_phases, quality, m_cdclVersions[i]) && quality > longestTrail) {
+				longestTrail = quality;
+				m_trailPhases.swap(m_phases);
+			}
+		}
+	}
+
+	if (longestTrail) {
+		m_toLocalSearch->publish([this](unsigned int var) { return m_trailPhases[var] != 0; }, longestTrail);
+		m_toLocalSearchCount++;
+		m_longestTrail = std::max<unsigned long>(m_longestTrail, longestTrail);
+		LOG1("[Phases] CDCL trail of %u/%u variables proposed to the local search solvers", longestTrail, m_varCount);
+	}
+}
+
+void
+PhaseExchange::printStats()
+{
+	LOGSTAT("[Phases] periods %lu, proposed to CDCL %lu (best unsat %u), proposed to local search %lu (longest trail "
+			"%lu/%u)",
+			m_periods,
+			m_toCdclCount,
+			m_bestUnsat,
+			m_toLocalSearchCount,
+			m_longestTrail,
+			m_varCount);
+}
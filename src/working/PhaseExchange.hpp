@@ -0,0 +1,104 @@
+#pragma once
+
+#include "containers/PhaseSnapshot.hpp"
+#include "solvers/CDCL/SolverCdclInterface.hpp"
+#include "solvers/LocalSearch/LocalSearchInterface.hpp"
+
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Periodic exchange of phases between the local search and the CDCL solvers of a portfolio.
+ *
+ * Each connected solver publishes its best assignment in its own PhaseSnapshot: the local search solvers when their
+ * number of unsatisfied clauses decreases, the CDCL solvers when their best trail (the longest conflict-free trail of
+ * the stable mode) changes. Every phaseExchangePeriod milliseconds, the service thread collects them:
+ *  - the assignment with the fewest unsatisfied clauses found so far is proposed to the CDCL solvers, which adopt it
+ *    at the root level as their best and target phases (rephasing targets);
+ *  - the longest best trail published since the last period is proposed to the local search solvers, which start
+ *    their next (outer) restart from it.
+ *
+ * The snapshots are lock-free, neither the solvers nor the service ever wait. Solvers whose adapter does not support
+ * the exchange are connected but never publish nor read. The CDCL solvers launched or removed at runtime (bandit
+ * replacements, memory governor evictions) are connected and disconnected by the portfolio.
+ * @ingroup working
+ */
+class PhaseExchange
+{
+  public:
+	/**
+	 * @brief Connect the solvers, they must not be launched yet.
+	 * @param varCount Number of variables of the formula of the solvers.
+	 */
+	PhaseExchange(unsigned int varCount,
+				  const std::vector<std::shared_ptr<SolverCdclInterface>>& cdclSolvers,
+				  const std::vector<std::shared_ptr<LocalSearchInterface>>& localSolvers);
+
+	~PhaseExchange();
+
+	/**
+	 * @brief Connect a CDCL solver launched at runtime, before it is launched.
+	 * @param solver A solver of the formula given at construction.
+	 */
+	void connect(const std::shared_ptr<SolverCdclInterface>& solver);
+
+	/**
+	 * @brief Forget the snapshot of a removed CDCL solver, nothing is done if it was not connected.
+	 * @param solver A stopped solver.
+	 */
+	void disconnect(const std::shared_ptr<SolverCdclInterface>& solver);
+
+	/// Launch the service thread.
+	void start();
+
+	/// Wait for the service thread, it ends on globalEnding.
+	void join();
+
+	/// Print the number of assignments exchanged in each direction.
+	void printStats();
+
+  protected:
+	/// Main loop of the service thread.
+	void mainLoop();
+
+	/// Collect the new publications and propose the best ones.
+	void exchange();
+
+	unsigned int m_varCount;
+
+	std::thread m_thread;
+
+	/// Publications of the solvers and the versions already read
+	std::vector<std::shared_ptr<PhaseSnapshot>> m_localSearchPhases;
+	std::vector<uint64_t> m_localSearchVersions;
+	std::vector<std::shared_ptr<PhaseSnapshot>> m_cdclPhases;
+	std::vector<uint64_t> m_cdclVersions;
+
+	/// Connected CDCL solvers, in the order of m_cdclPhases, only compared on disconnect
+	std::vector<const SolverCdclInterface*> m_cdclSolvers;
+
+	/// Protects the CDCL vectors, changed at runtime by connect and disconnect
+	std::mutex m_cdclMutex;
+
+	/// Lowest-unsat local search assignment, read by the CDCL solvers
+	std::shared_ptr<PhaseSnapshot> m_toCdcl;
+
+	/// Best CDCL trail of the last period, read by the local search solvers
+	std::shared_ptr<PhaseSnapshot> m_toLocalSearch;
+
+	/// Read buffer, lowest-unsat local search assignment and longest CDCL trail of the period
+	std::vector<char> m_phases;
+	std::vector<char> m_bestPhases;
+	std::vector<char> m_trailPhases;
+	unsigned int m_bestUnsat = UINT_MAX;
+
+	// Stats
+	//------
+	unsigned long m_periods = 0;
+	unsigned long m_toCdclCount = 0;
+	unsigned long m_toLocalSearchCount = 0;
+	unsigned long m_longestTrail = 0;
+};
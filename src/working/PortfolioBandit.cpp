@@ -0,0 +1,317 @@
+#include "working/PortfolioBandit.hpp"
+#include "painless.hpp"
+#include "utils/Logger.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/Placement.hpp"
+#include "utils/System.hpp"
+#include "working/PortfolioSimple.hpp"
+#include "working/SequentialWorker.hpp"
+
+#include "sharing/SharingStrategyFactory.hpp"
+#include "solvers/SolverFactory.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+PortfolioBandit::PortfolioBandit(PortfolioSimple* portfolio,
+								 std::shared_ptr<const FormulaArena> formula,
+								 const std::vector<int>& cube)
+	: SharingEntity()
+	, m_portfolio(portfolio)
+	, m_formula(std::move(formula))
+	, m_cube(cube)
+	, m_recentClauses(__globalParameters__.banditWarmClauses)
+{
+	for (char type : __globalParameters__.solver) {
+		if (type == 'y' || type == 't' || type == 'p')
+			continue;
+		if (std::none_of(m_arms.begin(), m_arms.end(), [type](const Arm& arm) { return arm.type == type; }))
+			m_arms.push_back(Arm{ type });
+	}
+}
+
+PortfolioBandit::~PortfolioBandit()
+{
+	join();
+}
+
+void
+PortfolioBandit::start()
+{
+	LOG0("Bandit reconfiguration every %d s over %zu arms", __globalParameters__.banditPeriod, m_arms.size());
+	m_thread = std::thread(&PortfolioBandit::mainLoop, this);
+}
+
+void
+PortfolioBandit::join()
+{
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+bool
+PortfolioBandit::importClause(const ClauseExchangePtr& clause)
+{
+	ClauseExchangePtr oldest;
+	while (!m_recentClauses.tryAddClauseBounded(clause)) {
+		if (!m_recentClauses.getClause(oldest))
+			return false;
+	}
+	return true;
+}
+
+void
+PortfolioBandit::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+{
+	for (const auto& clause : clauses)
+		importClause(clause);
+}
+
+char
+PortfolioBandit::getSolverChar(SolverCdclType type)
+{
+	switch (type) {
+		case SolverCdclType::GLUCOSE:
+			return 'g';
+		case SolverCdclType::LINGELING:
+			return 'l';
+		case SolverCdclType::CADICAL:
+			return 'c';
+		case SolverCdclType::MINISAT:
+			return 'm';
+		case SolverCdclType::KISSAT:
+			return 'k';
+		case SolverCdclType::MAPLECOMSPS:
+			return 'M';
+		case SolverCdclType::KISSATMAB:
+			return 'K';
+		case SolverCdclType::KISSATINC:
+			return 'I';
+	}
+	return 0;
+}
+
+void
+PortfolioBandit::mainLoop()
+{
+	const double period = __globalParameters__.banditPeriod;
+
+	while (!globalEnding) {
+		// Sliced wait, the timeout sets globalEnding after its notification
+		double start = SystemResourceMonitor::getRelativeTimeSeconds();
+		while (!globalEnding && SystemResourceMonitor::getRelativeTimeSeconds() - start < period) {
+			std::unique_lock<std::mutex> lock(mutexGlobalEnd);
+			condGlobalEnd.wait_for(lock, std::chrono::milliseconds(200));
+		}
+
+		if (globalEnding || m_portfolio->strategyEnding)
+			break;
+
+		std::lock_guard<std::mutex> lock(m_portfolio->reconfigurationMutex);
+		evaluate();
+		m_rounds++;
+	}
+
+	LOGDEBUG1("Bandit supervisor ended after %lu rounds", m_rounds);
+}
+
+void
+PortfolioBandit::evaluate()
+{
+	auto& solvers = m_portfolio->cdclSolvers;
+	const size_t count = solvers.size();
+
+	if (count == 0)
+		return;
+
+	std::vector<SolvingCdclStatistics> deltas(count);
+	std::vector<bool> hasSearchCounters(count);
+	unsigned long maxConflicts = 0, maxPropagations = 0, maxExports = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		SolvingCdclStatistics current = solvers[i]->getStatistics();
+		SolverRecord& record = m_records[solvers[i]->getSolverId()];
+
+		deltas[i].conflicts = (current.conflicts > record.last.conflicts) ? current.conflicts - record.last.conflicts : 0;
+		deltas[i].propagations =
+			(current.propagations > record.last.propagations) ? current.propagations - record.last.propagations : 0;
+		deltas[i].exports = (current.exports > record.last.exports) ? current.exports - record.last.exports : 0;
+		/* Some adapters (KissatMAB, KissatINC) only provide the exports */
+		hasSearchCounters[i] = current.conflicts || current.propagations;
+
+		record.last = current;
+		record.age++;
+
+		maxConflicts = std::max(maxConflicts, deltas[i].conflicts);
+		maxPropagations = std::max(maxPropagations, deltas[i].propagations);
+		maxExports = std::max(maxExports, deltas[i].exports);
+	}
+
+	size_t worst = count, best = count;
+
+	for (size_t i = 0; i < count; i++) {
+		double reward = 0;
+		unsigned int terms = 0;
+
+		if (hasSearchCounters[i] && maxConflicts) {
+			reward += (double)deltas[i].conflicts / maxConflicts;
+			terms++;
+		}
+		if (hasSearchCounters[i] && maxPropagations) {
+			reward += (double)deltas[i].propagations / maxPropagations;
+			terms++;
+		}
+		if (maxExports) {
+			reward += (double)deltas[i].exports / maxExports;
+			terms++;
+		}
+		if (terms)
+			reward /= terms;
+
+		SolverRecord& record = m_records[solvers[i]->getSolverId()];
+		record.score = (record.age == 1) ? reward : 0.5 * record.score + 0.5 * reward;
+
+		char type = getSolverChar(solvers[i]->getSolverType());
+		for (Arm& arm : m_arms) {
+			if (arm.type == type) {
+				arm.rewardSum += reward;
+				arm.pulls++;
+				break;
+			}
+		}
+
+		LOG2("[Bandit] Solver %u (%c) reward %.3f, score %.3f (conflicts %lu, propagations %lu, exports %lu)",
+			 solvers[i]->getSolverId(),
+			 type,
+			 reward,
+			 record.score,
+			 deltas[i].conflicts,
+			 deltas[i].propagations,
+			 deltas[i].exports);
+
+		if (best == count || record.score > m_records[solvers[best]->getSolverId()].score)
+			best = i;
+		// A replacement loads the original formula, the solvers restarted by the PRS pipeline keep the simplified one
+		if (record.age >= (unsigned)__globalParameters__.banditMinAge &&
+			(worst == count || record.score < m_records[solvers[worst]->getSolverId()].score) &&
+			!m_portfolio->isSimplifiedSolver(solvers[i]))
+			worst = i;
+	}
+
+	if (worst == count || worst == best)
+		return;
+
+	double worstScore = m_records[solvers[worst]->getSolverId()].score;
+	double bestScore = m_records[solvers[best]->getSolverId()].score;
+
+	if (worstScore < __globalParameters__.banditReplaceRatio * bestScore)
+		replaceSolver(worst, selectArm());
+}
+
+size_t
+PortfolioBandit::selectArm()
+{
+	unsigned long totalPulls = 0;
+
+	for (size_t i = 0; i < m_arms.size(); i++) {
+		if (!m_arms[i].pulls)
+			return i;
+		totalPulls += m_arms[i].pulls;
+	}
+
+	size_t selected = 0;
+	double bestUcb = -std::numeric_limits<double>::infinity();
+
+	for (size_t i = 0; i < m_arms.size(); i++) {
+		double ucb = m_arms[i].rewardSum / m_arms[i].pulls +
+					 __globalParameters__.banditExploration * std::sqrt(std::log((double)totalPulls) / m_arms[i].pulls);
+		if (ucb > bestUcb) {
+			bestUcb = ucb;
+			selected = i;
+		}
+	}
+
+	return selected;
+}
+
+void
+PortfolioBandit::replaceSolver(size_t idx, size_t armIdx)
+{
+	std::shared_ptr<SolverCdclInterface> oldSolver = m_portfolio->cdclSolvers[idx];
+	SolvingCdclStatistics oldStats = oldSolver->getStatistics();
+
+	if (!m_portfolio->detachSolver(oldSolver) || globalEnding)
+		return;
+
+	std::shared_ptr<SolverInterface> created;
+	if (SolverFactory::createSolver(
+			m_arms[armIdx].type, __globalParameters__.importDB.c_str()[0], oldSolver->getSolverId(), created) !=
+		SolverAlgorithmType::CDCL) {
+		LOGERROR("Bandit could not instantiate a solver of type '%c'", m_arms[armIdx].type);
+		return;
+	}
+
+	std::shared_ptr<SolverCdclInterface> newSolver = std::static_pointer_cast<SolverCdclInterface>(created);
+	newSolver->setSolverTypeId(m_portfolio->typeIDScaler(newSolver));
+	newSolver->diversify();
+	newSolver->addInitialClauses(m_formula->data(), m_formula->getClausesCount(), m_formula->getVariablesCount());
+
+	// Warm-start with the recently shared clauses, they are kept for the next replacements
+	std::vector<ClauseExchangePtr> warmClauses;
+	m_recentClauses.getClauses(warmClauses);
+	newSolver->importClauses(warmClauses);
+	importClauses(warmClauses);
+
+	if (!m_portfolio->localStrategies.empty()) {
+		std::vector<std::shared_ptr<SolverCdclInterface>> newSolvers = { newSolver };
+		SharingStrategyFactory::addEntitiesToLocal(m_portfolio->localStrategies, newSolvers);
+	} else {
+		for (auto& gstrat : m_portfolio->globalStrategies) {
+			gstrat->addProducer(newSolver);
+			gstrat->addClient(newSolver);
+			gstrat->connectProducer(newSolver);
+		}
+	}
+
+	if (m_portfolio->phaseExchange)
+		m_portfolio->phaseExchange->connect(newSolver);
+
+	m_portfolio->cdclSolvers[idx] = newSolver;
+	m_records.erase(newSolver->getSolverId());
+	m_arms[armIdx].launched++;
+	m_replacements++;
+
+	LOG1("[Bandit] Solver %u (%c, conflicts %lu, exports %lu) replaced by a %c solver warm-started with %zu clauses",
+		 oldSolver->getSolverId(),
+		 getSolverChar(oldSolver->getSolverType()),
+		 oldStats.conflicts,
+		 oldStats.exports,
+		 m_arms[armIdx].type,
+		 warmClauses.size());
+
+	SequentialWorker* newWorker = new SequentialWorker(newSolver);
+	newWorker->setThreadAffinity(ThreadPlacement::getCore(idx));
+	{
+		std::lock_guard<std::mutex> lock(m_portfolio->slavesMutex);
+		m_portfolio->addSlave(newWorker);
+	}
+	newWorker->solve(m_cube);
+
+	// The portfolio may have been interrupted before the new worker was registered
+	if (globalEnding || m_portfolio->strategyEnding)
+		newWorker->setSolverInterrupt();
+}
+
+void
+PortfolioBandit::printStats()
+{
+	LOGSTAT("Bandit: %lu rounds, %u replacements", m_rounds, m_replacements);
+	for (const Arm& arm : m_arms) {
+		LOGSTAT("Bandit arm '%c': pulls %lu, mean reward %.3f, launched %u",
+				arm.type,
+				arm.pulls,
+				arm.pulls ? arm.rewardSum / arm.pulls : 0.0,
+				arm.launched);
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "containers/ClauseBuffer.hpp"
+#include "containers/FormulaArena.hpp"
+#include "containers/SimpleTypes.hpp"
+#include "sharing/SharingEntity.hpp"
+#include "solvers/CDCL/SolverCdclInterface.hpp"
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class PortfolioSimple;
+
+/**
+ * @brief Supervisor reconfiguring the CDCL portfolio of a PortfolioSimple at runtime.
+ *
+ * Every banditPeriod seconds, the counters of each CDCL solver (SolvingCdclStatistics) are read and the progress done
+ * during the period is turned into a reward in [0,1]. Each solver type of the portfolio is an arm of a UCB1 bandit fed
+ * with the rewards of its solvers. When the solver with the lowest smoothed score is far behind the best one, it is
+ * stopped and replaced by a new diversified solver of the arm with the highest UCB score. The solvers restarted on
+ * the simplified formula by the PRS pipeline are never replaced.
+ *
+ * The supervisor is a client of the local sharing strategies, the recently shared clauses are kept to warm-start the
+ * import database of the new solvers.
+ * @ingroup working
+ */
+class PortfolioBandit : public SharingEntity
+{
+  public:
+	/**
+	 * @brief Constructor.
+	 * @param portfolio The portfolio to reconfigure, it must outlive this object.
+	 * @param formula The shared initial formula, kept to initialize the new solvers.
+	 * @param cube The cube given to the initial solvers.
+	 */
+	PortfolioBandit(PortfolioSimple* portfolio,
+					std::shared_ptr<const FormulaArena> formula,
+					const std::vector<int>& cube);
+
+	~PortfolioBandit();
+
+	/// Launch the supervisor thread.
+	void start();
+
+	/// Wait for the supervisor thread, it ends on globalEnding.
+	void join();
+
+	/// Store a recently shared clause for warm-starts, the oldest one is evicted when the window is full.
+	bool importClause(const ClauseExchangePtr& clause) override;
+
+	/// Store recently shared clauses for warm-starts.
+	void importClauses(const std::vector<ClauseExchangePtr>& clauses) override;
+
+	/// Print the arms statistics and the number of replacements.
+	void printStats();
+
+	/// Returns the option character used by SolverFactory for a CDCL type.
+	static char getSolverChar(SolverCdclType type);
+
+  protected:
+	/// One arm per CDCL solver type of the portfolio
+	struct Arm
+	{
+		char type;
+		double rewardSum = 0;
+		unsigned long pulls = 0;
+		unsigned int launched = 0;
+	};
+
+	/// Bandit state of a running solver
+	struct SolverRecord
+	{
+		SolvingCdclStatistics last;
+		double score = 0;
+		unsigned int age = 0;
+	};
+
+	/// Main loop of the supervisor thread.
+	void mainLoop();
+
+	/// Read the statistics, update the arms and replace the worst solver if needed.
+	void evaluate();
+
+	/// Index of the arm with the highest UCB1 score.
+	size_t selectArm();
+
+	/// Stop the solver at index idx of the portfolio and launch a new one of type armIdx.
+	void replaceSolver(size_t idx, size_t armIdx);
+
+	PortfolioSimple* m_portfolio;
+
+	std::shared_ptr<const FormulaArena> m_formula;
+
+	std::vector<int> m_cube;
+
+	std::vector<Arm> m_arms;
+
+	/// Records indexed by solver id
+	std::unordered_map<unsigned int, SolverRecord> m_records;
+
+	/// Window of the bandit-warm-cls most recently shared clauses, used to warm-start new solvers
+	ClauseBuffer m_recentClauses;
+
+	std::thread m_thread;
+
+	unsigned long m_rounds = 0;
+
+	unsigned int m_replacements = 0;
+};
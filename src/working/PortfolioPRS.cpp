@@ -280,10 +280,9 @@ prs_sync:
 	 * Producers exports their clauses to local Strategy which in turn exports to global Strategy
 	 * Producers clause production is managed by the local strategy
 	 * Received clauses from other nodes are directly exported to consumers
-	 * Received clauses from previous node are transfered to next node, thus globalStrategy is its own client
+	 * Received clauses from previous node are forwarded to next node by globalStrategy itself
 	 */
 	localStrategy->addClient(globalStrategy);
-	globalStrategy->addClient(globalStrategy);
 
 	/* Connect all solvers as consumers and producers of local strategy */
 	for (auto& solver : cdclSolvers) {
@@ -293,6 +292,14 @@ prs_sync:
 		globalStrategy->addClient(solver);		// All solvers are clients of the global strategy
 	}
 
+	/* Local search solvers only consume (their learned units and binaries) */
+	if (!__globalParameters__.noLsImport) {
+		for (auto& local : localSolvers) {
+			localStrategy->addClient(local);
+			globalStrategy->addClient(local);
+		}
+	}
+
 	/* Launch sharers */
 	SharingStrategyFactory::launchSharers(sharingStrategies, this->sharers);
 
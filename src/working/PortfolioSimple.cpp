@@ -5,16 +5,22 @@
 #include "utils/Parameters.hpp"
 #include "utils/System.hpp"
 #include "working/SequentialWorker.hpp"
+#include <algorithm>
 #include <thread>
 
 #include "containers/ClauseDatabases/ClauseDatabaseFactory.hpp"
+#include "containers/FormulaArena.hpp"
 #include "preprocessors/PRS-Preprocessors/preprocess.hpp"
+#include "preprocessors/SymmetryBreaking.hpp"
+#include "preprocessors/VariableElimination.hpp"
 #include "sharing/GlobalStrategies/MallobSharing.hpp"
 
 #include "preprocessors/GaspiInitializer.hpp"
 #include "sharing/SharingStrategyFactory.hpp"
 #include "solvers/SolverFactory.hpp"
 #include "utils/Parsers.hpp"
+#include "utils/Placement.hpp"
+#include "working/MemoryGovernor.hpp"
 
 #include "preprocessors/GaspiInitializer.hpp"
 
@@ -22,13 +28,49 @@ PortfolioSimple::PortfolioSimple() {}
 
 PortfolioSimple::~PortfolioSimple()
 {
+	// The pipeline may still be preprocessing or restarting solvers
+	if (pipelineThread.joinable()) {
+		for (auto& preproc : preprocessors)
+			preproc->setSolverInterrupt();
+		pipelineThread.join();
+	}
+
+	// The bandit may still be replacing a solver
+	if (bandit) {
+		bandit->join();
+		bandit->printStats();
+	}
+
+	if (governor) {
+		governor->join();
+		governor->printStats();
+	}
+
+	if (probing) {
+		probing->join();
+		probing->printStats();
+	}
+
+	if (phaseExchange) {
+		phaseExchange->join();
+		phaseExchange->printStats();
+	}
+
+	if (termination) {
+		termination->join();
+		termination->printStats();
+	}
+
+	if (prepCache)
+		prepCache->printStats();
+
 	// Wait for sharers in order to have stats and mpi_winner if dist
-	for (int i = 0; i < sharers.size(); i++) {
+	for (size_t i = 0; i < sharers.size(); i++) {
 		sharers[i]->join();
 	}
 
 	// Restore Model if preprocessors were equisatisfiable
-	if (mpi_rank <= 0 && finalResult == SatResult::SAT) {
+	if (mpi_rank <= 0 && finalResult == SatResult::SAT && restoreThroughPreprocessors) {
 		for (auto it = preprocessors.rbegin(); it != preprocessors.rend(); ++it) {
 			LOGDEBUG1("preprocessor %u", std::distance(it, preprocessors.rend()) - 1);
 			(*it)->restoreModel(finalModel);
@@ -54,9 +96,16 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 
 	strategyEnding = false;
 
-	std::vector<simpleClause> initClauses;
+	if (!ThreadPlacement::initialize(__globalParameters__.pinning))
+		LOGWARN("Invalid pinning policy '%s'", __globalParameters__.pinning.c_str());
+	ThreadPlacement::printPlacement();
+
+	// Zero terminated clauses, moved into the shared arena once the formula is known to every process
+	std::vector<lit_t> initLiterals;
+	// Set directly by a preprocessing cache hit, otherwise created from initLiterals
+	std::shared_ptr<const FormulaArena> formula;
 	unsigned int varCount;
-	unsigned int clausesCount;
+	unsigned int clausesCount = 0;
 	int receivedFinalResultBcast = 0;
 
 	// TODO: merge these threads with sequential workers in next version, for less OS intensive calls
@@ -65,8 +114,40 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 	// TODO Reimplement (and separate) PRS techniques compatible with zero ended clauses, in order to not loose time in
 	// serialization for mpi, and have better locality
 
+	// In pipelined mode, the solvers start on the original formula and PRS runs in the background
+	pipelined = __globalParameters__.prs && __globalParameters__.prsPipeline;
+	if (pipelined && dist) {
+		LOGWARN("The PRS pipeline is not supported in distributed mode, PRS runs before solving");
+		pipelined = false;
+	}
+	if (pipelined && __globalParameters__.sym)
+		LOGWARN("Symmetry breaking is not supported with the PRS pipeline, it is disabled");
+
 	if (mpi_rank <= 0) {
-		if (__globalParameters__.prs) {
+		// A previous run on the same formula and parameters replaces PRS and BVE
+		bool cached = false;
+		if (!__globalParameters__.prepCache.empty() && !pipelined && cube.empty() &&
+			(__globalParameters__.prs || __globalParameters__.bve)) {
+			prepCache = std::make_unique<PreprocessingCache>(__globalParameters__.prepCache,
+															 __globalParameters__.filename);
+			if (__globalParameters__.prs)
+				this->preprocessors.push_back(std::make_shared<preprocess>(0));
+			if (__globalParameters__.bve)
+				this->preprocessors.push_back(std::make_shared<VariableElimination>(this->preprocessors.size()));
+
+			SatResult cachedResult;
+			cached = prepCache->load(this->preprocessors, cachedResult, formula, varCount, clausesCount);
+			if (!cached) {
+				this->preprocessors.clear();
+			} else if (cachedResult == SatResult::UNSAT) {
+				LOG0("The preprocessing cache answered UNSAT");
+				finalResult = SatResult::UNSAT;
+				this->join(this, finalResult, {});
+				receivedFinalResultBcast = static_cast<int>(finalResult.load());
+			}
+		}
+
+		if (!cached && __globalParameters__.prs && !pipelined) {
 			/* PRS */
 			this->preprocessors.push_back(std::make_shared<preprocess>(0));
 			this->preprocessors.at(0)->loadFormula(__globalParameters__.filename.c_str());
@@ -96,11 +177,68 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 				auto lastSimplification = preprocessors.back();
 				varCount = lastSimplification->getVariablesCount();
 
-				initClauses = std::move(lastSimplification->getSimplifiedFormula());
+				std::vector<simpleClause> simplified = std::move(lastSimplification->getSimplifiedFormula());
+				clausesCount = simplified.size();
+				for (auto& clause : simplified) {
+					initLiterals.insert(initLiterals.end(), clause.begin(), clause.end());
+					initLiterals.push_back(0);
+					simpleClause().swap(clause);
+				}
 			}
-		} else if (!Parsers::parseCNF(__globalParameters__.filename.c_str(), initClauses, &varCount)) {
+		} else if (!cached && !Parsers::parseCNF(
+					   __globalParameters__.filename.c_str(), initLiterals, &varCount, &clausesCount)) {
 			PABORT(PERR_PARSING, "Error at parsing!");
 		}
+
+		// BVE runs once for all the solvers, on the formula given by PRS if any (in pipelined mode, after PRS)
+		if (__globalParameters__.bve && !pipelined && !cached && receivedFinalResultBcast == 0) {
+			this->preprocessors.push_back(std::make_shared<VariableElimination>(this->preprocessors.size()));
+			this->preprocessors.back()->addInitialClauses(initLiterals.data(), clausesCount, varCount);
+			std::vector<lit_t>().swap(initLiterals);
+
+			if (this->eliminateVariables(cube) == SatResult::UNKNOWN) {
+				std::vector<simpleClause> simplified = this->preprocessors.back()->getSimplifiedFormula();
+				this->preprocessors.back()->releaseMemory();
+				clausesCount = simplified.size();
+				for (auto& clause : simplified) {
+					initLiterals.insert(initLiterals.end(), clause.begin(), clause.end());
+					initLiterals.push_back(0);
+					simpleClause().swap(clause);
+				}
+			}
+
+			receivedFinalResultBcast = static_cast<int>(finalResult.load());
+		}
+
+		if (prepCache && !cached)
+			prepCache->store(this->preprocessors, finalResult.load(), initLiterals, varCount, clausesCount);
+
+		// The breaking clauses are not implied by the formula, they are added once the other preprocessors ran
+		if (__globalParameters__.sym && !pipelined && receivedFinalResultBcast == 0) {
+			this->preprocessors.push_back(std::make_shared<SymmetryBreaking>(this->preprocessors.size()));
+			this->preprocessors.back()->addInitialClauses(
+				formula ? formula->data() : initLiterals.data(), clausesCount, varCount);
+			std::vector<lit_t>().swap(initLiterals);
+			formula.reset();
+
+			if (this->preprocessors.back()->solve(cube) == SatResult::UNSAT) {
+				LOG0("SYM answered UNSAT");
+				finalResult = SatResult::UNSAT;
+				this->join(this, finalResult, {});
+			} else {
+				std::vector<simpleClause> clauses = this->preprocessors.back()->getSimplifiedFormula();
+				varCount = this->preprocessors.back()->getVariablesCount();
+				this->preprocessors.back()->releaseMemory();
+				clausesCount = clauses.size();
+				for (auto& clause : clauses) {
+					initLiterals.insert(initLiterals.end(), clause.begin(), clause.end());
+					initLiterals.push_back(0);
+					simpleClause().swap(clause);
+				}
+			}
+
+			receivedFinalResultBcast = static_cast<int>(finalResult.load());
+		}
 	}
 
 	// Send instance via MPI from leader 0 to workers.
@@ -116,21 +254,50 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 			condGlobalEnd.notify_all();
 			mutexGlobalEnd.unlock();
 			return;
-		} else // send formula if not solved by preprocessing
-			mpiutils::sendFormula(initClauses, &varCount, 0);
+		} else { // send formula if not solved by preprocessing
+			// The broadcast needs the literals of a cache hit in a vector
+			if (formula) {
+				initLiterals.assign(formula->data(), formula->data() + formula->getLiteralsCount() + clausesCount);
+				formula.reset();
+			}
+			mpiutils::sendFormula(initLiterals, &clausesCount, &varCount, 0);
+		}
+
+		/* The end of a process stops the solvers of all the others, without waiting for a global sharing round */
+		if (mpi_world_size > 1 && __globalParameters__.endPollPeriod > 0) {
+			if (DistributedTermination::isSupported()) {
+				termination = std::make_unique<DistributedTermination>(this);
+				termination->start();
+			} else
+				LOGWARN("MPI_THREAD_MULTIPLE is not provided, the end is only detected in the global sharing rounds");
+		}
+	}
+
+	if (pipelined) {
+		/* PRS */
+		this->preprocessors.push_back(std::make_shared<preprocess>(0));
+		if (__globalParameters__.bve)
+			this->preprocessors.push_back(std::make_shared<VariableElimination>(1));
+		pipelineThread = std::thread(&PortfolioSimple::runPipeline, this, cube);
 	}
 
+	// Single read-only copy of the formula, loaded by all the solvers of this process
+	if (!formula)
+		formula = FormulaArena::create(std::move(initLiterals), clausesCount, varCount);
+
 	// Init Database Factory For Solvers (Is it better to put this in the SolverFactory as for SharingFactory ?)
 	ClauseDatabaseFactory::initialize(__globalParameters__.maxClauseSize, __globalParameters__.importDBCap, 2, 1);
 
-	SolverFactory::createSolvers(__globalParameters__.cpus,
+	unsigned int solverCount = __globalParameters__.cpus;
+	if (__globalParameters__.memGovernor)
+		solverCount = MemoryGovernor::getMaxSolvers(*formula, solverCount);
+
+	SolverFactory::createSolvers(solverCount,
 								 __globalParameters__.importDB.c_str()[0],
 								 __globalParameters__.solver,
 								 cdclSolvers,
 								 localSolvers);
 
-	IDScaler globalIDScaler;
-	IDScaler typeIDScaler;
 	if (dist) {
 		globalIDScaler = [rank = mpi_rank,
 						  size = __globalParameters__.cpus](const std::shared_ptr<SolverInterface>& solver) {
@@ -178,6 +345,27 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 		}
 	}
 
+	/* The local search solvers consume the learned units and binaries, from all the local strategies */
+	if (!__globalParameters__.noLsImport) {
+		for (auto& local : localSolvers)
+			for (auto& lstrat : this->localStrategies)
+				lstrat->addClient(local);
+	}
+
+	/* The probing service produces for the first local strategy, which shares to all the solvers, and listens to all
+	 * the local strategies. It is connected before the solvers start exporting. */
+	if (__globalParameters__.probe && !this->localStrategies.empty()) {
+		probing = std::make_shared<ProbingService>(formula, __globalParameters__.probeThreads);
+		this->localStrategies.front()->addProducer(probing);
+		this->localStrategies.front()->connectProducer(probing);
+		for (auto& lstrat : this->localStrategies)
+			lstrat->addClient(probing);
+	}
+
+	/* The solvers are connected to the phase exchange before they are launched */
+	if (__globalParameters__.phaseExchangePeriod > 0 && !cdclSolvers.empty() && !localSolvers.empty())
+		phaseExchange = std::make_unique<PhaseExchange>(formula->getVariablesCount(), cdclSolvers, localSolvers);
+
 	std::vector<std::shared_ptr<SharingStrategy>> sharingStrategiesConcat;
 
 	/* Launch sharers */
@@ -190,17 +378,30 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 
 	if (globalEnding) {
 		this->setSolverInterrupt();
+		// The end may be decided remotely during the setup, the global strategies must still join the ending round
+		if (dist)
+			SharingStrategyFactory::launchSharers(sharingStrategiesConcat, this->sharers);
 		return;
 	}
 
 	/* Solving */
 	// Load formula in solvers in parallel using solverInitializers
 
+	// The placement index of a solver is its rank in cdclSolvers then localSolvers. The initializer is pinned on the
+	// core of its solver, so that the solver memory is first-touched on the right NUMA node.
+	unsigned int placementIndex = 0;
+
 	for (auto& cdcl : cdclSolvers) {
 		SequentialWorker* myworker = new SequentialWorker(cdcl);
 		this->addSlave(myworker);
-		solverInitializers.emplace_back([myworker, &cube, &cdcl, &initClauses, varCount, clausesCount] {
-			cdcl->addInitialClauses(initClauses, varCount);
+		int core = ThreadPlacement::getCore(placementIndex++);
+		if (core >= 0)
+			LOG0("Placement: solver %d on core %d (node %d)", cdcl->getSolverId(), core, ThreadPlacement::getNode(core));
+		solverInitializers.emplace_back([myworker, &cube, &cdcl, formula, core] {
+			if (ThreadPlacement::pinCurrentThread(core))
+				cdcl->setImportDatabase(ClauseDatabaseFactory::createDatabase(__globalParameters__.importDB.at(0)));
+			cdcl->addInitialClauses(formula->data(), formula->getClausesCount(), formula->getVariablesCount());
+			myworker->setThreadAffinity(core);
 			myworker->solve(cube);
 		});
 	}
@@ -208,8 +409,13 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 	for (auto& local : localSolvers) {
 		SequentialWorker* myworker = new SequentialWorker(local);
 		this->addSlave(myworker);
-		solverInitializers.emplace_back([myworker, &cube, &local, &initClauses, varCount, clausesCount] {
-			local->addInitialClauses(initClauses, varCount);
+		int core = ThreadPlacement::getCore(placementIndex++);
+		if (core >= 0)
+			LOG0("Placement: solver %d on core %d (node %d)", local->getSolverId(), core, ThreadPlacement::getNode(core));
+		solverInitializers.emplace_back([myworker, &cube, &local, formula, core] {
+			ThreadPlacement::pinCurrentThread(core);
+			local->addInitialFormula(formula);
+			myworker->setThreadAffinity(core);
 			myworker->solve(cube);
 		});
 	}
@@ -225,9 +431,13 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 	// In case GASPI is enabled
 	if (__globalParameters__.gaInitPeriod) {
 
-		if (__globalParameters__.gaPopSize < cdclSolvers.size())
+		if (static_cast<size_t>(__globalParameters__.gaPopSize) < cdclSolvers.size())
 			__globalParameters__.gaPopSize = cdclSolvers.size();
 
+		// The genetic algorithm works on a clause vector
+		std::vector<simpleClause> initClauses;
+		formula->toClauses(initClauses);
+
 		LOG0("GA Initialized");
 		saga::GeneticAlgorithm gaInitializer(__globalParameters__.gaPopSize,
 											 varCount,
@@ -254,7 +464,7 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 				saga::Solution& initPhases = gaInitializer.getNthSolution(solIdx);
 
 				// Todo fix the +1 on solution size, it is confusing
-				for (int i = 1; i < varCount; i++) {
+				for (unsigned int i = 1; i < varCount; i++) {
 					cdcl->setPhase(i, initPhases[i]);
 				}
 
@@ -272,7 +482,7 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 				saga::Solution& initPhases = gaInitializer.getNthSolution(solIdx);
 
 				// Todo fix the +1 on solution size, it is confusing
-				for (int i = 1; i < varCount; i++) {
+				for (unsigned int i = 1; i < varCount; i++) {
 					local->setPhase(i, initPhases[i]);
 				}
 
@@ -281,7 +491,170 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 		}
 	}
 
-	initClauses.clear();
+	if (__globalParameters__.banditPeriod > 0 && !cdclSolvers.empty()) {
+		// The bandit keeps the formula to initialize the new solvers
+		bandit = std::make_shared<PortfolioBandit>(this, formula, cube);
+		for (auto& lstrat : this->localStrategies)
+			lstrat->addClient(bandit);
+		bandit->start();
+	}
+
+	if (__globalParameters__.memGovernor) {
+		governor = std::make_unique<MemoryGovernor>(this);
+		governor->start();
+	}
+
+	if (probing)
+		probing->start();
+
+	if (phaseExchange)
+		phaseExchange->start();
+
+	// From now on, the pipeline may replace the initial solvers
+	{
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		solversLaunched = true;
+	}
+	pipelineCond.notify_all();
+}
+
+void
+PortfolioSimple::runPipeline(std::vector<int> cube)
+{
+	std::shared_ptr<PreprocessorInterface> prs = this->preprocessors.front();
+	double start = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	prs->loadFormula(__globalParameters__.filename.c_str());
+	SatResult res = prs->solve({});
+
+	if (globalEnding || strategyEnding)
+		return;
+
+	if (res == SatResult::UNSAT) {
+		LOG0("PRS answered UNSAT");
+		this->join(this, res, {});
+		return;
+	} else if (res == SatResult::SAT) {
+		LOG0("PRS answered SAT");
+		this->join(this, res, prs->getModel());
+		return;
+	}
+
+	prs->releaseMemory();
+	std::vector<simpleClause> clauses = prs->getSimplifiedFormula();
+	unsigned int varCount = prs->getVariablesCount();
+
+	// BVE goes on from the formula simplified by PRS
+	if (this->preprocessors.size() > 1) {
+		std::shared_ptr<PreprocessorInterface> bve = this->preprocessors.back();
+		bve->addInitialClauses(clauses, varCount);
+		std::vector<simpleClause>().swap(clauses);
+
+		if (this->eliminateVariables(cube) != SatResult::UNKNOWN || globalEnding || strategyEnding)
+			return;
+
+		clauses = bve->getSimplifiedFormula();
+		bve->releaseMemory();
+	}
+
+	std::shared_ptr<const FormulaArena> simplified = FormulaArena::create(clauses, varCount);
+	std::vector<simpleClause>().swap(clauses);
+
+	LOG0("[Pipeline] Preprocessing finished in %.2fs: %u variables, %u clauses",
+		 SystemResourceMonitor::getRelativeTimeSeconds() - start,
+		 simplified->getVariablesCount(),
+		 simplified->getClausesCount());
+
+	// Sliced wait, the end of the solving is not notified on pipelineCond
+	{
+		std::unique_lock<std::mutex> lock(pipelineMutex);
+		while (!solversLaunched && !globalEnding && !strategyEnding)
+			pipelineCond.wait_for(lock, std::chrono::milliseconds(200));
+	}
+
+	if (globalEnding || strategyEnding)
+		return;
+
+	restartOnSimplified(simplified, cube);
+}
+
+void
+PortfolioSimple::restartOnSimplified(std::shared_ptr<const FormulaArena> simplified, const std::vector<int>& cube)
+{
+	std::lock_guard<std::mutex> lock(reconfigurationMutex);
+
+	const double ratio = __globalParameters__.prsPipelineRestart;
+	std::vector<std::shared_ptr<SolverCdclInterface>> restarted;
+	std::vector<int> cores;
+
+	for (size_t i = 0; i < cdclSolvers.size() && !globalEnding; i++) {
+		// Designated solvers are spread over the portfolio, thus over the solver types
+		if ((unsigned int)((i + 1) * ratio) == (unsigned int)(i * ratio))
+			continue;
+
+		std::shared_ptr<SolverCdclInterface> oldSolver = cdclSolvers[i];
+		if (!detachSolver(oldSolver))
+			continue;
+
+		std::shared_ptr<SolverInterface> created;
+		if (SolverFactory::createSolver(PortfolioBandit::getSolverChar(oldSolver->getSolverType()),
+										__globalParameters__.importDB.c_str()[0],
+										oldSolver->getSolverId(),
+										created) != SolverAlgorithmType::CDCL) {
+			LOGERROR("[Pipeline] Could not restart solver %u", oldSolver->getSolverId());
+			continue;
+		}
+
+		std::shared_ptr<SolverCdclInterface> newSolver = std::static_pointer_cast<SolverCdclInterface>(created);
+		newSolver->setSolverTypeId(typeIDScaler(newSolver));
+		newSolver->diversify();
+		newSolver->addInitialClauses(simplified->data(), simplified->getClausesCount(), simplified->getVariablesCount());
+
+		cdclSolvers[i] = newSolver;
+		restarted.push_back(newSolver);
+		cores.push_back(ThreadPlacement::getCore(i));
+	}
+
+	// The restarted solvers stay out of the phase exchange, their variables are those of the simplified formula
+	{
+		std::lock_guard<std::mutex> lock(pipelineMutex);
+		simplifiedSolvers = restarted;
+	}
+
+	if (restarted.size() > 1) {
+		SharingStrategyFactory::instantiateLocalStrategies(1, simplifiedStrategies, restarted);
+		SharingStrategyFactory::launchSharers(simplifiedStrategies, this->sharers);
+	}
+
+	for (size_t i = 0; i < restarted.size(); i++) {
+		SequentialWorker* worker = new SequentialWorker(restarted[i]);
+		worker->setThreadAffinity(cores[i]);
+		{
+			std::lock_guard<std::mutex> lock(slavesMutex);
+			this->addSlave(worker);
+		}
+		worker->solve(cube);
+	}
+
+	// The portfolio may have been interrupted before the new workers were registered
+	if (globalEnding || strategyEnding)
+		setSolverInterrupt();
+
+	LOG0("[Pipeline] %zu solvers restarted on the simplified formula", restarted.size());
+}
+
+bool
+PortfolioSimple::isSimplifiedWorker(WorkingStrategy* strat)
+{
+	SequentialWorker* worker = dynamic_cast<SequentialWorker*>(strat);
+	return worker && isSimplifiedSolver(worker->solver);
+}
+
+bool
+PortfolioSimple::isSimplifiedSolver(const std::shared_ptr<SolverInterface>& solver)
+{
+	std::lock_guard<std::mutex> lock(pipelineMutex);
+	return std::find(simplifiedSolvers.begin(), simplifiedSolvers.end(), solver) != simplifiedSolvers.end();
 }
 
 void
@@ -300,6 +673,8 @@ PortfolioSimple::join(WorkingStrategy* strat, SatResult res, const std::vector<i
 
 		if (res == SatResult::SAT) {
 			finalModel = model;
+			// In pipelined mode, only PRS and the restarted solvers answer on the simplified formula
+			restoreThroughPreprocessors = !pipelined || strat == this || isSimplifiedWorker(strat);
 		}
 
 		if (strat != this) {
@@ -316,9 +691,70 @@ PortfolioSimple::join(WorkingStrategy* strat, SatResult res, const std::vector<i
 	}
 }
 
+SatResult
+PortfolioSimple::eliminateVariables(const std::vector<int>& cube)
+{
+	std::shared_ptr<PreprocessorInterface> bve = this->preprocessors.back();
+	SatResult res = bve->solve(cube);
+
+	if (res == SatResult::UNSAT) {
+		LOG0("BVE answered UNSAT");
+		this->join(this, res, {});
+	} else if (res == SatResult::SAT) {
+		LOG0("BVE answered SAT");
+		this->join(this, res, bve->getModel());
+	}
+	return res;
+}
+
+bool
+PortfolioSimple::detachSolver(const std::shared_ptr<SolverCdclInterface>& solver)
+{
+	SequentialWorker* worker = nullptr;
+
+	// Detach the worker so that the portfolio does not interrupt it while it is being destroyed
+	{
+		std::lock_guard<std::mutex> lock(slavesMutex);
+		for (auto it = slaves.begin(); it != slaves.end(); ++it) {
+			SequentialWorker* slave = dynamic_cast<SequentialWorker*>(*it);
+			if (slave && slave->solver == solver) {
+				worker = slave;
+				slaves.erase(it);
+				break;
+			}
+		}
+	}
+
+	if (!worker)
+		return false;
+
+	// The interrupted solver returns UNKNOWN which is ignored by join
+	worker->setSolverInterrupt();
+	delete worker;
+
+	for (auto& lstrat : localStrategies) {
+		lstrat->removeProducer(solver);
+		lstrat->removeClient(solver);
+	}
+	for (auto& gstrat : globalStrategies) {
+		gstrat->removeProducer(solver);
+		gstrat->removeClient(solver);
+	}
+	for (auto& sstrat : simplifiedStrategies) {
+		sstrat->removeProducer(solver);
+		sstrat->removeClient(solver);
+	}
+
+	if (phaseExchange)
+		phaseExchange->disconnect(solver);
+
+	return true;
+}
+
 void
 PortfolioSimple::setSolverInterrupt()
 {
+	std::lock_guard<std::mutex> lock(slavesMutex);
 	for (size_t i = 0; i < slaves.size(); i++) {
 		LOGDEBUG1("Interrupting slave %u", i);
 		slaves[i]->setSolverInterrupt();
@@ -328,6 +764,7 @@ PortfolioSimple::setSolverInterrupt()
 void
 PortfolioSimple::unsetSolverInterrupt()
 {
+	std::lock_guard<std::mutex> lock(slavesMutex);
 	for (size_t i = 0; i < slaves.size(); i++) {
 		slaves[i]->unsetSolverInterrupt();
 	}
@@ -336,6 +773,7 @@ PortfolioSimple::unsetSolverInterrupt()
 void
 PortfolioSimple::waitInterrupt()
 {
+	std::lock_guard<std::mutex> lock(slavesMutex);
 	for (size_t i = 0; i < slaves.size(); i++) {
 		slaves[i]->waitInterrupt();
 	}
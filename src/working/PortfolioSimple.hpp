@@ -1,9 +1,11 @@
 #pragma once
 
+#include "containers/FormulaArena.hpp"
 #include "utils/Parameters.hpp"
 #include "working/WorkingStrategy.hpp"
 
 #include "solvers/CDCL/SolverCdclInterface.hpp"
+#include "preprocessors/PreprocessingCache.hpp"
 #include "preprocessors/PreprocessorInterface.hpp"
 #include "solvers/LocalSearch/LocalSearchInterface.hpp"
 
@@ -12,8 +14,16 @@
 #include "sharing/GlobalStrategies/GlobalSharingStrategy.hpp"
 #include "sharing/SharingStrategy.hpp"
 
+#include "solvers/SolverFactory.hpp"
+#include "working/DistributedTermination.hpp"
+#include "working/MemoryGovernor.hpp"
+#include "working/PhaseExchange.hpp"
+#include "working/PortfolioBandit.hpp"
+#include "working/ProbingService.hpp"
+
 #include <condition_variable>
 #include <mutex>
+#include <thread>
 
 /**
  * @brief A Simple Implementation of WorkingStrategy for the portfolio parallel strategy
@@ -39,8 +49,56 @@ class PortfolioSimple : public WorkingStrategy
 	void waitInterrupt() override;
 
   protected:
+	friend class PortfolioBandit;
+	friend class MemoryGovernor;
+
+	/**
+	 * @brief Stop the worker of a running solver and disconnect the solver from the sharing strategies and the phase
+	 * exchange.
+	 * @return false if the solver has no running worker in this portfolio.
+	 * @warning The caller must hold reconfigurationMutex, the solver is not removed from cdclSolvers.
+	 */
+	bool detachSolver(const std::shared_ptr<SolverCdclInterface>& solver);
+
+	/**
+	 * @brief Body of the pipeline thread: run PRS while the solvers work on the original formula, then restart the
+	 * designated solvers on the simplified formula.
+	 * @param cube The cube given to the restarted solvers.
+	 */
+	void runPipeline(std::vector<int> cube);
+
+	/**
+	 * @brief Replace the designated CDCL solvers (a prsPipelineRestart fraction spread over the portfolio) by new
+	 * solvers of the same type loading the simplified formula, they share clauses only among themselves.
+	 */
+	void restartOnSimplified(std::shared_ptr<const FormulaArena> simplified, const std::vector<int>& cube);
+
+	/// True if strat is the worker of a solver restarted on the simplified formula
+	bool isSimplifiedWorker(WorkingStrategy* strat);
+
+	/// True if solver was restarted on the simplified formula
+	bool isSimplifiedSolver(const std::shared_ptr<SolverInterface>& solver);
+
+	/**
+	 * @brief Run the bounded variable elimination, the last of the preprocessors, on the clauses it was given.
+	 * @details A SAT or UNSAT answer is joined.
+	 * @return The answer of the elimination, UNKNOWN if the simplified formula is to be solved.
+	 */
+	SatResult eliminateVariables(const std::vector<int>& cube);
+
 	std::atomic<bool> strategyEnding;
 
+	/// Protects slaves, which can be replaced at runtime by the bandit
+	std::mutex slavesMutex;
+
+	/// Serializes the runtime modifications of cdclSolvers (bandit and memory governor)
+	std::mutex reconfigurationMutex;
+
+	// Diversification
+	//----------------
+	IDScaler globalIDScaler;
+	IDScaler typeIDScaler;
+
 	// Solvers
 	//--------
 	std::vector<std::shared_ptr<SolverCdclInterface>> cdclSolvers;
@@ -53,4 +111,44 @@ class PortfolioSimple : public WorkingStrategy
 	std::vector<std::shared_ptr<SharingStrategy>> localStrategies;
 	std::vector<std::shared_ptr<GlobalSharingStrategy>> globalStrategies;
 	std::vector<std::unique_ptr<Sharer>> sharers;
+
+	// Pipelined preprocessing
+	//------------------------
+	bool pipelined = false;
+
+	std::thread pipelineThread;
+
+	/// Protects solversLaunched and simplifiedSolvers
+	std::mutex pipelineMutex;
+	std::condition_variable pipelineCond;
+
+	/// The initial solvers are launched, the pipeline can replace them
+	bool solversLaunched = false;
+
+	/// Solvers working on the simplified formula, their models go through the preprocessors
+	std::vector<std::shared_ptr<SolverCdclInterface>> simplifiedSolvers;
+
+	/// Sharing group of the simplified solvers, their clauses are meaningless to the others
+	std::vector<std::shared_ptr<SharingStrategy>> simplifiedStrategies;
+
+	/// False if the winning model is a model of the original formula
+	bool restoreThroughPreprocessors = true;
+
+	/// Results of PRS and BVE from the previous runs, null if disabled
+	std::unique_ptr<PreprocessingCache> prepCache;
+
+	// Reconfiguration
+	//----------------
+	std::shared_ptr<PortfolioBandit> bandit;
+	std::unique_ptr<MemoryGovernor> governor;
+
+	// Root-level probing
+	//-------------------
+	std::shared_ptr<ProbingService> probing;
+
+	/// Phases exchanged between the local search and the CDCL solvers, null if disabled
+	std::unique_ptr<PhaseExchange> phaseExchange;
+
+	/// Listener stopping the solvers at the end of another process, null if not distributed or disabled
+	std::unique_ptr<DistributedTermination> termination;
 };
\ No newline at end of file
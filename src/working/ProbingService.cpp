@@ -0,0 +1,586 @@
+#include "working/ProbingService.hpp"
+#include "containers/Formula.hpp"
+#include "painless.hpp"
+#include "utils/Logger.hpp"
+#include "utils/Parameters.hpp"
+#include "utils/System.hpp"
+
+#include <algorithm>
+#include <climits>
+
+/// Variables probed by a task of a round
+static const unsigned int PROBE_CHUNK = 64;
+
+/// Imported clauses waiting for the next round above this number are dropped
+static const size_t MAX_PENDING_IMPORTS = 1'000'000;
+
+ProbingService::ProbingService(std::shared_ptr<const FormulaArena> formula, unsigned int threads)
+	: SharingEntity()
+	, m_formula(std::move(formula))
+	, m_threads(std::max(1U, threads))
+{
+}
+
+ProbingService::~ProbingService()
+{
+	join();
+}
+
+void
+ProbingService::start()
+{
+	LOG0("[Probing] Service launched with %u threads", m_threads);
+	m_thread = std::thread(&ProbingService::mainLoop, this);
+}
+
+void
+ProbingService::join()
+{
+	m_stop = true;
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+bool
+ProbingService::isStopped() const
+{
+	return m_stop || m_unsat || globalEnding;
+}
+
+bool
+ProbingService::importClause(const ClauseExchangePtr& clause)
+{
+	if (clause->size > 2)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_importMutex);
+	if (m_imports.size() >= MAX_PENDING_IMPORTS)
+		return false;
+	m_imports.emplace_back(clause->lits[0], (clause->size == 2) ? clause->lits[1] : 0);
+	return true;
+}
+
+void
+ProbingService::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+{
+	for (const auto& clause : clauses)
+		importClause(clause);
+}
+
+void
+ProbingService::printStats()
+{
+	LOGSTAT("[Probing] rounds %lu, probes %lu, failed literals %lu, backbone literals %lu, equivalences %lu (probing) "
+			"%lu (SCC), imported units %lu, imported binaries %lu",
+			m_rounds,
+			m_probes.load(),
+			m_failedCount.load(),
+			m_backboneCount.load(),
+			m_probingEquivalences.load(),
+			m_sccEquivalences.load(),
+			m_importedUnits,
+			m_importedBinaries);
+}
+
+void
+ProbingService::mainLoop()
+{
+	double start = SystemResourceMonitor::getRelativeTimeSeconds();
+
+	buildSnapshot();
+	m_probers.resize(m_threads);
+	for (Prober& prober : m_probers)
+		initProber(prober);
+
+	LOG0("[Probing] Snapshot of %u variables, %zu units, %zu long clauses built in %.2fs",
+		 m_varCount,
+		 m_units.size(),
+		 m_longStart.size(),
+		 SystemResourceMonitor::getRelativeTimeSeconds() - start);
+
+	const double period = __globalParameters__.probePeriod;
+
+	while (!isStopped()) {
+		integrateImports();
+		runRound();
+		m_rounds++;
+
+		if (period <= 0)
+			break;
+
+		// Sliced wait, the timeout sets globalEnding after its notification
+		double roundEnd = SystemResourceMonitor::getRelativeTimeSeconds();
+		while (!isStopped() && SystemResourceMonitor::getRelativeTimeSeconds() - roundEnd < period) {
+			std::unique_lock<std::mutex> lock(mutexGlobalEnd);
+			condGlobalEnd.wait_for(lock, std::chrono::milliseconds(200));
+		}
+	}
+
+	// The copies of the formula are not needed anymore
+	std::vector<Prober>().swap(m_probers);
+	LOGDEBUG1("Probing service ended after %lu rounds", m_rounds);
+}
+
+/* Snapshot */
+/* -------- */
+
+void
+ProbingService::buildSnapshot()
+{
+	m_varCount = m_formula->getVariablesCount();
+	m_implications.assign(2 * m_varCount, {});
+	m_unitValues.assign(m_varCount + 1, 0);
+
+	const lit_t* literals = m_formula->data();
+	simpleClause clause;
+
+	for (unsigned int i = 0; i < m_formula->getClausesCount(); i++) {
+		clause.clear();
+		for (; *literals; literals++)
+			clause.push_back(*literals);
+		literals++;
+
+		std::sort(clause.begin(), clause.end(), [](int lit1, int lit2) {
+			return std::abs(lit1) < std::abs(lit2) || (std::abs(lit1) == std::abs(lit2) && lit1 < lit2);
+		});
+		clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+		bool tautology = false;
+		for (unsigned int j = 1; j < clause.size(); j++)
+			tautology |= clause[j] == -clause[j - 1];
+
+		// The empty clause is left to the solvers
+		if (tautology || clause.empty())
+			continue;
+
+		if (clause.size() == 1) {
+			learnUnit(clause[0], UnitKind::IMPORTED);
+		} else if (clause.size() == 2) {
+			int neg0 = -clause[0], neg1 = -clause[1];
+			m_implications[LIT_IDX(neg0)].push_back(clause[1]);
+			m_implications[LIT_IDX(neg1)].push_back(clause[0]);
+		} else {
+			m_longStart.push_back(m_longLiterals.size());
+			m_longLiterals.insert(m_longLiterals.end(), clause.begin(), clause.end());
+			m_longLiterals.push_back(0);
+		}
+	}
+
+	m_formula.reset();
+}
+
+void
+ProbingService::initProber(Prober& prober)
+{
+	prober.values.assign(m_varCount + 1, 0);
+	prober.literals = m_longLiterals;
+	prober.watches.assign(2 * m_varCount, {});
+	prober.mark.assign(2 * m_varCount, 0);
+
+	for (unsigned int idx = 0; idx < m_longStart.size(); idx++) {
+		const int* clause = &prober.literals[m_longStart[idx]];
+		prober.watches[LIT_IDX(clause[0])].push_back({ idx, clause[1] });
+		prober.watches[LIT_IDX(clause[1])].push_back({ idx, clause[0] });
+	}
+}
+
+void
+ProbingService::integrateImports()
+{
+	std::vector<std::pair<int, int>> imports;
+	{
+		std::lock_guard<std::mutex> lock(m_importMutex);
+		imports.swap(m_imports);
+	}
+
+	for (auto [lit1, lit2] : imports) {
+		if (!lit2) {
+			m_importedUnits += learnUnit(lit1, UnitKind::IMPORTED);
+		} else {
+			int neg1 = -lit1, neg2 = -lit2;
+			m_implications[LIT_IDX(neg1)].push_back(lit2);
+			m_implications[LIT_IDX(neg2)].push_back(lit1);
+			m_importedBinaries++;
+		}
+	}
+}
+
+/* Learned facts */
+/* ------------- */
+
+bool
+ProbingService::learnUnit(int lit, UnitKind kind)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_learnedMutex);
+		signed char val = (lit > 0) ? 1 : -1;
+		if (m_unitValues[std::abs(lit)] == val)
+			return false;
+
+		// An opposite unit is still recorded, the threads find the conflict when assigning it
+		if (!m_unitValues[std::abs(lit)])
+			m_unitValues[std::abs(lit)] = val;
+		m_units.push_back(lit);
+		m_unitCount = m_units.size();
+	}
+
+	if (kind == UnitKind::IMPORTED)
+		return true;
+
+	if (kind == UnitKind::FAILED)
+		m_failedCount++;
+	else
+		m_backboneCount++;
+	exportClause(ClauseExchange::create(std::vector<lit_t>{ lit }, 1, getSharingId()));
+	return true;
+}
+
+void
+ProbingService::learnEquivalence(int lit1, int lit2, bool fromScc)
+{
+	if (std::abs(lit1) == std::abs(lit2))
+		return;
+
+	// lit1 == lit2 is also -lit1 == -lit2, the key has the smallest variable first and positive
+	if (std::abs(lit1) > std::abs(lit2))
+		std::swap(lit1, lit2);
+	if (lit1 < 0) {
+		lit1 = -lit1;
+		lit2 = -lit2;
+	}
+
+	uint64_t key = (uint64_t(lit1) << 32) | uint32_t(lit2);
+	{
+		std::lock_guard<std::mutex> lock(m_learnedMutex);
+		if (!m_equivalences.insert(key).second)
+			return;
+	}
+
+	if (fromScc)
+		m_sccEquivalences++;
+	else
+		m_probingEquivalences++;
+	exportClause(ClauseExchange::create(std::vector<lit_t>{ -lit1, lit2 }, 2, getSharingId()));
+	exportClause(ClauseExchange::create(std::vector<lit_t>{ lit1, -lit2 }, 2, getSharingId()));
+}
+
+void
+ProbingService::declareUnsat(int lit)
+{
+	if (m_unsat.exchange(true))
+		return;
+
+	LOG0("[Probing] Conflict at the root level, the formula is unsatisfiable");
+	exportClause(ClauseExchange::create(std::vector<lit_t>{ -lit }, 1, getSharingId()));
+}
+
+/* Propagation */
+/* ----------- */
+
+bool
+ProbingService::propagate(Prober& prober)
+{
+	while (prober.propagated < prober.trail.size()) {
+		int lit = prober.trail[prober.propagated++];
+
+		for (int implied : m_implications[LIT_IDX(lit)]) {
+			int val = value(prober, implied);
+			if (val < 0)
+				return false;
+			if (!val)
+				assign(prober, implied);
+		}
+
+		int falseLit = -lit;
+		std::vector<Watch>& watches = prober.watches[LIT_IDX(falseLit)];
+		size_t i = 0, j = 0;
+
+		for (; i < watches.size(); i++) {
+			Watch watch = watches[i];
+			if (value(prober, watch.blocker) > 0) {
+				watches[j++] = watch;
+				continue;
+			}
+
+			int* clause = &prober.literals[m_longStart[watch.clause]];
+			if (clause[0] == falseLit)
+				std::swap(clause[0], clause[1]);
+
+			if (clause[0] != watch.blocker && value(prober, clause[0]) > 0) {
+				watches[j++] = { watch.clause, clause[0] };
+				continue;
+			}
+
+			// Look for a new literal to watch
+			int* replacement = clause + 2;
+			while (*replacement && value(prober, *replacement) < 0)
+				replacement++;
+
+			if (*replacement) {
+				clause[1] = *replacement;
+				*replacement = falseLit;
+				prober.watches[LIT_IDX(clause[1])].push_back({ watch.clause, clause[0] });
+				continue;
+			}
+
+			watches[j++] = { watch.clause, clause[0] };
+			int val = value(prober, clause[0]);
+			if (val < 0) {
+				while (++i < watches.size())
+					watches[j++] = watches[i];
+				watches.resize(j);
+				return false;
+			}
+			if (!val)
+				assign(prober, clause[0]);
+		}
+		watches.resize(j);
+	}
+
+	return true;
+}
+
+void
+ProbingService::backtrack(Prober& prober, size_t trailSize)
+{
+	for (size_t i = trailSize; i < prober.trail.size(); i++)
+		prober.values[std::abs(prober.trail[i])] = 0;
+	prober.trail.resize(trailSize);
+	prober.propagated = std::min(prober.propagated, trailSize);
+}
+
+bool
+ProbingService::assignRoot(Prober& prober, int lit)
+{
+	int val = value(prober, lit);
+	if (val > 0)
+		return true;
+	if (!val) {
+		assign(prober, lit);
+		if (propagate(prober))
+			return true;
+	}
+	return false;
+}
+
+bool
+ProbingService::syncUnits(Prober& prober)
+{
+	if (prober.knownUnits == m_unitCount.load())
+		return true;
+
+	std::vector<int> fresh;
+	{
+		std::lock_guard<std::mutex> lock(m_learnedMutex);
+		fresh.assign(m_units.begin() + prober.knownUnits, m_units.end());
+		prober.knownUnits = m_units.size();
+	}
+
+	for (int lit : fresh) {
+		if (!assignRoot(prober, lit)) {
+			declareUnsat(lit);
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Round */
+/* ----- */
+
+void
+ProbingService::probeVariable(Prober& prober, int var)
+{
+	if (prober.values[var])
+		return;
+
+	m_probes++;
+	const size_t root = prober.trail.size();
+
+	assign(prober, var);
+	if (!propagate(prober)) {
+		backtrack(prober, root);
+		learnUnit(-var, UnitKind::FAILED);
+		return;
+	}
+
+	if (++prober.stamp == 0) {
+		std::fill(prober.mark.begin(), prober.mark.end(), 0);
+		prober.stamp = 1;
+	}
+	for (size_t i = root + 1; i < prober.trail.size(); i++)
+		prober.mark[LIT_IDX(prober.trail[i])] = prober.stamp;
+	backtrack(prober, root);
+
+	assign(prober, -var);
+	if (!propagate(prober)) {
+		backtrack(prober, root);
+		learnUnit(var, UnitKind::FAILED);
+		return;
+	}
+
+	// Implied by both polarities: backbone; implied with opposite signs: equivalent to -var
+	std::vector<int> backbone, equivalent;
+	for (size_t i = root + 1; i < prober.trail.size(); i++) {
+		int lit = prober.trail[i], neg = -lit;
+		if (prober.mark[LIT_IDX(lit)] == prober.stamp)
+			backbone.push_back(lit);
+		else if (prober.mark[LIT_IDX(neg)] == prober.stamp)
+			equivalent.push_back(lit);
+	}
+	backtrack(prober, root);
+
+	for (int lit : backbone)
+		learnUnit(lit, UnitKind::BACKBONE);
+	for (int lit : equivalent)
+		learnEquivalence(lit, -var, false);
+}
+
+void
+ProbingService::computeEquivalences()
+{
+	const unsigned int nodes = 2 * m_varCount;
+	const unsigned int unvisited = UINT_MAX;
+
+	std::vector<signed char> fixed;
+	{
+		std::lock_guard<std::mutex> lock(m_learnedMutex);
+		fixed = m_unitValues;
+	}
+
+	auto literal = [](unsigned int node) { return (node & 1) ? -int(node / 2 + 1) : int(node / 2 + 1); };
+
+	std::vector<unsigned int> index(nodes, unvisited), low(nodes, 0);
+	std::vector<char> onStack(nodes, 0);
+	std::vector<unsigned int> stack;
+	std::vector<std::pair<unsigned int, unsigned int>> calls;
+	std::vector<int> component;
+	unsigned int counter = 0;
+
+	for (unsigned int root = 0; root < nodes && !isStopped(); root++) {
+		if (index[root] != unvisited || fixed[root / 2 + 1])
+			continue;
+
+		index[root] = low[root] = counter++;
+		stack.push_back(root);
+		onStack[root] = 1;
+		calls.emplace_back(root, 0);
+
+		while (!calls.empty()) {
+			unsigned int node = calls.back().first;
+			const std::vector<int>& successors = m_implications[node];
+
+			if (calls.back().second < successors.size()) {
+				int lit = successors[calls.back().second++];
+				if (fixed[std::abs(lit)])
+					continue;
+
+				unsigned int next = LIT_IDX(lit);
+				if (index[next] == unvisited) {
+					index[next] = low[next] = counter++;
+					stack.push_back(next);
+					onStack[next] = 1;
+					calls.emplace_back(next, 0);
+				} else if (onStack[next]) {
+					low[node] = std::min(low[node], index[next]);
+				}
+				continue;
+			}
+
+			calls.pop_back();
+			if (!calls.empty())
+				low[calls.back().first] = std::min(low[calls.back().first], low[node]);
+
+			if (low[node] != index[node])
+				continue;
+
+			component.clear();
+			unsigned int member;
+			do {
+				member = stack.back();
+				stack.pop_back();
+				onStack[member] = 0;
+				component.push_back(literal(member));
+			} while (member != node);
+
+			if (component.size() < 2)
+				continue;
+
+			std::sort(component.begin(), component.end(), [](int lit1, int lit2) {
+				return std::abs(lit1) < std::abs(lit2) || (std::abs(lit1) == std::abs(lit2) && lit1 < lit2);
+			});
+
+			// x and -x in a same component: both are implied
+			bool contradiction = false;
+			for (unsigned int i = 1; i < component.size() && !contradiction; i++) {
+				if (component[i] == -component[i - 1]) {
+					learnUnit(component[i], UnitKind::FAILED);
+					learnUnit(component[i - 1], UnitKind::FAILED);
+					contradiction = true;
+				}
+			}
+
+			// The dual component (negated literals) gives the same equivalences
+			if (contradiction || component[0] < 0)
+				continue;
+
+			for (unsigned int i = 1; i < component.size(); i++)
+				learnEquivalence(component[i], component[0], true);
+		}
+	}
+}
+
+void
+ProbingService::runRound()
+{
+	const double start = SystemResourceMonitor::getRelativeTimeSeconds();
+	const double deadline = start + __globalParameters__.probeRoundTime;
+	const unsigned int first = m_cursor;
+	const unsigned int chunks = (m_varCount + PROBE_CHUNK - 1) / PROBE_CHUNK;
+
+	unsigned long units = m_unitCount, equivalences = m_probingEquivalences + m_sccEquivalences;
+
+	// Task 0 is the SCC computation, task t > 0 probes the chunk t - 1 starting from the cursor
+	std::atomic<unsigned int> nextTask(0);
+
+	auto worker = [&](unsigned int id) {
+		Prober& prober = m_probers[id];
+		if (!syncUnits(prober))
+			return;
+
+		for (unsigned int task = nextTask++; task <= chunks; task = nextTask++) {
+			if (task == 0) {
+				computeEquivalences();
+				continue;
+			}
+
+			unsigned int end = std::min(task * PROBE_CHUNK, m_varCount);
+			for (unsigned int offset = (task - 1) * PROBE_CHUNK; offset < end; offset++) {
+				if (isStopped() || SystemResourceMonitor::getRelativeTimeSeconds() > deadline)
+					return;
+
+				probeVariable(prober, (first - 1 + offset) % m_varCount + 1);
+				if (!syncUnits(prober))
+					return;
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < m_threads; i++)
+		pool.emplace_back(worker, i);
+	worker(0);
+	for (auto& thread : pool)
+		thread.join();
+
+	// The next round starts after the last chunk started by this one
+	unsigned int started = std::min(nextTask.load(), chunks + 1);
+	if (m_varCount && started > 1)
+		m_cursor = (first - 1 + (started - 1) * PROBE_CHUNK) % m_varCount + 1;
+
+	LOG1("[Probing] Round %lu: %lu new units, %lu new equivalences in %.2fs",
+		 m_rounds,
+		 m_unitCount - units,
+		 m_probingEquivalences + m_sccEquivalences - equivalences,
+		 SystemResourceMonitor::getRelativeTimeSeconds() - start);
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "containers/ClauseExchange.hpp"
+#include "containers/FormulaArena.hpp"
+#include "sharing/SharingEntity.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Root-level reasoning done once for the whole portfolio: failed literal probing, equivalent literal detection
+ * and partial backbone extraction, on a snapshot of the formula loaded by the solvers.
+ *
+ * The service works in rounds on its own pool of threads. During a round, one thread computes the strongly connected
+ * components of the binary implication graph (equivalent literals) while the others probe both polarities of the
+ * variables: a failed literal gives a unit, a literal implied by both polarities is a backbone literal and a literal
+ * implied with opposite signs is equivalent to the probed variable. Each thread propagates on its own copy of the long
+ * clauses, the units found by the other threads are added to its root level between two probes.
+ *
+ * The units and the equivalences (two binary clauses) are exported as soon as they are found to the local sharing
+ * strategy the service is a producer of. The service is also a client of the local strategies: the units and binary
+ * clauses shared by the solvers are added to the snapshot between two rounds. Each round resumes the probing where
+ * the previous one stopped.
+ * @ingroup working
+ */
+class ProbingService : public SharingEntity
+{
+  public:
+	/**
+	 * @brief Constructor.
+	 * @param formula The formula of the solvers, the snapshot is built from it by the service thread.
+	 * @param threads Number of threads of a round.
+	 */
+	ProbingService(std::shared_ptr<const FormulaArena> formula, unsigned int threads);
+
+	~ProbingService();
+
+	/// Launch the service thread.
+	void start();
+
+	/// Stop the rounds and wait for the service thread.
+	void join();
+
+	/// Keep a unit or binary clause shared by the solvers for the next round.
+	bool importClause(const ClauseExchangePtr& clause) override;
+
+	/// Keep the units and binary clauses shared by the solvers for the next round.
+	void importClauses(const std::vector<ClauseExchangePtr>& clauses) override;
+
+	/// Print the number of units and equivalences found.
+	void printStats();
+
+  protected:
+	/// Watch of a long clause, the blocker is a literal of the clause
+	struct Watch
+	{
+		unsigned int clause;
+		int blocker;
+	};
+
+	/// Propagation state of a thread of the pool, kept between rounds
+	struct Prober
+	{
+		/// values[var] is 1 (true), -1 (false) or 0
+		std::vector<signed char> values;
+		std::vector<int> trail;
+		size_t propagated = 0;
+
+		/// Copy of the long clauses, zero terminated, the two watched literals first
+		std::vector<int> literals;
+		std::vector<std::vector<Watch>> watches;
+
+		/// Number of units of the service already assigned at the root level
+		size_t knownUnits = 0;
+
+		/// mark[LIT_IDX(lit)] == stamp iff lit was implied by the positive probe of the current variable
+		std::vector<unsigned int> mark;
+		unsigned int stamp = 0;
+	};
+
+	/// Kind of a unit, for the statistics
+	enum class UnitKind
+	{
+		FAILED,
+		BACKBONE,
+		IMPORTED
+	};
+
+	/// Main loop of the service thread.
+	void mainLoop();
+
+	/// Split the formula into units, binary implications and long clauses.
+	void buildSnapshot();
+
+	/// Initialize the propagation state of a thread.
+	void initProber(Prober& prober);
+
+	/// Add the clauses imported since the last round, the pool is idle.
+	void integrateImports();
+
+	/// Run a round of SCC computation and probing on the pool.
+	void runRound();
+
+	/// Probe both polarities of a variable and learn the failed, backbone and equivalent literals.
+	void probeVariable(Prober& prober, int var);
+
+	/// Equivalent literals of the binary implication graph, with an iterative Tarjan algorithm.
+	void computeEquivalences();
+
+	/// Assign lit at the root level of a thread and propagate, false on a conflict.
+	bool assignRoot(Prober& prober, int lit);
+
+	/// Assign the units learned since the last call at the root level of a thread, false on a conflict.
+	bool syncUnits(Prober& prober);
+
+	/// Unit propagation on the binary implications and the long clauses, false on a conflict.
+	bool propagate(Prober& prober);
+
+	void backtrack(Prober& prober, size_t trailSize);
+
+	int value(const Prober& prober, int lit) const { return (lit > 0) ? prober.values[lit] : -prober.values[-lit]; }
+
+	void assign(Prober& prober, int lit)
+	{
+		prober.values[std::abs(lit)] = (lit > 0) ? 1 : -1;
+		prober.trail.push_back(lit);
+	}
+
+	/**
+	 * @brief Record a unit implied by the formula and export it if it is new.
+	 * @return false if the unit was already known.
+	 */
+	bool learnUnit(int lit, UnitKind kind);
+
+	/// Record the equivalence of two literals and export it as two binary clauses if it is new.
+	void learnEquivalence(int lit1, int lit2, bool fromScc);
+
+	/// The root level of a thread is in conflict after assigning lit: export -lit and stop the service
+	void declareUnsat(int lit);
+
+	bool isStopped() const;
+
+	std::shared_ptr<const FormulaArena> m_formula;
+
+	unsigned int m_threads;
+
+	unsigned int m_varCount = 0;
+
+	std::thread m_thread;
+
+	std::atomic<bool> m_stop{ false };
+
+	/// Set when a conflict is found at the root level
+	std::atomic<bool> m_unsat{ false };
+
+	// Snapshot
+	//---------
+	/// Binary implications by LIT_IDX, only modified between two rounds
+	std::vector<std::vector<int>> m_implications;
+
+	/// Start of each long clause in the literals of a Prober
+	std::vector<size_t> m_longStart;
+
+	/// Long clauses of the snapshot, copied by each Prober
+	std::vector<int> m_longLiterals;
+
+	std::vector<Prober> m_probers;
+
+	/// First variable probed by the next round
+	unsigned int m_cursor = 1;
+
+	// Learned facts
+	//--------------
+	/// Protects the units and the exported equivalences
+	std::mutex m_learnedMutex;
+
+	/// Units in learning order, m_unitValues[var] is the value of a unit variable
+	std::vector<int> m_units;
+	std::vector<signed char> m_unitValues;
+	std::atomic<size_t> m_unitCount{ 0 };
+
+	/// Exported equivalences, as pairs of literals
+	std::unordered_set<uint64_t> m_equivalences;
+
+	/// Units and binary clauses (second literal 0 for a unit) imported since the last round
+	std::mutex m_importMutex;
+	std::vector<std::pair<int, int>> m_imports;
+
+	// Stats
+	//------
+	std::atomic<unsigned long> m_failedCount{ 0 };
+	std::atomic<unsigned long> m_backboneCount{ 0 };
+	std::atomic<unsigned long> m_probingEquivalences{ 0 };
+	std::atomic<unsigned long> m_sccEquivalences{ 0 };
+	std::atomic<unsigned long> m_probes{ 0 };
+	unsigned long m_importedUnits = 0;
+	unsigned long m_importedBinaries = 0;
+	unsigned long m_rounds = 0;
+};
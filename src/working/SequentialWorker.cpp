@@ -131,6 +131,13 @@ SequentialWorker::waitInterrupt()
 	waitInterruptLock.unlock();
 }
 
+void
+SequentialWorker::setThreadAffinity(int coreId)
+{
+	if (coreId >= 0)
+		worker->setThreadAffinity(coreId);
+}
+
 void
 SequentialWorker::setSolverInterrupt()
 {
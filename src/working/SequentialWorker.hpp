@@ -31,6 +31,9 @@ class SequentialWorker : public WorkingStrategy
 
 	void waitInterrupt();
 
+	/// Pin the worker thread on a core.
+	void setThreadAffinity(int coreId);
+
 	std::shared_ptr<SolverInterface> solver;
 
   protected: